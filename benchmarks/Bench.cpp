@@ -0,0 +1,110 @@
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+namespace Bench
+{
+void Runner::SpinUp() const
+{
+  const auto end{std::chrono::steady_clock::now() +
+                 std::chrono::milliseconds{200}};
+  uint64_t spin{0};
+  while (std::chrono::steady_clock::now() < end)
+  {
+    spin++;
+    DoNotOptimize(spin);
+  }
+}
+
+bool Runner::matches(const std::string &name) const
+{
+  return this->options.filter.empty() ||
+         name.find(this->options.filter) != std::string::npos;
+}
+
+void Runner::record(const std::string &name, double flops,
+                    uint64_t iterations, std::vector<double> &sample_ns)
+{
+  std::sort(sample_ns.begin(), sample_ns.end());
+  const size_t count{sample_ns.size()};
+  const double median{count % 2 == 1
+                          ? sample_ns[count / 2]
+                          : (sample_ns[count / 2 - 1] + sample_ns[count / 2]) /
+                                2};
+  double mean{0};
+  for (double sample : sample_ns)
+  {
+    mean += sample;
+  }
+  mean /= static_cast<double>(count);
+  double variance{0};
+  for (double sample : sample_ns)
+  {
+    variance += (sample - mean) * (sample - mean);
+  }
+  variance /= static_cast<double>(count > 1 ? count - 1 : 1);
+
+  const Result result{name,   iterations, static_cast<uint32_t>(count),
+                      median, sample_ns.front(), mean,
+                      std::sqrt(variance), flops};
+  this->results.push_back(result);
+
+  // flops per nanosecond is GFLOP/s
+  const double spread{median > 0 ? 100 * result.stddev_ns / median : 0};
+  if (flops > 0)
+  {
+    std::printf("%-42s %12.2f ns/op %9.3f GFLOP/s  +-%.1f%%\n", name.c_str(),
+                median, flops / median, spread);
+  }
+  else
+  {
+    std::printf("%-42s %12.2f ns/op %9s GFLOP/s  +-%.1f%%\n", name.c_str(),
+                median, "-", spread);
+  }
+  std::fflush(stdout);
+}
+
+bool Runner::WriteJson(const std::string &path) const
+{
+  std::FILE *file{std::fopen(path.c_str(), "w")};
+  if (file == nullptr)
+  {
+    return false;
+  }
+
+  char date[32]{};
+  const std::time_t now{std::time(nullptr)};
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  std::fprintf(file, "{\n  \"context\": {\n");
+  std::fprintf(file, "    \"date\": \"%s\",\n", date);
+#ifdef __VERSION__
+  std::fprintf(file, "    \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+  std::fprintf(file, "    \"min_sample_ns\": %.0f,\n",
+               this->options.min_sample_ns);
+  std::fprintf(file, "    \"samples\": %u\n  },\n",
+               this->options.samples);
+  std::fprintf(file, "  \"benchmarks\": [\n");
+  for (size_t idx{0}; idx < this->results.size(); idx++)
+  {
+    const Result &result{this->results[idx]};
+    std::fprintf(file,
+                 "    {\"name\": \"%s\", \"iterations\": %llu, "
+                 "\"samples\": %u, \"median_ns\": %.4f, \"min_ns\": %.4f, "
+                 "\"mean_ns\": %.4f, \"stddev_ns\": %.4f, \"flops\": %.0f, "
+                 "\"gflops\": %.4f}%s\n",
+                 result.name.c_str(),
+                 static_cast<unsigned long long>(result.iterations),
+                 result.samples, result.median_ns, result.min_ns,
+                 result.mean_ns, result.stddev_ns, result.flops,
+                 result.median_ns > 0 ? result.flops / result.median_ns : 0,
+                 idx + 1 < this->results.size() ? "," : "");
+  }
+  std::fprintf(file, "  ]\n}\n");
+  return std::fclose(file) == 0;
+}
+} // namespace Bench
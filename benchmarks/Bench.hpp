@@ -0,0 +1,152 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A small micro-benchmark harness. Every benchmark is calibrated until
+ * one sample runs for at least Options::min_sample_ns, warmed up, then timed
+ * over several samples so the median and spread can be reported instead of a
+ * single noisy number.
+ */
+namespace Bench
+{
+/**
+ * @brief Tell the compiler value is read and written here, so the work that
+ * produced it can't be thrown away and the work that reads it can't be hoisted
+ * out of the timing loop. Everything in the library is constexpr, so without
+ * this the optimizer is free to fold whole benchmarks away.
+ */
+template <typename T>
+inline void DoNotOptimize(T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : "+m"(value) : : "memory");
+#else
+  static volatile const void *sink{nullptr};
+  sink = &value;
+#endif
+}
+
+struct Options
+{
+  // a single sample has to take at least this long
+  double min_sample_ns{2e6};
+  uint32_t warmup_samples{3};
+  uint32_t samples{15};
+  // only run benchmarks whose name contains this
+  std::string filter{};
+};
+
+struct Result
+{
+  std::string name;
+  // the number of calls per sample
+  uint64_t iterations;
+  uint32_t samples;
+  double median_ns;
+  double min_ns;
+  double mean_ns;
+  double stddev_ns;
+  // the nominal floating point operations in one call, 0 if it doesn't make
+  // sense for the operation
+  double flops;
+};
+
+class Runner
+{
+public:
+  explicit Runner(const Options &options) : options(options) {}
+
+  /**
+   * @brief Time op() and print the result
+   * @param name the benchmark name, conventionally Type/Operation/Shape
+   * @param flops the nominal floating point operations in one call of op, or
+   * 0 to leave GFLOP/s out
+   * @param op the operation to time. It should run the operation once and
+   * pass its inputs and outputs through DoNotOptimize.
+   */
+  template <typename Op>
+  void Run(const std::string &name, double flops, Op &&op);
+
+  /**
+   * @brief Keep the CPU busy for a moment so it's out of its power saving
+   * clocks before the first benchmark
+   */
+  void SpinUp() const;
+
+  const std::vector<Result> &Results() const { return this->results; }
+
+  /**
+   * @brief Write every result to path as JSON
+   * @return true if the file could be written
+   */
+  bool WriteJson(const std::string &path) const;
+
+private:
+  template <typename Op>
+  double timeBatch(Op &op, uint64_t iterations);
+
+  bool matches(const std::string &name) const;
+
+  void record(const std::string &name, double flops, uint64_t iterations,
+              std::vector<double> &sample_ns);
+
+  Options options;
+  std::vector<Result> results{};
+};
+
+template <typename Op>
+double Runner::timeBatch(Op &op, uint64_t iterations)
+{
+  const auto start{std::chrono::steady_clock::now()};
+  for (uint64_t idx{0}; idx < iterations; idx++)
+  {
+    op();
+  }
+  const auto end{std::chrono::steady_clock::now()};
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+template <typename Op>
+void Runner::Run(const std::string &name, double flops, Op &&op)
+{
+  if (!this->matches(name))
+  {
+    return;
+  }
+
+  // grow the batch until one sample is long enough to time reliably
+  uint64_t iterations{1};
+  while (true)
+  {
+    const double batch_ns{this->timeBatch(op, iterations)};
+    if (batch_ns >= this->options.min_sample_ns || iterations >= (1ull << 32))
+    {
+      break;
+    }
+    const double scale{batch_ns > 0 ? this->options.min_sample_ns / batch_ns
+                                    : 100.0};
+    const uint64_t next{static_cast<uint64_t>(iterations * scale * 1.2)};
+    iterations = next > iterations * 2 ? next : iterations * 2;
+  }
+
+  for (uint32_t idx{0}; idx < this->options.warmup_samples; idx++)
+  {
+    this->timeBatch(op, iterations);
+  }
+
+  std::vector<double> sample_ns(this->options.samples);
+  for (double &sample : sample_ns)
+  {
+    sample = this->timeBatch(op, iterations) / static_cast<double>(iterations);
+  }
+  this->record(name, flops, iterations, sample_ns);
+}
+} // namespace Bench
+
+#endif // BENCH_H_
@@ -0,0 +1,70 @@
+# Compare two matrix-bench JSON files and flag the benchmarks that got slower.
+# usage: python3 compare-bench.py baseline.json results.json [--threshold 10]
+# exits with 1 if anything regressed so it can gate a CI job. A benchmark only
+# counts as slower when both its median and its fastest sample are past the
+# threshold, which filters out most of the one-off noise.
+import argparse
+import json
+import sys
+
+
+def load_timings(file_path: str) -> dict[str, tuple[float, float]]:
+    with open(file_path, 'r') as file:
+        results = json.load(file)
+    return {benchmark["name"]: (benchmark["median_ns"], benchmark["min_ns"])
+            for benchmark in results["benchmarks"]}
+
+
+def percent_change(old: float, new: float) -> float:
+    return 100 * (new - old) / old if old > 0 else 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="Flag matrix-bench regressions against a baseline")
+    parser.add_argument("baseline", help="the stored baseline JSON")
+    parser.add_argument("results", help="the new results JSON")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="percent slowdown that counts as a regression")
+    args = parser.parse_args()
+
+    baseline = load_timings(args.baseline)
+    results = load_timings(args.results)
+
+    regressions: list[str] = []
+    improvements: list[str] = []
+    for name, (median, fastest) in results.items():
+        if name not in baseline:
+            print(f"{name}: new, {median:.2f} ns/op")
+            continue
+        old_median, old_fastest = baseline[name]
+        change = percent_change(old_median, median)
+        fastest_change = percent_change(old_fastest, fastest)
+        line = (f"{name}: {old_median:.2f} -> {median:.2f} ns/op "
+                f"({change:+.1f}%)")
+        if change > args.threshold and fastest_change > args.threshold:
+            regressions.append(line)
+        elif change < -args.threshold and fastest_change < -args.threshold:
+            improvements.append(line)
+
+    for name in baseline:
+        if name not in results:
+            print(f"{name}: missing from the new results")
+
+    if len(improvements) > 0:
+        print(f"\nFaster by more than {args.threshold}%:")
+        for line in improvements:
+            print("  " + line)
+
+    if len(regressions) > 0:
+        print(f"\nSlower by more than {args.threshold}%:")
+        for line in regressions:
+            print("  " + line)
+        return 1
+
+    print("\nNo regressions outside the threshold.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,906 @@
+// the benchmark harness
+#include "Bench.hpp"
+
+// the modules being measured
+#include "Ahrs.hpp"
+#include "Cholesky.hpp"
+#include "KalmanFilter.hpp"
+#include "Matrix.hpp"
+#include "MatrixBatch.hpp"
+#include "Quaternion.h"
+#include "RigidTransform.hpp"
+#include "Vector3D.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+// deterministic, non-zero values. Square matrices get a heavy diagonal so the
+// determinant and inverse stay well conditioned at every size.
+template <uint8_t rows, uint8_t columns>
+Matrix<rows, columns> testMatrix(float offset)
+{
+  Matrix<rows, columns> result{};
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    {
+      result[row_idx][column_idx] =
+          static_cast<float>((row_idx * 7 + column_idx * 3) % 11) * 0.25f +
+          offset;
+    }
+    if (rows == columns)
+    {
+      result[row_idx][row_idx] += 4.0f * rows;
+    }
+  }
+  return result;
+}
+
+std::string shape(size_t rows, size_t columns)
+{
+  return std::to_string(rows) + "x" + std::to_string(columns);
+}
+
+// operations that work on any shape
+template <uint8_t rows, uint8_t columns>
+void benchElementWise(Bench::Runner &runner)
+{
+  Matrix<rows, columns> a{testMatrix<rows, columns>(1.0f)};
+  Matrix<rows, columns> b{testMatrix<rows, columns>(2.0f)};
+  Matrix<rows, columns> result{};
+  Matrix<columns, rows> transposed{};
+  Matrix<1, columns> row{};
+  Matrix<rows, 1> column{};
+  float scalar{1.5f};
+  const std::string name{shape(rows, columns)};
+  const double elements{static_cast<double>(rows) * columns};
+
+  runner.Run("Matrix/Add/" + name, elements, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    a.Add(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/Sub/" + name, elements, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    a.Sub(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  // goes through the expression templates when they're turned on
+  runner.Run("Matrix/operator+/" + name, elements, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    result = a + b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/operator+=/" + name, elements, [&]() {
+    Bench::DoNotOptimize(b);
+    result += b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/ScalarMult/" + name, elements, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(scalar);
+    a.Mult(scalar, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/ElementMultiply/" + name, elements, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    a.ElementMultiply(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/ElementDivide/" + name, elements, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    a.ElementDivide(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  // square, sum, divide
+  runner.Run("Matrix/Normalize/" + name, 3 * elements, [&]() {
+    Bench::DoNotOptimize(a);
+    a.Normalize(result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/Transpose/" + name, 0, [&]() {
+    Bench::DoNotOptimize(a);
+    transposed = a.Transpose();
+    Bench::DoNotOptimize(transposed);
+  });
+
+  runner.Run("Matrix/Fill/" + name, 0, [&]() {
+    Bench::DoNotOptimize(scalar);
+    result.Fill(scalar);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/GetRow/" + name, 0, [&]() {
+    Bench::DoNotOptimize(a);
+    a.GetRow(rows - 1, row);
+    Bench::DoNotOptimize(row);
+  });
+
+  runner.Run("Matrix/GetColumn/" + name, 0, [&]() {
+    Bench::DoNotOptimize(a);
+    a.GetColumn(columns - 1, column);
+    Bench::DoNotOptimize(column);
+  });
+}
+
+// a (m x k) times b (k x n)
+template <uint8_t m, uint8_t k, uint8_t n>
+void benchMult(Bench::Runner &runner)
+{
+  Matrix<m, k> a{testMatrix<m, k>(1.0f)};
+  Matrix<k, n> b{testMatrix<k, n>(2.0f)};
+  Matrix<m, n> result{};
+  const std::string name{shape(m, k) + "*" + shape(k, n)};
+  const double flops{2.0 * m * k * n};
+
+  runner.Run("Matrix/Mult/" + name, flops, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    a.Mult(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/operator*/" + name, flops, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    result = a * b;
+    Bench::DoNotOptimize(result);
+  });
+
+  // the same product with a stored transposed, once through a transposed copy
+  // and once through the kernel that reads it in place
+  Matrix<k, m> a_stored{a.Transpose()};
+  runner.Run("Matrix/Transpose+Mult/" + name, flops, [&]() {
+    Bench::DoNotOptimize(a_stored);
+    Bench::DoNotOptimize(b);
+    a_stored.Transpose().Mult(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/TransposeMult/" + name, flops, [&]() {
+    Bench::DoNotOptimize(a_stored);
+    Bench::DoNotOptimize(b);
+    a_stored.TransposeMult(b, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  // and with b stored transposed
+  Matrix<n, k> b_stored{b.Transpose()};
+  runner.Run("Matrix/MultTranspose/" + name, flops, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b_stored);
+    a.MultTranspose(b_stored, result);
+    Bench::DoNotOptimize(result);
+  });
+}
+
+// operations that only make sense for square matrices. The flop counts are
+// the nominal LU counts so GFLOP/s lines up across sizes, even where the
+// small sizes use cofactor expansion.
+template <uint8_t size, bool with_minors>
+void benchSquare(Bench::Runner &runner)
+{
+  Matrix<size, size> a{testMatrix<size, size>(1.0f)};
+  Matrix<size, size> result{};
+  Matrix<size - 1, size - 1> minor{};
+  float determinant{0};
+  const std::string name{shape(size, size)};
+  const double cube{static_cast<double>(size) * size * size};
+
+  benchMult<size, size, size>(runner);
+
+  // the copy keeps the product from blowing up over the iterations, it's
+  // small next to the product itself
+  runner.Run("Matrix/operator*=/" + name, 2 * cube, [&]() {
+    Bench::DoNotOptimize(a);
+    result = a;
+    result *= a;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/Det/" + name, 2.0 * cube / 3, [&]() {
+    Bench::DoNotOptimize(a);
+    determinant = a.Det();
+    Bench::DoNotOptimize(determinant);
+  });
+
+  runner.Run("Matrix/Invert/" + name, 2.0 * cube, [&]() {
+    Bench::DoNotOptimize(a);
+    result = a.Invert();
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Matrix/MinorMatrix/" + name, 0, [&]() {
+    Bench::DoNotOptimize(a);
+    a.MinorMatrix(minor, 0, 0);
+    Bench::DoNotOptimize(minor);
+  });
+
+  // a determinant per element, far too slow to be worth running at the big
+  // sizes
+  if (with_minors)
+  {
+    const double minor_cube{static_cast<double>(size - 1) * (size - 1) *
+                            (size - 1)};
+    runner.Run("Matrix/MatrixOfMinors/" + name,
+               size * size * 2.0 * minor_cube / 3, [&]() {
+                 Bench::DoNotOptimize(a);
+                 a.MatrixOfMinors(result);
+                 Bench::DoNotOptimize(result);
+               });
+  }
+}
+
+void benchVector(Bench::Runner &runner)
+{
+  V3D<float> a{1.5f, -2.25f, 3.0f};
+  V3D<float> b{-0.5f, 4.0f, 0.75f};
+  V3D<float> result{};
+  float scalar{1.5f};
+  float magnitude{0};
+  bool equal{false};
+
+  runner.Run("V3D/operator+", 3, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    result = a + b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator-", 3, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    result = a - b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator*", 3, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(scalar);
+    result = a * scalar;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator/", 3, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(scalar);
+    result = a / scalar;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator+=", 3, [&]() {
+    Bench::DoNotOptimize(b);
+    result += b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator-=", 3, [&]() {
+    Bench::DoNotOptimize(b);
+    result -= b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator*=", 3, [&]() {
+    Bench::DoNotOptimize(scalar);
+    result *= scalar;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("V3D/operator==", 0, [&]() {
+    Bench::DoNotOptimize(a);
+    Bench::DoNotOptimize(b);
+    equal = a == b;
+    Bench::DoNotOptimize(equal);
+  });
+
+  runner.Run("V3D/magnitude", 6, [&]() {
+    Bench::DoNotOptimize(a);
+    magnitude = a.magnitude();
+    Bench::DoNotOptimize(magnitude);
+  });
+}
+
+void benchQuaternion(Bench::Runner &runner)
+{
+  Quaternion q{Quaternion::FromAngleAndAxis(0.7f, Matrix<1, 3>{1, 2, 3})};
+  Quaternion p{Quaternion::FromAngleAndAxis(-1.2f, Matrix<1, 3>{0, 1, -1})};
+  Quaternion result{};
+  Quaternion buffer{};
+  Matrix<1, 3> axis{0.3f, -0.4f, 0.5f};
+  V3D<float> vector{1.0f, -2.0f, 0.5f};
+  V3D<float> rotated{};
+  Matrix<3, 1> column{1.0f, -2.0f, 0.5f};
+  Matrix<3, 1> rotated_column{};
+  Matrix<3, 3> rotation{};
+  Matrix<3, 1> euler{};
+  float angle{0.7f};
+  float scalar{1.5f};
+
+  runner.Run("Quaternion/FromAngleAndAxis", 0, [&]() {
+    Bench::DoNotOptimize(angle);
+    Bench::DoNotOptimize(axis);
+    result = Quaternion::FromAngleAndAxis(angle, axis);
+    Bench::DoNotOptimize(result);
+  });
+
+  // 16 multiplies and 12 adds
+  runner.Run("Quaternion/operator*", 28, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(p);
+    result = q * p;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Quaternion/operator*=", 28, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(p);
+    result = q;
+    result *= p;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Quaternion/Q_Mult", 28, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(p);
+    q.Q_Mult(p, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Quaternion/ScalarMult", 4, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(scalar);
+    result = q * scalar;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Quaternion/operator+", 4, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(p);
+    result = q + p;
+    Bench::DoNotOptimize(result);
+  });
+
+  // two Hamilton products
+  runner.Run("Quaternion/RotateQuaternion", 56, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(p);
+    q.Rotate(p, buffer);
+    Bench::DoNotOptimize(buffer);
+  });
+
+  // two cross products, a scale and the adds
+  runner.Run("Quaternion/RotateV3D", 30, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(vector);
+    rotated = q.Rotate(vector);
+    Bench::DoNotOptimize(rotated);
+  });
+
+  runner.Run("Quaternion/RotateColumn", 30, [&]() {
+    Bench::DoNotOptimize(q);
+    Bench::DoNotOptimize(column);
+    rotated_column = q.Rotate(column);
+    Bench::DoNotOptimize(rotated_column);
+  });
+
+  for (size_t count : {16, 256, 4096})
+  {
+    std::vector<float> points(3 * count);
+    for (size_t idx{0}; idx < points.size(); idx++)
+    {
+      points[idx] = static_cast<float>(idx % 17) * 0.5f - 4.0f;
+    }
+    std::vector<float> out(3 * count);
+    runner.Run("Quaternion/RotateMany/" + std::to_string(count), 30.0 * count,
+               [&]() {
+                 Bench::DoNotOptimize(q);
+                 Bench::DoNotOptimize(points.front());
+                 q.RotateMany(points.data(), out.data(), count);
+                 Bench::DoNotOptimize(out.front());
+               });
+  }
+
+  runner.Run("Quaternion/Normalize", 12, [&]() {
+    Bench::DoNotOptimize(p);
+    result = p;
+    result.Normalize();
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("Quaternion/ToRotationMatrix", 0, [&]() {
+    Bench::DoNotOptimize(q);
+    rotation = q.ToRotationMatrix();
+    Bench::DoNotOptimize(rotation);
+  });
+
+  runner.Run("Quaternion/ToEulerAngle", 0, [&]() {
+    Bench::DoNotOptimize(q);
+    euler = q.ToEulerAngle();
+    Bench::DoNotOptimize(euler);
+  });
+}
+
+// the same poses as a RigidTransform and as a homogeneous Matrix<4, 4>
+void benchRigidTransform(Bench::Runner &runner)
+{
+  RigidTransform a{
+      Quaternion::FromAngleAndAxis(0.7f, Matrix<1, 3>{1, 2, 3}),
+      V3D<float>{0.5f, -1.0f, 2.0f}};
+  RigidTransform b{
+      Quaternion::FromAngleAndAxis(-1.2f, Matrix<1, 3>{0, 1, -1}),
+      V3D<float>{-3.0f, 0.25f, 1.0f}};
+  Matrix<4, 4> a_matrix{a.ToMatrix()};
+  Matrix<4, 4> b_matrix{b.ToMatrix()};
+  RigidTransform result{};
+  Matrix<4, 4> result_matrix{};
+  V3D<float> point{1.0f, -2.0f, 0.5f};
+  V3D<float> moved{};
+
+  runner.Run("RigidTransform/Compose", 0, [&]() {
+    Bench::DoNotOptimize(a);
+    result = a * b;
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("RigidTransform/Matrix4x4/Compose", 0, [&]() {
+    Bench::DoNotOptimize(a_matrix);
+    result_matrix = a_matrix * b_matrix;
+    Bench::DoNotOptimize(result_matrix);
+  });
+
+  runner.Run("RigidTransform/Inverse", 0, [&]() {
+    Bench::DoNotOptimize(a);
+    result = a.Inverse();
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("RigidTransform/Matrix4x4/Inverse", 0, [&]() {
+    Bench::DoNotOptimize(a_matrix);
+    result_matrix = a_matrix.Invert();
+    Bench::DoNotOptimize(result_matrix);
+  });
+
+  runner.Run("RigidTransform/InverseCompose", 0, [&]() {
+    Bench::DoNotOptimize(a);
+    result = a.InverseCompose(b);
+    Bench::DoNotOptimize(result);
+  });
+
+  runner.Run("RigidTransform/Apply", 0, [&]() {
+    Bench::DoNotOptimize(point);
+    moved = a.Apply(point);
+    Bench::DoNotOptimize(moved);
+  });
+
+  runner.Run("RigidTransform/Interpolate", 0, [&]() {
+    Bench::DoNotOptimize(a);
+    result = a.Interpolate(b, 0.3f);
+    Bench::DoNotOptimize(result);
+  });
+
+  constexpr size_t count{4096};
+  std::vector<float> points(3 * count);
+  for (size_t idx{0}; idx < points.size(); idx++)
+  {
+    points[idx] = static_cast<float>(idx % 17) * 0.5f - 4.0f;
+  }
+  std::vector<float> out(3 * count);
+  // two batches, plus room to align each component array
+  std::vector<float> arena_buffer(6 * count + 6 * 16);
+  Arena arena{arena_buffer.data(), arena_buffer.size() * sizeof(float)};
+  V3DBatch<float> batch{arena, count};
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    batch.Set(idx, V3D<float>{points[3 * idx], points[3 * idx + 1],
+                              points[3 * idx + 2]});
+  }
+  V3DBatch<float> batch_out{arena, count};
+
+  runner.Run("RigidTransform/ApplyMany/" + std::to_string(count),
+             18.0 * count, [&]() {
+               Bench::DoNotOptimize(points.front());
+               a.Apply(points.data(), out.data(), count);
+               Bench::DoNotOptimize(out.front());
+             });
+
+  runner.Run("RigidTransform/ApplyBatch/" + std::to_string(count),
+             18.0 * count, [&]() {
+               Bench::DoNotOptimize(batch);
+               a.Apply(batch, batch_out);
+               Bench::DoNotOptimize(batch_out);
+             });
+}
+
+// a gyro, accelerometer and magnetometer log of a slow wobble, as x, y, z, ...
+struct ImuLog
+{
+  explicit ImuLog(size_t count) : gyro(3 * count), accel(3 * count), mag(3 * count)
+  {
+    for (size_t idx{0}; idx < count; idx++)
+    {
+      const float t{static_cast<float>(idx) * 0.01f};
+      gyro[3 * idx] = 0.3f * std::sin(t);
+      gyro[3 * idx + 1] = -0.2f * std::cos(0.7f * t);
+      gyro[3 * idx + 2] = 0.1f;
+      accel[3 * idx] = 0.1f * std::sin(t);
+      accel[3 * idx + 1] = 0.05f;
+      accel[3 * idx + 2] = 0.99f;
+      mag[3 * idx] = 0.4f;
+      mag[3 * idx + 1] = 0.02f * std::cos(t);
+      mag[3 * idx + 2] = -0.9f;
+    }
+  }
+
+  std::vector<float> gyro;
+  std::vector<float> accel;
+  std::vector<float> mag;
+};
+
+void benchAhrs(Bench::Runner &runner)
+{
+  Quaternion q{Quaternion::FromAngleAndAxis(0.7f, Matrix<1, 3>{1, 2, 3})};
+  V3D<float> gyro{0.3f, -0.2f, 0.1f};
+  V3D<float> accel{0.1f, 0.05f, 0.99f};
+  V3D<float> mag{0.4f, 0.02f, -0.9f};
+  float dt{0.001f};
+
+  // what the integrator replaces, one Euler step of q' = q * omega / 2 and a
+  // full normalize with its square root
+  runner.Run("Ahrs/EulerStep", 0, [&]() {
+    Bench::DoNotOptimize(gyro);
+    q = q + (q * Quaternion{0, gyro.x, gyro.y, gyro.z}) * (dt / 2);
+    q.Normalize();
+    Bench::DoNotOptimize(q);
+  });
+
+  runner.Run("Ahrs/Integrate", 0, [&]() {
+    Bench::DoNotOptimize(gyro);
+    q.Integrate(gyro, dt);
+    q.Renormalize();
+    Bench::DoNotOptimize(q);
+  });
+
+  MahonyFilter mahony{1.0f, 0.1f};
+  MadgwickFilter madgwick{};
+
+  runner.Run("Ahrs/Mahony/Update", 0, [&]() {
+    Bench::DoNotOptimize(accel);
+    mahony.Update(gyro, accel, dt);
+    Bench::DoNotOptimize(mahony);
+  });
+
+  runner.Run("Ahrs/Mahony/UpdateMag", 0, [&]() {
+    Bench::DoNotOptimize(accel);
+    mahony.Update(gyro, accel, mag, dt);
+    Bench::DoNotOptimize(mahony);
+  });
+
+  runner.Run("Ahrs/Madgwick/Update", 0, [&]() {
+    Bench::DoNotOptimize(accel);
+    madgwick.Update(gyro, accel, dt);
+    Bench::DoNotOptimize(madgwick);
+  });
+
+  runner.Run("Ahrs/Madgwick/UpdateMag", 0, [&]() {
+    Bench::DoNotOptimize(accel);
+    madgwick.Update(gyro, accel, mag, dt);
+    Bench::DoNotOptimize(madgwick);
+  });
+
+  // a second of samples at 1 kHz
+  constexpr size_t count{1000};
+  ImuLog log{count};
+
+  runner.Run("Ahrs/IntegrateMany/" + std::to_string(count), 0, [&]() {
+    Bench::DoNotOptimize(log.gyro.front());
+    q.IntegrateMany(log.gyro.data(), count, dt);
+    Bench::DoNotOptimize(q);
+  });
+
+  runner.Run("Ahrs/Mahony/UpdateMany/" + std::to_string(count), 0, [&]() {
+    Bench::DoNotOptimize(log.gyro.front());
+    mahony.UpdateMany(log.gyro.data(), log.accel.data(), log.mag.data(), count,
+                      dt);
+    Bench::DoNotOptimize(mahony);
+  });
+
+  runner.Run("Ahrs/Madgwick/UpdateMany/" + std::to_string(count), 0, [&]() {
+    Bench::DoNotOptimize(log.gyro.front());
+    madgwick.UpdateMany(log.gyro.data(), log.accel.data(), log.mag.data(),
+                        count, dt);
+    Bench::DoNotOptimize(madgwick);
+  });
+}
+
+void printUsage(const char *program)
+{
+  std::printf(
+      "usage: %s [options]\n"
+      "  --json <path>        write the results to path as JSON\n"
+      "  --filter <text>      only run benchmarks whose name contains text\n"
+      "  --samples <count>    timed samples per benchmark (default 15)\n"
+      "  --min-time <ms>      minimum length of one sample (default 2)\n"
+      "  --quick              fewer, shorter samples for a fast smoke run\n"
+      "compare two JSON files with compare-bench.py\n",
+      program);
+}
+// a filter in the typical navigation shapes. The transition couples each state
+// to the next one and damps them a little, so repeated predicts keep the
+// covariance bounded.
+template <uint8_t states, uint8_t measurements>
+void benchKalman(Bench::Runner &runner)
+{
+  static KalmanFilter<states, measurements> filter{};
+  Matrix<states, states> transition{};
+  Matrix<states, states> process_noise{};
+  for (uint8_t row_idx{0}; row_idx < states; row_idx++)
+  {
+    transition[row_idx][row_idx] = 0.99f;
+    if (row_idx + 1 < states)
+    {
+      transition[row_idx][row_idx + 1] = 0.01f;
+    }
+    process_noise[row_idx][row_idx] = 1e-3f;
+  }
+  Matrix<measurements, states> observation{
+      testMatrix<measurements, states>(0.1f) * 0.1f};
+  Matrix<measurements, measurements> measurement_noise{};
+  Matrix<measurements, 1> noise{};
+  Matrix<measurements, 1> measurement{};
+  for (uint8_t idx{0}; idx < measurements; idx++)
+  {
+    measurement_noise[idx][idx] = 0.5f;
+    noise[idx][0] = 0.5f;
+    measurement[idx][0] = static_cast<float>(idx);
+  }
+  bool updated{false};
+  const std::string name{std::to_string(states) + "/" +
+                         std::to_string(measurements)};
+  const double n{static_cast<double>(states)};
+  const double m{static_cast<double>(measurements)};
+
+  runner.Run("KalmanFilter/Predict/" + name, 3 * n * n * n, [&]() {
+    Bench::DoNotOptimize(transition);
+    filter.Predict(transition, process_noise);
+    Bench::DoNotOptimize(filter);
+  });
+
+  // an update on its own keeps shrinking the covariance, so the updates are
+  // timed in predict/update steps that hold it at a steady state
+  runner.Run("KalmanFilter/Step/" + name, 6 * n * n * n + 4 * m * n * n,
+             [&]() {
+               Bench::DoNotOptimize(measurement);
+               filter.Predict(transition, process_noise);
+               updated = filter.Update(measurement, observation,
+                                       measurement_noise);
+               Bench::DoNotOptimize(updated);
+             });
+
+  runner.Run("KalmanFilter/StepSequential/" + name,
+             3 * n * n * n + 5 * m * n * n, [&]() {
+               Bench::DoNotOptimize(measurement);
+               filter.Predict(transition, process_noise);
+               updated =
+                   filter.UpdateSequential(measurement, observation, noise);
+               Bench::DoNotOptimize(updated);
+             });
+}
+// the same operations on count matrices, one Matrix at a time against the
+// interleaved batch. Det and Invert only exist in the batch up to 4x4.
+template <uint8_t size, bool closed_form>
+void benchMatrixBatch(Bench::Runner &runner)
+{
+  constexpr size_t count{1024};
+  static std::array<Matrix<size, size>, count> matrices{};
+  static std::array<Matrix<size, size>, count> results{};
+  static MatrixBatch<count, size, size> batch{};
+  static MatrixBatch<count, size, size> spd{};
+  static MatrixBatch<count, size, size> result{};
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    matrices[idx] = testMatrix<size, size>(static_cast<float>(idx % 7));
+  }
+  batch.Load(matrices.data());
+  batch.Transpose(result);
+  batch.Mult(result, spd);
+  const std::string name{shape(size, size)};
+  const double cube{static_cast<double>(size) * size * size * count};
+
+  runner.Run("MatrixBatch/Loop/Mult/" + name, 2 * cube, [&]() {
+    Bench::DoNotOptimize(matrices);
+    for (size_t idx{0}; idx < count; idx++)
+    {
+      matrices[idx].Mult(matrices[idx], results[idx]);
+    }
+    Bench::DoNotOptimize(results);
+  });
+
+  runner.Run("MatrixBatch/Mult/" + name, 2 * cube, [&]() {
+    Bench::DoNotOptimize(batch);
+    batch.Mult(batch, result);
+    Bench::DoNotOptimize(result);
+  });
+
+  if constexpr (closed_form)
+  {
+    static std::array<float, count> determinants{};
+    runner.Run("MatrixBatch/Loop/Det/" + name, 2.0 * cube / 3, [&]() {
+      Bench::DoNotOptimize(matrices);
+      for (size_t idx{0}; idx < count; idx++)
+      {
+        determinants[idx] = matrices[idx].Det();
+      }
+      Bench::DoNotOptimize(determinants);
+    });
+
+    runner.Run("MatrixBatch/Det/" + name, 2.0 * cube / 3, [&]() {
+      Bench::DoNotOptimize(batch);
+      batch.Det(determinants);
+      Bench::DoNotOptimize(determinants);
+    });
+
+    runner.Run("MatrixBatch/Loop/Invert/" + name, 2.0 * cube, [&]() {
+      Bench::DoNotOptimize(matrices);
+      for (size_t idx{0}; idx < count; idx++)
+      {
+        results[idx] = matrices[idx].Invert();
+      }
+      Bench::DoNotOptimize(results);
+    });
+
+    runner.Run("MatrixBatch/Invert/" + name, 2.0 * cube, [&]() {
+      Bench::DoNotOptimize(batch);
+      batch.Invert(result);
+      Bench::DoNotOptimize(result);
+    });
+  }
+
+  // the loop factors a copy, which is small next to the factorization
+  spd.Store(matrices.data());
+  runner.Run("MatrixBatch/Loop/Cholesky/" + name, cube / 3, [&]() {
+    Bench::DoNotOptimize(matrices);
+    bool factored{true};
+    for (size_t idx{0}; idx < count; idx++)
+    {
+      results[idx] = matrices[idx];
+      factored &= LLT<size>::FactorInPlace(results[idx]);
+    }
+    Bench::DoNotOptimize(factored);
+  });
+
+  runner.Run("MatrixBatch/Cholesky/" + name, cube / 3, [&]() {
+    Bench::DoNotOptimize(spd);
+    bool factored{spd.Cholesky(result)};
+    Bench::DoNotOptimize(factored);
+  });
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  Bench::Options options{};
+  std::string json_path{};
+  for (int idx{1}; idx < argc; idx++)
+  {
+    const bool has_value{idx + 1 < argc};
+    if (std::strcmp(argv[idx], "--json") == 0 && has_value)
+    {
+      json_path = argv[++idx];
+    }
+    else if (std::strcmp(argv[idx], "--filter") == 0 && has_value)
+    {
+      options.filter = argv[++idx];
+    }
+    else if (std::strcmp(argv[idx], "--samples") == 0 && has_value)
+    {
+      options.samples = static_cast<uint32_t>(std::atoi(argv[++idx]));
+    }
+    else if (std::strcmp(argv[idx], "--min-time") == 0 && has_value)
+    {
+      options.min_sample_ns = std::atof(argv[++idx]) * 1e6;
+    }
+    else if (std::strcmp(argv[idx], "--quick") == 0)
+    {
+      options.samples = 5;
+      options.warmup_samples = 1;
+      options.min_sample_ns = 2e5;
+    }
+    else
+    {
+      printUsage(argv[0]);
+      return std::strcmp(argv[idx], "--help") == 0 ? 0 : 1;
+    }
+  }
+  if (options.samples == 0)
+  {
+    options.samples = 1;
+  }
+
+#ifdef MATRIX_EXPRESSION_TEMPLATES
+  std::printf("matrix-bench (expression templates on)\n");
+#else
+  std::printf("matrix-bench (expression templates off)\n");
+#endif
+
+  Bench::Runner runner{options};
+  runner.SpinUp();
+
+  benchElementWise<2, 2>(runner);
+  benchElementWise<3, 3>(runner);
+  benchElementWise<4, 4>(runner);
+  benchElementWise<8, 8>(runner);
+  benchElementWise<16, 16>(runner);
+  benchElementWise<32, 32>(runner);
+  benchElementWise<64, 64>(runner);
+  benchElementWise<2, 3>(runner);
+  benchElementWise<3, 4>(runner);
+  benchElementWise<4, 8>(runner);
+  benchElementWise<16, 4>(runner);
+  benchElementWise<64, 8>(runner);
+  benchElementWise<1, 64>(runner);
+  benchElementWise<64, 1>(runner);
+
+  benchSquare<2, true>(runner);
+  benchSquare<3, true>(runner);
+  benchSquare<4, true>(runner);
+  benchSquare<8, true>(runner);
+  benchSquare<16, true>(runner);
+  benchSquare<32, false>(runner);
+  benchSquare<64, false>(runner);
+
+  benchMult<3, 4, 6>(runner);
+  benchMult<4, 16, 4>(runner);
+  benchMult<16, 4, 16>(runner);
+  benchMult<8, 64, 8>(runner);
+  benchMult<64, 8, 64>(runner);
+  benchMult<1, 64, 64>(runner);
+  benchMult<64, 64, 1>(runner);
+
+  benchVector(runner);
+  benchQuaternion(runner);
+  benchRigidTransform(runner);
+  benchAhrs(runner);
+
+  benchKalman<6, 3>(runner);
+  benchKalman<9, 3>(runner);
+  benchKalman<15, 6>(runner);
+  benchKalman<24, 6>(runner);
+
+  benchMatrixBatch<3, true>(runner);
+  benchMatrixBatch<4, true>(runner);
+  benchMatrixBatch<6, false>(runner);
+
+  if (!json_path.empty())
+  {
+    if (!runner.WriteJson(json_path))
+    {
+      std::fprintf(stderr, "couldn't write %s\n", json_path.c_str());
+      return 1;
+    }
+    std::printf("wrote %zu results to %s\n", runner.Results().size(),
+                json_path.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,13 @@
+# be in the root folder of this project when you run this
+# runs the benchmarks and compares them with the stored baseline, if there is one
+cd build/
+ninja matrix-bench
+echo "Running benchmarks. This will take a while."
+./benchmarks/matrix-bench --json ../benchmarks/matrix-bench-results.json
+cd ../benchmarks/
+if [ ! -f matrix-bench-baseline.json ]; then
+    cp matrix-bench-results.json matrix-bench-baseline.json
+    echo "No baseline yet, saved these results as the baseline."
+    exit 0
+fi
+python3 compare-bench.py matrix-bench-baseline.json matrix-bench-results.json
@@ -0,0 +1,259 @@
+#include "Ahrs.hpp"
+#include <cmath>
+
+namespace
+{
+// UpdateMany normalizes this many samples at a time into a buffer on the
+// stack before running them through the filter
+constexpr size_t sample_chunk{32};
+
+// 1 / |reading|, or 0 for a reading of all zeros so its correction drops out.
+// Written without a branch so the loop over a chunk vectorizes, see
+// InverseScale in MatrixBatch.cpp.
+inline float inverseLength(float x, float y, float z)
+{
+    const float squared = x * x + y * y + z * z;
+    const float non_zero = static_cast<float>(squared != 0);
+    return non_zero / std::sqrt(squared + (1 - non_zero));
+}
+
+inline V3D<float> sample(const float *xyz, size_t idx)
+{
+    return V3D<float>{xyz[3 * idx], xyz[3 * idx + 1], xyz[3 * idx + 2]};
+}
+
+inline V3D<float> unit(const V3D<float> &reading)
+{
+    return reading * inverseLength(reading.x, reading.y, reading.z);
+}
+
+// the inverse lengths of count samples from xyz
+inline void inverseLengths(const float *xyz, size_t count, float *inverse)
+{
+    for (size_t idx = 0; idx < count; idx++)
+    {
+        inverse[idx] = inverseLength(xyz[3 * idx], xyz[3 * idx + 1], xyz[3 * idx + 2]);
+    }
+}
+
+inline V3D<float> cross(const V3D<float> &a, const V3D<float> &b)
+{
+    return V3D<float>{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+// the magnetic field measured in the body frame, moved into the earth frame
+// and flattened onto the x-z plane so only its dip is kept. Heading comes
+// from the difference between this and the measurement.
+inline V3D<float> earthField(const Quaternion &q, const V3D<float> &mag)
+{
+    const V3D<float> earth{q.Rotate(mag)};
+    return V3D<float>{std::sqrt(earth.x * earth.x + earth.y * earth.y), 0, earth.z};
+}
+
+// Mahony's error for a unit accelerometer reading, the measured direction of
+// gravity crossed with where the orientation says gravity (earth z) should be
+// in the body frame, the last row of the rotation matrix. Zero for a zero
+// reading.
+inline V3D<float> gravityError(const Quaternion &q, const V3D<float> &accel)
+{
+    const V3D<float> expected{
+        2 * (q.v1() * q.v3() - q.w() * q.v2()),
+        2 * (q.w() * q.v1() + q.v2() * q.v3()),
+        q.w() * q.w() - q.v1() * q.v1() - q.v2() * q.v2() + q.v3() * q.v3()};
+    return cross(accel, expected);
+}
+
+// the same for a unit magnetometer reading and where the earth's field should
+// be in the body frame
+inline V3D<float> fieldError(const Quaternion &q, const V3D<float> &mag)
+{
+    return cross(mag, q.Conjugate().Rotate(earthField(q, mag)));
+}
+
+// Madgwick's gradient for a unit accelerometer reading. f = expected gravity -
+// measured, and the gradient of |f|^2 / 2 is J^T * f with J the Jacobian of
+// the expected gravity. f isn't zero for a zero reading, so that's skipped
+// with a branch; a mask multiplied in costs more, being on the dependency
+// chain from one sample to the next.
+inline Quaternion gravityGradient(const Quaternion &q, const V3D<float> &accel, float inverse_length)
+{
+    if (inverse_length == 0)
+    {
+        return Quaternion{};
+    }
+    const float q0 = q.w();
+    const float q1 = q.v1();
+    const float q2 = q.v2();
+    const float q3 = q.v3();
+    const float fx = 2 * (q1 * q3 - q0 * q2) - accel.x;
+    const float fy = 2 * (q0 * q1 + q2 * q3) - accel.y;
+    const float fz = 2 * (0.5f - q1 * q1 - q2 * q2) - accel.z;
+    return Quaternion{
+        -2 * q2 * fx + 2 * q1 * fy,
+        2 * q3 * fx + 2 * q0 * fy - 4 * q1 * fz,
+        -2 * q0 * fx + 2 * q3 * fy - 4 * q2 * fz,
+        2 * q1 * fx + 2 * q2 * fy};
+}
+
+// the same for a unit magnetometer reading and the earth's field b = (bx, 0,
+// bz). A zero reading gives a zero b and f, so no mask.
+inline Quaternion fieldGradient(const Quaternion &q, const V3D<float> &mag)
+{
+    const float q0 = q.w();
+    const float q1 = q.v1();
+    const float q2 = q.v2();
+    const float q3 = q.v3();
+    const V3D<float> b{earthField(q, mag)};
+    const float bx = b.x;
+    const float bz = b.z;
+    const float fx = 2 * bx * (0.5f - q2 * q2 - q3 * q3) + 2 * bz * (q1 * q3 - q0 * q2) - mag.x;
+    const float fy = 2 * bx * (q1 * q2 - q0 * q3) + 2 * bz * (q0 * q1 + q2 * q3) - mag.y;
+    const float fz = 2 * bx * (q0 * q2 + q1 * q3) + 2 * bz * (0.5f - q1 * q1 - q2 * q2) - mag.z;
+    return Quaternion{
+        -2 * bz * q2 * fx + (-2 * bx * q3 + 2 * bz * q1) * fy + 2 * bx * q2 * fz,
+        2 * bz * q3 * fx + (2 * bx * q2 + 2 * bz * q0) * fy + (2 * bx * q3 - 4 * bz * q1) * fz,
+        (-4 * bx * q2 - 2 * bz * q0) * fx + (2 * bx * q1 + 2 * bz * q3) * fy + (2 * bx * q0 - 4 * bz * q2) * fz,
+        (-4 * bx * q3 + 2 * bz * q1) * fx + (-2 * bx * q0 + 2 * bz * q2) * fy + 2 * bx * q1 * fz};
+}
+} // namespace
+
+MahonyFilter::MahonyFilter(float proportional_gain, float integral_gain)
+    : proportional_gain{proportional_gain}, integral_gain{integral_gain}
+{
+}
+
+void MahonyFilter::Update(const V3D<float> &gyro, const V3D<float> &accel, float dt)
+{
+    this->integrate(gyro, gravityError(this->orientation, unit(accel)), dt);
+}
+
+void MahonyFilter::Update(const V3D<float> &gyro, const V3D<float> &accel, const V3D<float> &mag, float dt)
+{
+    this->integrate(gyro, gravityError(this->orientation, unit(accel)) + fieldError(this->orientation, unit(mag)), dt);
+}
+
+void MahonyFilter::UpdateMany(const float *gyro, const float *accel, size_t n, float dt)
+{
+    // the square roots don't depend on the orientation, so they're taken a
+    // chunk at a time off the sample to sample dependency chain
+    float inverse_accel[sample_chunk];
+    for (size_t start = 0; start < n; start += sample_chunk)
+    {
+        const size_t count = n - start < sample_chunk ? n - start : sample_chunk;
+        inverseLengths(accel + 3 * start, count, inverse_accel);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> a{sample(accel, start + idx) * inverse_accel[idx]};
+            this->integrate(sample(gyro, start + idx), gravityError(this->orientation, a), dt);
+        }
+    }
+}
+
+void MahonyFilter::UpdateMany(const float *gyro, const float *accel, const float *mag, size_t n, float dt)
+{
+    float inverse_accel[sample_chunk];
+    float inverse_mag[sample_chunk];
+    for (size_t start = 0; start < n; start += sample_chunk)
+    {
+        const size_t count = n - start < sample_chunk ? n - start : sample_chunk;
+        inverseLengths(accel + 3 * start, count, inverse_accel);
+        inverseLengths(mag + 3 * start, count, inverse_mag);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> a{sample(accel, start + idx) * inverse_accel[idx]};
+            const V3D<float> m{sample(mag, start + idx) * inverse_mag[idx]};
+            this->integrate(sample(gyro, start + idx),
+                            gravityError(this->orientation, a) + fieldError(this->orientation, m), dt);
+        }
+    }
+}
+
+void MahonyFilter::Reset(const Quaternion &orientation)
+{
+    this->orientation = orientation;
+    this->integral_error = V3D<float>{};
+}
+
+void MahonyFilter::integrate(const V3D<float> &gyro, const V3D<float> &error, float dt)
+{
+    if (this->integral_gain > 0)
+    {
+        this->integral_error += error * (this->integral_gain * dt);
+    }
+    this->orientation.Integrate(gyro + error * this->proportional_gain + this->integral_error, dt);
+    this->orientation.Renormalize();
+}
+
+MadgwickFilter::MadgwickFilter(float beta) : beta{beta}
+{
+}
+
+void MadgwickFilter::Update(const V3D<float> &gyro, const V3D<float> &accel, float dt)
+{
+    const float inverse_accel = inverseLength(accel.x, accel.y, accel.z);
+    Quaternion gradient{gravityGradient(this->orientation, accel * inverse_accel, inverse_accel)};
+    this->integrate(gyro, gradient, dt);
+}
+
+void MadgwickFilter::Update(const V3D<float> &gyro, const V3D<float> &accel, const V3D<float> &mag, float dt)
+{
+    const float inverse_accel = inverseLength(accel.x, accel.y, accel.z);
+    Quaternion gradient{gravityGradient(this->orientation, accel * inverse_accel, inverse_accel)};
+    gradient += fieldGradient(this->orientation, unit(mag));
+    this->integrate(gyro, gradient, dt);
+}
+
+void MadgwickFilter::UpdateMany(const float *gyro, const float *accel, size_t n, float dt)
+{
+    // see MahonyFilter::UpdateMany
+    float inverse_accel[sample_chunk];
+    for (size_t start = 0; start < n; start += sample_chunk)
+    {
+        const size_t count = n - start < sample_chunk ? n - start : sample_chunk;
+        inverseLengths(accel + 3 * start, count, inverse_accel);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> a{sample(accel, start + idx) * inverse_accel[idx]};
+            Quaternion gradient{gravityGradient(this->orientation, a, inverse_accel[idx])};
+            this->integrate(sample(gyro, start + idx), gradient, dt);
+        }
+    }
+}
+
+void MadgwickFilter::UpdateMany(const float *gyro, const float *accel, const float *mag, size_t n, float dt)
+{
+    float inverse_accel[sample_chunk];
+    float inverse_mag[sample_chunk];
+    for (size_t start = 0; start < n; start += sample_chunk)
+    {
+        const size_t count = n - start < sample_chunk ? n - start : sample_chunk;
+        inverseLengths(accel + 3 * start, count, inverse_accel);
+        inverseLengths(mag + 3 * start, count, inverse_mag);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> a{sample(accel, start + idx) * inverse_accel[idx]};
+            const V3D<float> m{sample(mag, start + idx) * inverse_mag[idx]};
+            Quaternion gradient{gravityGradient(this->orientation, a, inverse_accel[idx])};
+            gradient += fieldGradient(this->orientation, m);
+            this->integrate(sample(gyro, start + idx), gradient, dt);
+        }
+    }
+}
+
+void MadgwickFilter::Reset(const Quaternion &orientation)
+{
+    this->orientation = orientation;
+}
+
+void MadgwickFilter::integrate(const V3D<float> &gyro, Quaternion &gradient, float dt)
+{
+    const float squared = gradient[0] * gradient[0] + gradient[1] * gradient[1] + gradient[2] * gradient[2] + gradient[3] * gradient[3];
+    this->orientation.Integrate(gyro, dt);
+    if (squared > 0)
+    {
+        // a step of beta * dt whatever the gradient's length
+        gradient *= -this->beta * dt / std::sqrt(squared);
+        this->orientation += gradient;
+    }
+    this->orientation.Renormalize();
+}
@@ -0,0 +1,150 @@
+#ifndef AHRS_H_
+#define AHRS_H_
+
+#include <cstddef>
+
+#include "Quaternion.h"
+#include "Vector3D.hpp"
+
+/**
+ * @brief Attitude and heading reference filters. Both fuse a gyro with an
+ * accelerometer, and optionally a magnetometer, into an orientation
+ * quaternion that turns body frame vectors into the earth frame (z up):
+ * @code
+ * MadgwickFilter filter{};
+ * filter.Update(gyro, accel, 1.0f / 1000);
+ * const V3D<float> up_in_body{filter.Orientation().Conjugate().Rotate(V3D<float>{0, 0, 1})};
+ * @endcode
+ *
+ * The gyro is integrated through Quaternion::Integrate and the orientation is
+ * kept at unit length with Quaternion::Renormalize, which needs no square
+ * root. UpdateMany normalizes the accelerometer and magnetometer readings a
+ * chunk at a time ahead of the filter, off the dependency chain from one
+ * sample to the next, so prefer it when the samples arrive in a buffer.
+ *
+ * Samples where the accelerometer (or magnetometer) reads all zeros can't be
+ * normalized, so that sensor's correction is skipped and only the gyro is
+ * integrated.
+ */
+
+/**
+ * @brief Mahony's nonlinear complementary filter. The cross product between
+ * the measured and the expected direction of gravity (and the magnetic field)
+ * is fed back into the gyro rate through a PI controller. The integral term
+ * learns the gyro bias.
+ */
+class MahonyFilter
+{
+public:
+    /**
+     * @param proportional_gain how quickly the filter trusts the
+     * accelerometer over the gyro
+     * @param integral_gain how quickly it learns the gyro bias, 0 to turn bias
+     * estimation off
+     */
+    explicit MahonyFilter(float proportional_gain = 1.0f, float integral_gain = 0.0f);
+
+    /**
+     * @brief Fuse one gyro and accelerometer sample
+     * @param gyro body rates in radians per second
+     * @param accel the accelerometer reading, in any unit
+     * @param dt the time since the last sample in seconds
+     */
+    void Update(const V3D<float> &gyro, const V3D<float> &accel, float dt);
+
+    /**
+     * @brief Fuse one gyro, accelerometer and magnetometer sample
+     * @param mag the magnetometer reading, in any unit
+     */
+    void Update(const V3D<float> &gyro, const V3D<float> &accel, const V3D<float> &mag, float dt);
+
+    /**
+     * @brief Fuse a buffer of n samples in one call
+     * @param gyro, accel n samples each, stored as x, y, z, x, y, z, ...
+     */
+    void UpdateMany(const float *gyro, const float *accel, size_t n, float dt);
+
+    /**
+     * @brief Fuse a buffer of n samples with a magnetometer in one call
+     */
+    void UpdateMany(const float *gyro, const float *accel, const float *mag, size_t n, float dt);
+
+    /**
+     * @brief Start again from orientation and forget the learnt gyro bias
+     */
+    void Reset(const Quaternion &orientation = Quaternion{1, 0, 0, 0});
+
+    const Quaternion &Orientation() const { return this->orientation; }
+
+    /**
+     * @return the gyro bias learnt by the integral term, in radians per second
+     * and with the opposite sign
+     */
+    const V3D<float> &GyroCorrection() const { return this->integral_error; }
+
+private:
+    // feed the error back into the gyro rate and integrate it
+    void integrate(const V3D<float> &gyro, const V3D<float> &error, float dt);
+
+    Quaternion orientation{1, 0, 0, 0};
+    V3D<float> integral_error{};
+    float proportional_gain;
+    float integral_gain;
+};
+
+/**
+ * @brief Madgwick's gradient descent filter. Every sample takes one gradient
+ * step of size beta towards the orientation that best lines the expected
+ * gravity (and magnetic field) up with the measured one, on top of the
+ * integrated gyro.
+ */
+class MadgwickFilter
+{
+public:
+    /**
+     * @param beta the gradient step in radians per second, about the gyro's
+     * noise. Larger converges faster but lets more accelerometer noise in.
+     */
+    explicit MadgwickFilter(float beta = 0.1f);
+
+    /**
+     * @brief Fuse one gyro and accelerometer sample
+     * @param gyro body rates in radians per second
+     * @param accel the accelerometer reading, in any unit
+     * @param dt the time since the last sample in seconds
+     */
+    void Update(const V3D<float> &gyro, const V3D<float> &accel, float dt);
+
+    /**
+     * @brief Fuse one gyro, accelerometer and magnetometer sample
+     * @param mag the magnetometer reading, in any unit
+     */
+    void Update(const V3D<float> &gyro, const V3D<float> &accel, const V3D<float> &mag, float dt);
+
+    /**
+     * @brief Fuse a buffer of n samples in one call
+     * @param gyro, accel n samples each, stored as x, y, z, x, y, z, ...
+     */
+    void UpdateMany(const float *gyro, const float *accel, size_t n, float dt);
+
+    /**
+     * @brief Fuse a buffer of n samples with a magnetometer in one call
+     */
+    void UpdateMany(const float *gyro, const float *accel, const float *mag, size_t n, float dt);
+
+    /**
+     * @brief Start again from orientation
+     */
+    void Reset(const Quaternion &orientation = Quaternion{1, 0, 0, 0});
+
+    const Quaternion &Orientation() const { return this->orientation; }
+
+private:
+    // integrate the gyro, then step down the normalized gradient
+    void integrate(const V3D<float> &gyro, Quaternion &gradient, float dt);
+
+    Quaternion orientation{1, 0, 0, 0};
+    float beta;
+};
+
+#endif // AHRS_H_
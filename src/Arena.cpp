@@ -0,0 +1,31 @@
+#include "Arena.hpp"
+
+Arena::Arena(void *buffer, size_t capacity)
+    : buffer(static_cast<uint8_t *>(buffer)), capacity(capacity)
+{
+}
+
+void *Arena::Allocate(size_t bytes, size_t alignment)
+{
+  // align the address, not the offset, the buffer itself may not be aligned
+  const uintptr_t start{reinterpret_cast<uintptr_t>(this->buffer) +
+                        this->used};
+  const uintptr_t aligned{(start + alignment - 1) &
+                          ~static_cast<uintptr_t>(alignment - 1)};
+  const size_t offset{this->used + static_cast<size_t>(aligned - start)};
+  if (offset > this->capacity || bytes > this->capacity - offset)
+  {
+    return nullptr;
+  }
+
+  this->used = offset + bytes;
+  return this->buffer + offset;
+}
+
+void Arena::Rewind(size_t mark)
+{
+  if (mark < this->used)
+  {
+    this->used = mark;
+  }
+}
@@ -0,0 +1,97 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A bump allocator over a buffer the caller owns. Nothing is ever
+ * freed on its own: take a Mark before a batch of temporary allocations and
+ * Rewind to it afterwards, or Reset to start over.
+ *
+ * Allocate returns nullptr once the buffer is used up, there is no fallback to
+ * the heap.
+ */
+class Arena
+{
+public:
+  /**
+   * @brief Alignment in bytes of allocations that don't ask for one. Matches
+   * the widest SIMD register the element kernels use.
+   */
+  static constexpr size_t default_alignment{64};
+
+  /**
+   * @brief Hand out memory from buffer
+   * @param buffer the memory to allocate from, it has to outlive the arena
+   * and everything allocated from it
+   * @param capacity the size of buffer in bytes
+   */
+  Arena(void *buffer, size_t capacity);
+
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  /**
+   * @brief Allocate bytes of uninitialized memory
+   * @param alignment has to be a power of 2
+   * @return the memory, or nullptr if there isn't enough left
+   */
+  void *Allocate(size_t bytes, size_t alignment = default_alignment);
+
+  /**
+   * @brief Allocate room for count uninitialized values of Type
+   * @return the memory, or nullptr if there isn't enough left
+   */
+  template <typename Type>
+  Type *Allocate(size_t count)
+  {
+    const size_t alignment{alignof(Type) > default_alignment
+                               ? alignof(Type)
+                               : default_alignment};
+    return static_cast<Type *>(this->Allocate(count * sizeof(Type), alignment));
+  }
+
+  /**
+   * @return a marker for everything allocated so far, see Rewind
+   */
+  size_t Mark() const { return this->used; }
+
+  /**
+   * @brief Free everything allocated since mark was taken
+   */
+  void Rewind(size_t mark);
+
+  /**
+   * @brief Free everything
+   */
+  void Reset() { this->used = 0; }
+
+  /**
+   * @return the number of bytes handed out, including alignment padding
+   */
+  size_t Used() const { return this->used; }
+
+  size_t Capacity() const { return this->capacity; }
+
+private:
+  uint8_t *buffer;
+  size_t capacity;
+  size_t used{0};
+};
+
+/**
+ * @brief An arena that carries its own buffer, so it can live on the stack or
+ * as a global with no allocation at all
+ */
+template <size_t bytes>
+class StaticArena : public Arena
+{
+public:
+  StaticArena() : Arena(this->storage, bytes) {}
+
+private:
+  alignas(Arena::default_alignment) uint8_t storage[bytes];
+};
+
+#endif // ARENA_H_
@@ -0,0 +1,80 @@
+#ifndef BOUNDS_CHECK_H_
+#define BOUNDS_CHECK_H_
+
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * @brief What the checked accessors (Get, operator[] and friends) do with an
+ * index out of range. It's picked for the whole build with the
+ * MATRIX_BOUNDS_CHECK CMake option:
+ * - saturate (the default outside Debug builds): reads return a sentinel
+ *   (1e+10 saturated to the element type), rows clamp to row 0
+ * - trap (the default in Debug builds): the program aborts on the spot. At
+ *   compile time the out of range access is a compile error instead.
+ * - none: no checks and no branches, an index out of range is undefined
+ *   behaviour
+ *
+ * Only the public accessors are checked. The kernels inside the library index
+ * their storage directly whatever the policy.
+ */
+namespace BoundsCheck
+{
+enum class Policy : uint8_t
+{
+  Saturate,
+  Trap,
+  Unchecked
+};
+
+#if defined(MATRIX_BOUNDS_TRAP)
+constexpr Policy policy{Policy::Trap};
+#elif defined(MATRIX_BOUNDS_UNCHECKED)
+constexpr Policy policy{Policy::Unchecked};
+#else
+constexpr Policy policy{Policy::Saturate};
+#endif
+
+/**
+ * @brief Where trap mode stops. It isn't constexpr, so reaching it during
+ * constant evaluation is a compile error.
+ */
+[[noreturn]] inline void OutOfRange()
+{
+  std::abort();
+}
+
+/**
+ * @brief Check an index for an accessor that has a fallback
+ * @param in_range whether the index is in range
+ * @return whether the accessor should go ahead. Only false when the policy
+ * saturates and the index is out of range.
+ */
+constexpr bool Accept(bool in_range)
+{
+  if (policy == Policy::Unchecked)
+  {
+    return true;
+  }
+  if (policy == Policy::Trap && !in_range)
+  {
+    OutOfRange();
+  }
+  return in_range;
+}
+
+/**
+ * @brief Check an index for an accessor that has no fallback (the ones that
+ * return a reference). Only trap mode checks these.
+ * @param in_range whether the index is in range
+ */
+constexpr void Assert(bool in_range)
+{
+  if (policy == Policy::Trap && !in_range)
+  {
+    OutOfRange();
+  }
+}
+} // namespace BoundsCheck
+
+#endif // BOUNDS_CHECK_H_
@@ -0,0 +1,392 @@
+#ifdef CHOLESKY_H_ // since the .cpp file has to be included by the .hpp file
+                   // this will evaluate to true
+#include "Cholesky.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+template <uint8_t size, typename Type>
+LLT<size, Type>::LLT(const Matrix<size, size, Type> &matrix)
+{
+  this->Compute(matrix);
+}
+
+template <uint8_t size, typename Type>
+bool LLT<size, Type>::Compute(const Matrix<size, size, Type> &matrix)
+{
+  this->factor = matrix;
+  this->positive_definite = LLT<size, Type>::FactorInPlace(this->factor);
+  return this->positive_definite;
+}
+
+template <uint8_t size, typename Type>
+bool LLT<size, Type>::FactorInPlace(Matrix<size, size, Type> &matrix)
+{
+  Type *l{matrix.matrix.data()};
+
+  // row by row so every dot product runs along two contiguous rows
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    Type *row{l + row_idx * size};
+    for (uint8_t column_idx{0}; column_idx <= row_idx; column_idx++)
+    {
+      const Type *other_row{l + column_idx * size};
+      Type sum{row[column_idx]};
+      for (uint8_t inner_idx{0}; inner_idx < column_idx; inner_idx++)
+      {
+        sum -= row[inner_idx] * other_row[inner_idx];
+      }
+
+      if (column_idx == row_idx)
+      {
+        // this also catches NaN
+        if (!(sum > 0))
+        {
+          return false;
+        }
+        row[column_idx] = static_cast<Type>(std::sqrt(
+            static_cast<typename ScalarTraits<Type>::Accumulator>(sum)));
+      }
+      else
+      {
+        row[column_idx] = sum / other_row[column_idx];
+      }
+    }
+
+    std::fill(row + row_idx + 1, row + size, Type{0});
+  }
+
+  return true;
+}
+
+template <uint8_t size, typename Type>
+template <uint8_t rhs_columns>
+Matrix<size, rhs_columns, Type> &
+LLT<size, Type>::SolveLower(const Matrix<size, rhs_columns, Type> &rhs,
+                      Matrix<size, rhs_columns, Type> &result) const
+{
+  const Type *l{this->factor.matrix.data()};
+  if (&result != &rhs)
+  {
+    result = rhs;
+  }
+  Type *x{result.matrix.data()};
+
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    Type *x_row{x + row_idx * rhs_columns};
+    for (uint8_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      const Type factor{l[row_idx * size + inner_idx]};
+      const Type *x_inner{x + inner_idx * rhs_columns};
+      for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+      {
+        x_row[column_idx] -= factor * x_inner[column_idx];
+      }
+    }
+
+    const Type inverse_diagonal{1 / l[row_idx * size + row_idx]};
+    for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+    {
+      x_row[column_idx] *= inverse_diagonal;
+    }
+  }
+
+  return result;
+}
+
+template <uint8_t size, typename Type>
+template <uint8_t rhs_columns>
+Matrix<size, rhs_columns, Type> &
+LLT<size, Type>::SolveUpper(const Matrix<size, rhs_columns, Type> &rhs,
+                      Matrix<size, rhs_columns, Type> &result) const
+{
+  const Type *l{this->factor.matrix.data()};
+  if (&result != &rhs)
+  {
+    result = rhs;
+  }
+  Type *x{result.matrix.data()};
+
+  // L^T is upper triangular, and row idx of L is column idx of L^T. Once x[idx]
+  // is known, push it into every row above so L is only read along its rows.
+  for (int16_t row_idx = size - 1; row_idx >= 0; row_idx--)
+  {
+    const Type *l_row{l + row_idx * size};
+    Type *x_row{x + row_idx * rhs_columns};
+    const Type inverse_diagonal{1 / l_row[row_idx]};
+    for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+    {
+      x_row[column_idx] *= inverse_diagonal;
+    }
+
+    for (uint8_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      const Type factor{l_row[inner_idx]};
+      Type *x_inner{x + inner_idx * rhs_columns};
+      for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+      {
+        x_inner[column_idx] -= factor * x_row[column_idx];
+      }
+    }
+  }
+
+  return result;
+}
+
+template <uint8_t size, typename Type>
+template <uint8_t rhs_columns>
+Matrix<size, rhs_columns, Type> &
+LLT<size, Type>::Solve(const Matrix<size, rhs_columns, Type> &rhs,
+                 Matrix<size, rhs_columns, Type> &result) const
+{
+  if (!this->positive_definite)
+  {
+    result.Fill(0);
+    return result;
+  }
+
+  this->SolveLower(rhs, result);
+  return this->SolveUpper(result, result);
+}
+
+template <uint8_t size, typename Type>
+Matrix<size, size, Type> &
+LLT<size, Type>::Invert(Matrix<size, size, Type> &result) const
+{
+  Matrix<size, size, Type> identity{};
+  identity.Identity();
+  return this->Solve(identity, result);
+}
+
+template <uint8_t size, typename Type>
+Type LLT<size, Type>::Det() const
+{
+  if (!this->positive_definite)
+  {
+    return 0;
+  }
+
+  Type determinant{1};
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    const Type diagonal{this->factor.matrix[idx * size + idx]};
+    determinant *= diagonal * diagonal;
+  }
+  return determinant;
+}
+
+template <uint8_t size, typename Type>
+Type LLT<size, Type>::LogDet() const
+{
+  if (!this->positive_definite)
+  {
+    return -INFINITY;
+  }
+
+  Type log_determinant{0};
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    log_determinant += static_cast<Type>(
+        std::log(static_cast<typename ScalarTraits<Type>::Accumulator>(
+            this->factor.matrix[idx * size + idx])));
+  }
+  return 2 * log_determinant;
+}
+
+template <uint8_t size, typename Type>
+LDLT<size, Type>::LDLT(const Matrix<size, size, Type> &matrix)
+{
+  this->Compute(matrix);
+}
+
+template <uint8_t size, typename Type>
+bool LDLT<size, Type>::Compute(const Matrix<size, size, Type> &matrix)
+{
+  this->factors = matrix;
+  this->valid = LDLT<size, Type>::FactorInPlace(this->factors);
+  return this->valid;
+}
+
+template <uint8_t size, typename Type>
+bool LDLT<size, Type>::FactorInPlace(Matrix<size, size, Type> &matrix)
+{
+  Type *ld{matrix.matrix.data()};
+
+  // each pivot is measured against the biggest entry of its own row of the
+  // lower triangle (and the column below it, the rest of the row by
+  // symmetry), the same way as in LU. Against the whole matrix a badly scaled
+  // SPD matrix that LLT accepts would be rejected here.
+  Type row_scales[size > 0 ? size : 1]{};
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx <= row_idx; column_idx++)
+    {
+      const Type value{ConstexprMath::Abs(ld[row_idx * size + column_idx])};
+      row_scales[row_idx] = std::max(row_scales[row_idx], value);
+      row_scales[column_idx] = std::max(row_scales[column_idx], value);
+    }
+  }
+
+  // L[row][inner] * D[inner] for the row being worked on
+  Type scaled_row[size > 0 ? size : 1];
+
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    Type *row{ld + row_idx * size};
+    for (uint8_t column_idx{0}; column_idx < row_idx; column_idx++)
+    {
+      const Type *other_row{ld + column_idx * size};
+      Type sum{row[column_idx]};
+      for (uint8_t inner_idx{0}; inner_idx < column_idx; inner_idx++)
+      {
+        sum -= scaled_row[inner_idx] * other_row[inner_idx];
+      }
+      scaled_row[column_idx] = sum;
+      row[column_idx] = sum / other_row[column_idx];
+    }
+
+    Type diagonal{row[row_idx]};
+    for (uint8_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      diagonal -= scaled_row[inner_idx] * row[inner_idx];
+    }
+    if (!(ConstexprMath::Abs(diagonal) >
+          row_scales[row_idx] * size * ScalarTraits<Type>::epsilon))
+    {
+      return false;
+    }
+    row[row_idx] = diagonal;
+
+    std::fill(row + row_idx + 1, row + size, Type{0});
+  }
+
+  return true;
+}
+
+template <uint8_t size, typename Type>
+bool LDLT<size, Type>::IsPositiveDefinite() const
+{
+  if (!this->valid)
+  {
+    return false;
+  }
+
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    if (!(this->factors.matrix[idx * size + idx] > 0))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <uint8_t size, typename Type>
+template <uint8_t rhs_columns>
+Matrix<size, rhs_columns, Type> &
+LDLT<size, Type>::Solve(const Matrix<size, rhs_columns, Type> &rhs,
+                  Matrix<size, rhs_columns, Type> &result) const
+{
+  if (!this->valid)
+  {
+    result.Fill(0);
+    return result;
+  }
+
+  const Type *ld{this->factors.matrix.data()};
+  if (&result != &rhs)
+  {
+    result = rhs;
+  }
+  Type *x{result.matrix.data()};
+
+  // L * y = rhs with the unit lower triangle
+  for (uint8_t row_idx{1}; row_idx < size; row_idx++)
+  {
+    Type *x_row{x + row_idx * rhs_columns};
+    for (uint8_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      const Type factor{ld[row_idx * size + inner_idx]};
+      const Type *x_inner{x + inner_idx * rhs_columns};
+      for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+      {
+        x_row[column_idx] -= factor * x_inner[column_idx];
+      }
+    }
+  }
+
+  // D * z = y
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    Type *x_row{x + row_idx * rhs_columns};
+    const Type inverse_diagonal{1 / ld[row_idx * size + row_idx]};
+    for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+    {
+      x_row[column_idx] *= inverse_diagonal;
+    }
+  }
+
+  // L^T * x = z, reading L along its rows
+  for (int16_t row_idx = size - 1; row_idx > 0; row_idx--)
+  {
+    const Type *ld_row{ld + row_idx * size};
+    const Type *x_row{x + row_idx * rhs_columns};
+    for (uint8_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      const Type factor{ld_row[inner_idx]};
+      Type *x_inner{x + inner_idx * rhs_columns};
+      for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+      {
+        x_inner[column_idx] -= factor * x_row[column_idx];
+      }
+    }
+  }
+
+  return result;
+}
+
+template <uint8_t size, typename Type>
+Matrix<size, size, Type> &
+LDLT<size, Type>::Invert(Matrix<size, size, Type> &result) const
+{
+  Matrix<size, size, Type> identity{};
+  identity.Identity();
+  return this->Solve(identity, result);
+}
+
+template <uint8_t size, typename Type>
+Type LDLT<size, Type>::Det() const
+{
+  if (!this->valid)
+  {
+    return 0;
+  }
+
+  Type determinant{1};
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    determinant *= this->factors.matrix[idx * size + idx];
+  }
+  return determinant;
+}
+
+template <uint8_t size, typename Type>
+Type LDLT<size, Type>::LogDet() const
+{
+  if (!this->IsPositiveDefinite())
+  {
+    return -INFINITY;
+  }
+
+  Type log_determinant{0};
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    log_determinant += static_cast<Type>(
+        std::log(static_cast<typename ScalarTraits<Type>::Accumulator>(
+            this->factors.matrix[idx * size + idx])));
+  }
+  return log_determinant;
+}
+
+#endif // CHOLESKY_H_
@@ -0,0 +1,188 @@
+#ifndef CHOLESKY_H_
+#define CHOLESKY_H_
+
+#include <cstdint>
+
+#include "Matrix.hpp"
+
+/**
+ * @brief Cholesky factorization (A = L * L^T) of a symmetric positive-definite
+ * matrix. Needs about half the work of LU and no pivoting, so prefer it for
+ * covariances and anything else that is known to be SPD.
+ * @note only the lower triangle of the input is read
+ */
+template <uint8_t size, typename Type>
+class LLT
+{
+public:
+  /**
+   * @brief create an empty factorization. Call Compute before using it.
+   */
+  LLT() = default;
+
+  /**
+   * @brief Factorize matrix
+   */
+  LLT(const Matrix<size, size, Type> &matrix);
+
+  /**
+   * @brief Factorize matrix, replacing whatever was factorized before
+   * @return false if the matrix isn't positive definite
+   */
+  bool Compute(const Matrix<size, size, Type> &matrix);
+
+  /**
+   * @brief Overwrite matrix with its Cholesky factor L. The upper triangle is
+   * set to 0.
+   * @return false if the matrix isn't positive definite. The contents of
+   * matrix are unspecified in that case.
+   */
+  static bool FactorInPlace(Matrix<size, size, Type> &matrix);
+
+  /**
+   * @return false if the last matrix passed to Compute wasn't positive
+   * definite. None of the other functions give meaningful answers then.
+   */
+  bool IsPositiveDefinite() const { return this->positive_definite; }
+
+  /**
+   * @brief Solve A * result = rhs for every column of rhs
+   * @param rhs one or more right hand sides stored as columns
+   * @param result A buffer to store the result into
+   * @note there is no problem if result == rhs
+   * @note if the matrix isn't positive definite result is filled with 0
+   */
+  template <uint8_t rhs_columns>
+  Matrix<size, rhs_columns, Type> &
+  Solve(const Matrix<size, rhs_columns, Type> &rhs,
+        Matrix<size, rhs_columns, Type> &result) const;
+
+  /**
+   * @brief Forward substitution: solve L * result = rhs
+   * @note there is no problem if result == rhs
+   */
+  template <uint8_t rhs_columns>
+  Matrix<size, rhs_columns, Type> &
+  SolveLower(const Matrix<size, rhs_columns, Type> &rhs,
+             Matrix<size, rhs_columns, Type> &result) const;
+
+  /**
+   * @brief Back substitution: solve L^T * result = rhs
+   * @note there is no problem if result == rhs
+   */
+  template <uint8_t rhs_columns>
+  Matrix<size, rhs_columns, Type> &
+  SolveUpper(const Matrix<size, rhs_columns, Type> &rhs,
+             Matrix<size, rhs_columns, Type> &result) const;
+
+  /**
+   * @brief Invert the factorized matrix
+   * @param result A buffer to store the result into
+   */
+  Matrix<size, size, Type> &Invert(Matrix<size, size, Type> &result) const;
+
+  /**
+   * @return the determinant of the factorized matrix
+   */
+  Type Det() const;
+
+  /**
+   * @return the natural log of the determinant. Unlike Det this doesn't
+   * overflow or underflow for large or badly scaled matrices.
+   */
+  Type LogDet() const;
+
+  /**
+   * @brief Get the lower triangular factor L
+   */
+  const Matrix<size, size, Type> &GetL() const { return this->factor; }
+
+private:
+  Matrix<size, size, Type> factor{};
+  bool positive_definite{false};
+};
+
+/**
+ * @brief Square root free Cholesky factorization (A = L * D * L^T) of a
+ * symmetric matrix, where L has a unit diagonal and D is diagonal. It avoids
+ * the square roots of LLT and also works on symmetric matrices that are
+ * indefinite, as long as none of the pivots come out as zero.
+ * @note only the lower triangle of the input is read
+ */
+template <uint8_t size, typename Type>
+class LDLT
+{
+public:
+  /**
+   * @brief create an empty factorization. Call Compute before using it.
+   */
+  LDLT() = default;
+
+  /**
+   * @brief Factorize matrix
+   */
+  LDLT(const Matrix<size, size, Type> &matrix);
+
+  /**
+   * @brief Factorize matrix, replacing whatever was factorized before
+   * @return false if one of the pivots is zero
+   */
+  bool Compute(const Matrix<size, size, Type> &matrix);
+
+  /**
+   * @brief Overwrite matrix with its packed factors: D on the diagonal and
+   * the strictly lower triangle of L below it. The upper triangle is set to 0.
+   * @return false if one of the pivots is zero
+   */
+  static bool FactorInPlace(Matrix<size, size, Type> &matrix);
+
+  /**
+   * @return false if the factorization failed on a zero pivot
+   */
+  bool IsValid() const { return this->valid; }
+
+  /**
+   * @return true if every entry of D is positive
+   */
+  bool IsPositiveDefinite() const;
+
+  /**
+   * @brief Solve A * result = rhs for every column of rhs
+   * @note there is no problem if result == rhs
+   * @note if the factorization failed result is filled with 0
+   */
+  template <uint8_t rhs_columns>
+  Matrix<size, rhs_columns, Type> &
+  Solve(const Matrix<size, rhs_columns, Type> &rhs,
+        Matrix<size, rhs_columns, Type> &result) const;
+
+  /**
+   * @brief Invert the factorized matrix
+   * @param result A buffer to store the result into
+   */
+  Matrix<size, size, Type> &Invert(Matrix<size, size, Type> &result) const;
+
+  /**
+   * @return the determinant of the factorized matrix
+   */
+  Type Det() const;
+
+  /**
+   * @return the natural log of the determinant
+   * @note only meaningful if IsPositiveDefinite
+   */
+  Type LogDet() const;
+
+  /**
+   * @brief Get the packed factors: D on the diagonal and L below it
+   */
+  const Matrix<size, size, Type> &GetFactors() const { return this->factors; }
+
+private:
+  Matrix<size, size, Type> factors{};
+  bool valid{false};
+};
+
+#include "Cholesky.cpp"
+
+#endif // CHOLESKY_H_
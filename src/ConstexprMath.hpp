@@ -0,0 +1,138 @@
+#ifndef CONSTEXPR_MATH_H_
+#define CONSTEXPR_MATH_H_
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief Math functions that can run in constant expressions. At run time
+ * they're the same as the <cmath> functions. At compile time sqrt, sin and cos
+ * fall back to series that agree with <cmath> to within about one float ulp.
+ */
+namespace ConstexprMath
+{
+/**
+ * @return true while the compiler is evaluating a constant expression. Lets
+ * constexpr functions keep the run time only fast paths (the SIMD kernels,
+ * <cmath>) for run time.
+ * @note on compilers without __builtin_is_constant_evaluated this is always
+ * false, so only the small sizes that stay on plain loops fold at compile time
+ */
+constexpr bool IsConstantEvaluated()
+{
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+template <typename Type>
+constexpr Type Abs(Type value)
+{
+  return value < 0 ? -value : value;
+}
+
+namespace detail
+{
+// Newton's method in double until it stops moving
+template <typename Type>
+constexpr Type sqrt(Type value)
+{
+  if (!IsConstantEvaluated())
+  {
+    return std::sqrt(value);
+  }
+
+  if (value < 0 || value != value)
+  {
+    return std::numeric_limits<Type>::quiet_NaN();
+  }
+  if (value == 0 || value == std::numeric_limits<Type>::infinity())
+  {
+    return value;
+  }
+
+  const double target{static_cast<double>(value)};
+  double guess{target > 1 ? target : 1.0};
+  for (uint8_t iteration{0}; iteration < 100; iteration++)
+  {
+    const double next{0.5 * (guess + target / guess)};
+    if (next == guess)
+    {
+      break;
+    }
+    guess = next;
+  }
+  return static_cast<Type>(guess);
+}
+
+constexpr double pi{3.14159265358979323846};
+
+// bring the angle into [-pi, pi] so the series converges quickly
+constexpr double wrapAngle(double angle)
+{
+  const double turns{angle / (2 * pi)};
+  const double whole_turns{static_cast<double>(static_cast<int64_t>(
+      turns < 0 ? turns - 0.5 : turns + 0.5))};
+  return angle - whole_turns * 2 * pi;
+}
+
+// sum of the Taylor series starting with term (x for sin, 1 for cos)
+constexpr double taylor(double x, double term, uint8_t first_power)
+{
+  double sum{term};
+  for (uint8_t power = first_power + 2; power < 40; power += 2)
+  {
+    term *= -x * x / ((power - 1) * power);
+    sum += term;
+  }
+  return sum;
+}
+} // namespace detail
+
+constexpr float Sqrt(float value) { return detail::sqrt(value); }
+
+constexpr double Sqrt(double value) { return detail::sqrt(value); }
+
+constexpr long double Sqrt(long double value) { return detail::sqrt(value); }
+
+// integers go through float, so Sqrt(2) isn't ambiguous between the overloads
+template <typename Integer,
+          typename std::enable_if<std::is_integral<Integer>::value,
+                                  int>::type = 0>
+constexpr float Sqrt(Integer value)
+{
+  return Sqrt(static_cast<float>(value));
+}
+
+constexpr float Sin(float angle)
+{
+  if (!IsConstantEvaluated())
+  {
+    return std::sin(angle);
+  }
+  const double wrapped{detail::wrapAngle(angle)};
+  return static_cast<float>(detail::taylor(wrapped, wrapped, 1));
+}
+
+constexpr float Cos(float angle)
+{
+  if (!IsConstantEvaluated())
+  {
+    return std::cos(angle);
+  }
+  const double wrapped{detail::wrapAngle(angle)};
+  return static_cast<float>(detail::taylor(wrapped, 1, 0));
+}
+} // namespace ConstexprMath
+
+#endif // CONSTEXPR_MATH_H_
@@ -0,0 +1,348 @@
+#include "DynMatrix.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "BoundsCheck.hpp"
+#include "ElementKernels.hpp"
+#include "Gemm.hpp"
+
+DynMatrix::DynMatrix(Arena &arena, size_t rows, size_t columns)
+{
+  float *storage{arena.Allocate<float>(rows * columns)};
+  if (storage == nullptr)
+  {
+    return;
+  }
+
+  this->data = storage;
+  this->rows = rows;
+  this->columns = columns;
+  this->Fill(0);
+}
+
+DynMatrix::DynMatrix(float *data, size_t rows, size_t columns)
+    : data(data), rows(rows), columns(columns)
+{
+}
+
+DynMatrix DynMatrix::View(float *data, size_t rows, size_t columns)
+{
+  if (data == nullptr)
+  {
+    return DynMatrix{};
+  }
+  return DynMatrix{data, rows, columns};
+}
+
+DynMatrix::DynMatrix(DynMatrix &&other)
+    : data(other.data), rows(other.rows), columns(other.columns)
+{
+  other.data = nullptr;
+  other.rows = 0;
+  other.columns = 0;
+}
+
+DynMatrix &DynMatrix::operator=(DynMatrix &&other)
+{
+  if (this != &other)
+  {
+    this->data = other.data;
+    this->rows = other.rows;
+    this->columns = other.columns;
+    other.data = nullptr;
+    other.rows = 0;
+    other.columns = 0;
+  }
+  return *this;
+}
+
+float DynMatrix::Get(size_t row_index, size_t column_index) const
+{
+  if (!BoundsCheck::Accept(row_index < this->rows &&
+                           column_index < this->columns))
+  {
+    return 1e+10;
+  }
+  return this->data[row_index * this->columns + column_index];
+}
+
+void DynMatrix::Identity()
+{
+  this->Fill(0);
+  const size_t diagonal{std::min(this->rows, this->columns)};
+  for (size_t idx{0}; idx < diagonal; idx++)
+  {
+    this->data[idx * this->columns + idx] = 1;
+  }
+}
+
+void DynMatrix::Fill(float value)
+{
+  ElementKernels::Fill(this->data, value, this->Size());
+}
+
+bool DynMatrix::CopyFrom(const DynMatrix &other)
+{
+  if (!this->sameSize(other))
+  {
+    return false;
+  }
+
+  if (this->data != other.data)
+  {
+    memcpy(this->data, other.data, this->Size() * sizeof(float));
+  }
+  return true;
+}
+
+bool DynMatrix::Add(const DynMatrix &other, DynMatrix &result) const
+{
+  if (!this->sameSize(other) || !this->sameSize(result))
+  {
+    return false;
+  }
+
+  ElementKernels::Add(this->data, other.data, result.data, this->Size());
+  return true;
+}
+
+bool DynMatrix::Sub(const DynMatrix &other, DynMatrix &result) const
+{
+  if (!this->sameSize(other) || !this->sameSize(result))
+  {
+    return false;
+  }
+
+  ElementKernels::Sub(this->data, other.data, result.data, this->Size());
+  return true;
+}
+
+bool DynMatrix::Mult(const DynMatrix &other, DynMatrix &result) const
+{
+  if (this->columns != other.rows || result.rows != this->rows ||
+      result.columns != other.columns || &result == this || &result == &other)
+  {
+    return false;
+  }
+
+  if (this->rows * this->columns * other.columns < Gemm::block_threshold)
+  {
+    // same plain loop as Matrix::Mult for small products
+    for (size_t row_idx{0}; row_idx < this->rows; row_idx++)
+    {
+      float *result_row{result[row_idx]};
+      for (size_t column_idx{0}; column_idx < other.columns; column_idx++)
+      {
+        result_row[column_idx] = 0;
+      }
+
+      for (size_t inner_idx{0}; inner_idx < this->columns; inner_idx++)
+      {
+        const float scale{this->data[row_idx * this->columns + inner_idx]};
+        const float *other_row{other[inner_idx]};
+        for (size_t column_idx{0}; column_idx < other.columns; column_idx++)
+        {
+          result_row[column_idx] += scale * other_row[column_idx];
+        }
+      }
+    }
+    return true;
+  }
+
+  Gemm::Multiply(this->rows, other.columns, this->columns,
+                 this->data, this->columns,
+                 other.data, other.columns,
+                 result.data, result.columns);
+  return true;
+}
+
+bool DynMatrix::Mult(float scalar, DynMatrix &result) const
+{
+  if (!this->sameSize(result))
+  {
+    return false;
+  }
+
+  ElementKernels::Scale(this->data, scalar, result.data, this->Size());
+  return true;
+}
+
+bool DynMatrix::ElementMultiply(const DynMatrix &other,
+                                DynMatrix &result) const
+{
+  if (!this->sameSize(other) || !this->sameSize(result))
+  {
+    return false;
+  }
+
+  ElementKernels::Multiply(this->data, other.data, result.data, this->Size());
+  return true;
+}
+
+bool DynMatrix::ElementDivide(const DynMatrix &other, DynMatrix &result) const
+{
+  if (!this->sameSize(other) || !this->sameSize(result))
+  {
+    return false;
+  }
+
+  ElementKernels::Divide(this->data, other.data, result.data, this->Size());
+  return true;
+}
+
+bool DynMatrix::Transpose(DynMatrix &result) const
+{
+  if (result.rows != this->columns || result.columns != this->rows ||
+      &result == this)
+  {
+    return false;
+  }
+
+  // go through in square tiles so neither side strides through the whole
+  // matrix between cache hits
+  constexpr size_t tile{16};
+  for (size_t row_block{0}; row_block < this->rows; row_block += tile)
+  {
+    const size_t row_end{std::min(row_block + tile, this->rows)};
+    for (size_t column_block{0}; column_block < this->columns;
+         column_block += tile)
+    {
+      const size_t column_end{std::min(column_block + tile, this->columns)};
+      for (size_t row_idx{row_block}; row_idx < row_end; row_idx++)
+      {
+        for (size_t column_idx{column_block}; column_idx < column_end;
+             column_idx++)
+        {
+          result.data[column_idx * this->rows + row_idx] =
+              this->data[row_idx * this->columns + column_idx];
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool DynMatrix::Solve(const DynMatrix &rhs, DynMatrix &result,
+                      Arena &scratch) const
+{
+  const size_t size{this->rows};
+  const size_t rhs_columns{rhs.columns};
+  if (this->columns != size || rhs.rows != size || !rhs.sameSize(result))
+  {
+    return false;
+  }
+
+  const size_t mark{scratch.Mark()};
+  float *lu{scratch.Allocate<float>(size * size)};
+  float *x{scratch.Allocate<float>(size * rhs_columns)};
+  size_t *permutation{scratch.Allocate<size_t>(size)};
+  float *row_scales{scratch.Allocate<float>(size)};
+  if (lu == nullptr || x == nullptr || permutation == nullptr ||
+      row_scales == nullptr)
+  {
+    scratch.Rewind(mark);
+    return false;
+  }
+
+  // this is LU<size>::Compute on run time sizes. The row updates go through
+  // the element kernels since the rows can be thousands of elements long.
+  // Pivots are measured against their own original row like there too.
+  memcpy(lu, this->data, size * size * sizeof(float));
+  for (size_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    row_scales[row_idx] = 0;
+    for (size_t column_idx{0}; column_idx < size; column_idx++)
+    {
+      row_scales[row_idx] = std::max(
+          row_scales[row_idx], std::fabs(lu[row_idx * size + column_idx]));
+    }
+  }
+
+  for (size_t idx{0}; idx < size; idx++)
+  {
+    permutation[idx] = idx;
+  }
+
+  for (size_t pivot_idx{0}; pivot_idx < size; pivot_idx++)
+  {
+    size_t best_row{pivot_idx};
+    float best_value{std::fabs(lu[pivot_idx * size + pivot_idx])};
+    for (size_t row_idx = pivot_idx + 1; row_idx < size; row_idx++)
+    {
+      const float value{std::fabs(lu[row_idx * size + pivot_idx])};
+      if (value > best_value)
+      {
+        best_value = value;
+        best_row = row_idx;
+      }
+    }
+
+    const float tolerance{row_scales[permutation[best_row]] * size *
+                          FLT_EPSILON};
+    if (!(best_value > tolerance))
+    {
+      scratch.Rewind(mark);
+      return false;
+    }
+
+    if (best_row != pivot_idx)
+    {
+      std::swap_ranges(lu + pivot_idx * size, lu + (pivot_idx + 1) * size,
+                       lu + best_row * size);
+      std::swap(permutation[pivot_idx], permutation[best_row]);
+    }
+
+    const float *pivot_row{lu + pivot_idx * size};
+    const float inverse_pivot{1 / pivot_row[pivot_idx]};
+    const size_t trailing{size - pivot_idx - 1};
+    for (size_t row_idx = pivot_idx + 1; row_idx < size; row_idx++)
+    {
+      float *row{lu + row_idx * size};
+      const float multiplier{row[pivot_idx] * inverse_pivot};
+      row[pivot_idx] = multiplier;
+      ElementKernels::ScaleAdd(pivot_row + pivot_idx + 1, -multiplier,
+                               row + pivot_idx + 1, row + pivot_idx + 1,
+                               trailing);
+    }
+  }
+
+  // apply the row permutation into x, so rhs and result can be the same
+  for (size_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    memcpy(x + row_idx * rhs_columns, rhs[permutation[row_idx]],
+           rhs_columns * sizeof(float));
+  }
+
+  // forward substitution with the unit lower triangle
+  for (size_t row_idx{1}; row_idx < size; row_idx++)
+  {
+    float *x_row{x + row_idx * rhs_columns};
+    for (size_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      ElementKernels::ScaleAdd(x + inner_idx * rhs_columns,
+                               -lu[row_idx * size + inner_idx], x_row, x_row,
+                               rhs_columns);
+    }
+  }
+
+  // back substitution with the upper triangle
+  for (size_t row_idx{size}; row_idx-- > 0;)
+  {
+    float *x_row{x + row_idx * rhs_columns};
+    for (size_t inner_idx = row_idx + 1; inner_idx < size; inner_idx++)
+    {
+      ElementKernels::ScaleAdd(x + inner_idx * rhs_columns,
+                               -lu[row_idx * size + inner_idx], x_row, x_row,
+                               rhs_columns);
+    }
+    ElementKernels::Scale(x_row, 1 / lu[row_idx * size + row_idx], x_row,
+                          rhs_columns);
+  }
+
+  memcpy(result.data, x, size * rhs_columns * sizeof(float));
+  scratch.Rewind(mark);
+  return true;
+}
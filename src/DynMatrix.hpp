@@ -0,0 +1,229 @@
+#ifndef DYN_MATRIX_H_
+#define DYN_MATRIX_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Arena.hpp"
+#include "Matrix.hpp"
+
+/**
+ * @brief A row-major matrix whose size is picked at run time, for problems
+ * too big for Matrix (which tops out at 255x255 and lives on the stack).
+ *
+ * A DynMatrix never allocates on its own. Its storage comes from an Arena, or
+ * from an array the caller wraps with View, and stays valid until the arena is
+ * rewound past it. It runs on the same element kernels and GEMM as Matrix.
+ *
+ * If the arena runs out the matrix is left empty: IsValid returns false and
+ * both dimensions are 0. Every operation writing into a result returns false
+ * and leaves it untouched if the dimensions don't match.
+ */
+class DynMatrix
+{
+public:
+  /**
+   * @brief Create an empty 0x0 matrix
+   */
+  DynMatrix() = default;
+
+  /**
+   * @brief Allocate a rows x columns matrix from arena with every element
+   * set to 0
+   */
+  DynMatrix(Arena &arena, size_t rows, size_t columns);
+
+  /**
+   * @brief Allocate a copy of a fixed size matrix from arena
+   */
+  template <uint8_t fixed_rows, uint8_t fixed_columns>
+  DynMatrix(Arena &arena, const Matrix<fixed_rows, fixed_columns> &matrix);
+
+  /**
+   * @brief Wrap an existing row-major array without copying it
+   * @note the array has to outlive the view
+   */
+  static DynMatrix View(float *data, size_t rows, size_t columns);
+
+  // copies would share storage, use CopyFrom to copy the elements
+  DynMatrix(const DynMatrix &) = delete;
+  DynMatrix &operator=(const DynMatrix &) = delete;
+
+  /**
+   * @brief Take over other's storage, other is left empty
+   */
+  DynMatrix(DynMatrix &&other);
+  DynMatrix &operator=(DynMatrix &&other);
+
+  /**
+   * @return false if the arena ran out while creating this matrix
+   */
+  bool IsValid() const { return this->data != nullptr; }
+
+  size_t GetRowSize() const { return this->rows; }
+  size_t GetColumnSize() const { return this->columns; }
+
+  /**
+   * @return the number of elements in the matrix
+   */
+  size_t Size() const { return this->rows * this->columns; }
+
+  float *Data() { return this->data; }
+  const float *Data() const { return this->data; }
+
+  /**
+   * @brief Get an element from the matrix
+   * @return The element. Out of range indices are handled by the bounds check
+   * policy, by default they return 1e+10, see BoundsCheck
+   */
+  float Get(size_t row_index, size_t column_index) const;
+
+  /**
+   * @brief get the specified row of the matrix
+   * @note row_index is only checked when the bounds check policy traps, see
+   * BoundsCheck
+   */
+  float *operator[](size_t row_index)
+  {
+    BoundsCheck::Assert(row_index < this->rows);
+    return this->data + row_index * this->columns;
+  }
+  const float *operator[](size_t row_index) const
+  {
+    BoundsCheck::Assert(row_index < this->rows);
+    return this->data + row_index * this->columns;
+  }
+
+  /**
+   * @brief set the matrix diagonals to 1 and all other values to 0
+   */
+  void Identity();
+
+  /**
+   * @brief Set all elements in this to value
+   */
+  void Fill(float value);
+
+  /**
+   * @brief Copy the elements of other into this matrix
+   */
+  bool CopyFrom(const DynMatrix &other);
+
+  template <uint8_t fixed_rows, uint8_t fixed_columns>
+  bool CopyFrom(const Matrix<fixed_rows, fixed_columns> &other);
+
+  /**
+   * @brief Copy the elements of this matrix into a fixed size one
+   */
+  template <uint8_t fixed_rows, uint8_t fixed_columns>
+  bool CopyTo(Matrix<fixed_rows, fixed_columns> &other) const;
+
+  /**
+   * @brief Element-wise matrix addition
+   * @note there is no problem if result == this or result == other
+   */
+  bool Add(const DynMatrix &other, DynMatrix &result) const;
+
+  /**
+   * @brief Element-wise matrix subtraction
+   * @note there is no problem if result == this or result == other
+   */
+  bool Sub(const DynMatrix &other, DynMatrix &result) const;
+
+  /**
+   * @brief Matrix multiply the two matrices
+   * @warning result must not be this or other, false is returned if it is
+   */
+  bool Mult(const DynMatrix &other, DynMatrix &result) const;
+
+  /**
+   * @brief Multiply the matrix by a scalar
+   * @note there is no problem if result == this
+   */
+  bool Mult(float scalar, DynMatrix &result) const;
+
+  /**
+   * @brief Element-wise multiply the two matrices
+   * @note there is no problem if result == this or result == other
+   */
+  bool ElementMultiply(const DynMatrix &other, DynMatrix &result) const;
+
+  /**
+   * @brief Element-wise divide the two matrices
+   * @note there is no problem if result == this or result == other
+   */
+  bool ElementDivide(const DynMatrix &other, DynMatrix &result) const;
+
+  /**
+   * @brief Transpose this matrix into result
+   * @warning result must not be this, false is returned if it is
+   */
+  bool Transpose(DynMatrix &result) const;
+
+  /**
+   * @brief Solve this * result = rhs for every column of rhs with an LU
+   * factorization with partial pivoting
+   * @param scratch the factorization is built here, it's rewound again
+   * before returning
+   * @return false if this isn't square, the sizes don't match, scratch is too
+   * small or the matrix is singular
+   * @note there is no problem if result == rhs
+   */
+  bool Solve(const DynMatrix &rhs, DynMatrix &result, Arena &scratch) const;
+
+private:
+  DynMatrix(float *data, size_t rows, size_t columns);
+
+  bool sameSize(const DynMatrix &other) const
+  {
+    return this->rows == other.rows && this->columns == other.columns;
+  }
+
+  float *data{nullptr};
+  size_t rows{0};
+  size_t columns{0};
+};
+
+template <uint8_t fixed_rows, uint8_t fixed_columns>
+DynMatrix::DynMatrix(Arena &arena,
+                     const Matrix<fixed_rows, fixed_columns> &matrix)
+    : DynMatrix(arena, fixed_rows, fixed_columns)
+{
+  this->CopyFrom(matrix);
+}
+
+template <uint8_t fixed_rows, uint8_t fixed_columns>
+bool DynMatrix::CopyFrom(const Matrix<fixed_rows, fixed_columns> &other)
+{
+  if (this->rows != fixed_rows || this->columns != fixed_columns)
+  {
+    return false;
+  }
+
+  for (uint16_t idx{0}; idx < fixed_rows * fixed_columns; idx++)
+  {
+    this->data[idx] = other.Element(idx);
+  }
+  return true;
+}
+
+template <uint8_t fixed_rows, uint8_t fixed_columns>
+bool DynMatrix::CopyTo(Matrix<fixed_rows, fixed_columns> &other) const
+{
+  if (this->rows != fixed_rows || this->columns != fixed_columns)
+  {
+    return false;
+  }
+
+  for (uint8_t row_idx{0}; row_idx < fixed_rows; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < fixed_columns; column_idx++)
+    {
+      other[row_idx][column_idx] =
+          this->data[row_idx * fixed_columns + column_idx];
+    }
+  }
+  return true;
+}
+
+#endif // DYN_MATRIX_H_
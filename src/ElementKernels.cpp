@@ -0,0 +1,985 @@
+#include "ElementKernels.hpp"
+
+#include <cmath>
+
+#ifdef MATRIX_THREADS
+#include "Parallel.hpp"
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define ELEMENT_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// the wider x86 kernels are compiled with per-function target attributes so
+// the rest of the library keeps running on CPUs that don't have them
+#if defined(ELEMENT_KERNELS_SSE2) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define ELEMENT_KERNELS_AVX
+#include <immintrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ELEMENT_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+using ElementKernels::InstructionSet;
+
+struct AddOp
+{
+  static float Scalar(float a, float b) { return a + b; }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a, __m256 b)
+  {
+    return _mm256_add_ps(a, b);
+  }
+  TARGET_AVX512 static __m512 AVX512(__m512 a, __m512 b)
+  {
+    return _mm512_add_ps(a, b);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_NEON
+  static float32x4_t NEON(float32x4_t a, float32x4_t b)
+  {
+    return vaddq_f32(a, b);
+  }
+#endif
+};
+
+struct SubOp
+{
+  static float Scalar(float a, float b) { return a - b; }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a, __m256 b)
+  {
+    return _mm256_sub_ps(a, b);
+  }
+  TARGET_AVX512 static __m512 AVX512(__m512 a, __m512 b)
+  {
+    return _mm512_sub_ps(a, b);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_NEON
+  static float32x4_t NEON(float32x4_t a, float32x4_t b)
+  {
+    return vsubq_f32(a, b);
+  }
+#endif
+};
+
+struct MultiplyOp
+{
+  static float Scalar(float a, float b) { return a * b; }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a, __m256 b)
+  {
+    return _mm256_mul_ps(a, b);
+  }
+  TARGET_AVX512 static __m512 AVX512(__m512 a, __m512 b)
+  {
+    return _mm512_mul_ps(a, b);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_NEON
+  static float32x4_t NEON(float32x4_t a, float32x4_t b)
+  {
+    return vmulq_f32(a, b);
+  }
+#endif
+};
+
+struct DivideOp
+{
+  static float Scalar(float a, float b) { return a / b; }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a, __m256 b)
+  {
+    return _mm256_div_ps(a, b);
+  }
+  TARGET_AVX512 static __m512 AVX512(__m512 a, __m512 b)
+  {
+    return _mm512_div_ps(a, b);
+  }
+#endif
+  // 32 bit ARM has no vector divide, so it keeps the scalar divide kernels
+#if defined(ELEMENT_KERNELS_NEON) && defined(__aarch64__)
+  static float32x4_t NEON(float32x4_t a, float32x4_t b)
+  {
+    return vdivq_f32(a, b);
+  }
+#endif
+};
+
+// a * b + c. The AVX512 kernels always have FMA, the others keep the multiply
+// and the add separate.
+struct MultiplyAddOp
+{
+  static float Scalar(float a, float b, float c) { return a * b + c; }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a, __m128 b, __m128 c)
+  {
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a, __m256 b, __m256 c)
+  {
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+  }
+  TARGET_AVX512 static __m512 AVX512(__m512 a, __m512 b, __m512 c)
+  {
+    return _mm512_fmadd_ps(a, b, c);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_NEON
+  static float32x4_t NEON(float32x4_t a, float32x4_t b, float32x4_t c)
+  {
+    return vmlaq_f32(c, a, b);
+  }
+#endif
+};
+
+// a * b - c
+struct MultiplySubOp
+{
+  static float Scalar(float a, float b, float c) { return a * b - c; }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a, __m128 b, __m128 c)
+  {
+    return _mm_sub_ps(_mm_mul_ps(a, b), c);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a, __m256 b, __m256 c)
+  {
+    return _mm256_sub_ps(_mm256_mul_ps(a, b), c);
+  }
+  TARGET_AVX512 static __m512 AVX512(__m512 a, __m512 b, __m512 c)
+  {
+    return _mm512_fmsub_ps(a, b, c);
+  }
+#endif
+#ifdef ELEMENT_KERNELS_NEON
+  static float32x4_t NEON(float32x4_t a, float32x4_t b, float32x4_t c)
+  {
+    return vsubq_f32(vmulq_f32(a, b), c);
+  }
+#endif
+};
+
+struct SqrtOp
+{
+  static float Scalar(float a) { return std::sqrt(a); }
+#ifdef ELEMENT_KERNELS_SSE2
+  static __m128 SSE2(__m128 a) { return _mm_sqrt_ps(a); }
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  TARGET_AVX2 static __m256 AVX2(__m256 a) { return _mm256_sqrt_ps(a); }
+  TARGET_AVX512 static __m512 AVX512(__m512 a)
+  {
+    // same as _mm512_sqrt_ps, which also trips -Wuninitialized in GCC's
+    // headers
+    return _mm512_maskz_sqrt_ps(0xFFFF, a);
+  }
+#endif
+  // like divide, 32 bit ARM only has a reciprocal square root estimate
+#if defined(ELEMENT_KERNELS_NEON) && defined(__aarch64__)
+  static float32x4_t NEON(float32x4_t a) { return vsqrtq_f32(a); }
+#endif
+};
+
+struct KernelTable
+{
+  InstructionSet instruction_set;
+  void (*add)(const float *, const float *, float *, size_t);
+  void (*sub)(const float *, const float *, float *, size_t);
+  void (*multiply)(const float *, const float *, float *, size_t);
+  void (*divide)(const float *, const float *, float *, size_t);
+  void (*scale)(const float *, float, float *, size_t);
+  void (*divide_scalar)(const float *, float, float *, size_t);
+  void (*multiply_add)(const float *, const float *, const float *, float *,
+                       size_t);
+  void (*multiply_sub)(const float *, const float *, const float *, float *,
+                       size_t);
+  void (*scale_add)(const float *, float, const float *, float *, size_t);
+  void (*sqrt)(const float *, float *, size_t);
+  void (*fill)(float *, float, size_t);
+  float (*sum_of_squares)(const float *, size_t);
+};
+
+// -------------------------------- Scalar --------------------------------
+template <typename Op>
+void binaryScalar(const float *a, const float *b, float *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = Op::Scalar(a[idx], b[idx]);
+  }
+}
+
+template <typename Op>
+void broadcastScalar(const float *a, float scalar, float *result,
+                     size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = Op::Scalar(a[idx], scalar);
+  }
+}
+
+template <typename Op>
+void ternaryScalar(const float *a, const float *b, const float *c,
+                   float *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = Op::Scalar(a[idx], b[idx], c[idx]);
+  }
+}
+
+template <typename Op>
+void broadcastTernaryScalar(const float *a, float scalar, const float *c,
+                            float *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = Op::Scalar(a[idx], scalar, c[idx]);
+  }
+}
+
+template <typename Op>
+void unaryScalar(const float *a, float *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = Op::Scalar(a[idx]);
+  }
+}
+
+void fillScalar(float *result, float value, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = value;
+  }
+}
+
+float sumOfSquaresScalar(const float *a, size_t count)
+{
+  float sum{0};
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    sum += a[idx] * a[idx];
+  }
+  return sum;
+}
+
+const KernelTable scalar_table{
+    InstructionSet::Scalar,
+    binaryScalar<AddOp>,
+    binaryScalar<SubOp>,
+    binaryScalar<MultiplyOp>,
+    binaryScalar<DivideOp>,
+    broadcastScalar<MultiplyOp>,
+    broadcastScalar<DivideOp>,
+    ternaryScalar<MultiplyAddOp>,
+    ternaryScalar<MultiplySubOp>,
+    broadcastTernaryScalar<MultiplyAddOp>,
+    unaryScalar<SqrtOp>,
+    fillScalar,
+    sumOfSquaresScalar};
+
+// --------------------------------- SSE2 ---------------------------------
+#ifdef ELEMENT_KERNELS_SSE2
+float horizontalSum(__m128 vector)
+{
+  __m128 shuffled{_mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 3, 0, 1))};
+  __m128 sums{_mm_add_ps(vector, shuffled)};
+  shuffled = _mm_movehl_ps(shuffled, sums);
+  sums = _mm_add_ss(sums, shuffled);
+  return _mm_cvtss_f32(sums);
+}
+
+template <typename Op>
+void binarySSE2(const float *a, const float *b, float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    _mm_storeu_ps(result + idx,
+                  Op::SSE2(_mm_loadu_ps(a + idx), _mm_loadu_ps(b + idx)));
+  }
+  binaryScalar<Op>(a + idx, b + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+void broadcastSSE2(const float *a, float scalar, float *result, size_t count)
+{
+  const __m128 scalar_vector{_mm_set1_ps(scalar)};
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    _mm_storeu_ps(result + idx,
+                  Op::SSE2(_mm_loadu_ps(a + idx), scalar_vector));
+  }
+  broadcastScalar<Op>(a + idx, scalar, result + idx, count - idx);
+}
+
+template <typename Op>
+void ternarySSE2(const float *a, const float *b, const float *c, float *result,
+                 size_t count)
+{
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    _mm_storeu_ps(result + idx, Op::SSE2(_mm_loadu_ps(a + idx),
+                                         _mm_loadu_ps(b + idx),
+                                         _mm_loadu_ps(c + idx)));
+  }
+  ternaryScalar<Op>(a + idx, b + idx, c + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+void broadcastTernarySSE2(const float *a, float scalar, const float *c,
+                          float *result, size_t count)
+{
+  const __m128 scalar_vector{_mm_set1_ps(scalar)};
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    _mm_storeu_ps(result + idx, Op::SSE2(_mm_loadu_ps(a + idx), scalar_vector,
+                                         _mm_loadu_ps(c + idx)));
+  }
+  broadcastTernaryScalar<Op>(a + idx, scalar, c + idx, result + idx,
+                             count - idx);
+}
+
+template <typename Op>
+void unarySSE2(const float *a, float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    _mm_storeu_ps(result + idx, Op::SSE2(_mm_loadu_ps(a + idx)));
+  }
+  unaryScalar<Op>(a + idx, result + idx, count - idx);
+}
+
+void fillSSE2(float *result, float value, size_t count)
+{
+  const __m128 value_vector{_mm_set1_ps(value)};
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    _mm_storeu_ps(result + idx, value_vector);
+  }
+  fillScalar(result + idx, value, count - idx);
+}
+
+float sumOfSquaresSSE2(const float *a, size_t count)
+{
+  // two accumulators so consecutive adds don't wait on each other
+  __m128 sum0{_mm_setzero_ps()};
+  __m128 sum1{_mm_setzero_ps()};
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    const __m128 value0{_mm_loadu_ps(a + idx)};
+    const __m128 value1{_mm_loadu_ps(a + idx + 4)};
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(value0, value0));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(value1, value1));
+  }
+  return horizontalSum(_mm_add_ps(sum0, sum1)) +
+         sumOfSquaresScalar(a + idx, count - idx);
+}
+
+const KernelTable sse2_table{
+    InstructionSet::SSE2,
+    binarySSE2<AddOp>,
+    binarySSE2<SubOp>,
+    binarySSE2<MultiplyOp>,
+    binarySSE2<DivideOp>,
+    broadcastSSE2<MultiplyOp>,
+    broadcastSSE2<DivideOp>,
+    ternarySSE2<MultiplyAddOp>,
+    ternarySSE2<MultiplySubOp>,
+    broadcastTernarySSE2<MultiplyAddOp>,
+    unarySSE2<SqrtOp>,
+    fillSSE2,
+    sumOfSquaresSSE2};
+#endif
+
+// --------------------------------- AVX2 ---------------------------------
+#ifdef ELEMENT_KERNELS_AVX
+template <typename Op>
+TARGET_AVX2 void binaryAVX2(const float *a, const float *b, float *result,
+                            size_t count)
+{
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    _mm256_storeu_ps(result + idx, Op::AVX2(_mm256_loadu_ps(a + idx),
+                                            _mm256_loadu_ps(b + idx)));
+  }
+  binaryScalar<Op>(a + idx, b + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+TARGET_AVX2 void broadcastAVX2(const float *a, float scalar, float *result,
+                               size_t count)
+{
+  const __m256 scalar_vector{_mm256_set1_ps(scalar)};
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    _mm256_storeu_ps(result + idx,
+                     Op::AVX2(_mm256_loadu_ps(a + idx), scalar_vector));
+  }
+  broadcastScalar<Op>(a + idx, scalar, result + idx, count - idx);
+}
+
+template <typename Op>
+TARGET_AVX2 void ternaryAVX2(const float *a, const float *b, const float *c,
+                             float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    _mm256_storeu_ps(result + idx, Op::AVX2(_mm256_loadu_ps(a + idx),
+                                            _mm256_loadu_ps(b + idx),
+                                            _mm256_loadu_ps(c + idx)));
+  }
+  ternaryScalar<Op>(a + idx, b + idx, c + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+TARGET_AVX2 void broadcastTernaryAVX2(const float *a, float scalar,
+                                      const float *c, float *result,
+                                      size_t count)
+{
+  const __m256 scalar_vector{_mm256_set1_ps(scalar)};
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    _mm256_storeu_ps(result + idx, Op::AVX2(_mm256_loadu_ps(a + idx),
+                                            scalar_vector,
+                                            _mm256_loadu_ps(c + idx)));
+  }
+  broadcastTernaryScalar<Op>(a + idx, scalar, c + idx, result + idx,
+                             count - idx);
+}
+
+template <typename Op>
+TARGET_AVX2 void unaryAVX2(const float *a, float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    _mm256_storeu_ps(result + idx, Op::AVX2(_mm256_loadu_ps(a + idx)));
+  }
+  unaryScalar<Op>(a + idx, result + idx, count - idx);
+}
+
+TARGET_AVX2 void fillAVX2(float *result, float value, size_t count)
+{
+  const __m256 value_vector{_mm256_set1_ps(value)};
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    _mm256_storeu_ps(result + idx, value_vector);
+  }
+  fillScalar(result + idx, value, count - idx);
+}
+
+TARGET_AVX2 float sumOfSquaresAVX2(const float *a, size_t count)
+{
+  __m256 sum0{_mm256_setzero_ps()};
+  __m256 sum1{_mm256_setzero_ps()};
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    const __m256 value0{_mm256_loadu_ps(a + idx)};
+    const __m256 value1{_mm256_loadu_ps(a + idx + 8)};
+    sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(value0, value0));
+    sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(value1, value1));
+  }
+  const __m256 sum{_mm256_add_ps(sum0, sum1)};
+  return horizontalSum(_mm_add_ps(_mm256_castps256_ps128(sum),
+                                  _mm256_extractf128_ps(sum, 1))) +
+         sumOfSquaresScalar(a + idx, count - idx);
+}
+
+const KernelTable avx2_table{
+    InstructionSet::AVX2,
+    binaryAVX2<AddOp>,
+    binaryAVX2<SubOp>,
+    binaryAVX2<MultiplyOp>,
+    binaryAVX2<DivideOp>,
+    broadcastAVX2<MultiplyOp>,
+    broadcastAVX2<DivideOp>,
+    ternaryAVX2<MultiplyAddOp>,
+    ternaryAVX2<MultiplySubOp>,
+    broadcastTernaryAVX2<MultiplyAddOp>,
+    unaryAVX2<SqrtOp>,
+    fillAVX2,
+    sumOfSquaresAVX2};
+
+// -------------------------------- AVX512 --------------------------------
+template <typename Op>
+TARGET_AVX512 void binaryAVX512(const float *a, const float *b,
+                                float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    _mm512_storeu_ps(result + idx, Op::AVX512(_mm512_loadu_ps(a + idx),
+                                              _mm512_loadu_ps(b + idx)));
+  }
+  binaryScalar<Op>(a + idx, b + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+TARGET_AVX512 void broadcastAVX512(const float *a, float scalar,
+                                   float *result, size_t count)
+{
+  const __m512 scalar_vector{_mm512_set1_ps(scalar)};
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    _mm512_storeu_ps(result + idx,
+                     Op::AVX512(_mm512_loadu_ps(a + idx), scalar_vector));
+  }
+  broadcastScalar<Op>(a + idx, scalar, result + idx, count - idx);
+}
+
+template <typename Op>
+TARGET_AVX512 void ternaryAVX512(const float *a, const float *b, const float *c,
+                                 float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    _mm512_storeu_ps(result + idx, Op::AVX512(_mm512_loadu_ps(a + idx),
+                                              _mm512_loadu_ps(b + idx),
+                                              _mm512_loadu_ps(c + idx)));
+  }
+  ternaryScalar<Op>(a + idx, b + idx, c + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+TARGET_AVX512 void broadcastTernaryAVX512(const float *a, float scalar,
+                                          const float *c, float *result,
+                                          size_t count)
+{
+  const __m512 scalar_vector{_mm512_set1_ps(scalar)};
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    _mm512_storeu_ps(result + idx, Op::AVX512(_mm512_loadu_ps(a + idx),
+                                              scalar_vector,
+                                              _mm512_loadu_ps(c + idx)));
+  }
+  broadcastTernaryScalar<Op>(a + idx, scalar, c + idx, result + idx,
+                             count - idx);
+}
+
+template <typename Op>
+TARGET_AVX512 void unaryAVX512(const float *a, float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    _mm512_storeu_ps(result + idx, Op::AVX512(_mm512_loadu_ps(a + idx)));
+  }
+  unaryScalar<Op>(a + idx, result + idx, count - idx);
+}
+
+TARGET_AVX512 void fillAVX512(float *result, float value, size_t count)
+{
+  const __m512 value_vector{_mm512_set1_ps(value)};
+  size_t idx{0};
+  for (; idx + 16 <= count; idx += 16)
+  {
+    _mm512_storeu_ps(result + idx, value_vector);
+  }
+  fillScalar(result + idx, value, count - idx);
+}
+
+TARGET_AVX512 float sumOfSquaresAVX512(const float *a, size_t count)
+{
+  __m512 sum0{_mm512_setzero_ps()};
+  __m512 sum1{_mm512_setzero_ps()};
+  size_t idx{0};
+  for (; idx + 32 <= count; idx += 32)
+  {
+    const __m512 value0{_mm512_loadu_ps(a + idx)};
+    const __m512 value1{_mm512_loadu_ps(a + idx + 16)};
+    sum0 = _mm512_add_ps(sum0, _mm512_mul_ps(value0, value0));
+    sum1 = _mm512_add_ps(sum1, _mm512_mul_ps(value1, value1));
+  }
+  // spill the lanes rather than using _mm512_reduce_add_ps, which trips
+  // -Wuninitialized inside GCC's own headers
+  float lanes[16];
+  _mm512_storeu_ps(lanes, _mm512_add_ps(sum0, sum1));
+  return sumOfSquaresScalar(a + idx, count - idx) +
+         ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+         ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7])) +
+         ((lanes[8] + lanes[9]) + (lanes[10] + lanes[11])) +
+         ((lanes[12] + lanes[13]) + (lanes[14] + lanes[15]));
+}
+
+const KernelTable avx512_table{
+    InstructionSet::AVX512,
+    binaryAVX512<AddOp>,
+    binaryAVX512<SubOp>,
+    binaryAVX512<MultiplyOp>,
+    binaryAVX512<DivideOp>,
+    broadcastAVX512<MultiplyOp>,
+    broadcastAVX512<DivideOp>,
+    ternaryAVX512<MultiplyAddOp>,
+    ternaryAVX512<MultiplySubOp>,
+    broadcastTernaryAVX512<MultiplyAddOp>,
+    unaryAVX512<SqrtOp>,
+    fillAVX512,
+    sumOfSquaresAVX512};
+#endif
+
+// --------------------------------- NEON ---------------------------------
+#ifdef ELEMENT_KERNELS_NEON
+template <typename Op>
+void binaryNEON(const float *a, const float *b, float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    vst1q_f32(result + idx, Op::NEON(vld1q_f32(a + idx), vld1q_f32(b + idx)));
+  }
+  binaryScalar<Op>(a + idx, b + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+void broadcastNEON(const float *a, float scalar, float *result, size_t count)
+{
+  const float32x4_t scalar_vector{vdupq_n_f32(scalar)};
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    vst1q_f32(result + idx, Op::NEON(vld1q_f32(a + idx), scalar_vector));
+  }
+  broadcastScalar<Op>(a + idx, scalar, result + idx, count - idx);
+}
+
+template <typename Op>
+void ternaryNEON(const float *a, const float *b, const float *c, float *result,
+                 size_t count)
+{
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    vst1q_f32(result + idx, Op::NEON(vld1q_f32(a + idx),
+                                     vld1q_f32(b + idx),
+                                     vld1q_f32(c + idx)));
+  }
+  ternaryScalar<Op>(a + idx, b + idx, c + idx, result + idx, count - idx);
+}
+
+template <typename Op>
+void broadcastTernaryNEON(const float *a, float scalar, const float *c,
+                          float *result, size_t count)
+{
+  const float32x4_t scalar_vector{vdupq_n_f32(scalar)};
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    vst1q_f32(result + idx, Op::NEON(vld1q_f32(a + idx), scalar_vector,
+                                     vld1q_f32(c + idx)));
+  }
+  broadcastTernaryScalar<Op>(a + idx, scalar, c + idx, result + idx,
+                             count - idx);
+}
+
+template <typename Op>
+void unaryNEON(const float *a, float *result, size_t count)
+{
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    vst1q_f32(result + idx, Op::NEON(vld1q_f32(a + idx)));
+  }
+  unaryScalar<Op>(a + idx, result + idx, count - idx);
+}
+
+void fillNEON(float *result, float value, size_t count)
+{
+  const float32x4_t value_vector{vdupq_n_f32(value)};
+  size_t idx{0};
+  for (; idx + 4 <= count; idx += 4)
+  {
+    vst1q_f32(result + idx, value_vector);
+  }
+  fillScalar(result + idx, value, count - idx);
+}
+
+float sumOfSquaresNEON(const float *a, size_t count)
+{
+  float32x4_t sum0{vdupq_n_f32(0)};
+  float32x4_t sum1{vdupq_n_f32(0)};
+  size_t idx{0};
+  for (; idx + 8 <= count; idx += 8)
+  {
+    const float32x4_t value0{vld1q_f32(a + idx)};
+    const float32x4_t value1{vld1q_f32(a + idx + 4)};
+    sum0 = vmlaq_f32(sum0, value0, value0);
+    sum1 = vmlaq_f32(sum1, value1, value1);
+  }
+  const float32x4_t sum{vaddq_f32(sum0, sum1)};
+#if defined(__aarch64__)
+  const float total{vaddvq_f32(sum)};
+#else
+  const float32x2_t pairs{vadd_f32(vget_low_f32(sum), vget_high_f32(sum))};
+  const float total{vget_lane_f32(vpadd_f32(pairs, pairs), 0)};
+#endif
+  return total + sumOfSquaresScalar(a + idx, count - idx);
+}
+
+const KernelTable neon_table{
+    InstructionSet::NEON,
+    binaryNEON<AddOp>,
+    binaryNEON<SubOp>,
+    binaryNEON<MultiplyOp>,
+#if defined(__aarch64__)
+    binaryNEON<DivideOp>,
+    broadcastNEON<MultiplyOp>,
+    broadcastNEON<DivideOp>,
+#else
+    binaryScalar<DivideOp>,
+    broadcastNEON<MultiplyOp>,
+    broadcastScalar<DivideOp>,
+#endif
+    ternaryNEON<MultiplyAddOp>,
+    ternaryNEON<MultiplySubOp>,
+    broadcastTernaryNEON<MultiplyAddOp>,
+#if defined(__aarch64__)
+    unaryNEON<SqrtOp>,
+#else
+    unaryScalar<SqrtOp>,
+#endif
+    fillNEON,
+    sumOfSquaresNEON};
+#endif
+
+// ------------------------------- Dispatch -------------------------------
+const KernelTable *tableFor(InstructionSet instruction_set)
+{
+  switch (instruction_set)
+  {
+  case InstructionSet::Scalar:
+    return &scalar_table;
+#ifdef ELEMENT_KERNELS_SSE2
+  case InstructionSet::SSE2:
+    return &sse2_table;
+#endif
+#ifdef ELEMENT_KERNELS_AVX
+  case InstructionSet::AVX2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? &avx2_table : nullptr;
+  case InstructionSet::AVX512:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") ? &avx512_table : nullptr;
+#endif
+#ifdef ELEMENT_KERNELS_NEON
+  case InstructionSet::NEON:
+    return &neon_table;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+const KernelTable *bestTable()
+{
+  // try the widest instruction sets first
+  const InstructionSet preference[]{InstructionSet::AVX512,
+                                    InstructionSet::AVX2,
+                                    InstructionSet::NEON,
+                                    InstructionSet::SSE2};
+  for (InstructionSet instruction_set : preference)
+  {
+    const KernelTable *table{tableFor(instruction_set)};
+    if (table != nullptr)
+    {
+      return table;
+    }
+  }
+  return &scalar_table;
+}
+
+const KernelTable *&activeTable()
+{
+  // picked once, the first time any kernel runs
+  static const KernelTable *table{bestTable()};
+  return table;
+}
+
+// call kernel(begin, end) over [0, count), split into chunks across the
+// thread pool when the arrays are big enough to be worth it
+template <typename Kernel>
+void forChunks(size_t count, const Kernel &kernel)
+{
+#ifdef MATRIX_THREADS
+  if (count >= Parallel::element_threshold && Parallel::Pool() != nullptr)
+  {
+    Parallel::ForChunks(
+        count, Parallel::element_chunk,
+        [](size_t begin, size_t end, void *context) {
+          (*static_cast<const Kernel *>(context))(begin, end);
+        },
+        const_cast<Kernel *>(&kernel));
+    return;
+  }
+#endif
+  kernel(0, count);
+}
+} // namespace
+
+namespace ElementKernels
+{
+InstructionSet ActiveInstructionSet()
+{
+  return activeTable()->instruction_set;
+}
+
+bool IsSupported(InstructionSet instruction_set)
+{
+  return tableFor(instruction_set) != nullptr;
+}
+
+bool UseInstructionSet(InstructionSet instruction_set)
+{
+  const KernelTable *table{tableFor(instruction_set)};
+  if (table == nullptr)
+  {
+    return false;
+  }
+  activeTable() = table;
+  return true;
+}
+
+void Add(const float *a, const float *b, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->add(a + begin, b + begin, result + begin, end - begin);
+  });
+}
+
+void Sub(const float *a, const float *b, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->sub(a + begin, b + begin, result + begin, end - begin);
+  });
+}
+
+void Multiply(const float *a, const float *b, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->multiply(a + begin, b + begin, result + begin, end - begin);
+  });
+}
+
+void Divide(const float *a, const float *b, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->divide(a + begin, b + begin, result + begin, end - begin);
+  });
+}
+
+void Scale(const float *a, float scalar, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->scale(a + begin, scalar, result + begin, end - begin);
+  });
+}
+
+void DivideScalar(const float *a, float scalar, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->divide_scalar(a + begin, scalar, result + begin, end - begin);
+  });
+}
+
+void MultiplyAdd(const float *a, const float *b, const float *c, float *result,
+                 size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->multiply_add(a + begin, b + begin, c + begin, result + begin,
+                   end - begin);
+  });
+}
+
+void MultiplySub(const float *a, const float *b, const float *c, float *result,
+                 size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->multiply_sub(a + begin, b + begin, c + begin, result + begin,
+                   end - begin);
+  });
+}
+
+void ScaleAdd(const float *a, float scalar, const float *c, float *result,
+              size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->scale_add(a + begin, scalar, c + begin, result + begin,
+                     end - begin);
+  });
+}
+
+void Sqrt(const float *a, float *result, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->sqrt(a + begin, result + begin, end - begin);
+  });
+}
+
+void Fill(float *result, float value, size_t count)
+{
+  const KernelTable *table{activeTable()};
+  forChunks(count, [=](size_t begin, size_t end) {
+    table->fill(result + begin, value, end - begin);
+  });
+}
+
+float SumOfSquares(const float *a, size_t count)
+{
+  // stays on one thread, splitting the sum would change the rounding with the
+  // thread count
+  return activeTable()->sum_of_squares(a, count);
+}
+} // namespace ElementKernels
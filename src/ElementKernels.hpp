@@ -0,0 +1,279 @@
+#ifndef ELEMENT_KERNELS_H_
+#define ELEMENT_KERNELS_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "ScalarTraits.hpp"
+
+/**
+ * @brief Vectorized element-wise kernels over contiguous float arrays.
+ * The fastest implementation the CPU supports is picked the first time any
+ * kernel is called, so one binary runs well on every machine it lands on.
+ *
+ * The templates at the bottom are the same kernels for every other element
+ * type. They're plain loops the compiler is left to vectorize on its own.
+ */
+namespace ElementKernels
+{
+/**
+ * @brief Arrays with fewer elements than this aren't worth an out of line
+ * call, so the matrix types keep them in a plain inline loop
+ */
+constexpr uint16_t dispatch_threshold{16};
+
+enum class InstructionSet : uint8_t
+{
+  Scalar,
+  SSE2,
+  AVX2,
+  AVX512,
+  NEON
+};
+
+/**
+ * @return The instruction set the kernels are currently running on
+ */
+InstructionSet ActiveInstructionSet();
+
+/**
+ * @return true if this CPU (and this build) can run the given instruction set
+ */
+bool IsSupported(InstructionSet instruction_set);
+
+/**
+ * @brief Force the kernels onto a specific instruction set. Mostly useful for
+ * testing the slower paths on a fast machine.
+ * @return false if the instruction set isn't supported. The active
+ * instruction set doesn't change in that case.
+ * @warning don't call this while other threads are running kernels
+ */
+bool UseInstructionSet(InstructionSet instruction_set);
+
+/**
+ * @brief result[i] = a[i] + b[i]
+ * @note result may be the same array as a or b
+ */
+void Add(const float *a, const float *b, float *result, size_t count);
+
+/**
+ * @brief result[i] = a[i] - b[i]
+ * @note result may be the same array as a or b
+ */
+void Sub(const float *a, const float *b, float *result, size_t count);
+
+/**
+ * @brief result[i] = a[i] * b[i]
+ * @note result may be the same array as a or b
+ */
+void Multiply(const float *a, const float *b, float *result, size_t count);
+
+/**
+ * @brief result[i] = a[i] / b[i]
+ * @note result may be the same array as a or b
+ */
+void Divide(const float *a, const float *b, float *result, size_t count);
+
+/**
+ * @brief result[i] = a[i] * scalar
+ * @note result may be the same array as a
+ */
+void Scale(const float *a, float scalar, float *result, size_t count);
+
+/**
+ * @brief result[i] = a[i] / scalar
+ * @note result may be the same array as a
+ */
+void DivideScalar(const float *a, float scalar, float *result, size_t count);
+
+/**
+ * @brief result[i] = a[i] * b[i] + c[i]
+ * @note result may be the same array as a, b or c
+ */
+void MultiplyAdd(const float *a, const float *b, const float *c, float *result,
+                 size_t count);
+
+/**
+ * @brief result[i] = a[i] * b[i] - c[i]
+ * @note result may be the same array as a, b or c
+ */
+void MultiplySub(const float *a, const float *b, const float *c, float *result,
+                 size_t count);
+
+/**
+ * @brief result[i] = a[i] * scalar + c[i]
+ * @note result may be the same array as a or c
+ */
+void ScaleAdd(const float *a, float scalar, const float *c, float *result,
+              size_t count);
+
+/**
+ * @brief result[i] = sqrt(a[i])
+ * @note result may be the same array as a
+ */
+void Sqrt(const float *a, float *result, size_t count);
+
+/**
+ * @brief result[i] = value
+ */
+void Fill(float *result, float value, size_t count);
+
+/**
+ * @return the sum of a[i] * a[i]
+ */
+float SumOfSquares(const float *a, size_t count);
+
+/**
+ * @brief result[i] = a[i] + b[i] for element types other than float
+ */
+template <typename Type>
+void Add(const Type *a, const Type *b, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] + b[idx];
+  }
+}
+
+/**
+ * @brief result[i] = a[i] - b[i] for element types other than float
+ */
+template <typename Type>
+void Sub(const Type *a, const Type *b, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] - b[idx];
+  }
+}
+
+/**
+ * @brief result[i] = a[i] * b[i] for element types other than float
+ */
+template <typename Type>
+void Multiply(const Type *a, const Type *b, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] * b[idx];
+  }
+}
+
+/**
+ * @brief result[i] = a[i] / b[i] for element types other than float
+ */
+template <typename Type>
+void Divide(const Type *a, const Type *b, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] / b[idx];
+  }
+}
+
+/**
+ * @brief result[i] = a[i] * scalar for element types other than float
+ */
+template <typename Type>
+void Scale(const Type *a, Type scalar, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] * scalar;
+  }
+}
+
+/**
+ * @brief result[i] = a[i] / scalar for element types other than float
+ */
+template <typename Type>
+void DivideScalar(const Type *a, Type scalar, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] / scalar;
+  }
+}
+
+/**
+ * @brief result[i] = a[i] * b[i] + c[i] for element types other than float
+ */
+template <typename Type>
+void MultiplyAdd(const Type *a, const Type *b, const Type *c, Type *result,
+                 size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] * b[idx] + c[idx];
+  }
+}
+
+/**
+ * @brief result[i] = a[i] * b[i] - c[i] for element types other than float
+ */
+template <typename Type>
+void MultiplySub(const Type *a, const Type *b, const Type *c, Type *result,
+                 size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] * b[idx] - c[idx];
+  }
+}
+
+/**
+ * @brief result[i] = a[i] * scalar + c[i] for element types other than float
+ */
+template <typename Type>
+void ScaleAdd(const Type *a, Type scalar, const Type *c, Type *result,
+              size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = a[idx] * scalar + c[idx];
+  }
+}
+
+/**
+ * @brief result[i] = sqrt(a[i]) for element types other than float
+ */
+template <typename Type>
+void Sqrt(const Type *a, Type *result, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = static_cast<Type>(std::sqrt(a[idx]));
+  }
+}
+
+/**
+ * @brief result[i] = value for element types other than float
+ */
+template <typename Type>
+void Fill(Type *result, Type value, size_t count)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result[idx] = value;
+  }
+}
+
+/**
+ * @return the sum of a[i] * a[i] for element types other than float, summed
+ * in the type's accumulator
+ */
+template <typename Type>
+typename ScalarTraits<Type>::Accumulator SumOfSquares(const Type *a,
+                                                      size_t count)
+{
+  typename ScalarTraits<Type>::Accumulator sum{0};
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    sum += ScalarTraits<Type>::Product(a[idx], a[idx]);
+  }
+  return sum;
+}
+} // namespace ElementKernels
+
+#endif // ELEMENT_KERNELS_H_
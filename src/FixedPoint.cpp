@@ -0,0 +1,484 @@
+#ifdef FIXED_POINT_H_ // since the .cpp file has to be included by the .hpp file
+                     // this will evaluate to true
+#include "FixedPoint.hpp"
+
+namespace FixedPoint
+{
+namespace detail
+{
+// storage up to 32 bits multiplies and divides in plain integers, 64 bit
+// storage needs the 128 bit helpers below
+template <typename Storage>
+using IsNarrow = std::integral_constant<bool, (sizeof(Storage) <= 4)>;
+
+// an unsigned integer that can hold the product of two magnitudes of Storage.
+// 16 bit storage stays in 32 bits, which is a single instruction on a
+// Cortex-M0 where 64 bit math is a library call.
+template <typename Storage>
+using UnsignedProduct =
+    typename std::conditional<(sizeof(Storage) <= 2), uint32_t,
+                              uint64_t>::type;
+
+// an unsigned 128 bit integer, enough for the products of 64 bit storage
+struct Wide
+{
+  uint64_t high;
+  uint64_t low;
+};
+
+constexpr Wide multiplyWide(uint64_t left, uint64_t right)
+{
+  const uint64_t left_low{left & 0xFFFFFFFF};
+  const uint64_t left_high{left >> 32};
+  const uint64_t right_low{right & 0xFFFFFFFF};
+  const uint64_t right_high{right >> 32};
+
+  const uint64_t low_low{left_low * right_low};
+  const uint64_t low_high{left_low * right_high};
+  const uint64_t high_low{left_high * right_low};
+  const uint64_t high_high{left_high * right_high};
+
+  const uint64_t middle{(low_low >> 32) + (low_high & 0xFFFFFFFF) +
+                        (high_low & 0xFFFFFFFF)};
+  return Wide{high_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32),
+              (middle << 32) | (low_low & 0xFFFFFFFF)};
+}
+
+constexpr Wide add(Wide value, uint64_t addend)
+{
+  const uint64_t low{value.low + addend};
+  return Wide{value.high + (low < value.low ? 1 : 0), low};
+}
+
+constexpr Wide shiftLeft(uint64_t value, uint8_t shift)
+{
+  if (shift == 0)
+  {
+    return Wide{0, value};
+  }
+  if (shift >= 64)
+  {
+    return Wide{value << (shift - 64), 0};
+  }
+  return Wide{value >> (64 - shift), value << shift};
+}
+
+constexpr Wide shiftRight(Wide value, uint8_t shift)
+{
+  if (shift == 0)
+  {
+    return value;
+  }
+  if (shift >= 64)
+  {
+    return Wide{0, value.high >> (shift - 64)};
+  }
+  return Wide{value.high >> shift,
+              (value.low >> shift) | (value.high << (64 - shift))};
+}
+
+// numerator / divisor, or the biggest uint64_t if the quotient doesn't fit
+constexpr uint64_t divideWide(Wide numerator, uint64_t divisor)
+{
+  if (numerator.high >= divisor)
+  {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  // restoring long division. The remainder is always below the divisor, so
+  // only the bit shifted out of it needs to be remembered.
+  uint64_t remainder{numerator.high};
+  uint64_t quotient{0};
+  for (int8_t bit{63}; bit >= 0; bit--)
+  {
+    const bool carry{(remainder >> 63) != 0};
+    remainder = (remainder << 1) | ((numerator.low >> bit) & 1);
+    quotient <<= 1;
+    if (carry || remainder >= divisor)
+    {
+      remainder -= divisor;
+      quotient |= 1;
+    }
+  }
+  return quotient;
+}
+
+template <typename Storage>
+constexpr uint64_t magnitude(Storage value)
+{
+  return value < 0 ? 0 - static_cast<uint64_t>(value)
+                   : static_cast<uint64_t>(value);
+}
+
+// turn a magnitude and a sign back into Storage, saturating
+template <typename Storage>
+constexpr Storage fromMagnitude(uint64_t value, bool negative)
+{
+  constexpr uint64_t limit{
+      static_cast<uint64_t>(std::numeric_limits<Storage>::max())};
+  if (negative)
+  {
+    return value > limit ? std::numeric_limits<Storage>::lowest()
+                         : static_cast<Storage>(-static_cast<Storage>(value));
+  }
+  return value > limit ? std::numeric_limits<Storage>::max()
+                       : static_cast<Storage>(value);
+}
+
+// (left * right) >> shift rounded to nearest, as Result
+template <typename Result, typename Storage>
+constexpr Result multiply(Storage left, Storage right, uint8_t shift,
+                          std::true_type)
+{
+  using Unsigned = UnsignedProduct<Storage>;
+  const Unsigned product{static_cast<Unsigned>(magnitude(left)) *
+                         static_cast<Unsigned>(magnitude(right))};
+  const Unsigned half{shift > 0 ? Unsigned{1} << (shift - 1) : 0};
+  return fromMagnitude<Result>((product + half) >> shift,
+                               (left < 0) != (right < 0));
+}
+
+template <typename Result, typename Storage>
+constexpr Result multiply(Storage left, Storage right, uint8_t shift,
+                          std::false_type)
+{
+  const bool negative{(left < 0) != (right < 0)};
+  Wide product{multiplyWide(magnitude(left), magnitude(right))};
+  if (shift > 0)
+  {
+    product = add(product, uint64_t{1} << (shift - 1));
+  }
+  product = shiftRight(product, shift);
+  if (product.high != 0)
+  {
+    return negative ? std::numeric_limits<Result>::lowest()
+                    : std::numeric_limits<Result>::max();
+  }
+  return fromMagnitude<Result>(product.low, negative);
+}
+
+// (numerator << shift) / divisor rounded to nearest, from magnitudes
+template <typename Storage>
+constexpr Storage divide(uint64_t numerator, uint8_t shift, uint64_t divisor,
+                         bool negative, std::true_type)
+{
+  using Unsigned = UnsignedProduct<Storage>;
+  const Unsigned shifted{static_cast<Unsigned>(numerator) << shift};
+  return fromMagnitude<Storage>(
+      (shifted + static_cast<Unsigned>(divisor / 2)) /
+          static_cast<Unsigned>(divisor),
+      negative);
+}
+
+template <typename Storage>
+constexpr Storage divide(uint64_t numerator, uint8_t shift, uint64_t divisor,
+                         bool negative, std::false_type)
+{
+  const Wide shifted{add(shiftLeft(numerator, shift), divisor / 2)};
+  return fromMagnitude<Storage>(divideWide(shifted, divisor), negative);
+}
+
+template <typename Storage>
+constexpr Storage saturatingAdd(Storage left, Storage right)
+{
+  constexpr Storage max{std::numeric_limits<Storage>::max()};
+  constexpr Storage lowest{std::numeric_limits<Storage>::lowest()};
+  if (right > 0 && left > max - right)
+  {
+    return max;
+  }
+  if (right < 0 && left < lowest - right)
+  {
+    return lowest;
+  }
+  return static_cast<Storage>(left + right);
+}
+
+template <typename Storage>
+constexpr Storage saturatingSub(Storage left, Storage right)
+{
+  constexpr Storage max{std::numeric_limits<Storage>::max()};
+  constexpr Storage lowest{std::numeric_limits<Storage>::lowest()};
+  if (right < 0 && left > max + right)
+  {
+    return max;
+  }
+  if (right > 0 && left < lowest + right)
+  {
+    return lowest;
+  }
+  return static_cast<Storage>(left - right);
+}
+
+// value * 2^shift for floating point values
+template <typename Storage, typename Number>
+constexpr Storage fromNumber(Number value, uint8_t shift, std::true_type)
+{
+  if (value != value)
+  {
+    return 0;
+  }
+  // powers of 2 are exact in double, so these don't round
+  const double bound{
+      static_cast<double>(uint64_t{1} << std::numeric_limits<Storage>::digits)};
+  const double scaled{static_cast<double>(value) *
+                      static_cast<double>(uint64_t{1} << shift)};
+  const double rounded{scaled < 0 ? scaled - 0.5 : scaled + 0.5};
+  if (rounded >= bound)
+  {
+    return std::numeric_limits<Storage>::max();
+  }
+  if (rounded <= -bound)
+  {
+    return std::numeric_limits<Storage>::lowest();
+  }
+  return static_cast<Storage>(static_cast<int64_t>(rounded));
+}
+
+// value * 2^shift for integers
+template <typename Storage, typename Number>
+constexpr Storage fromNumber(Number value, uint8_t shift, std::false_type)
+{
+  const bool negative{value < 0};
+  const uint64_t value_magnitude{
+      negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value)};
+  // one past the limit still fits when it's negative, it's the lowest value
+  const uint64_t limit{
+      (static_cast<uint64_t>(std::numeric_limits<Storage>::max()) >> shift) + 1};
+  if (value_magnitude > limit)
+  {
+    return negative ? std::numeric_limits<Storage>::lowest()
+                    : std::numeric_limits<Storage>::max();
+  }
+  return fromMagnitude<Storage>(value_magnitude << shift, negative);
+}
+
+// rescale a raw value from one number of fraction bits to another
+template <typename Storage, typename OtherStorage>
+constexpr Storage rescale(OtherStorage raw, uint8_t from_bits, uint8_t to_bits)
+{
+  const bool negative{raw < 0};
+  uint64_t value{magnitude(raw)};
+  if (from_bits > to_bits)
+  {
+    const uint8_t shift = from_bits - to_bits;
+    const uint64_t half{uint64_t{1} << (shift - 1)};
+    // adding half can only overflow when value is already the biggest one
+    value = value > std::numeric_limits<uint64_t>::max() - half
+                ? (value >> shift) + 1
+                : (value + half) >> shift;
+  }
+  else if (to_bits > from_bits)
+  {
+    const uint8_t shift = to_bits - from_bits;
+    if (value > (std::numeric_limits<uint64_t>::max() >> shift))
+    {
+      return negative ? std::numeric_limits<Storage>::lowest()
+                      : std::numeric_limits<Storage>::max();
+    }
+    value <<= shift;
+  }
+  return fromMagnitude<Storage>(value, negative);
+}
+} // namespace detail
+
+template <typename Storage, uint8_t fraction_bits>
+template <typename Number,
+          typename std::enable_if<std::is_arithmetic<Number>::value, int>::type>
+constexpr Fixed<Storage, fraction_bits>::Fixed(Number value)
+    : raw(detail::fromNumber<Storage>(
+          value, fraction_bits,
+          std::integral_constant<bool,
+                                 std::is_floating_point<Number>::value>{}))
+{
+}
+
+template <typename Storage, uint8_t fraction_bits>
+template <typename OtherStorage,
+          typename std::enable_if<(sizeof(OtherStorage) < sizeof(Storage)),
+                                  int>::type>
+constexpr Fixed<Storage, fraction_bits>::Fixed(
+    Fixed<OtherStorage, fraction_bits> other)
+    : raw(other.Raw())
+{
+}
+
+template <typename Storage, uint8_t fraction_bits>
+template <typename OtherStorage, uint8_t other_fraction_bits,
+          typename std::enable_if<
+              !(sizeof(OtherStorage) < sizeof(Storage) &&
+                other_fraction_bits == fraction_bits),
+              int>::type>
+constexpr Fixed<Storage, fraction_bits>::Fixed(
+    Fixed<OtherStorage, other_fraction_bits> other)
+    : raw(detail::rescale<Storage>(other.Raw(), other_fraction_bits,
+                                   fraction_bits))
+{
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits>
+Fixed<Storage, fraction_bits>::FromRaw(Storage raw)
+{
+  Fixed<Storage, fraction_bits> value{};
+  value.raw = raw;
+  return value;
+}
+
+template <typename Storage, uint8_t fraction_bits>
+template <typename Number,
+          typename std::enable_if<std::is_arithmetic<Number>::value, int>::type>
+constexpr Fixed<Storage, fraction_bits>::operator Number() const
+{
+  if (std::is_floating_point<Number>::value)
+  {
+    return static_cast<Number>(
+        static_cast<double>(this->raw) /
+        static_cast<double>(uint64_t{1} << fraction_bits));
+  }
+
+  // shift the magnitude so the integer part rounds towards zero
+  const uint64_t whole{detail::magnitude(this->raw) >> fraction_bits};
+  return this->raw < 0 ? static_cast<Number>(-static_cast<int64_t>(whole))
+                       : static_cast<Number>(whole);
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> Fixed<Storage, fraction_bits>::Max()
+{
+  return FromRaw(std::numeric_limits<Storage>::max());
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> Fixed<Storage, fraction_bits>::Lowest()
+{
+  return FromRaw(std::numeric_limits<Storage>::lowest());
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> Fixed<Storage, fraction_bits>::Epsilon()
+{
+  return FromRaw(1);
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> &
+Fixed<Storage, fraction_bits>::operator+=(Fixed<Storage, fraction_bits> other)
+{
+  this->raw = detail::saturatingAdd(this->raw, other.raw);
+  return *this;
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> &
+Fixed<Storage, fraction_bits>::operator-=(Fixed<Storage, fraction_bits> other)
+{
+  this->raw = detail::saturatingSub(this->raw, other.raw);
+  return *this;
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> &
+Fixed<Storage, fraction_bits>::operator*=(Fixed<Storage, fraction_bits> other)
+{
+  this->raw = detail::multiply<Storage>(this->raw, other.raw, fraction_bits,
+                                        detail::IsNarrow<Storage>{});
+  return *this;
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits> &
+Fixed<Storage, fraction_bits>::operator/=(Fixed<Storage, fraction_bits> other)
+{
+  if (other.raw == 0)
+  {
+    // saturate towards the sign of the dividend, 0 / 0 stays 0
+    this->raw = this->raw == 0  ? 0
+                : this->raw > 0 ? std::numeric_limits<Storage>::max()
+                                : std::numeric_limits<Storage>::lowest();
+    return *this;
+  }
+
+  this->raw = detail::divide<Storage>(
+      detail::magnitude(this->raw), fraction_bits,
+      detail::magnitude(other.raw), (this->raw < 0) != (other.raw < 0),
+      detail::IsNarrow<Storage>{});
+  return *this;
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits>
+Fixed<Storage, fraction_bits>::operator-() const
+{
+  return FromRaw(detail::saturatingSub(Storage{0}, this->raw));
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits>
+Sqrt(Fixed<Storage, fraction_bits> value)
+{
+  constexpr uint8_t bits{std::numeric_limits<Storage>::digits + fraction_bits};
+  static_assert(bits <= 122, "The fixed point type is too wide for Sqrt");
+
+  if (value.Raw() <= 0)
+  {
+    return Fixed<Storage, fraction_bits>{};
+  }
+
+  // the root of raw * 2^fraction_bits is the raw root. Work it out two bits of
+  // the radicand at a time, the way long division works out a quotient.
+  const uint64_t radicand{static_cast<uint64_t>(value.Raw())};
+  uint64_t root{0};
+  uint64_t remainder{0};
+  for (int16_t bit = (bits + 1) / 2 * 2 - 1; bit > 0; bit -= 2)
+  {
+    const uint64_t high_bit{bit >= fraction_bits
+                                ? (radicand >> (bit - fraction_bits)) & 1
+                                : 0};
+    const uint64_t low_bit{bit - 1 >= fraction_bits
+                               ? (radicand >> (bit - 1 - fraction_bits)) & 1
+                               : 0};
+    remainder = (remainder << 2) | (high_bit << 1) | low_bit;
+    const uint64_t trial{(root << 2) | 1};
+    root <<= 1;
+    if (remainder >= trial)
+    {
+      remainder -= trial;
+      root |= 1;
+    }
+  }
+  return Fixed<Storage, fraction_bits>::FromRaw(static_cast<Storage>(root));
+}
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits>
+Reciprocal(Fixed<Storage, fraction_bits> value)
+{
+  if (value.Raw() == 0)
+  {
+    return Fixed<Storage, fraction_bits>::Max();
+  }
+  // 1 is 1 << fraction_bits, so the raw reciprocal is 2^(2 * fraction_bits)
+  // divided by raw
+  return Fixed<Storage, fraction_bits>::FromRaw(detail::divide<Storage>(
+      1, 2 * fraction_bits, detail::magnitude(value.Raw()), value.Raw() < 0,
+      std::integral_constant<bool, (2 * fraction_bits < 64 &&
+                                    sizeof(Storage) <= 4)>{}));
+}
+} // namespace FixedPoint
+
+template <typename Storage, uint8_t fraction_bits>
+constexpr typename ScalarTraits<
+    FixedPoint::Fixed<Storage, fraction_bits>>::Accumulator
+ScalarTraits<FixedPoint::Fixed<Storage, fraction_bits>>::Product(Type left,
+                                                                 Type right)
+{
+  // the product of two magnitudes of Storage always fits the narrow path's
+  // integers, only the result is wider
+  return Accumulator::FromRaw(
+      FixedPoint::detail::multiply<typename Accumulator::RawType>(
+          left.Raw(), right.Raw(), fraction_bits,
+          FixedPoint::detail::IsNarrow<Storage>{}));
+}
+
+#endif // FIXED_POINT_H_
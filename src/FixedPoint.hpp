@@ -0,0 +1,246 @@
+#ifndef FIXED_POINT_H_
+#define FIXED_POINT_H_
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "ScalarTraits.hpp"
+
+/**
+ * @brief Saturating fixed-point numbers for parts without an FPU. On a
+ * Cortex-M0 every float operation is a call into the soft-float library, while
+ * a fixed-point add is a single instruction and a multiply is an integer
+ * multiply and a shift.
+ *
+ * Fixed<Storage, fraction_bits> stores value * 2^fraction_bits in a signed
+ * integer. Every operation rounds to nearest and saturates at the ends of the
+ * range instead of wrapping, and division by zero saturates towards the sign of
+ * the dividend. Products and quotients are computed at twice the storage width
+ * (64 bits for 32 bit storage) and then narrowed, so nothing is lost in the
+ * middle of an operation.
+ *
+ * They work as the element type of Matrix, see ScalarTraits below for how the
+ * matrix code sums them.
+ *
+ * @code
+ * Matrix<3, 3, FixedPoint::Q16_16> rotation{...};
+ * Matrix<3, 1, FixedPoint::Q16_16> rotated{rotation * vector};
+ * @endcode
+ *
+ * @note Q15 and Q31 can't hold 1, it saturates to 1 - 2^-15 (or 2^-31). That
+ * includes the diagonal of Identity.
+ * @note converting from float or double is only free for constants, at run time
+ * it's a soft-float call like any other
+ */
+namespace FixedPoint
+{
+template <typename Storage, uint8_t fraction_bits>
+class Fixed
+{
+  static_assert(std::is_signed<Storage>::value &&
+                    std::is_integral<Storage>::value,
+                "Fixed point storage has to be a signed integer");
+  static_assert(fraction_bits < std::numeric_limits<Storage>::digits + 1,
+                "There are more fraction bits than the storage has");
+
+public:
+  using RawType = Storage;
+  static constexpr uint8_t fraction{fraction_bits};
+
+  /**
+   * @brief Create a zero
+   */
+  constexpr Fixed() = default;
+
+  /**
+   * @brief Convert an integer or floating point value, saturating it to the
+   * range of the type
+   */
+  template <typename Number,
+            typename std::enable_if<std::is_arithmetic<Number>::value,
+                                    int>::type = 0>
+  constexpr Fixed(Number value);
+
+  /**
+   * @brief Widen a fixed-point value with the same fraction and narrower
+   * storage. This one is exact, so it's implicit.
+   */
+  template <typename OtherStorage,
+            typename std::enable_if<(sizeof(OtherStorage) < sizeof(Storage)),
+                                    int>::type = 0>
+  constexpr Fixed(Fixed<OtherStorage, fraction_bits> other);
+
+  /**
+   * @brief Convert any other fixed-point value, rounding and saturating it
+   */
+  template <typename OtherStorage, uint8_t other_fraction_bits,
+            typename std::enable_if<
+                !(sizeof(OtherStorage) < sizeof(Storage) &&
+                  other_fraction_bits == fraction_bits),
+                int>::type = 0>
+  constexpr explicit Fixed(Fixed<OtherStorage, other_fraction_bits> other);
+
+  /**
+   * @brief Create a value straight from its stored integer
+   */
+  static constexpr Fixed FromRaw(Storage raw);
+
+  /**
+   * @return The stored integer, value * 2^fraction_bits
+   */
+  constexpr Storage Raw() const { return this->raw; }
+
+  /**
+   * @brief Convert to an integer (rounding towards zero) or floating point
+   */
+  template <typename Number,
+            typename std::enable_if<std::is_arithmetic<Number>::value,
+                                    int>::type = 0>
+  constexpr explicit operator Number() const;
+
+  /**
+   * @return The biggest value the type can hold
+   */
+  static constexpr Fixed Max();
+
+  /**
+   * @return The most negative value the type can hold
+   */
+  static constexpr Fixed Lowest();
+
+  /**
+   * @return The smallest step between two values, 2^-fraction_bits
+   */
+  static constexpr Fixed Epsilon();
+
+  constexpr Fixed &operator+=(Fixed other);
+  constexpr Fixed &operator-=(Fixed other);
+  constexpr Fixed &operator*=(Fixed other);
+  constexpr Fixed &operator/=(Fixed other);
+  constexpr Fixed operator-() const;
+
+  // defined here so ints and floats convert on either side of the operator
+  friend constexpr Fixed operator+(Fixed left, Fixed right)
+  {
+    return left += right;
+  }
+  friend constexpr Fixed operator-(Fixed left, Fixed right)
+  {
+    return left -= right;
+  }
+  friend constexpr Fixed operator*(Fixed left, Fixed right)
+  {
+    return left *= right;
+  }
+  friend constexpr Fixed operator/(Fixed left, Fixed right)
+  {
+    return left /= right;
+  }
+  friend constexpr bool operator==(Fixed left, Fixed right)
+  {
+    return left.raw == right.raw;
+  }
+  friend constexpr bool operator!=(Fixed left, Fixed right)
+  {
+    return left.raw != right.raw;
+  }
+  friend constexpr bool operator<(Fixed left, Fixed right)
+  {
+    return left.raw < right.raw;
+  }
+  friend constexpr bool operator<=(Fixed left, Fixed right)
+  {
+    return left.raw <= right.raw;
+  }
+  friend constexpr bool operator>(Fixed left, Fixed right)
+  {
+    return left.raw > right.raw;
+  }
+  friend constexpr bool operator>=(Fixed left, Fixed right)
+  {
+    return left.raw >= right.raw;
+  }
+
+private:
+  Storage raw{0};
+};
+
+/**
+ * @brief 1 sign bit and 15 fraction bits, [-1, 1)
+ */
+using Q15 = Fixed<int16_t, 15>;
+
+/**
+ * @brief 1 sign bit and 31 fraction bits, [-1, 1)
+ */
+using Q31 = Fixed<int32_t, 31>;
+
+/**
+ * @brief 16 integer bits (including the sign) and 16 fraction bits,
+ * [-32768, 32768)
+ */
+using Q16_16 = Fixed<int32_t, 16>;
+
+/**
+ * @return The square root of value, rounded down. Negative values return 0.
+ * @note integer only, a bit at a time, so it never touches a divider
+ */
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits>
+Sqrt(Fixed<Storage, fraction_bits> value);
+
+/**
+ * @return 1 / value, saturated. Computed from 1 directly, so it also works for
+ * Q15 and Q31 which can't hold 1 themselves.
+ */
+template <typename Storage, uint8_t fraction_bits>
+constexpr Fixed<Storage, fraction_bits>
+Reciprocal(Fixed<Storage, fraction_bits> value);
+} // namespace FixedPoint
+
+/**
+ * @brief Fixed-point sums are accumulated at twice the storage width, and
+ * products are summed at full precision before they're rounded. A Q31 dot
+ * product multiplies 32 bit values into 64 bits and sums them in 64 bits, so
+ * intermediate sums can run well past 1 and only the final result saturates.
+ */
+template <typename Storage, uint8_t fraction_bits>
+struct ScalarTraits<FixedPoint::Fixed<Storage, fraction_bits>>
+{
+  using Type = FixedPoint::Fixed<Storage, fraction_bits>;
+  using Accumulator = FixedPoint::Fixed<
+      typename std::conditional<sizeof(Storage) < sizeof(int64_t),
+                                typename std::conditional<sizeof(Storage) <
+                                                              sizeof(int32_t),
+                                                          int32_t,
+                                                          int64_t>::type,
+                                Storage>::type,
+      fraction_bits>;
+  using Printable = double;
+
+  static constexpr bool is_number{true};
+
+  static constexpr Type epsilon{Type::Epsilon()};
+  static constexpr Type lowest{Type::Lowest()};
+  static constexpr Type max{Type::Max()};
+
+  static constexpr Type Saturate(double value) { return Type{value}; }
+
+  static constexpr Accumulator Product(Type left, Type right);
+};
+
+// let the constexpr math used by the matrix code find the fixed-point versions
+namespace ConstexprMath
+{
+template <typename Storage, uint8_t fraction_bits>
+constexpr FixedPoint::Fixed<Storage, fraction_bits>
+Sqrt(FixedPoint::Fixed<Storage, fraction_bits> value)
+{
+  return FixedPoint::Sqrt(value);
+}
+} // namespace ConstexprMath
+
+#include "FixedPoint.cpp"
+
+#endif // FIXED_POINT_H_
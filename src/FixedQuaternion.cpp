@@ -0,0 +1,125 @@
+#ifdef FIXED_QUATERNION_H_ // since the .cpp file has to be included by the .hpp
+                          // file this will evaluate to true
+
+template <typename Type>
+constexpr FixedQuaternion<Type>::FixedQuaternion(const Quaternion &q)
+    : Matrix<1, 4, Type>(Type{q.w()}, Type{q.v1()}, Type{q.v2()}, Type{q.v3()})
+{
+}
+
+template <typename Type>
+constexpr Quaternion FixedQuaternion<Type>::ToQuaternion() const
+{
+    return Quaternion{static_cast<float>(this->w()), static_cast<float>(this->v1()),
+                      static_cast<float>(this->v2()), static_cast<float>(this->v3())};
+}
+
+template <typename Type>
+constexpr FixedQuaternion<Type> FixedQuaternion<Type>::operator*(const FixedQuaternion &other) const
+{
+    MATRIX_PERF_SCOPE(QuaternionMult, *this * other);
+    FixedQuaternion result{};
+    return this->Q_Mult(other, result);
+}
+
+template <typename Type>
+constexpr FixedQuaternion<Type> &FixedQuaternion<Type>::operator*=(const FixedQuaternion &other)
+{
+    MATRIX_PERF_SCOPE(QuaternionMult, *this *= other);
+    // Q_Mult reads both quaternions before writing, so other can be this one
+    FixedQuaternion result{};
+    *this = this->Q_Mult(other, result);
+    return *this;
+}
+
+template <typename Type>
+constexpr FixedQuaternion<Type> &FixedQuaternion<Type>::operator*=(Type scalar)
+{
+    for (uint8_t idx{0}; idx < 4; idx++)
+    {
+        this->matrix[idx] *= scalar;
+    }
+    return *this;
+}
+
+template <typename Type>
+constexpr FixedQuaternion<Type> &
+FixedQuaternion<Type>::Q_Mult(const FixedQuaternion &other, FixedQuaternion &buffer) const
+{
+    MATRIX_PERF_SCOPE(QuaternionMult, this->Q_Mult(other, buffer));
+    using Traits = ScalarTraits<Type>;
+    const Type w{this->w()};
+    const Type x{this->v1()};
+    const Type y{this->v2()};
+    const Type z{this->v3()};
+    const Type ow{other.w()};
+    const Type ox{other.v1()};
+    const Type oy{other.v2()};
+    const Type oz{other.v3()};
+
+    // eq. 6, each component summed at full width and rounded once
+    buffer.w() = static_cast<Type>(Traits::Product(ow, w) - Traits::Product(ox, x) -
+                                   Traits::Product(oy, y) - Traits::Product(oz, z));
+    buffer.v1() = static_cast<Type>(Traits::Product(ow, x) + Traits::Product(ox, w) -
+                                    Traits::Product(oy, z) + Traits::Product(oz, y));
+    buffer.v2() = static_cast<Type>(Traits::Product(ow, y) + Traits::Product(ox, z) +
+                                    Traits::Product(oy, w) - Traits::Product(oz, x));
+    buffer.v3() = static_cast<Type>(Traits::Product(ow, z) - Traits::Product(ox, y) +
+                                    Traits::Product(oy, x) + Traits::Product(oz, w));
+    return buffer;
+}
+
+template <typename Type>
+constexpr V3D<Type> FixedQuaternion<Type>::Rotate(const V3D<Type> &vector) const
+{
+    MATRIX_PERF_SCOPE(QuaternionRotate, this->Rotate(vector));
+    using Traits = ScalarTraits<Type>;
+    // v' = v + w * t + u x t where u is the vector part and t = 2 * (u x v),
+    // as in Quaternion::Rotate
+    const Type qw{this->w()};
+    const Type qx{this->v1()};
+    const Type qy{this->v2()};
+    const Type qz{this->v3()};
+    const Type tx{static_cast<Type>(Accumulator{2} * (Traits::Product(qy, vector.z) - Traits::Product(qz, vector.y)))};
+    const Type ty{static_cast<Type>(Accumulator{2} * (Traits::Product(qz, vector.x) - Traits::Product(qx, vector.z)))};
+    const Type tz{static_cast<Type>(Accumulator{2} * (Traits::Product(qx, vector.y) - Traits::Product(qy, vector.x)))};
+    return V3D<Type>{
+        static_cast<Type>(Accumulator{vector.x} + Traits::Product(qw, tx) + Traits::Product(qy, tz) - Traits::Product(qz, ty)),
+        static_cast<Type>(Accumulator{vector.y} + Traits::Product(qw, ty) + Traits::Product(qz, tx) - Traits::Product(qx, tz)),
+        static_cast<Type>(Accumulator{vector.z} + Traits::Product(qw, tz) + Traits::Product(qx, ty) - Traits::Product(qy, tx))};
+}
+
+template <typename Type>
+constexpr void FixedQuaternion<Type>::Normalize()
+{
+    MATRIX_PERF_SCOPE(QuaternionNormalize, this->Normalize());
+    const Type magnitude{static_cast<Type>(FixedPoint::Sqrt(this->magnitudeSquared()))};
+    if (magnitude == Type{})
+    {
+        return;
+    }
+    *this *= FixedPoint::Reciprocal(magnitude);
+}
+
+template <typename Type>
+constexpr void FixedQuaternion<Type>::Renormalize()
+{
+    const Accumulator magnitude_squared{this->magnitudeSquared()};
+    *this *= static_cast<Type>((Accumulator{3} - magnitude_squared) * Accumulator{0.5});
+}
+
+template <typename Type>
+constexpr FixedQuaternion<Type> FixedQuaternion<Type>::Conjugate() const
+{
+    return FixedQuaternion{this->w(), -this->v1(), -this->v2(), -this->v3()};
+}
+
+template <typename Type>
+constexpr typename FixedQuaternion<Type>::Accumulator FixedQuaternion<Type>::magnitudeSquared() const
+{
+    using Traits = ScalarTraits<Type>;
+    return Traits::Product(this->w(), this->w()) + Traits::Product(this->v1(), this->v1()) +
+           Traits::Product(this->v2(), this->v2()) + Traits::Product(this->v3(), this->v3());
+}
+
+#endif // FIXED_QUATERNION_H_
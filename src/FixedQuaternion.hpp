@@ -0,0 +1,125 @@
+#ifndef FIXED_QUATERNION_H_
+#define FIXED_QUATERNION_H_
+
+#include <type_traits>
+
+#include "FixedPoint.hpp"
+#include "Matrix.hpp"
+#include "Quaternion.h"
+#include "Vector3D.hpp"
+
+/**
+ * @brief A quaternion w + v1 i + v2 j + v3 k with fixed-point elements, for
+ * attitude updates on parts without an FPU. It does the same multiply,
+ * normalize and rotate as Quaternion, but each component is summed in the
+ * wider ScalarTraits accumulator and rounded once, so a Q16_16 product is as
+ * close to the float one as a Q16_16 can hold.
+ *
+ * @code
+ * FixedQuaternion<> attitude{Quaternion::FromAngleAndAxis(angle, axis)};
+ * attitude *= FixedQuaternion<>{step};
+ * attitude.Renormalize();
+ * @endcode
+ *
+ * @note Q15 and Q31 can't hold 1, so only use them for quaternions that never
+ * get close to the identity. Q16_16 is the one meant for attitudes.
+ */
+template <typename Type = FixedPoint::Q16_16>
+class FixedQuaternion : public Matrix<1, 4, Type>
+{
+    static_assert(std::is_same<Type, FixedPoint::Fixed<typename Type::RawType,
+                                                        Type::fraction>>::value,
+                  "FixedQuaternion is for fixed-point types, use Quaternion for float");
+
+public:
+    using Accumulator = typename ScalarTraits<Type>::Accumulator;
+
+    constexpr FixedQuaternion() : Matrix<1, 4, Type>() {}
+    constexpr FixedQuaternion(Type w, Type v1, Type v2, Type v3) : Matrix<1, 4, Type>(w, v1, v2, v3) {}
+    constexpr FixedQuaternion(const FixedQuaternion &q) = default;
+
+    /**
+     * @brief Convert a float quaternion, rounding and saturating each element
+     */
+    constexpr explicit FixedQuaternion(const Quaternion &q);
+
+    /**
+     * @return The quaternion as floats
+     */
+    constexpr Quaternion ToQuaternion() const;
+
+    constexpr FixedQuaternion &operator=(const FixedQuaternion &other) = default;
+
+    /**
+     * @brief Access the elements of the quaternion by name
+     */
+    constexpr Type &w() { return this->matrix[0]; }
+    constexpr Type w() const { return this->matrix[0]; }
+    constexpr Type &v1() { return this->matrix[1]; }
+    constexpr Type v1() const { return this->matrix[1]; }
+    constexpr Type &v2() { return this->matrix[2]; }
+    constexpr Type v2() const { return this->matrix[2]; }
+    constexpr Type &v3() { return this->matrix[3]; }
+    constexpr Type v3() const { return this->matrix[3]; }
+
+    /**
+     * @brief Do quaternion multiplication
+     */
+    constexpr FixedQuaternion operator*(const FixedQuaternion &other) const;
+
+    /**
+     * @brief Multiply this quaternion by another in place, so
+     * this = this * other
+     * @note other can be this quaternion
+     */
+    constexpr FixedQuaternion &operator*=(const FixedQuaternion &other);
+
+    /**
+     * @brief Scale the quaternion in place
+     */
+    constexpr FixedQuaternion &operator*=(Type scalar);
+
+    /**
+     * @brief Q_Mult a quaternion by another quaternion, the same product as
+     * Quaternion::Q_Mult
+     * @param other The quaternion to rotate by
+     * @param buffer The buffer to store the result in
+     * @return A reference to the buffer
+     */
+    constexpr FixedQuaternion &Q_Mult(const FixedQuaternion &other, FixedQuaternion &buffer) const;
+
+    /**
+     * @brief Rotate a vector by this quaternion
+     * @note this quaternion has to be normalized
+     */
+    constexpr V3D<Type> Rotate(const V3D<Type> &vector) const;
+
+    /**
+     * @brief Normalize the quaternion to a magnitude of 1. The squared
+     * magnitude and its root are taken in the accumulator, and the elements
+     * are scaled by its reciprocal, so there's one division instead of four.
+     */
+    constexpr void Normalize();
+
+    /**
+     * @brief Pull the quaternion back towards a magnitude of 1 without a
+     * square root, see Quaternion::Renormalize
+     */
+    constexpr void Renormalize();
+
+    /**
+     * @return the conjugate w - v1 i - v2 j - v3 k, which for a normalized
+     * quaternion is the inverse rotation
+     */
+    constexpr FixedQuaternion Conjugate() const;
+
+private:
+    /**
+     * @return the sum of the squares of the elements, in the accumulator
+     */
+    constexpr Accumulator magnitudeSquared() const;
+};
+
+#include "FixedQuaternion.cpp"
+
+#endif // FIXED_QUATERNION_H_
@@ -0,0 +1,272 @@
+#include "Gemm.hpp"
+
+#include <algorithm>
+
+#ifdef MATRIX_THREADS
+#include "Parallel.hpp"
+#include "ThreadPool.hpp"
+#endif
+
+namespace
+{
+// The register tile that the micro kernel keeps in accumulators. 4x8 floats is
+// 8 SSE/NEON registers (or 4 AVX registers), which leaves enough room for the
+// operands on every target we care about.
+constexpr size_t micro_rows{4};
+constexpr size_t micro_columns{8};
+
+// Cache blocking sizes. The packed blocks of a (block_rows x block_depth) and
+// b (block_depth x block_columns) live on the stack, so they're kept small
+// enough for a microcontroller's stack rather than sized to fill L2. At 4 KB
+// each both stay in L1 on anything with a cache, and the products these
+// matrices see (at most 255 on a side) lose nothing measurable to the extra
+// packing passes.
+constexpr size_t block_rows{32};
+constexpr size_t block_depth{32};
+constexpr size_t block_columns{32};
+
+// the most stack the packed blocks are allowed to take
+constexpr size_t max_packing_bytes{8 * 1024};
+static_assert((block_rows * block_depth + block_depth * block_columns) *
+                      sizeof(float) <=
+                  max_packing_bytes,
+              "the packed blocks have to fit in max_packing_bytes of stack");
+
+// where element (row, column) of an operand lives, for operands stored as they
+// are and for operands stored transposed
+template <bool transposed>
+size_t offset(size_t row, size_t column, size_t ld)
+{
+  return transposed ? column * ld + row : row * ld + column;
+}
+
+/**
+ * @brief Copy a block of a into micro_rows tall panels. Inside a panel the
+ * values for one step of k are contiguous so the micro kernel can stream
+ * through them. Rows past the edge of the matrix are padded with zeros.
+ * @note packing is a copy anyways, so a transposed a costs nothing extra.
+ * Stored transposed, the values of one panel for one step of k are next to
+ * each other in memory.
+ */
+template <bool transposed>
+void packA(const float *a, size_t lda, size_t row_count, size_t depth,
+           float *packed)
+{
+  for (size_t row_idx{0}; row_idx < row_count; row_idx += micro_rows)
+  {
+    const size_t panel_rows{std::min(micro_rows, row_count - row_idx)};
+    for (size_t depth_idx{0}; depth_idx < depth; depth_idx++)
+    {
+      for (size_t panel_idx{0}; panel_idx < micro_rows; panel_idx++)
+      {
+        *packed++ =
+            panel_idx < panel_rows
+                ? a[offset<transposed>(row_idx + panel_idx, depth_idx, lda)]
+                : 0;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Copy a block of b into micro_columns wide panels. Columns past the
+ * edge of the matrix are padded with zeros.
+ */
+template <bool transposed>
+void packB(const float *b, size_t ldb, size_t depth, size_t column_count,
+           float *packed)
+{
+  for (size_t column_idx{0}; column_idx < column_count;
+       column_idx += micro_columns)
+  {
+    const size_t panel_columns{
+        std::min(micro_columns, column_count - column_idx)};
+    for (size_t depth_idx{0}; depth_idx < depth; depth_idx++)
+    {
+      for (size_t panel_idx{0}; panel_idx < micro_columns; panel_idx++)
+      {
+        *packed++ =
+            panel_idx < panel_columns
+                ? b[offset<transposed>(depth_idx, column_idx + panel_idx, ldb)]
+                : 0;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Multiply one packed panel of a by one packed panel of b and write
+ * the valid part of the micro_rows x micro_columns tile into c.
+ * @param accumulate add to c instead of overwriting it
+ */
+void microKernel(size_t depth, const float *a, const float *b, float *c,
+                 size_t ldc, size_t tile_rows, size_t tile_columns,
+                 bool accumulate)
+{
+  float accumulator[micro_rows][micro_columns]{};
+
+  for (size_t depth_idx{0}; depth_idx < depth; depth_idx++)
+  {
+    for (size_t row_idx{0}; row_idx < micro_rows; row_idx++)
+    {
+      const float a_value{a[row_idx]};
+      for (size_t column_idx{0}; column_idx < micro_columns; column_idx++)
+      {
+        accumulator[row_idx][column_idx] += a_value * b[column_idx];
+      }
+    }
+    a += micro_rows;
+    b += micro_columns;
+  }
+
+  for (size_t row_idx{0}; row_idx < tile_rows; row_idx++)
+  {
+    float *c_row{c + row_idx * ldc};
+    for (size_t column_idx{0}; column_idx < tile_columns; column_idx++)
+    {
+      c_row[column_idx] = accumulate
+                              ? c_row[column_idx] +
+                                    accumulator[row_idx][column_idx]
+                              : accumulator[row_idx][column_idx];
+    }
+  }
+}
+
+/**
+ * @brief Multiply a packed block of a by a packed block of b, one register
+ * tile at a time
+ */
+void macroKernel(size_t row_count, size_t column_count, size_t depth,
+                 const float *packed_a, const float *packed_b, float *c,
+                 size_t ldc, bool accumulate)
+{
+  for (size_t column_idx{0}; column_idx < column_count;
+       column_idx += micro_columns)
+  {
+    const size_t tile_columns{
+        std::min(micro_columns, column_count - column_idx)};
+    const float *b_panel{packed_b + column_idx * depth};
+    for (size_t row_idx{0}; row_idx < row_count; row_idx += micro_rows)
+    {
+      const size_t tile_rows{std::min(micro_rows, row_count - row_idx)};
+      microKernel(depth, packed_a + row_idx * depth, b_panel,
+                  c + row_idx * ldc + column_idx, ldc, tile_rows,
+                  tile_columns, accumulate);
+    }
+  }
+}
+
+/**
+ * @brief The single threaded product, cache blocked and packed
+ */
+template <bool transpose_a, bool transpose_b>
+void multiplyBlocked(size_t m, size_t n, size_t k,
+                     const float *a, size_t lda,
+                     const float *b, size_t ldb,
+                     float *c, size_t ldc)
+{
+  if (k == 0)
+  {
+    for (size_t row_idx{0}; row_idx < m; row_idx++)
+    {
+      std::fill(c + row_idx * ldc, c + row_idx * ldc + n, 0.0f);
+    }
+    return;
+  }
+
+  // the panels are padded up to a full register tile, so round the buffers up
+  // to match
+  static_assert(block_rows % micro_rows == 0,
+                "block_rows must be a multiple of micro_rows");
+  static_assert(block_columns % micro_columns == 0,
+                "block_columns must be a multiple of micro_columns");
+  float packed_a[block_rows * block_depth];
+  float packed_b[block_depth * block_columns];
+
+  for (size_t column_idx{0}; column_idx < n; column_idx += block_columns)
+  {
+    const size_t column_count{std::min(block_columns, n - column_idx)};
+    for (size_t depth_idx{0}; depth_idx < k; depth_idx += block_depth)
+    {
+      const size_t depth{std::min(block_depth, k - depth_idx)};
+      packB<transpose_b>(b + offset<transpose_b>(depth_idx, column_idx, ldb),
+                         ldb, depth, column_count, packed_b);
+
+      // the first pass through k overwrites c, every other pass adds to it
+      const bool accumulate{depth_idx != 0};
+      for (size_t row_idx{0}; row_idx < m; row_idx += block_rows)
+      {
+        const size_t row_count{std::min(block_rows, m - row_idx)};
+        packA<transpose_a>(a + offset<transpose_a>(row_idx, depth_idx, lda),
+                           lda, row_count, depth, packed_a);
+        macroKernel(row_count, column_count, depth, packed_a, packed_b,
+                    c + row_idx * ldc + column_idx, ldc, accumulate);
+      }
+    }
+  }
+}
+
+/**
+ * @brief The product, split over the thread pool when there is one and the
+ * product is big enough
+ */
+template <bool transpose_a, bool transpose_b>
+void multiply(size_t m, size_t n, size_t k,
+              const float *a, size_t lda,
+              const float *b, size_t ldb,
+              float *c, size_t ldc)
+{
+#ifdef MATRIX_THREADS
+  ThreadPool *pool{Parallel::Pool()};
+  if (pool != nullptr &&
+      static_cast<uint64_t>(m) * n * k >= Parallel::multiply_threshold)
+  {
+    // one task per macro tile of c. The tiles line up with the cache blocks,
+    // so each element of c is summed in exactly the same order as it would
+    // be on one thread.
+    const size_t row_tiles{(m + block_rows - 1) / block_rows};
+    const size_t column_tiles{(n + block_columns - 1) / block_columns};
+    pool->Run(row_tiles * column_tiles, [=](size_t tile_idx) {
+      const size_t row_idx{(tile_idx / column_tiles) * block_rows};
+      const size_t column_idx{(tile_idx % column_tiles) * block_columns};
+      multiplyBlocked<transpose_a, transpose_b>(
+          std::min(block_rows, m - row_idx),
+          std::min(block_columns, n - column_idx), k,
+          a + offset<transpose_a>(row_idx, 0, lda), lda,
+          b + offset<transpose_b>(0, column_idx, ldb), ldb,
+          c + row_idx * ldc + column_idx, ldc);
+    });
+    return;
+  }
+#endif
+
+  multiplyBlocked<transpose_a, transpose_b>(m, n, k, a, lda, b, ldb, c, ldc);
+}
+} // namespace
+
+namespace Gemm
+{
+void Multiply(size_t m, size_t n, size_t k,
+              const float *a, size_t lda,
+              const float *b, size_t ldb,
+              float *c, size_t ldc)
+{
+  multiply<false, false>(m, n, k, a, lda, b, ldb, c, ldc);
+}
+
+void MultiplyTransposedA(size_t m, size_t n, size_t k,
+                         const float *a, size_t lda,
+                         const float *b, size_t ldb,
+                         float *c, size_t ldc)
+{
+  multiply<true, false>(m, n, k, a, lda, b, ldb, c, ldc);
+}
+
+void MultiplyTransposedB(size_t m, size_t n, size_t k,
+                         const float *a, size_t lda,
+                         const float *b, size_t ldb,
+                         float *c, size_t ldc)
+{
+  multiply<false, true>(m, n, k, a, lda, b, ldb, c, ldc);
+}
+} // namespace Gemm
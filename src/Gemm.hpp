@@ -0,0 +1,191 @@
+#ifndef GEMM_H_
+#define GEMM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ScalarTraits.hpp"
+
+/**
+ * @brief General matrix multiply kernels shared by all of the matrix types.
+ * All operands are row-major and addressed through a base pointer plus a
+ * leading dimension (the distance in elements between two consecutive rows),
+ * so they can point at a full matrix or at a block inside a larger one.
+ */
+namespace Gemm
+{
+/**
+ * @brief Products with fewer multiply-adds than this are done with a simple
+ * inline loop. Everything above goes through the packed, blocked kernel.
+ */
+constexpr uint32_t block_threshold{16 * 16 * 16};
+
+/**
+ * @brief Calculate c = a * b
+ * @param m the number of rows in a and c
+ * @param n the number of columns in b and c
+ * @param k the number of columns in a and rows in b
+ * @param a pointer to the first element of a
+ * @param lda the leading dimension of a
+ * @param b pointer to the first element of b
+ * @param ldb the leading dimension of b
+ * @param c pointer to the first element of c
+ * @param ldc the leading dimension of c
+ * @note large products run on the thread pool when the library is built with
+ * MATRIX_THREADS, see Parallel.hpp
+ * @note the blocked kernel packs a and b into 8 KB of stack, and nothing is
+ * ever allocated
+ * @warning c must not overlap with a or b
+ */
+void Multiply(size_t m, size_t n, size_t k,
+              const float *a, size_t lda,
+              const float *b, size_t ldb,
+              float *c, size_t ldc);
+
+/**
+ * @brief Calculate c = a^T * b without transposing a first
+ * @param m the number of columns in a and rows in c
+ * @param n the number of columns in b and c
+ * @param k the number of rows in a and b
+ * @param a pointer to the first element of a, which is stored k x m
+ * @param lda the leading dimension of a as it is stored
+ * @warning c must not overlap with a or b
+ */
+void MultiplyTransposedA(size_t m, size_t n, size_t k,
+                         const float *a, size_t lda,
+                         const float *b, size_t ldb,
+                         float *c, size_t ldc);
+
+/**
+ * @brief Calculate c = a * b^T without transposing b first
+ * @param m the number of rows in a and c
+ * @param n the number of rows in b and columns in c
+ * @param k the number of columns in a and b
+ * @param b pointer to the first element of b, which is stored n x k
+ * @param ldb the leading dimension of b as it is stored
+ * @warning c must not overlap with a or b
+ */
+void MultiplyTransposedB(size_t m, size_t n, size_t k,
+                         const float *a, size_t lda,
+                         const float *b, size_t ldb,
+                         float *c, size_t ldc);
+
+/**
+ * @brief Calculate c = a * b for element types other than float. Same
+ * arguments as the float version, but it's a plain loop summed in the type's
+ * accumulator and always runs on the calling thread.
+ * @warning c must not overlap with a or b
+ */
+template <typename Type>
+void Multiply(size_t m, size_t n, size_t k,
+              const Type *a, size_t lda,
+              const Type *b, size_t ldb,
+              Type *c, size_t ldc)
+{
+  using Accumulator = typename ScalarTraits<Type>::Accumulator;
+  // sum a strip of each row of c at a time so b is read along its rows
+  constexpr size_t strip{64};
+  Accumulator sums[strip]{};
+  for (size_t row_idx{0}; row_idx < m; row_idx++)
+  {
+    for (size_t strip_idx{0}; strip_idx < n; strip_idx += strip)
+    {
+      const size_t width{n - strip_idx < strip ? n - strip_idx : strip};
+      for (size_t column_idx{0}; column_idx < width; column_idx++)
+      {
+        sums[column_idx] = 0;
+      }
+
+      for (size_t inner_idx{0}; inner_idx < k; inner_idx++)
+      {
+        const Type scale{a[row_idx * lda + inner_idx]};
+        const Type *b_row{b + inner_idx * ldb + strip_idx};
+        for (size_t column_idx{0}; column_idx < width; column_idx++)
+        {
+          sums[column_idx] +=
+              ScalarTraits<Type>::Product(scale, b_row[column_idx]);
+        }
+      }
+
+      Type *c_row{c + row_idx * ldc + strip_idx};
+      for (size_t column_idx{0}; column_idx < width; column_idx++)
+      {
+        c_row[column_idx] = static_cast<Type>(sums[column_idx]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Calculate c = a^T * b for element types other than float. Every row
+ * of a is read along its length, one element per row of c.
+ * @warning c must not overlap with a or b
+ */
+template <typename Type>
+void MultiplyTransposedA(size_t m, size_t n, size_t k,
+                         const Type *a, size_t lda,
+                         const Type *b, size_t ldb,
+                         Type *c, size_t ldc)
+{
+  using Accumulator = typename ScalarTraits<Type>::Accumulator;
+  constexpr size_t strip{64};
+  Accumulator sums[strip]{};
+  for (size_t row_idx{0}; row_idx < m; row_idx++)
+  {
+    for (size_t strip_idx{0}; strip_idx < n; strip_idx += strip)
+    {
+      const size_t width{n - strip_idx < strip ? n - strip_idx : strip};
+      for (size_t column_idx{0}; column_idx < width; column_idx++)
+      {
+        sums[column_idx] = 0;
+      }
+
+      for (size_t inner_idx{0}; inner_idx < k; inner_idx++)
+      {
+        const Type scale{a[inner_idx * lda + row_idx]};
+        const Type *b_row{b + inner_idx * ldb + strip_idx};
+        for (size_t column_idx{0}; column_idx < width; column_idx++)
+        {
+          sums[column_idx] +=
+              ScalarTraits<Type>::Product(scale, b_row[column_idx]);
+        }
+      }
+
+      Type *c_row{c + row_idx * ldc + strip_idx};
+      for (size_t column_idx{0}; column_idx < width; column_idx++)
+      {
+        c_row[column_idx] = static_cast<Type>(sums[column_idx]);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Calculate c = a * b^T for element types other than float. Every
+ * element of c is the dot product of a row of a and a row of b.
+ * @warning c must not overlap with a or b
+ */
+template <typename Type>
+void MultiplyTransposedB(size_t m, size_t n, size_t k,
+                         const Type *a, size_t lda,
+                         const Type *b, size_t ldb,
+                         Type *c, size_t ldc)
+{
+  for (size_t row_idx{0}; row_idx < m; row_idx++)
+  {
+    const Type *a_row{a + row_idx * lda};
+    for (size_t column_idx{0}; column_idx < n; column_idx++)
+    {
+      const Type *b_row{b + column_idx * ldb};
+      typename ScalarTraits<Type>::Accumulator sum{0};
+      for (size_t inner_idx{0}; inner_idx < k; inner_idx++)
+      {
+        sum += ScalarTraits<Type>::Product(a_row[inner_idx], b_row[inner_idx]);
+      }
+      c[row_idx * ldc + column_idx] = static_cast<Type>(sum);
+    }
+  }
+}
+} // namespace Gemm
+
+#endif // GEMM_H_
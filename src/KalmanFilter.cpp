@@ -0,0 +1,303 @@
+#ifdef KALMAN_FILTER_H_ // since the .cpp file has to be included by the .hpp
+                        // file this will evaluate to true
+#include "KalmanFilter.hpp"
+
+#include <algorithm>
+
+template <uint8_t states, uint8_t measurements, typename Type>
+KalmanFilter<states, measurements, Type>::KalmanFilter()
+    : state{}, covariance{}
+{
+  this->covariance.Identity();
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+KalmanFilter<states, measurements, Type>::KalmanFilter(
+    const Matrix<states, 1, Type> &state,
+    const Matrix<states, states, Type> &covariance)
+    : state{state}, covariance{covariance}
+{
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+void KalmanFilter<states, measurements, Type>::Predict(
+    const Matrix<states, states, Type> &transition,
+    const Matrix<states, states, Type> &process_noise)
+{
+  transition.Mult(this->state, this->state_scratch);
+  this->state = this->state_scratch;
+  this->PredictCovariance(transition, process_noise);
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+void KalmanFilter<states, measurements, Type>::PredictCovariance(
+    const Matrix<states, states, Type> &transition,
+    const Matrix<states, states, Type> &process_noise)
+{
+  // F * P * F^T is symmetric, so only half of the second product is summed,
+  // reading F^T straight from the rows of F
+  transition.Mult(this->covariance, this->product);
+  lowerProductTransposed(this->product, transition, this->covariance, false);
+  addLower(process_noise, this->covariance);
+  mirrorLower(this->covariance);
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+bool KalmanFilter<states, measurements, Type>::Update(
+    const Matrix<measurements, 1, Type> &measurement,
+    const Matrix<measurements, states, Type> &observation,
+    const Matrix<measurements, measurements, Type> &measurement_noise)
+{
+  observation.Mult(this->state, this->innovation_scratch);
+  measurement.Sub(this->innovation_scratch, this->innovation_scratch);
+  return this->UpdateInnovation(this->innovation_scratch, observation,
+                                measurement_noise);
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+bool KalmanFilter<states, measurements, Type>::UpdateInnovation(
+    const Matrix<measurements, 1, Type> &innovation,
+    const Matrix<measurements, states, Type> &observation,
+    const Matrix<measurements, measurements, Type> &measurement_noise)
+{
+  // S = H * P * H^T + R, only the lower triangle that LLT reads
+  observation.Mult(this->covariance, this->observed_covariance);
+  lowerProductTransposed(this->observed_covariance, observation,
+                         this->innovation_covariance, false);
+  addLower(measurement_noise, this->innovation_covariance);
+  if (!this->factorization.Compute(this->innovation_covariance))
+  {
+    return false;
+  }
+
+  // K = P * H^T * S^-1, solved for as K^T = S^-1 * (H * P) since S and P
+  // are symmetric
+  this->factorization.Solve(this->observed_covariance, this->gain_transposed);
+
+  this->gain_transposed.TransposeMult(innovation, this->state_scratch);
+  this->state += this->state_scratch;
+
+  // Joseph form, P = (I - K * H) * P * (I - K * H)^T + K * R * K^T. A sum
+  // of two symmetric positive semi-definite terms, so rounding can't make
+  // the covariance indefinite like P - K * H * P can. Built from
+  // (I - K * H)^T = I - H^T * K^T, which is already in the layout the
+  // products need.
+  observation.TransposeMult(this->gain_transposed, this->transposed);
+  Type *joseph{this->transposed.matrix.data()};
+  for (uint16_t idx{0}; idx < states * states; idx++)
+  {
+    joseph[idx] = -joseph[idx];
+  }
+  for (uint8_t idx{0}; idx < states; idx++)
+  {
+    joseph[idx * states + idx] += 1;
+  }
+
+  this->transposed.TransposeMult(this->covariance, this->product);
+  lowerProduct(this->product, this->transposed, this->covariance, false);
+  this->gain_transposed.TransposeMult(measurement_noise, this->gain_noise);
+  lowerProduct(this->gain_noise, this->gain_transposed, this->covariance,
+               true);
+  mirrorLower(this->covariance);
+  return true;
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+bool KalmanFilter<states, measurements, Type>::UpdateScalar(
+    Type innovation, const Matrix<1, states, Type> &observation, Type noise)
+{
+  return this->updateScalar(innovation, observation.matrix.data(), noise);
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+bool KalmanFilter<states, measurements, Type>::UpdateSequential(
+    const Matrix<measurements, 1, Type> &measurement,
+    const Matrix<measurements, states, Type> &observation,
+    const Matrix<measurements, 1, Type> &noise)
+{
+  for (uint8_t measurement_idx{0}; measurement_idx < measurements;
+       measurement_idx++)
+  {
+    // the prediction uses the state the earlier measurements updated
+    const Type *row{observation.matrix.data() + measurement_idx * states};
+    Type predicted{0};
+    for (uint8_t idx{0}; idx < states; idx++)
+    {
+      predicted += row[idx] * this->state.matrix[idx];
+    }
+
+    if (!this->updateScalar(measurement.matrix[measurement_idx] - predicted,
+                            row, noise.matrix[measurement_idx]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+bool KalmanFilter<states, measurements, Type>::updateScalar(
+    Type innovation, const Type *observation, Type noise)
+{
+  const Type *p{this->covariance.matrix.data()};
+  Type *u{this->vector_scratch.matrix.data()};
+  Type *gain{this->gain_scratch.matrix.data()};
+
+  // u = P * h^T, and S = h * u + r is a scalar
+  Type innovation_variance{noise};
+  for (uint8_t row_idx{0}; row_idx < states; row_idx++)
+  {
+    const Type *p_row{p + row_idx * states};
+    Type sum{0};
+    for (uint8_t idx{0}; idx < states; idx++)
+    {
+      sum += p_row[idx] * observation[idx];
+    }
+    u[row_idx] = sum;
+    innovation_variance += observation[row_idx] * sum;
+  }
+
+  // this also catches NaN
+  if (!(innovation_variance > 0))
+  {
+    return false;
+  }
+
+  const Type inverse_variance{1 / innovation_variance};
+  for (uint8_t idx{0}; idx < states; idx++)
+  {
+    gain[idx] = u[idx] * inverse_variance;
+    this->state.matrix[idx] += gain[idx] * innovation;
+  }
+
+  // the Joseph form expanded for a single row of H:
+  // P - K * u^T - u * K^T + S * K * K^T, O(states^2) instead of O(states^3)
+  Type *p_out{this->covariance.matrix.data()};
+  for (uint8_t row_idx{0}; row_idx < states; row_idx++)
+  {
+    Type *p_row{p_out + row_idx * states};
+    const Type row_gain{gain[row_idx]};
+    const Type row_u{u[row_idx]};
+    const Type scaled_gain{innovation_variance * row_gain};
+    for (uint8_t column_idx{0}; column_idx <= row_idx; column_idx++)
+    {
+      p_row[column_idx] += scaled_gain * gain[column_idx] -
+                           row_gain * u[column_idx] - row_u * gain[column_idx];
+    }
+  }
+  mirrorLower(this->covariance);
+  return true;
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+template <uint8_t size, uint8_t inner>
+void KalmanFilter<states, measurements, Type>::lowerProduct(
+    const Matrix<size, inner, Type> &left, const Matrix<inner, size, Type> &right,
+    Matrix<size, size, Type> &result, bool add)
+{
+  const Type *a{left.matrix.data()};
+  const Type *b{right.matrix.data()};
+  Type *c{result.matrix.data()};
+
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    Type *c_row{c + row_idx * size};
+    if (!add)
+    {
+      std::fill(c_row, c_row + row_idx + 1, Type{0});
+    }
+
+    for (uint8_t inner_idx{0}; inner_idx < inner; inner_idx++)
+    {
+      const Type scale{a[row_idx * inner + inner_idx]};
+      const Type *b_row{b + inner_idx * size};
+      for (uint8_t column_idx{0}; column_idx <= row_idx; column_idx++)
+      {
+        c_row[column_idx] += scale * b_row[column_idx];
+      }
+    }
+  }
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+template <uint8_t size, uint8_t inner>
+void KalmanFilter<states, measurements, Type>::lowerProductTransposed(
+    const Matrix<size, inner, Type> &left,
+    const Matrix<size, inner, Type> &right, Matrix<size, size, Type> &result,
+    bool add)
+{
+  const Type *a{left.matrix.data()};
+  const Type *b{right.matrix.data()};
+  Type *c{result.matrix.data()};
+
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    const Type *a_row{a + row_idx * inner};
+    Type *c_row{c + row_idx * size};
+    uint8_t column_idx{0};
+
+    // four dot products at a time, so four independent sums are in flight
+    // instead of one long chain of dependent adds
+    for (; column_idx + 3 <= row_idx; column_idx += 4)
+    {
+      const Type *b_row{b + column_idx * inner};
+      Type sums[4]{};
+      for (uint8_t inner_idx{0}; inner_idx < inner; inner_idx++)
+      {
+        const Type scale{a_row[inner_idx]};
+        sums[0] += scale * b_row[inner_idx];
+        sums[1] += scale * b_row[inner + inner_idx];
+        sums[2] += scale * b_row[2 * inner + inner_idx];
+        sums[3] += scale * b_row[3 * inner + inner_idx];
+      }
+      for (uint8_t idx{0}; idx < 4; idx++)
+      {
+        c_row[column_idx + idx] =
+            add ? c_row[column_idx + idx] + sums[idx] : sums[idx];
+      }
+    }
+
+    for (; column_idx <= row_idx; column_idx++)
+    {
+      const Type *b_row{b + column_idx * inner};
+      Type sum{0};
+      for (uint8_t inner_idx{0}; inner_idx < inner; inner_idx++)
+      {
+        sum += a_row[inner_idx] * b_row[inner_idx];
+      }
+      c_row[column_idx] = add ? c_row[column_idx] + sum : sum;
+    }
+  }
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+template <uint8_t size>
+void KalmanFilter<states, measurements, Type>::addLower(
+    const Matrix<size, size, Type> &other, Matrix<size, size, Type> &result)
+{
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx <= row_idx; column_idx++)
+    {
+      result.matrix[row_idx * size + column_idx] +=
+          other.matrix[row_idx * size + column_idx];
+    }
+  }
+}
+
+template <uint8_t states, uint8_t measurements, typename Type>
+template <uint8_t size>
+void KalmanFilter<states, measurements, Type>::mirrorLower(
+    Matrix<size, size, Type> &result)
+{
+  for (uint8_t row_idx{1}; row_idx < size; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < row_idx; column_idx++)
+    {
+      result.matrix[column_idx * size + row_idx] =
+          result.matrix[row_idx * size + column_idx];
+    }
+  }
+}
+
+#endif // KALMAN_FILTER_H_
@@ -0,0 +1,194 @@
+#ifndef KALMAN_FILTER_H_
+#define KALMAN_FILTER_H_
+
+#include <cstdint>
+
+#include "Cholesky.hpp"
+#include "Matrix.hpp"
+
+/**
+ * @brief Kalman filter with a fixed number of states and measurements. Use
+ * it as a linear filter, or as an extended Kalman filter by propagating the
+ * state through the nonlinear models yourself and passing in their
+ * Jacobians.
+ * @code
+ * KalmanFilter<9, 3> filter{initial_state, initial_covariance};
+ * // linear
+ * filter.Predict(F, Q);
+ * filter.Update(z, H, R);
+ * // extended
+ * filter.State() = f(filter.State());
+ * filter.PredictCovariance(F, Q);
+ * filter.UpdateInnovation(z - h(filter.State()), H, R);
+ * @endcode
+ *
+ * Every temporary of predict and update is a member, so a filter never
+ * allocates and its whole footprint is known at compile time. The covariance
+ * is kept exactly symmetric: products that are known to be symmetric only sum
+ * their lower triangle and mirror it. The gain comes from a Cholesky solve
+ * of the innovation covariance instead of its inverse, and the covariance is
+ * updated in Joseph form so rounding can't make it lose positive
+ * definiteness.
+ *
+ * If the measurement noise is diagonal, UpdateSequential processes the
+ * measurements one at a time. Each one costs O(states^2) with no
+ * factorization, against O(states^3) for a full Update.
+ *
+ * @note the element type has to be float or double, like LLT
+ * @warning a filter is big (a few times states^2 elements), so keep it in
+ * static storage or a long lived object rather than on a small stack
+ */
+template <uint8_t states, uint8_t measurements, typename Type>
+class KalmanFilter
+{
+public:
+  /**
+   * @brief Start from a zero state with an identity covariance
+   */
+  KalmanFilter();
+
+  /**
+   * @brief Start from a known state and covariance
+   * @param covariance must be symmetric positive definite
+   */
+  KalmanFilter(const Matrix<states, 1, Type> &state,
+               const Matrix<states, states, Type> &covariance);
+
+  /**
+   * @brief The state estimate. Write through it to propagate the state with
+   * a nonlinear model.
+   */
+  Matrix<states, 1, Type> &State() { return this->state; }
+  const Matrix<states, 1, Type> &State() const { return this->state; }
+
+  /**
+   * @brief The covariance of the state estimate
+   * @warning keep it symmetric if you write to it
+   */
+  Matrix<states, states, Type> &Covariance() { return this->covariance; }
+  const Matrix<states, states, Type> &Covariance() const
+  {
+    return this->covariance;
+  }
+
+  /**
+   * @brief Linear predict: x = F * x, P = F * P * F^T + Q
+   * @param transition the state transition F
+   * @param process_noise the process noise covariance Q
+   */
+  void Predict(const Matrix<states, states, Type> &transition,
+               const Matrix<states, states, Type> &process_noise);
+
+  /**
+   * @brief Predict the covariance only: P = F * P * F^T + Q. For an extended
+   * filter, after propagating State() through the nonlinear model.
+   * @param transition the Jacobian F of the process model at the state
+   * @param process_noise the process noise covariance Q
+   */
+  void PredictCovariance(const Matrix<states, states, Type> &transition,
+                         const Matrix<states, states, Type> &process_noise);
+
+  /**
+   * @brief Linear update with a measurement z = H * x + noise
+   * @param measurement the measurement z
+   * @param observation the observation model H
+   * @param measurement_noise the measurement noise covariance R
+   * @return false if H * P * H^T + R isn't positive definite. The state and
+   * covariance are left untouched then.
+   */
+  bool Update(const Matrix<measurements, 1, Type> &measurement,
+              const Matrix<measurements, states, Type> &observation,
+              const Matrix<measurements, measurements, Type> &measurement_noise);
+
+  /**
+   * @brief Update with an innovation computed by the caller. For an
+   * extended filter the innovation is z - h(x) and H is the Jacobian of h.
+   * @param innovation the difference between the measurement and its
+   * prediction
+   * @param observation the observation model H
+   * @param measurement_noise the measurement noise covariance R
+   * @return false if H * P * H^T + R isn't positive definite. The state and
+   * covariance are left untouched then.
+   */
+  bool
+  UpdateInnovation(const Matrix<measurements, 1, Type> &innovation,
+                   const Matrix<measurements, states, Type> &observation,
+                   const Matrix<measurements, measurements, Type>
+                       &measurement_noise);
+
+  /**
+   * @brief Update with a single scalar measurement
+   * @param innovation the difference between the measurement and its
+   * prediction
+   * @param observation the row of H for this measurement
+   * @param noise the variance of the measurement
+   * @return false if h * P * h^T + r isn't positive. The state and covariance
+   * are left untouched then.
+   */
+  bool UpdateScalar(Type innovation,
+                    const Matrix<1, states, Type> &observation, Type noise);
+
+  /**
+   * @brief Linear update one measurement at a time. Gives the same result as
+   * Update when the measurement noise is diagonal, without factorizing
+   * anything.
+   * @param measurement the measurement z
+   * @param observation the observation model H
+   * @param noise the diagonal of the measurement noise covariance R
+   * @return false if one of the measurements couldn't be applied. The
+   * measurements before it have been applied, the ones after it haven't.
+   */
+  bool UpdateSequential(const Matrix<measurements, 1, Type> &measurement,
+                        const Matrix<measurements, states, Type> &observation,
+                        const Matrix<measurements, 1, Type> &noise);
+
+private:
+  Matrix<states, 1, Type> state;
+  Matrix<states, states, Type> covariance;
+
+  // scratch space. The square ones are shared by predict and update.
+  Matrix<states, 1, Type> state_scratch{};
+  Matrix<measurements, 1, Type> innovation_scratch{};
+  Matrix<states, states, Type> product{};
+  Matrix<states, states, Type> transposed{};
+  Matrix<measurements, states, Type> observed_covariance{};
+  Matrix<measurements, measurements, Type> innovation_covariance{};
+  Matrix<measurements, states, Type> gain_transposed{};
+  Matrix<states, measurements, Type> gain_noise{};
+  Matrix<states, 1, Type> vector_scratch{};
+  Matrix<states, 1, Type> gain_scratch{};
+  LLT<measurements, Type> factorization{};
+
+  // result = left * right for a product that is known to be symmetric. Only
+  // the lower triangle is summed, each row as a run of contiguous
+  // multiply-adds along the rows of right the compiler can vectorize. With
+  // add the product is added to result instead.
+  template <uint8_t size, uint8_t inner>
+  static void lowerProduct(const Matrix<size, inner, Type> &left,
+                           const Matrix<inner, size, Type> &right,
+                           Matrix<size, size, Type> &result, bool add);
+
+  // the same for result = left * right^T. Every element is the dot product
+  // of a row of left and a row of right, so right is never transposed.
+  template <uint8_t size, uint8_t inner>
+  static void lowerProductTransposed(const Matrix<size, inner, Type> &left,
+                                     const Matrix<size, inner, Type> &right,
+                                     Matrix<size, size, Type> &result,
+                                     bool add);
+
+  // the scalar update on a raw row of H
+  bool updateScalar(Type innovation, const Type *observation, Type noise);
+
+  // add the lower triangle of other to the lower triangle of result
+  template <uint8_t size>
+  static void addLower(const Matrix<size, size, Type> &other,
+                       Matrix<size, size, Type> &result);
+
+  // copy the lower triangle over the upper one
+  template <uint8_t size>
+  static void mirrorLower(Matrix<size, size, Type> &result);
+};
+
+#include "KalmanFilter.cpp"
+
+#endif // KALMAN_FILTER_H_
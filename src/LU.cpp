@@ -0,0 +1,192 @@
+#ifdef LU_H_ // since the .cpp file has to be included by the .hpp file this
+             // will evaluate to true
+#include "LU.hpp"
+
+#include <algorithm>
+
+template <uint8_t size, typename Type>
+constexpr LU<size, Type>::LU(const Matrix<size, size, Type> &matrix)
+{
+  this->Compute(matrix);
+}
+
+template <uint8_t size, typename Type>
+constexpr bool LU<size, Type>::Compute(const Matrix<size, size, Type> &matrix)
+{
+  this->factors = matrix;
+  this->permutation_sign = 1;
+  this->singular = false;
+  Type *lu{this->factors.matrix.data()};
+
+  // a pivot is only as big as the row it came from, so each one is measured
+  // against the biggest entry of its own original row. Against the biggest
+  // entry of the whole matrix a well conditioned matrix with rows of very
+  // different scale, like diag(100, 1e-5), would look singular.
+  Type row_scales[size > 0 ? size : 1]{};
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < size; column_idx++)
+    {
+      row_scales[row_idx] =
+          std::max(row_scales[row_idx],
+                   ConstexprMath::Abs(lu[row_idx * size + column_idx]));
+    }
+  }
+
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    this->permutation[idx] = idx;
+  }
+
+  for (uint8_t pivot_idx{0}; pivot_idx < size; pivot_idx++)
+  {
+    // pick the biggest remaining entry in this column as the pivot
+    uint8_t best_row{pivot_idx};
+    Type best_value{ConstexprMath::Abs(lu[pivot_idx * size + pivot_idx])};
+    for (uint8_t row_idx = pivot_idx + 1; row_idx < size; row_idx++)
+    {
+      const Type value{ConstexprMath::Abs(lu[row_idx * size + pivot_idx])};
+      if (value > best_value)
+      {
+        best_value = value;
+        best_row = row_idx;
+      }
+    }
+
+    // anything this small relative to its row is treated as a zero pivot,
+    // and so is NaN
+    const Type tolerance{row_scales[this->permutation[best_row]] * size *
+                         ScalarTraits<Type>::epsilon};
+    if (!(best_value > tolerance))
+    {
+      this->singular = true;
+      return false;
+    }
+
+    if (best_row != pivot_idx)
+    {
+      // std::swap isn't constexpr until C++20
+      for (uint8_t column_idx{0}; column_idx < size; column_idx++)
+      {
+        const Type temp{lu[pivot_idx * size + column_idx]};
+        lu[pivot_idx * size + column_idx] = lu[best_row * size + column_idx];
+        lu[best_row * size + column_idx] = temp;
+      }
+      const uint8_t temp{this->permutation[pivot_idx]};
+      this->permutation[pivot_idx] = this->permutation[best_row];
+      this->permutation[best_row] = temp;
+      this->permutation_sign = -this->permutation_sign;
+    }
+
+    // eliminate everything below the pivot
+    const Type *pivot_row{lu + pivot_idx * size};
+    const Type inverse_pivot{1 / pivot_row[pivot_idx]};
+    for (uint8_t row_idx = pivot_idx + 1; row_idx < size; row_idx++)
+    {
+      Type *row{lu + row_idx * size};
+      const Type multiplier{row[pivot_idx] * inverse_pivot};
+      row[pivot_idx] = multiplier;
+      for (uint8_t column_idx = pivot_idx + 1; column_idx < size; column_idx++)
+      {
+        row[column_idx] -= multiplier * pivot_row[column_idx];
+      }
+    }
+  }
+
+  return true;
+}
+
+template <uint8_t size, typename Type>
+constexpr Type LU<size, Type>::Det() const
+{
+  if (this->singular)
+  {
+    return 0;
+  }
+
+  Type determinant{this->permutation_sign};
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    determinant *= this->factors.matrix[idx * size + idx];
+  }
+  return determinant;
+}
+
+template <uint8_t size, typename Type>
+template <uint8_t rhs_columns>
+constexpr Matrix<size, rhs_columns, Type> &
+LU<size, Type>::Solve(const Matrix<size, rhs_columns, Type> &rhs,
+                Matrix<size, rhs_columns, Type> &result) const
+{
+  if (this->singular)
+  {
+    result.Fill(0);
+    return result;
+  }
+
+  // apply the row permutation. Go through a copy so rhs and result can be
+  // the same matrix.
+  Matrix<size, rhs_columns, Type> permuted{};
+  for (uint8_t row_idx{0}; row_idx < size; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+    {
+      permuted.matrix[row_idx * rhs_columns + column_idx] =
+          rhs.matrix[this->permutation[row_idx] * rhs_columns + column_idx];
+    }
+  }
+
+  const Type *lu{this->factors.matrix.data()};
+  Type *x{permuted.matrix.data()};
+
+  // forward substitution with the unit lower triangle. Working a whole row of
+  // right hand sides at a time keeps the inner loop contiguous.
+  for (uint8_t row_idx{1}; row_idx < size; row_idx++)
+  {
+    Type *x_row{x + row_idx * rhs_columns};
+    for (uint8_t inner_idx{0}; inner_idx < row_idx; inner_idx++)
+    {
+      const Type factor{lu[row_idx * size + inner_idx]};
+      const Type *x_inner{x + inner_idx * rhs_columns};
+      for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+      {
+        x_row[column_idx] -= factor * x_inner[column_idx];
+      }
+    }
+  }
+
+  // back substitution with the upper triangle
+  for (int16_t row_idx = size - 1; row_idx >= 0; row_idx--)
+  {
+    Type *x_row{x + row_idx * rhs_columns};
+    for (uint8_t inner_idx = row_idx + 1; inner_idx < size; inner_idx++)
+    {
+      const Type factor{lu[row_idx * size + inner_idx]};
+      const Type *x_inner{x + inner_idx * rhs_columns};
+      for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+      {
+        x_row[column_idx] -= factor * x_inner[column_idx];
+      }
+    }
+
+    const Type inverse_diagonal{1 / lu[row_idx * size + row_idx]};
+    for (uint8_t column_idx{0}; column_idx < rhs_columns; column_idx++)
+    {
+      x_row[column_idx] *= inverse_diagonal;
+    }
+  }
+
+  result = permuted;
+  return result;
+}
+
+template <uint8_t size, typename Type>
+constexpr Matrix<size, size, Type> &
+LU<size, Type>::Invert(Matrix<size, size, Type> &result) const
+{
+  Matrix<size, size, Type> identity{};
+  identity.Identity();
+  return this->Solve(identity, result);
+}
+
+#endif // LU_H_
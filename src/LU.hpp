@@ -0,0 +1,93 @@
+#ifndef LU_H_
+#define LU_H_
+
+#include <array>
+#include <cstdint>
+
+#include "Matrix.hpp"
+
+/**
+ * @brief LU factorization with partial pivoting (PA = LU) of a square matrix.
+ * Factor once in O(n^3), then get the determinant, inverse or solutions to
+ * Ax = b from the factors without redoing the elimination.
+ */
+template <uint8_t size, typename Type>
+class LU
+{
+public:
+  /**
+   * @brief create an empty factorization. Call Compute before using it.
+   */
+  constexpr LU() = default;
+
+  /**
+   * @brief Factorize matrix
+   */
+  constexpr LU(const Matrix<size, size, Type> &matrix);
+
+  /**
+   * @brief Factorize matrix, replacing whatever was factorized before
+   * @return false if the matrix is singular
+   */
+  constexpr bool Compute(const Matrix<size, size, Type> &matrix);
+
+  /**
+   * @return true if the last matrix passed to Compute was singular (or
+   * numerically too close to it to invert)
+   */
+  constexpr bool IsSingular() const { return this->singular; }
+
+  /**
+   * @return the determinant of the factorized matrix
+   */
+  constexpr Type Det() const;
+
+  /**
+   * @brief Solve A * result = rhs for every column of rhs
+   * @param rhs one or more right hand sides stored as columns
+   * @param result A buffer to store the result into
+   * @note there is no problem if result == rhs
+   * @note if the matrix is singular result is filled with 0
+   */
+  template <uint8_t rhs_columns>
+  constexpr Matrix<size, rhs_columns, Type> &
+  Solve(const Matrix<size, rhs_columns, Type> &rhs,
+        Matrix<size, rhs_columns, Type> &result) const;
+
+  /**
+   * @brief Invert the factorized matrix
+   * @param result A buffer to store the result into
+   * @note if the matrix is singular result is filled with 0
+   */
+  constexpr Matrix<size, size, Type> &
+  Invert(Matrix<size, size, Type> &result) const;
+
+  /**
+   * @brief Get the packed factors. The strictly lower triangle holds L (its
+   * unit diagonal isn't stored) and the upper triangle holds U.
+   */
+  constexpr const Matrix<size, size, Type> &GetFactors() const
+  {
+    return this->factors;
+  }
+
+  /**
+   * @brief Get the row permutation. Row idx of PA is row
+   * GetPermutation()[idx] of A.
+   */
+  constexpr const std::array<uint8_t, size> &GetPermutation() const
+  {
+    return this->permutation;
+  }
+
+private:
+  Matrix<size, size, Type> factors{};
+  std::array<uint8_t, size> permutation{};
+  // +1 or -1 depending on how many rows were swapped
+  Type permutation_sign{1};
+  bool singular{true};
+};
+
+#include "LU.cpp"
+
+#endif // LU_H_
@@ -3,63 +3,74 @@
 #include "Matrix.hpp"
 
 #include <algorithm>
-#include <cmath>
 #include <cstdlib>
 #include <type_traits>
-#include <cstring>
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns>::Matrix(float value)
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>::Matrix(Type value) : matrix{}
 {
   this->Fill(value);
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns>::Matrix(const std::array<float, rows * columns> &array)
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>::Matrix(
+    const std::array<Type, rows * columns> &array)
+    : matrix{}
 {
   this->setMatrixToArray(array);
 }
 
-template <uint8_t rows, uint8_t columns>
-template <typename... Args>
-Matrix<rows, columns>::Matrix(Args... args)
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename... Args, typename>
+constexpr Matrix<rows, columns, Type>::Matrix(Args... args) : matrix{}
 {
   constexpr uint16_t arraySize{static_cast<uint16_t>(rows) *
                                static_cast<uint16_t>(columns)};
 
-  std::initializer_list<float> initList{static_cast<float>(args)...};
+  std::initializer_list<Type> initList{static_cast<Type>(args)...};
   // choose whichever buffer size is smaller for the copy length
-  uint32_t minSize =
+  uint16_t minSize =
       std::min(arraySize, static_cast<uint16_t>(initList.size()));
-  memcpy(this->matrix.begin(), initList.begin(), minSize * sizeof(float));
+  for (uint16_t idx{0}; idx < minSize; idx++)
+  {
+    this->matrix[idx] = initList.begin()[idx];
+  }
 }
 
-template <uint8_t rows, uint8_t columns>
-void Matrix<rows, columns>::Identity()
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename OtherType>
+constexpr Matrix<rows, columns, Type>::Matrix(
+    const Matrix<rows, columns, OtherType> &other)
+    : matrix{}
 {
-  this->Fill(0);
-  for (uint8_t idx{0}; idx < rows; idx++)
+  for (uint16_t idx{0}; idx < rows * columns; idx++)
   {
-    this->matrix[idx * columns + idx] = 1;
+    this->matrix[idx] = static_cast<Type>(other.matrix[idx]);
   }
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns>::Matrix(const Matrix<rows, columns> &other)
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Expression>
+constexpr Matrix<rows, columns, Type>::Matrix(
+    const MatrixExpression<Expression, rows, columns, Type> &expression)
+    : matrix{}
 {
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  this->assign(expression);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr void Matrix<rows, columns, Type>::Identity()
+{
+  this->Fill(0);
+  for (uint8_t idx{0}; idx < rows; idx++)
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
-    {
-      this->matrix[row_idx * columns + column_idx] =
-          other.Get(row_idx, column_idx);
-    }
+    this->matrix[idx * columns + idx] = 1;
   }
 }
 
-template <uint8_t rows, uint8_t columns>
-void Matrix<rows, columns>::setMatrixToArray(
-    const std::array<float, rows * columns> &array)
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr void Matrix<rows, columns, Type>::setMatrixToArray(
+    const std::array<Type, rows * columns> &array)
 {
   for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
   {
@@ -80,95 +91,284 @@ void Matrix<rows, columns>::setMatrixToArray(
   }
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::Add(const Matrix<rows, columns> &other,
-                           Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::Add(const Matrix<rows, columns, Type> &other,
+                           Matrix<rows, columns, Type> &result) const
 {
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  MATRIX_PERF_SCOPE(MatrixAdd, this->Add(other, result));
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      result[row_idx][column_idx] =
-          this->Get(row_idx, column_idx) + other.Get(row_idx, column_idx);
+      result.matrix[idx] = this->matrix[idx] + other.matrix[idx];
     }
+    return result;
   }
+
+  ElementKernels::Add(this->matrix.data(), other.matrix.data(),
+                      result.matrix.data(), rows * columns);
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::Sub(const Matrix<rows, columns> &other,
-                           Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::Sub(const Matrix<rows, columns, Type> &other,
+                           Matrix<rows, columns, Type> &result) const
 {
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  MATRIX_PERF_SCOPE(MatrixSub, this->Sub(other, result));
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      result[row_idx][column_idx] =
-          this->Get(row_idx, column_idx) - other.Get(row_idx, column_idx);
+      result.matrix[idx] = this->matrix[idx] - other.matrix[idx];
     }
+    return result;
   }
 
+  ElementKernels::Sub(this->matrix.data(), other.matrix.data(),
+                      result.matrix.data(), rows * columns);
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
+template <uint8_t rows, uint8_t columns, typename Type>
 template <uint8_t other_columns>
-Matrix<rows, other_columns> &
-Matrix<rows, columns>::Mult(const Matrix<columns, other_columns> &other,
-                            Matrix<rows, other_columns> &result) const
+constexpr Matrix<rows, other_columns, Type> &
+Matrix<rows, columns, Type>::Mult(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result) const
 {
-  // allocate some buffers for all of our dot products
-  Matrix<1, columns> this_row;
-  Matrix<columns, 1> other_column;
+  MATRIX_PERF_SCOPE(MatrixMult, this->Mult(other, result));
+  this->multiply(other, result, MultTag<other_columns>{});
+  return result;
+}
 
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr void Matrix<rows, columns, Type>::multiply(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result,
+    std::integral_constant<uint8_t, 0>) const
+{
+  if (static_cast<uint32_t>(rows) * columns * other_columns <
+          Gemm::block_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    // get our row
-    this->GetRow(row_idx, this_row);
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    // small products are cheapest as a plain loop the compiler can unroll.
+    // It's also the only path that can run at compile time.
+    this->multiplySmall(other, result,
+                        std::is_same<Accumulator, Type>{});
+    return;
+  }
+
+  Gemm::Multiply(rows, other_columns, columns,
+                 this->matrix.data(), columns,
+                 other.matrix.data(), other_columns,
+                 result.matrix.data(), other_columns);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr void Matrix<rows, columns, Type>::multiply(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result,
+    std::integral_constant<uint8_t, 2>) const
+{
+  const std::array<Type, 4> a{this->matrix};
+  const std::array<Type, 4> b{other.matrix};
+  result.matrix[0] = a[0] * b[0] + a[1] * b[2];
+  result.matrix[1] = a[0] * b[1] + a[1] * b[3];
+  result.matrix[2] = a[2] * b[0] + a[3] * b[2];
+  result.matrix[3] = a[2] * b[1] + a[3] * b[3];
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr void Matrix<rows, columns, Type>::multiply(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result,
+    std::integral_constant<uint8_t, 3>) const
+{
+  const std::array<Type, 9> a{this->matrix};
+  const std::array<Type, 9> b{other.matrix};
+  for (uint8_t row_idx{0}; row_idx < 3; row_idx++)
+  {
+    const Type *a_row{&(a[row_idx * 3])};
+    for (uint8_t column_idx{0}; column_idx < 3; column_idx++)
     {
-      // get the other matrix'ss column
-      other.GetColumn(column_idx, other_column);
+      result.matrix[row_idx * 3 + column_idx] = a_row[0] * b[column_idx] +
+                                                a_row[1] * b[3 + column_idx] +
+                                                a_row[2] * b[6 + column_idx];
+    }
+  }
+}
 
-      // the result's index is equal to the dot product of these two vectors
-      result[row_idx][column_idx] =
-          Matrix<rows, columns>::DotProduct(this_row, other_column.Transpose());
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr void Matrix<rows, columns, Type>::multiply(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result,
+    std::integral_constant<uint8_t, 4>) const
+{
+  // every row of the result is a combination of the rows of other, four wide
+  // so it maps onto one vector register
+  const std::array<Type, 16> a{this->matrix};
+  const std::array<Type, 16> b{other.matrix};
+  for (uint8_t row_idx{0}; row_idx < 4; row_idx++)
+  {
+    const Type *a_row{&(a[row_idx * 4])};
+    for (uint8_t column_idx{0}; column_idx < 4; column_idx++)
+    {
+      result.matrix[row_idx * 4 + column_idx] =
+          a_row[0] * b[column_idx] + a_row[1] * b[4 + column_idx] +
+          a_row[2] * b[8 + column_idx] + a_row[3] * b[12 + column_idx];
     }
   }
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr Matrix<rows, other_columns, Type> &
+Matrix<rows, columns, Type>::Mult(
+    const MatrixTransposed<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result) const
+{
+  MATRIX_PERF_SCOPE(MatrixMultTranspose, this->Mult(other, result));
+  this->View().MultTranspose(other.Source(), result.View());
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr Matrix<columns, other_columns, Type> &
+Matrix<rows, columns, Type>::TransposeMult(
+    const Matrix<rows, other_columns, Type> &other,
+    Matrix<columns, other_columns, Type> &result) const
+{
+  MATRIX_PERF_SCOPE(MatrixTransposeMult, this->TransposeMult(other, result));
+  this->View().TransposeMult(other.View(), result.View());
+  return result;
+}
 
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_rows>
+constexpr Matrix<rows, other_rows, Type> &
+Matrix<rows, columns, Type>::MultTranspose(
+    const Matrix<other_rows, columns, Type> &other,
+    Matrix<rows, other_rows, Type> &result) const
+{
+  MATRIX_PERF_SCOPE(MatrixMultTranspose, this->MultTranspose(other, result));
+  this->View().MultTranspose(other.View(), result.View());
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::Mult(float scalar, Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr void Matrix<rows, columns, Type>::multiplySmall(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result, std::true_type) const
 {
+  // walking the rows of other keeps every access contiguous
   for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    Type *result_row{&(result.matrix[row_idx * other_columns])};
+    for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+    {
+      result_row[column_idx] = 0;
+    }
+
+    for (uint8_t inner_idx{0}; inner_idx < columns; inner_idx++)
     {
-      result[row_idx][column_idx] = this->Get(row_idx, column_idx) * scalar;
+      const Type scale{this->matrix[row_idx * columns + inner_idx]};
+      const Type *other_row{&(other.matrix[inner_idx * other_columns])};
+      for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+      {
+        result_row[column_idx] += scale * other_row[column_idx];
+      }
     }
   }
+}
 
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr void Matrix<rows, columns, Type>::multiplySmall(
+    const Matrix<columns, other_columns, Type> &other,
+    Matrix<rows, other_columns, Type> &result, std::false_type) const
+{
+  // same walk, but each row is summed in the accumulator before it's stored
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    std::array<Accumulator, other_columns> result_row{};
+    for (uint8_t inner_idx{0}; inner_idx < columns; inner_idx++)
+    {
+      const Type scale{this->matrix[row_idx * columns + inner_idx]};
+      const Type *other_row{&(other.matrix[inner_idx * other_columns])};
+      for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+      {
+        result_row[column_idx] +=
+            ScalarTraits<Type>::Product(scale, other_row[column_idx]);
+      }
+    }
+
+    for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+    {
+      result.matrix[row_idx * other_columns + column_idx] =
+          static_cast<Type>(result_row[column_idx]);
+    }
+  }
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::Mult(Type scalar,
+                                  Matrix<rows, columns, Type> &result) const
+{
+  MATRIX_PERF_SCOPE(MatrixScalarMult, this->Mult(scalar, result));
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
+  {
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
+    {
+      result.matrix[idx] = this->matrix[idx] * scalar;
+    }
+    return result;
+  }
+
+  ElementKernels::Scale(this->matrix.data(), scalar, result.matrix.data(),
+                        rows * columns);
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns>
-Matrix<rows, columns>::Invert() const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::Invert() const
 {
+  MATRIX_PERF_SCOPE(MatrixInvert, this->Invert());
   // since all matrix sizes have to be statically specified at compile time we
   // can do this
   static_assert(rows == columns,
                 "Your matrix isn't square and can't be inverted");
 
-  Matrix<rows, columns> result{};
-  // unfortunately we can't calculate this at compile time so we'll just reurn
-  // zeros
-  float determinant{this->Det()};
+  return this->invert(InvertTag{});
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::invert(std::true_type) const
+{
+  Matrix<rows, columns, Type> result{};
+  LU<rows, Type>{*this}.Invert(result);
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::invert(std::false_type) const
+{
+  Matrix<rows, columns, Type> result{};
+  Type determinant{this->Det()};
   if (determinant == 0)
   {
     // you can't invert a matrix with a negative determinant
@@ -176,151 +376,427 @@ Matrix<rows, columns>::Invert() const
     return result;
   }
 
-  // TODO: This algorithm is really inneficient because of the matrix of minors.
-  // We should make a different algorithm how to calculate the inverse:
-  // https://www.mathsisfun.com/algebra/matrix-inverse-minors-cofactors-adjugate.html
-
   // calculate the matrix of minors
-  Matrix<rows, columns> minors{};
+  Matrix<rows, columns, Type> minors{};
   this->MatrixOfMinors(minors);
 
   // now adjugate the matrix and save it in our output
   minors.adjugate(result);
 
   // scale the result by 1/determinant and we have our answer
-  result = result * (1 / determinant);
-  // result.Mult(1 / determinant, result);
+  result.Mult(1 / determinant, result);
+
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::invert(std::integral_constant<uint8_t, 2>) const
+{
+  const std::array<Type, 4> &m{this->matrix};
+  const Type determinant{m[0] * m[3] - m[1] * m[2]};
+  if (determinant == 0)
+  {
+    return Matrix<rows, columns, Type>{Type{0}};
+  }
 
+  const Type scale{1 / determinant};
+  Matrix<rows, columns, Type> result{};
+  result.matrix = {m[3] * scale, -m[1] * scale, -m[2] * scale, m[0] * scale};
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<columns, rows>
-Matrix<rows, columns>::Transpose() const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::invert(std::integral_constant<uint8_t, 3>) const
 {
-  Matrix<columns, rows> result{};
+  const std::array<Type, 9> &m{this->matrix};
+  // the adjugate. Its first column holds the cofactors of the first row,
+  // which double as the terms of the determinant.
+  Matrix<rows, columns, Type> result{};
+  result.matrix = {m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8],
+                   m[1] * m[5] - m[2] * m[4], m[5] * m[6] - m[3] * m[8],
+                   m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+                   m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7],
+                   m[0] * m[4] - m[1] * m[3]};
+  const Type determinant{m[0] * result.matrix[0] + m[1] * result.matrix[3] +
+                         m[2] * result.matrix[6]};
+  if (determinant == 0)
+  {
+    result.Fill(0);
+    return result;
+  }
+
+  const Type scale{1 / determinant};
+  for (uint8_t idx{0}; idx < 9; idx++)
+  {
+    result.matrix[idx] *= scale;
+  }
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::invert(std::integral_constant<uint8_t, 4>) const
+{
+  const std::array<Type, 16> &m{this->matrix};
+  // Laplace expansion along pairs of rows: the 2x2 determinants of the top
+  // two rows and of the bottom two rows, for every pair of columns. Each one
+  // is shared by several cofactors.
+  const Type s0{m[0] * m[5] - m[1] * m[4]};
+  const Type s1{m[0] * m[6] - m[2] * m[4]};
+  const Type s2{m[0] * m[7] - m[3] * m[4]};
+  const Type s3{m[1] * m[6] - m[2] * m[5]};
+  const Type s4{m[1] * m[7] - m[3] * m[5]};
+  const Type s5{m[2] * m[7] - m[3] * m[6]};
+  const Type c0{m[8] * m[13] - m[9] * m[12]};
+  const Type c1{m[8] * m[14] - m[10] * m[12]};
+  const Type c2{m[8] * m[15] - m[11] * m[12]};
+  const Type c3{m[9] * m[14] - m[10] * m[13]};
+  const Type c4{m[9] * m[15] - m[11] * m[13]};
+  const Type c5{m[10] * m[15] - m[11] * m[14]};
+
+  const Type determinant{s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 +
+                         s5 * c0};
+  if (determinant == 0)
+  {
+    return Matrix<rows, columns, Type>{Type{0}};
+  }
+
+  const Type scale{1 / determinant};
+  Matrix<rows, columns, Type> result{};
+  result.matrix = {
+      (m[5] * c5 - m[6] * c4 + m[7] * c3) * scale,
+      (-m[1] * c5 + m[2] * c4 - m[3] * c3) * scale,
+      (m[13] * s5 - m[14] * s4 + m[15] * s3) * scale,
+      (-m[9] * s5 + m[10] * s4 - m[11] * s3) * scale,
+      (-m[4] * c5 + m[6] * c2 - m[7] * c1) * scale,
+      (m[0] * c5 - m[2] * c2 + m[3] * c1) * scale,
+      (-m[12] * s5 + m[14] * s2 - m[15] * s1) * scale,
+      (m[8] * s5 - m[10] * s2 + m[11] * s1) * scale,
+      (m[4] * c4 - m[5] * c2 + m[7] * c0) * scale,
+      (-m[0] * c4 + m[1] * c2 - m[3] * c0) * scale,
+      (m[12] * s4 - m[13] * s2 + m[15] * s0) * scale,
+      (-m[8] * s4 + m[9] * s2 - m[11] * s0) * scale,
+      (-m[4] * c3 + m[5] * c1 - m[6] * c0) * scale,
+      (m[0] * c3 - m[1] * c1 + m[2] * c0) * scale,
+      (-m[12] * s3 + m[13] * s1 - m[14] * s0) * scale,
+      (m[8] * s3 - m[9] * s1 + m[10] * s0) * scale};
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<columns, rows, Type>
+Matrix<rows, columns, Type>::Transpose() const
+{
+  MATRIX_PERF_SCOPE(MatrixTranspose, this->Transpose());
+  return this->transpose(ClosedFormTag{});
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<columns, rows, Type>
+Matrix<rows, columns, Type>::transpose(std::integral_constant<uint8_t, 0>) const
+{
+  Matrix<columns, rows, Type> result{};
   for (uint8_t column_idx{0}; column_idx < rows; column_idx++)
   {
     for (uint8_t row_idx{0}; row_idx < columns; row_idx++)
     {
-      result[row_idx][column_idx] = this->Get(column_idx, row_idx);
+      result.matrix[row_idx * rows + column_idx] =
+          this->matrix[column_idx * columns + row_idx];
     }
   }
 
   return result;
 }
 
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<columns, rows, Type>
+Matrix<rows, columns, Type>::transpose(std::integral_constant<uint8_t, 2>) const
+{
+  const std::array<Type, 4> &m{this->matrix};
+  Matrix<columns, rows, Type> result{};
+  result.matrix = {m[0], m[2], m[1], m[3]};
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<columns, rows, Type>
+Matrix<rows, columns, Type>::transpose(std::integral_constant<uint8_t, 3>) const
+{
+  const std::array<Type, 9> &m{this->matrix};
+  Matrix<columns, rows, Type> result{};
+  result.matrix = {m[0], m[3], m[6], m[1], m[4], m[7], m[2], m[5], m[8]};
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<columns, rows, Type>
+Matrix<rows, columns, Type>::transpose(std::integral_constant<uint8_t, 4>) const
+{
+  const std::array<Type, 16> &m{this->matrix};
+  Matrix<columns, rows, Type> result{};
+  result.matrix = {m[0], m[4], m[8],  m[12], m[1], m[5], m[9],  m[13],
+                   m[2], m[6], m[10], m[14], m[3], m[7], m[11], m[15]};
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixTransposed<columns, rows, Type>
+Matrix<rows, columns, Type>::Transposed() const
+{
+  return MatrixTransposed<columns, rows, Type>{this->View()};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type Matrix<rows, columns, Type>::Det() const
+{
+  MATRIX_PERF_SCOPE(MatrixDet, this->Det());
+  static_assert(rows == columns,
+                "You can't take the determinant of a non-square matrix.");
+
+  return this->det(DetTag{});
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type Matrix<rows, columns, Type>::det(std::true_type) const
+{
+  return LU<rows, Type>{*this}.Det();
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type
+Matrix<rows, columns, Type>::det(std::integral_constant<uint8_t, 0>) const
+{
+  return ScalarTraits<Type>::Saturate(1e+6);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type
+Matrix<rows, columns, Type>::det(std::integral_constant<uint8_t, 1>) const
+{
+  return this->matrix[0];
+}
+
 // explicitly define the determinant for a 2x2 matrix because it is definitely
 // the fastest way to calculate a 2x2 matrix determinant
-template <>
-inline float Matrix<0, 0>::Det() const { return 1e+6; }
-template <>
-inline float Matrix<1, 1>::Det() const { return this->matrix[0]; }
-template <>
-inline float Matrix<2, 2>::Det() const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type
+Matrix<rows, columns, Type>::det(std::integral_constant<uint8_t, 2>) const
 {
   return this->matrix[0] * this->matrix[3] - this->matrix[1] * this->matrix[2];
 }
 
-template <uint8_t rows, uint8_t columns>
-float Matrix<rows, columns>::Det() const
+// cofactor expansion along the first row with the 2x2 minors written out
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type
+Matrix<rows, columns, Type>::det(std::integral_constant<uint8_t, 3>) const
 {
-  static_assert(rows == columns,
-                "You can't take the determinant of a non-square matrix.");
+  const std::array<Type, 9> &m{this->matrix};
+  return m[0] * (m[4] * m[8] - m[5] * m[7]) -
+         m[1] * (m[3] * m[8] - m[5] * m[6]) +
+         m[2] * (m[3] * m[7] - m[4] * m[6]);
+}
+
+// Laplace expansion along the top two rows: six 2x2 determinants of the top
+// rows against the complementary ones of the bottom rows, see the 4x4 invert
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type
+Matrix<rows, columns, Type>::det(std::integral_constant<uint8_t, 4>) const
+{
+  const std::array<Type, 16> &m{this->matrix};
+  return (m[0] * m[5] - m[1] * m[4]) * (m[10] * m[15] - m[11] * m[14]) -
+         (m[0] * m[6] - m[2] * m[4]) * (m[9] * m[15] - m[11] * m[13]) +
+         (m[0] * m[7] - m[3] * m[4]) * (m[9] * m[14] - m[10] * m[13]) +
+         (m[1] * m[6] - m[2] * m[5]) * (m[8] * m[15] - m[11] * m[12]) -
+         (m[1] * m[7] - m[3] * m[5]) * (m[8] * m[14] - m[10] * m[12]) +
+         (m[2] * m[7] - m[3] * m[6]) * (m[8] * m[13] - m[9] * m[12]);
+}
 
-  Matrix<rows - 1, columns - 1> MinorMatrix{};
-  float determinant{0};
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t size>
+constexpr Type
+Matrix<rows, columns, Type>::det(std::integral_constant<uint8_t, size>) const
+{
+  Matrix<rows - 1, columns - 1, Type> MinorMatrix{};
+  Type determinant{0};
   for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
   {
-    // for odd indices the sign is negative
-    float sign = (column_idx % 2 == 0) ? 1 : -1;
-    determinant += sign * this->matrix[column_idx] *
-                   this->MinorMatrix(MinorMatrix, 0, column_idx).Det();
+    // for odd indices the sign is negative. Negating rather than multiplying
+    // by -1 keeps types that can't hold 1 (like Q15) exact.
+    const Type term{this->matrix[column_idx] *
+                    this->MinorMatrix(MinorMatrix, 0, column_idx).Det()};
+    determinant += (column_idx % 2 == 0) ? term : -term;
   }
 
   return determinant;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::ElementMultiply(const Matrix<rows, columns> &other,
-                                       Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::ElementMultiply(
+    const Matrix<rows, columns, Type> &other,
+    Matrix<rows, columns, Type> &result) const
 {
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  MATRIX_PERF_SCOPE(MatrixElementMultiply,
+                    this->ElementMultiply(other, result));
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      result[row_idx][column_idx] =
-          this->Get(row_idx, column_idx) * other.Get(row_idx, column_idx);
+      result.matrix[idx] = this->matrix[idx] * other.matrix[idx];
     }
+    return result;
   }
 
+  ElementKernels::Multiply(this->matrix.data(), other.matrix.data(),
+                           result.matrix.data(), rows * columns);
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::ElementDivide(const Matrix<rows, columns> &other,
-                                     Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::ElementDivide(
+    const Matrix<rows, columns, Type> &other,
+    Matrix<rows, columns, Type> &result) const
 {
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  MATRIX_PERF_SCOPE(MatrixElementDivide, this->ElementDivide(other, result));
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      result[row_idx][column_idx] =
-          this->Get(row_idx, column_idx) / other.Get(row_idx, column_idx);
+      result.matrix[idx] = this->matrix[idx] / other.matrix[idx];
     }
+    return result;
   }
 
+  ElementKernels::Divide(this->matrix.data(), other.matrix.data(),
+                         result.matrix.data(), rows * columns);
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-float Matrix<rows, columns>::Get(uint8_t row_index,
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Type Matrix<rows, columns, Type>::Get(uint8_t row_index,
                                  uint8_t column_index) const
 {
-  if (row_index > rows - 1 || column_index > columns - 1)
+  if (!BoundsCheck::Accept(row_index < rows && column_index < columns))
   {
-    return 1e+10; // TODO: We should throw something here instead of failing
-                  // quietly
+    return ScalarTraits<Type>::Saturate(1e+10);
   }
   return this->matrix[row_index * columns + column_index];
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<1, columns> &
-Matrix<rows, columns>::GetRow(uint8_t row_index,
-                              Matrix<1, columns> &row) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<1, columns, Type> &
+Matrix<rows, columns, Type>::GetRow(uint8_t row_index,
+                              Matrix<1, columns, Type> &row) const
 {
-  memcpy(&(row[0]), this->matrix.begin() + row_index * columns,
-         columns * sizeof(float));
+  MATRIX_PERF_SCOPE(MatrixGetRow, this->GetRow(row_index, row));
+  BoundsCheck::Assert(row_index < rows);
+  for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+  {
+    row.matrix[column_idx] = this->matrix[row_index * columns + column_idx];
+  }
 
   return row;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, 1> &
-Matrix<rows, columns>::GetColumn(uint8_t column_index,
-                                 Matrix<rows, 1> &column) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, 1, Type> &
+Matrix<rows, columns, Type>::GetColumn(uint8_t column_index,
+                                 Matrix<rows, 1, Type> &column) const
 {
+  MATRIX_PERF_SCOPE(MatrixGetColumn, this->GetColumn(column_index, column));
+  if (!BoundsCheck::Accept(column_index < columns))
+  {
+    column.Fill(ScalarTraits<Type>::Saturate(1e+10));
+    return column;
+  }
+
   for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
   {
-    column[row_idx][0] = this->Get(row_idx, column_index);
+    column.matrix[row_idx] = this->matrix[row_idx * columns + column_index];
   }
 
   return column;
 }
 
-template <uint8_t rows, uint8_t columns>
-void Matrix<rows, columns>::ToString(std::string &stringBuffer) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns, Type> Matrix<rows, columns, Type>::View()
+{
+  return MatrixView<rows, columns, Type>{this->matrix.data(), columns};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns, const Type>
+Matrix<rows, columns, Type>::View() const
+{
+  return MatrixView<rows, columns, const Type>{this->matrix.data(), columns};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<1, columns, Type>
+Matrix<rows, columns, Type>::Row(uint8_t row_index)
+{
+  return this->View().Row(row_index);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<1, columns, const Type>
+Matrix<rows, columns, Type>::Row(uint8_t row_index) const
+{
+  return this->View().Row(row_index);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, 1, Type>
+Matrix<rows, columns, Type>::Column(uint8_t column_index)
+{
+  return this->View().Column(column_index);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, 1, const Type>
+Matrix<rows, columns, Type>::Column(uint8_t column_index) const
+{
+  return this->View().Column(column_index);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset,
+          uint8_t column_offset>
+constexpr MatrixView<sub_rows, sub_columns, Type>
+Matrix<rows, columns, Type>::Block()
+{
+  return this->View()
+      .template Block<sub_rows, sub_columns, row_offset, column_offset>();
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset,
+          uint8_t column_offset>
+constexpr MatrixView<sub_rows, sub_columns, const Type>
+Matrix<rows, columns, Type>::Block() const
+{
+  return this->View()
+      .template Block<sub_rows, sub_columns, row_offset, column_offset>();
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+void Matrix<rows, columns, Type>::ToString(std::string &stringBuffer) const
 {
   for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
   {
     stringBuffer += "|";
     for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
     {
-      stringBuffer +=
-          std::to_string(this->matrix[row_idx * columns + column_idx]);
+      // to_string has no overloads for the smaller types, print them as the
+      // type their traits ask for
+      stringBuffer += std::to_string(
+          static_cast<typename ScalarTraits<Type>::Printable>(
+              this->matrix[row_idx * columns + column_idx]));
       if (column_idx != columns - 1)
       {
         stringBuffer += "\t";
@@ -330,133 +806,315 @@ void Matrix<rows, columns>::ToString(std::string &stringBuffer) const
   }
 }
 
-template <uint8_t rows, uint8_t columns>
-std::array<float, columns> &Matrix<rows, columns>::
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixRow<columns, Type> Matrix<rows, columns, Type>::
 operator[](uint8_t row_index)
 {
-  if (row_index > rows - 1)
+  if (!BoundsCheck::Accept(row_index < rows))
   {
-    // TODO: We should throw something here instead of failing quietly.
     row_index = 0;
   }
-  // cursed reinterpret_cast that will help us fake having a nested array when
-  // we really don't
-  return *reinterpret_cast<std::array<float, columns> *>(
-      &(this->matrix[row_index * columns]));
+  return MatrixRow<columns, Type>{&(this->matrix[row_index * columns])};
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &Matrix<rows, columns>::
-operator=(const Matrix<rows, columns> &other)
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Expression>
+constexpr Matrix<rows, columns, Type> &Matrix<rows, columns, Type>::
+operator=(const MatrixExpression<Expression, rows, columns, Type> &expression)
 {
-  memcpy(this->matrix.begin(), other.matrix.begin(),
-         rows * columns * sizeof(float));
+  if (!Expression::element_wise)
+  {
+    // A = A.Transposed() would read elements the loop already overwrote
+    const Matrix<rows, columns, Type> evaluated{expression};
+    return *this = evaluated;
+  }
 
-  // return a reference to ourselves so you can chain together these functions
+  this->assign(expression);
   return *this;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> Matrix<rows, columns>::
-operator+(const Matrix<rows, columns> &other) const
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Expression>
+constexpr void Matrix<rows, columns, Type>::assign(
+    const MatrixExpression<Expression, rows, columns, Type> &expression)
 {
-  Matrix<rows, columns> buffer{};
-  this->Add(other, buffer);
-  return buffer;
+  // every element-wise node only reads the same index of its operands
+  // (products are already materialized), so writing into this as we go is
+  // safe even if this matrix is one of the operands
+  for (uint16_t idx{0}; idx < rows * columns; idx++)
+  {
+    this->matrix[idx] = expression.Element(idx);
+  }
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> Matrix<rows, columns>::
-operator-(const Matrix<rows, columns> &other) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::operator+=(const Matrix<rows, columns, Type> &other)
 {
-  Matrix<rows, columns> buffer{};
-  this->Sub(other, buffer);
-  return buffer;
+  return this->Add(other, *this);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Expression>
+constexpr Matrix<rows, columns, Type> &Matrix<rows, columns, Type>::
+operator+=(const MatrixExpression<Expression, rows, columns, Type> &expression)
+{
+  if (!Expression::element_wise)
+  {
+    const Matrix<rows, columns, Type> evaluated{expression};
+    return *this += evaluated;
+  }
+
+  for (uint16_t idx{0}; idx < rows * columns; idx++)
+  {
+    this->matrix[idx] += expression.Element(idx);
+  }
+  return *this;
 }
 
-template <uint8_t rows, uint8_t columns>
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::operator-=(const Matrix<rows, columns, Type> &other)
+{
+  return this->Sub(other, *this);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Expression>
+constexpr Matrix<rows, columns, Type> &Matrix<rows, columns, Type>::
+operator-=(const MatrixExpression<Expression, rows, columns, Type> &expression)
+{
+  if (!Expression::element_wise)
+  {
+    const Matrix<rows, columns, Type> evaluated{expression};
+    return *this -= evaluated;
+  }
+
+  for (uint16_t idx{0}; idx < rows * columns; idx++)
+  {
+    this->matrix[idx] -= expression.Element(idx);
+  }
+  return *this;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::operator*=(Type scalar)
+{
+  return this->Mult(scalar, *this);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::operator*=(const Matrix<columns, columns, Type> &other)
+{
+  MATRIX_PERF_SCOPE(MatrixMult, *this *= other);
+  // other is only this matrix when it's square
+  const bool aliased{static_cast<const void *>(&other) ==
+                     static_cast<const void *>(this)};
+  if (static_cast<uint32_t>(rows) * columns * columns < Gemm::block_threshold ||
+      ConstexprMath::IsConstantEvaluated())
+  {
+    if (aliased)
+    {
+      const Matrix<columns, columns, Type> copy{other};
+      return *this *= copy;
+    }
+
+    // each row of the result only needs the same row of this, so it's summed
+    // on the side and written back over the row it came from
+    for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+    {
+      std::array<Accumulator, columns> result_row{};
+      for (uint8_t inner_idx{0}; inner_idx < columns; inner_idx++)
+      {
+        const Type scale{this->matrix[row_idx * columns + inner_idx]};
+        const Type *other_row{&(other.matrix[inner_idx * columns])};
+        for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+        {
+          result_row[column_idx] +=
+              ScalarTraits<Type>::Product(scale, other_row[column_idx]);
+        }
+      }
+
+      for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+      {
+        this->matrix[row_idx * columns + column_idx] =
+            static_cast<Type>(result_row[column_idx]);
+      }
+    }
+    return *this;
+  }
+
+  // the blocked kernel reads its operands while it writes the result, so it
+  // gets a copy of this one
+  const Matrix<rows, columns, Type> source{*this};
+  const Type *other_data{aliased ? source.matrix.data() : other.matrix.data()};
+  Gemm::Multiply(rows, columns, columns,
+                 source.matrix.data(), columns,
+                 other_data, columns,
+                 this->matrix.data(), columns);
+  return *this;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Result, typename Operation>
+constexpr Result Matrix<rows, columns, Type>::evaluate(Operation operation,
+                                                       std::false_type)
+{
+  Result result{};
+  operation(result);
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Result, typename Operation>
+constexpr Result Matrix<rows, columns, Type>::evaluate(Operation operation,
+                                                       std::true_type)
+{
+  if (ConstexprMath::IsConstantEvaluated())
+  {
+    return evaluate<Result>(operation, std::false_type{});
+  }
+  return evaluateUninitialized<Result>(operation);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Result, typename Operation>
+Result Matrix<rows, columns, Type>::evaluateUninitialized(Operation operation)
+{
+  // not constexpr, a constant expression can't leave its storage uninitialized
+  Result result;
+  operation(result);
+  return result;
+}
+
+#ifndef MATRIX_EXPRESSION_TEMPLATES
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> Matrix<rows, columns, Type>::
+operator+(const Matrix<rows, columns, Type> &other) const
+{
+  return evaluate<Matrix<rows, columns, Type>>(
+      [&](Matrix<rows, columns, Type> &result) { this->Add(other, result); },
+      ElementWiseKernel{});
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> Matrix<rows, columns, Type>::
+operator-(const Matrix<rows, columns, Type> &other) const
+{
+  return evaluate<Matrix<rows, columns, Type>>(
+      [&](Matrix<rows, columns, Type> &result) { this->Sub(other, result); },
+      ElementWiseKernel{});
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
 template <uint8_t other_columns>
-Matrix<rows, other_columns> Matrix<rows, columns>::
-operator*(const Matrix<columns, other_columns> &other) const
+constexpr Matrix<rows, other_columns, Type> Matrix<rows, columns, Type>::
+operator*(const Matrix<columns, other_columns, Type> &other) const
 {
-  Matrix<rows, other_columns> buffer{};
-  this->Mult(other, buffer);
-  return buffer;
+  return evaluate<Matrix<rows, other_columns, Type>>(
+      [&](Matrix<rows, other_columns, Type> &result)
+      { this->Mult(other, result); },
+      ProductKernel<other_columns>{});
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> Matrix<rows, columns>::operator*(float scalar) const
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+constexpr Matrix<rows, other_columns, Type> Matrix<rows, columns, Type>::
+operator*(const MatrixTransposed<columns, other_columns, Type> &other) const
 {
-  Matrix<rows, columns> buffer{};
-  this->Mult(scalar, buffer);
-  return buffer;
+  return evaluate<Matrix<rows, other_columns, Type>>(
+      [&](Matrix<rows, other_columns, Type> &result)
+      { this->Mult(other, result); },
+      ProductKernel<other_columns>{});
 }
 
-template <uint8_t rows, uint8_t columns>
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type>
+Matrix<rows, columns, Type>::operator*(Type scalar) const
+{
+  return evaluate<Matrix<rows, columns, Type>>(
+      [&](Matrix<rows, columns, Type> &result) { this->Mult(scalar, result); },
+      ElementWiseKernel{});
+}
+#endif // MATRIX_EXPRESSION_TEMPLATES
+
+template <uint8_t rows, uint8_t columns, typename Type>
 template <uint8_t vector_size>
-float Matrix<rows, columns>::DotProduct(const Matrix<1, vector_size> &vec1,
-                                        const Matrix<1, vector_size> &vec2)
+constexpr Type
+Matrix<rows, columns, Type>::DotProduct(const Matrix<1, vector_size, Type> &vec1,
+                                        const Matrix<1, vector_size, Type> &vec2)
 {
-  float sum{0};
+  Accumulator sum{0};
   for (uint8_t i{0}; i < vector_size; i++)
   {
-    sum += vec1.Get(0, i) * vec2.Get(0, i);
+    sum += ScalarTraits<Type>::Product(vec1.matrix[i], vec2.matrix[i]);
   }
 
-  return sum;
+  return static_cast<Type>(sum);
 }
 
-template <uint8_t rows, uint8_t columns>
+template <uint8_t rows, uint8_t columns, typename Type>
 template <uint8_t vector_size>
-float Matrix<rows, columns>::DotProduct(const Matrix<vector_size, 1> &vec1,
-                                        const Matrix<vector_size, 1> &vec2)
+constexpr Type
+Matrix<rows, columns, Type>::DotProduct(const Matrix<vector_size, 1, Type> &vec1,
+                                        const Matrix<vector_size, 1, Type> &vec2)
 {
-  float sum{0};
+  Accumulator sum{0};
   for (uint8_t i{0}; i < vector_size; i++)
   {
-    sum += vec1.Get(i, 0) * vec2.Get(i, 0);
+    sum += ScalarTraits<Type>::Product(vec1.matrix[i], vec2.matrix[i]);
   }
 
-  return sum;
+  return static_cast<Type>(sum);
 }
 
-template <uint8_t rows, uint8_t columns>
-void Matrix<rows, columns>::Fill(float value)
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr void Matrix<rows, columns, Type>::Fill(Type value)
 {
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      this->matrix[row_idx * columns + column_idx] = value;
+      this->matrix[idx] = value;
     }
+    return;
   }
+
+  ElementKernels::Fill(this->matrix.data(), value, rows * columns);
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::MatrixOfMinors(Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::MatrixOfMinors(
+    Matrix<rows, columns, Type> &result) const
 {
-  Matrix<rows - 1, columns - 1> MinorMatrix{};
+  MATRIX_PERF_SCOPE(MatrixOfMinors, this->MatrixOfMinors(result));
+  Matrix<rows - 1, columns - 1, Type> MinorMatrix{};
 
   for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
   {
     for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
     {
       this->MinorMatrix(MinorMatrix, row_idx, column_idx);
-      result[row_idx][column_idx] = MinorMatrix.Det();
+      result.matrix[row_idx * columns + column_idx] = MinorMatrix.Det();
     }
   }
 
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows - 1, columns - 1> &
-Matrix<rows, columns>::MinorMatrix(Matrix<rows - 1, columns - 1> &result,
-                                   uint8_t row_idx, uint8_t column_idx) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows - 1, columns - 1, Type> &
+Matrix<rows, columns, Type>::MinorMatrix(
+    Matrix<rows - 1, columns - 1, Type> &result, uint8_t row_idx,
+    uint8_t column_idx) const
 {
-  std::array<float, (rows - 1) * (columns - 1)> subArray{};
-  uint16_t array_idx{0};
+  MATRIX_PERF_SCOPE(MatrixMinorMatrix,
+                    this->MinorMatrix(result, row_idx, column_idx));
+  uint16_t result_idx{0};
   for (uint8_t row_iter{0}; row_iter < rows; row_iter++)
   {
     if (row_iter == row_idx)
@@ -469,69 +1127,90 @@ Matrix<rows, columns>::MinorMatrix(Matrix<rows - 1, columns - 1> &result,
       {
         continue;
       }
-      subArray[array_idx] = this->Get(row_iter, column_iter);
-      array_idx++;
+      result.matrix[result_idx] = this->matrix[row_iter * columns + column_iter];
+      result_idx++;
     }
   }
 
-  result = Matrix<rows - 1, columns - 1>{subArray};
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::adjugate(Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixMinor<rows - 1, columns - 1, Type>
+Matrix<rows, columns, Type>::Minor(uint8_t row_idx, uint8_t column_idx) const
+{
+  return MatrixMinor<rows - 1, columns - 1, Type>{this->View(), row_idx,
+                                                  column_idx};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::adjugate(Matrix<rows, columns, Type> &result) const
 {
   for (uint8_t row_iter{0}; row_iter < rows; row_iter++)
   {
     for (uint8_t column_iter{0}; column_iter < columns; column_iter++)
     {
-      float sign = ((row_iter + 1) % 2) == 0 ? -1 : 1;
-      sign *= ((column_iter + 1) % 2) == 0 ? -1 : 1;
-      result[column_iter][row_iter] = this->Get(row_iter, column_iter) * sign;
+      const Type value{this->matrix[row_iter * columns + column_iter]};
+      result.matrix[column_iter * rows + row_iter] =
+          (row_iter + column_iter) % 2 == 0 ? value : -value;
     }
   }
 
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
-Matrix<rows, columns> &
-Matrix<rows, columns>::Normalize(Matrix<rows, columns> &result) const
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr Matrix<rows, columns, Type> &
+Matrix<rows, columns, Type>::Normalize(
+    Matrix<rows, columns, Type> &result) const
 {
-  float sum{0};
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  MATRIX_PERF_SCOPE(MatrixNormalize, this->Normalize(result));
+  static_assert(!std::is_integral<Type>::value,
+                "Integer matrices can't be normalized");
+
+  Accumulator sum{0};
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      float val{this->Get(row_idx, column_idx)};
-      sum += val * val;
+      sum += ScalarTraits<Type>::Product(this->matrix[idx], this->matrix[idx]);
     }
   }
+  else
+  {
+    sum = ElementKernels::SumOfSquares(this->matrix.data(), rows * columns);
+  }
 
   if (sum == 0)
   {
     // this wouldn't do anything anyways
-    result.Fill(1e+6);
+    result.Fill(ScalarTraits<Type>::Saturate(1e+6));
     return result;
   }
 
-  sum = sqrt(sum);
+  sum = ConstexprMath::Sqrt(sum);
 
-  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  if (rows * columns < ElementKernels::dispatch_threshold ||
+      ConstexprMath::IsConstantEvaluated())
   {
-    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    for (uint16_t idx{0}; idx < rows * columns; idx++)
     {
-      result[row_idx][column_idx] = this->Get(row_idx, column_idx) / sum;
+      result.matrix[idx] = static_cast<Type>(this->matrix[idx] / sum);
     }
+    return result;
   }
 
+  ElementKernels::DivideScalar(this->matrix.data(), static_cast<Type>(sum),
+                               result.matrix.data(), rows * columns);
   return result;
 }
 
-template <uint8_t rows, uint8_t columns>
+template <uint8_t rows, uint8_t columns, typename Type>
 template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset, uint8_t column_offset>
-Matrix<sub_rows, sub_columns> Matrix<rows, columns>::SubMatrix() const
+constexpr Matrix<sub_rows, sub_columns, Type>
+Matrix<rows, columns, Type>::SubMatrix() const
 {
   // static assert that sub_rows + row_offset <= rows
   // static assert that sub_columns + column_offset <= columns
@@ -540,21 +1219,23 @@ Matrix<sub_rows, sub_columns> Matrix<rows, columns>::SubMatrix() const
   static_assert(sub_columns + column_offset <= columns,
                 "The submatrix you're trying to get is out of bounds (columns)");
 
-  Matrix<sub_rows, sub_columns> buffer{};
+  Matrix<sub_rows, sub_columns, Type> buffer{};
   for (uint8_t row_idx{0}; row_idx < sub_rows; row_idx++)
   {
     for (uint8_t column_idx{0}; column_idx < sub_columns; column_idx++)
     {
-      buffer[row_idx][column_idx] =
-          this->Get(row_idx + row_offset, column_idx + column_offset);
+      buffer.matrix[row_idx * sub_columns + column_idx] =
+          this->matrix[(row_idx + row_offset) * columns + column_idx +
+                       column_offset];
     }
   }
   return buffer;
 }
 
-template <uint8_t rows, uint8_t columns>
+template <uint8_t rows, uint8_t columns, typename Type>
 template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset, uint8_t column_offset>
-void Matrix<rows, columns>::SetSubMatrix(const Matrix<sub_rows, sub_columns> &sub_matrix)
+constexpr void Matrix<rows, columns, Type>::SetSubMatrix(
+    const Matrix<sub_rows, sub_columns, Type> &sub_matrix)
 {
   static_assert(sub_rows + row_offset <= rows,
                 "The submatrix you're trying to set is out of bounds (rows)");
@@ -565,7 +1246,8 @@ void Matrix<rows, columns>::SetSubMatrix(const Matrix<sub_rows, sub_columns> &su
   {
     for (uint8_t column_idx{0}; column_idx < sub_columns; column_idx++)
     {
-      this->matrix[(row_idx + row_offset) * columns + column_idx + column_offset] = sub_matrix.Get(row_idx, column_idx);
+      this->matrix[(row_idx + row_offset) * columns + column_idx + column_offset] =
+          sub_matrix.matrix[row_idx * sub_columns + column_idx];
     }
   }
 }
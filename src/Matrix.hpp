@@ -2,53 +2,144 @@
 #define MATRIX_H_
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <string>
+#include <type_traits>
+#include <utility>
+
+#include "BoundsCheck.hpp"
+#include "ConstexprMath.hpp"
+#include "ElementKernels.hpp"
+#include "FixedPoint.hpp"
+#include "Gemm.hpp"
+#include "MatrixExpression.hpp"
+#include "PerfCounters.hpp"
+#include "ScalarTraits.hpp"
+
+template <uint8_t size, typename Type = float>
+class LU;
+template <uint8_t size, typename Type = float>
+class LLT;
+template <uint8_t size, typename Type = float>
+class LDLT;
+template <uint8_t states, uint8_t measurements, typename Type = float>
+class KalmanFilter;
+template <size_t count, uint8_t rows, uint8_t columns, typename Type = float>
+class MatrixBatch;
+template <uint8_t rows, uint8_t columns, typename Type = float>
+class MatrixView;
+template <uint8_t rows, uint8_t columns, typename Type = float>
+class MatrixMinor;
 
 // TODO: Add a function to calculate eigenvalues/vectors
 // TODO: Add a function to compute RREF
 // TODO: Add a function for SVD decomposition
 // TODO: Add a function for LQ decomposition
 
-template <uint8_t rows, uint8_t columns>
+/**
+ * @brief One row of a matrix, so matrix[row][column] reads and writes the
+ * element in place
+ */
+template <uint8_t columns, typename Type = float>
+class MatrixRow
+{
+public:
+  constexpr explicit MatrixRow(Type *row) : row(row) {}
+
+  /**
+   * @note column_index is only checked when the bounds check policy traps, see
+   * BoundsCheck
+   */
+  constexpr Type &operator[](uint8_t column_index) const
+  {
+    BoundsCheck::Assert(column_index < columns);
+    return this->row[column_index];
+  }
+
+private:
+  Type *row;
+};
+
+/**
+ * @note Everything except ToString can be used in constant expressions, so
+ * products, inverses and so on of constant matrices fold at compile time:
+ * @code
+ * constexpr Matrix<3, 3> mount{...};
+ * constexpr Matrix<3, 3> calibration{...};
+ * constexpr Matrix<3, 3> sensor_to_body{mount * calibration};
+ * @endcode
+ *
+ * The element type is the last template parameter and defaults to float (the
+ * default lives on the declaration in MatrixExpression.hpp). Use double where
+ * float runs out of precision, like long running covariances, _Float16 to
+ * halve the storage of big batches, or an integer type for exact arithmetic.
+ * MatrixOf<Type, rows, columns> spells the same thing with the type first.
+ * @note only float runs on the SIMD and blocked GEMM kernels, every other type
+ * uses plain loops the compiler vectorizes as well as it can
+ * @note sums (products, dot products, norms) of _Float16 matrices are
+ * accumulated in float, see ScalarTraits
+ * @note integer matrices take their determinant by exact cofactor expansion at
+ * every size and can't be normalized. Their inverse is only exact when the
+ * determinant is 1 or -1.
+ */
+template <uint8_t rows, uint8_t columns, typename Type>
 class Matrix
+    : public MatrixExpression<Matrix<rows, columns, Type>, rows, columns, Type>
 {
 public:
   /**
    * @brief create a matrix but leave all of its values unitialized
    */
-  Matrix() = default;
+  constexpr Matrix() = default;
 
   /**
    * @brief Create a matrix but fill all of its entries with one value
    */
-  Matrix(float value);
+  constexpr Matrix(Type value);
 
   /**
    * @brief Initialize a matrix with an array
    */
-  Matrix(const std::array<float, rows * columns> &array);
+  constexpr Matrix(const std::array<Type, rows * columns> &array);
 
   /**
    * @brief Initialize a matrix as a copy of another matrix
    */
-  Matrix(const Matrix<rows, columns> &other);
+  constexpr Matrix(const Matrix<rows, columns, Type> &other) = default;
+
+  /**
+   * @brief Initialize a matrix by converting every element of a matrix of
+   * another element type
+   */
+  template <typename OtherType>
+  constexpr explicit Matrix(const Matrix<rows, columns, OtherType> &other);
 
   /**
    * @brief Initialize a matrix directly with any number of arguments
    */
-  template <typename... Args>
-  Matrix(Args... args);
+  template <typename... Args,
+            typename = decltype(std::initializer_list<Type>{
+                static_cast<Type>(std::declval<Args>())...})>
+  constexpr Matrix(Args... args);
+
+  /**
+   * @brief Initialize a matrix by evaluating an expression
+   */
+  template <typename Expression>
+  constexpr Matrix(
+      const MatrixExpression<Expression, rows, columns, Type> &expression);
 
   /**
    * @brief set the matrix diagonals to 1 and all other values to 0
    */
-  void Identity();
+  constexpr void Identity();
 
   /**
    * @brief Set all elements in this to value
    */
-  void Fill(float value);
+  constexpr void Fill(Type value);
 
   /**
    * @brief Element-wise matrix addition
@@ -56,8 +147,9 @@ public:
    * @param result A buffer to store the result into
    * @note there is no problem if result == this
    */
-  Matrix<rows, columns> &Add(const Matrix<rows, columns> &other,
-                             Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  Add(const Matrix<rows, columns, Type> &other,
+      Matrix<rows, columns, Type> &result) const;
 
   /**
    * @brief Element-wise subtract matrix
@@ -65,17 +157,55 @@ public:
    * @param result A buffer to store the result into
    * @note there is no problem if result == this
    */
-  Matrix<rows, columns> &Sub(const Matrix<rows, columns> &other,
-                             Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  Sub(const Matrix<rows, columns, Type> &other,
+      Matrix<rows, columns, Type> &result) const;
 
   /**
    * @brief Matrix multiply the two matrices
    * @param other the other matrix to multiply into this one
    * @param result A buffer to store the result into
+   * @warning result must not be this or other
    */
   template <uint8_t other_columns>
-  Matrix<rows, other_columns> &Mult(const Matrix<columns, other_columns> &other,
-                                    Matrix<rows, other_columns> &result) const;
+  constexpr Matrix<rows, other_columns, Type> &
+  Mult(const Matrix<columns, other_columns, Type> &other,
+       Matrix<rows, other_columns, Type> &result) const;
+
+  /**
+   * @brief Multiply by the transpose of a matrix, see MultTranspose
+   * @code
+   * HP.Mult(H.Transposed(), S);
+   * @endcode
+   */
+  template <uint8_t other_columns>
+  constexpr Matrix<rows, other_columns, Type> &
+  Mult(const MatrixTransposed<columns, other_columns, Type> &other,
+       Matrix<rows, other_columns, Type> &result) const;
+
+  /**
+   * @brief Calculate this^T * other without transposing this. Both matrices
+   * are read along their rows.
+   * @param other a matrix with as many rows as this one
+   * @param result A buffer to store the result into
+   * @warning result must not be this or other
+   */
+  template <uint8_t other_columns>
+  constexpr Matrix<columns, other_columns, Type> &
+  TransposeMult(const Matrix<rows, other_columns, Type> &other,
+                Matrix<columns, other_columns, Type> &result) const;
+
+  /**
+   * @brief Calculate this * other^T without transposing other. Every element
+   * of the result is the dot product of a row of this and a row of other.
+   * @param other a matrix with as many columns as this one
+   * @param result A buffer to store the result into
+   * @warning result must not be this or other
+   */
+  template <uint8_t other_rows>
+  constexpr Matrix<rows, other_rows, Type> &
+  MultTranspose(const Matrix<other_rows, columns, Type> &other,
+                Matrix<rows, other_rows, Type> &result) const;
 
   /**
    * @brief Multiply the matrix by a scalar
@@ -83,8 +213,8 @@ public:
    * @param result A buffer to store the result into
    * @note there is no problem if result == this
    */
-  Matrix<rows, columns> &Mult(float scalar,
-                              Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  Mult(Type scalar, Matrix<rows, columns, Type> &result) const;
 
   /**
    * @brief Element-wise multiply the two matrices
@@ -92,8 +222,9 @@ public:
    * @param result A buffer to store the result into
    * @note there is no problem if result == this
    */
-  Matrix<rows, columns> &ElementMultiply(const Matrix<rows, columns> &other,
-                                         Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  ElementMultiply(const Matrix<rows, columns, Type> &other,
+                  Matrix<rows, columns, Type> &result) const;
 
   /**
    * @brief Element-wise divide the two matrices
@@ -101,64 +232,124 @@ public:
    * @param result A buffer to store the result into
    * @note there is no problem if result == this
    */
-  Matrix<rows, columns> &ElementDivide(const Matrix<rows, columns> &other,
-                                       Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  ElementDivide(const Matrix<rows, columns, Type> &other,
+                Matrix<rows, columns, Type> &result) const;
 
-  Matrix<rows - 1, columns - 1> &
-  MinorMatrix(Matrix<rows - 1, columns - 1> &result, uint8_t row_idx,
+  /**
+   * @brief Copy this matrix without row_idx and column_idx into result
+   */
+  constexpr Matrix<rows - 1, columns - 1, Type> &
+  MinorMatrix(Matrix<rows - 1, columns - 1, Type> &result, uint8_t row_idx,
               uint8_t column_idx) const;
 
+  /**
+   * @return A read-only view of this matrix without row_idx and column_idx,
+   * see MatrixMinor
+   */
+  constexpr MatrixMinor<rows - 1, columns - 1, Type>
+  Minor(uint8_t row_idx, uint8_t column_idx) const;
+
   /**
    * @return Get the determinant of the matrix
-   * @note for right now only 2x2 and 3x3 matrices are supported
+   * @note float and double matrices up to closed_form_size use a closed form,
+   * bigger ones are factorized with LU. Integer matrices use cofactor
+   * expansion.
    */
-  float Det() const;
+  constexpr Type Det() const;
 
-  Matrix<rows, columns> &MatrixOfMinors(Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  MatrixOfMinors(Matrix<rows, columns, Type> &result) const;
 
   /**
    * @brief Invert this matrix
-   * @param result A buffer to store the result into
-   * @warning this is super slow! Only call it if you absolutely have to!!!
+   * @return the inverse, or all zeros if the matrix is singular
+   * @note float and double matrices up to closed_form_size use a closed
+   * form, bigger ones are factorized with LU. Integer matrices use the
+   * adjugate. If you need the inverse to solve a system use LU<size>::Solve
+   * instead, it's faster and more accurate.
    */
-  Matrix<rows, columns> Invert() const;
+  constexpr Matrix<rows, columns, Type> Invert() const;
 
   /**
    * @brief Transpose this matrix
-   * @param result A buffer to store the result into
+   * @return a transposed copy of this matrix
+   * @note Transposed() gives the transpose without copying anything
+   */
+  constexpr Matrix<columns, rows, Type> Transpose() const;
+
+  /**
+   * @return The transpose of this matrix as a read-only view, see
+   * MatrixTransposed
    */
-  Matrix<columns, rows> Transpose() const;
+  constexpr MatrixTransposed<columns, rows, Type> Transposed() const;
 
   /**
    * @brief reduce the matrix so the sum of its elements equal 1
    * @param result a buffer to store the result into
    */
-  Matrix<rows, columns> &Normalize(Matrix<rows, columns> &result) const;
+  constexpr Matrix<rows, columns, Type> &
+  Normalize(Matrix<rows, columns, Type> &result) const;
 
   /**
    * @brief Get a row from the matrix
    * @param row_index the row index to get
    * @param row a buffer to write the row into
+   * @note this copies the row, Row() views it in place
    */
-  Matrix<1, columns> &GetRow(uint8_t row_index, Matrix<1, columns> &row) const;
+  constexpr Matrix<1, columns, Type> &GetRow(uint8_t row_index,
+                                       Matrix<1, columns, Type> &row) const;
 
   /**
-   * @brief Get a row from the matrix
-   * @param column_index the row index to get
-   * @param column a buffer to write the row into
+   * @brief Get a column from the matrix
+   * @param column_index the column index to get
+   * @param column a buffer to write the column into
+   * @note this copies the column, Column() views it in place
+   */
+  constexpr Matrix<rows, 1, Type> &GetColumn(uint8_t column_index,
+                                       Matrix<rows, 1, Type> &column) const;
+
+  /**
+   * @brief A view of the whole matrix, see MatrixView
+   */
+  constexpr MatrixView<rows, columns, Type> View();
+  constexpr MatrixView<rows, columns, const Type> View() const;
+
+  /**
+   * @brief A view of one row, writes through it land in this matrix
+   * @note row_index is only checked when the bounds check policy traps
    */
-  Matrix<rows, 1> &GetColumn(uint8_t column_index,
-                             Matrix<rows, 1> &column) const;
+  constexpr MatrixView<1, columns, Type> Row(uint8_t row_index);
+  constexpr MatrixView<1, columns, const Type> Row(uint8_t row_index) const;
+
+  /**
+   * @brief A view of one column, writes through it land in this matrix
+   * @note column_index is only checked when the bounds check policy traps
+   */
+  constexpr MatrixView<rows, 1, Type> Column(uint8_t column_index);
+  constexpr MatrixView<rows, 1, const Type>
+  Column(uint8_t column_index) const;
+
+  /**
+   * @brief A view of a block of this matrix, the in place version of
+   * SubMatrix and SetSubMatrix
+   */
+  template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset,
+            uint8_t column_offset>
+  constexpr MatrixView<sub_rows, sub_columns, Type> Block();
+  template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset,
+            uint8_t column_offset>
+  constexpr MatrixView<sub_rows, sub_columns, const Type> Block() const;
 
   /**
    * @brief Get the number of rows in this matrix
    */
-  constexpr uint8_t GetRowSize() { return rows; }
+  constexpr uint8_t GetRowSize() const { return rows; }
 
   /**
    * @brief Get the number of columns in this matrix
    */
-  constexpr uint8_t GetColumnSize() { return columns; }
+  constexpr uint8_t GetColumnSize() const { return columns; }
 
   void ToString(std::string &stringBuffer) const;
 
@@ -167,61 +358,287 @@ public:
    * @param row the row index of the element
    * @param column the column index of the element
    * @return The value of the element you want to get
+   * @note out of range indices are handled by the bounds check policy, see
+   * BoundsCheck. Element() never checks.
    */
-  float Get(uint8_t row_index, uint8_t column_index) const;
+  constexpr Type Get(uint8_t row_index, uint8_t column_index) const;
 
   /**
-   * @brief get the specified row of the matrix returned as a reference to the
-   * internal array
+   * @brief get the specified row of the matrix, writes through it land in this
+   * matrix
    */
-  std::array<float, columns> &operator[](uint8_t row_index);
+  constexpr MatrixRow<columns, Type> operator[](uint8_t row_index);
+
+  /**
+   * @brief Get an element by its row-major index, without bounds checks
+   */
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->matrix[index];
+  }
 
   /**
    * @brief Copy the contents of other into this matrix
    */
-  Matrix<rows, columns> &operator=(const Matrix<rows, columns> &other);
+  constexpr Matrix<rows, columns, Type> &
+  operator=(const Matrix<rows, columns, Type> &other) = default;
+
+  /**
+   * @brief Evaluate an expression into this matrix in a single pass
+   */
+  template <typename Expression>
+  constexpr Matrix<rows, columns, Type> &
+  operator=(const MatrixExpression<Expression, rows, columns, Type> &expression);
+
+  /**
+   * @brief Add other to this matrix in place
+   */
+  constexpr Matrix<rows, columns, Type> &
+  operator+=(const Matrix<rows, columns, Type> &other);
+
+  /**
+   * @brief Add an expression to this matrix in place, in a single pass
+   */
+  template <typename Expression>
+  constexpr Matrix<rows, columns, Type> &
+  operator+=(const MatrixExpression<Expression, rows, columns, Type> &expression);
+
+  /**
+   * @brief Subtract other from this matrix in place
+   */
+  constexpr Matrix<rows, columns, Type> &
+  operator-=(const Matrix<rows, columns, Type> &other);
+
+  /**
+   * @brief Subtract an expression from this matrix in place, in a single pass
+   */
+  template <typename Expression>
+  constexpr Matrix<rows, columns, Type> &
+  operator-=(const MatrixExpression<Expression, rows, columns, Type> &expression);
+
+  /**
+   * @brief Scale this matrix in place
+   */
+  constexpr Matrix<rows, columns, Type> &operator*=(Type scalar);
 
+  /**
+   * @brief Multiply this matrix by a square matrix in place, so
+   * this = this * other
+   * @note other can be this matrix
+   */
+  constexpr Matrix<rows, columns, Type> &
+  operator*=(const Matrix<columns, columns, Type> &other);
+
+#ifndef MATRIX_EXPRESSION_TEMPLATES
   /**
    * @brief Return a new matrix that is the sum of this matrix and other matrix
    */
-  Matrix<rows, columns> operator+(const Matrix<rows, columns> &other) const;
+  constexpr Matrix<rows, columns, Type>
+  operator+(const Matrix<rows, columns, Type> &other) const;
 
-  Matrix<rows, columns> operator-(const Matrix<rows, columns> &other) const;
+  constexpr Matrix<rows, columns, Type>
+  operator-(const Matrix<rows, columns, Type> &other) const;
 
   template <uint8_t other_columns>
-  Matrix<rows, other_columns> operator*(const Matrix<columns, other_columns> &other) const;
+  constexpr Matrix<rows, other_columns, Type>
+  operator*(const Matrix<columns, other_columns, Type> &other) const;
 
-  Matrix<rows, columns> operator*(float scalar) const;
+  template <uint8_t other_columns>
+  constexpr Matrix<rows, other_columns, Type>
+  operator*(const MatrixTransposed<columns, other_columns, Type> &other) const;
+
+  constexpr Matrix<rows, columns, Type> operator*(Type scalar) const;
+#endif
 
   template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset, uint8_t column_offset>
-  Matrix<sub_rows, sub_columns> SubMatrix() const;
+  constexpr Matrix<sub_rows, sub_columns, Type> SubMatrix() const;
 
   template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset, uint8_t column_offset>
-  void SetSubMatrix(const Matrix<sub_rows, sub_columns> &sub_matrix);
+  constexpr void
+  SetSubMatrix(const Matrix<sub_rows, sub_columns, Type> &sub_matrix);
 
   /**
    * @brief take the dot product of the two vectors
    */
   template <uint8_t vector_size>
-  static float DotProduct(const Matrix<1, vector_size> &vec1,
-                          const Matrix<1, vector_size> &vec2);
+  static constexpr Type DotProduct(const Matrix<1, vector_size, Type> &vec1,
+                                    const Matrix<1, vector_size, Type> &vec2);
 
   template <uint8_t vector_size>
-  static float DotProduct(const Matrix<vector_size, 1> &vec1,
-                          const Matrix<vector_size, 1> &vec2);
+  static constexpr Type DotProduct(const Matrix<vector_size, 1, Type> &vec1,
+                                    const Matrix<vector_size, 1, Type> &vec2);
 
-  static float DotProduct(const Matrix<1, 1> &vec1,
-                          const Matrix<1, 1> &vec2) { return vec1.Get(0, 0) * vec2.Get(0, 0); }
+  static constexpr Type DotProduct(const Matrix<1, 1, Type> &vec1,
+                                   const Matrix<1, 1, Type> &vec2) { return vec1.matrix[0] * vec2.matrix[0]; }
 
 protected:
-  std::array<float, rows * columns> matrix;
+  std::array<Type, rows * columns> matrix;
+
+  // let matrices of different sizes reach into each other's storage so the
+  // kernels can work on the raw arrays
+  template <uint8_t other_rows, uint8_t other_columns, typename OtherType>
+  friend class Matrix;
+  template <uint8_t view_rows, uint8_t view_columns, typename ViewType>
+  friend class MatrixView;
+
+  template <uint8_t size, typename OtherType>
+  friend class LU;
+  template <uint8_t size, typename OtherType>
+  friend class LLT;
+  template <uint8_t size, typename OtherType>
+  friend class LDLT;
+  template <uint8_t states, uint8_t measurements, typename OtherType>
+  friend class KalmanFilter;
+  template <size_t count, uint8_t batch_rows, uint8_t batch_columns,
+            typename OtherType>
+  friend class MatrixBatch;
+  friend class SparseMatrix;
+
+  // Det and Invert switch from cofactor expansion to LU at this size
+  static constexpr uint8_t lu_size_threshold{4};
+
+  // LU divides by its pivots, so integer matrices stay on cofactor expansion
+  static constexpr bool use_lu{rows >= lu_size_threshold &&
+                               !std::is_integral<Type>::value};
+
+  // Det, Invert, Mult and Transpose of square float and double matrices up to
+  // this size are written out in full. These are the rotation, transform and
+  // covariance block sizes that get called in tight loops, and the general
+  // paths spend more on their loops and copies than on the arithmetic there.
+  static constexpr uint8_t closed_form_size{4};
+
+  static constexpr bool use_closed_form{
+      rows == columns && rows >= 2 && rows <= closed_form_size &&
+      std::is_floating_point<Type>::value};
 
 private:
-  Matrix<rows, columns> &adjugate(Matrix<rows, columns> &result) const;
+  // what products, dot products and norms are summed in
+  using Accumulator = typename ScalarTraits<Type>::Accumulator;
+
+  // the closed forms are tagged with their size, the general paths with 0
+  using ClosedFormTag =
+      std::integral_constant<uint8_t, use_closed_form ? rows : 0>;
+  template <uint8_t other_columns>
+  using MultTag =
+      std::integral_constant<uint8_t, other_columns == columns
+                                          ? ClosedFormTag::value
+                                          : 0>;
+
+  template <uint8_t other_columns>
+  constexpr void multiply(const Matrix<columns, other_columns, Type> &other,
+                          Matrix<rows, other_columns, Type> &result,
+                          std::integral_constant<uint8_t, 0>) const;
+  // the closed forms copy both operands first, so the compiler can keep them
+  // in registers instead of reloading them after every store to result
+  template <uint8_t other_columns>
+  constexpr void multiply(const Matrix<columns, other_columns, Type> &other,
+                          Matrix<rows, other_columns, Type> &result,
+                          std::integral_constant<uint8_t, 2>) const;
+  template <uint8_t other_columns>
+  constexpr void multiply(const Matrix<columns, other_columns, Type> &other,
+                          Matrix<rows, other_columns, Type> &result,
+                          std::integral_constant<uint8_t, 3>) const;
+  template <uint8_t other_columns>
+  constexpr void multiply(const Matrix<columns, other_columns, Type> &other,
+                          Matrix<rows, other_columns, Type> &result,
+                          std::integral_constant<uint8_t, 4>) const;
 
-  void setMatrixToArray(const std::array<float, rows * columns> &array);
+  // the inline product of Mult. Types that are their own accumulator sum
+  // straight into result, the others sum each row in their accumulator first.
+  template <uint8_t other_columns>
+  constexpr void
+  multiplySmall(const Matrix<columns, other_columns, Type> &other,
+                Matrix<rows, other_columns, Type> &result,
+                std::true_type in_place) const;
+  template <uint8_t other_columns>
+  constexpr void
+  multiplySmall(const Matrix<columns, other_columns, Type> &other,
+                Matrix<rows, other_columns, Type> &result,
+                std::false_type in_place) const;
+
+  constexpr Matrix<rows, columns, Type> &
+  adjugate(Matrix<rows, columns, Type> &result) const;
+
+  // evaluate an expression into this matrix in a single pass
+  template <typename Expression>
+  constexpr void
+  assign(const MatrixExpression<Expression, rows, columns, Type> &expression);
+
+  // the by-value operators build their result with these. Results big enough
+  // to go through the out of line kernels skip zero filling a buffer the
+  // kernel then overwrites. Small ones keep it, the compiler drops it anyway
+  // once the loop is inlined, and it's the only way to get a buffer at
+  // compile time.
+  template <typename Result, typename Operation>
+  static constexpr Result evaluate(Operation operation, std::false_type);
+  template <typename Result, typename Operation>
+  static constexpr Result evaluate(Operation operation, std::true_type);
+  template <typename Result, typename Operation>
+  static Result evaluateUninitialized(Operation operation);
+
+  using ElementWiseKernel =
+      std::integral_constant<bool, rows * columns >=
+                                       ElementKernels::dispatch_threshold>;
+  template <uint8_t other_columns>
+  using ProductKernel =
+      std::integral_constant<bool, static_cast<uint32_t>(rows) * columns *
+                                           other_columns >=
+                                       Gemm::block_threshold>;
+
+  // cofactor expansion is tagged with the size so the smallest sizes can use
+  // their closed forms
+  using DetTag =
+      std::conditional_t<use_lu && !use_closed_form, std::true_type,
+                         std::integral_constant<uint8_t, rows>>;
+  using InvertTag =
+      std::conditional_t<use_closed_form, ClosedFormTag,
+                         std::integral_constant<bool, use_lu>>;
+
+  constexpr Type det(std::true_type use_lu) const;
+  constexpr Type det(std::integral_constant<uint8_t, 0>) const;
+  constexpr Type det(std::integral_constant<uint8_t, 1>) const;
+  constexpr Type det(std::integral_constant<uint8_t, 2>) const;
+  constexpr Type det(std::integral_constant<uint8_t, 3>) const;
+  constexpr Type det(std::integral_constant<uint8_t, 4>) const;
+  template <uint8_t size>
+  constexpr Type det(std::integral_constant<uint8_t, size>) const;
+
+  constexpr Matrix<rows, columns, Type> invert(std::true_type use_lu) const;
+  constexpr Matrix<rows, columns, Type> invert(std::false_type use_lu) const;
+  constexpr Matrix<rows, columns, Type>
+  invert(std::integral_constant<uint8_t, 2>) const;
+  constexpr Matrix<rows, columns, Type>
+  invert(std::integral_constant<uint8_t, 3>) const;
+  constexpr Matrix<rows, columns, Type>
+  invert(std::integral_constant<uint8_t, 4>) const;
+
+  constexpr Matrix<columns, rows, Type>
+  transpose(std::integral_constant<uint8_t, 0>) const;
+  constexpr Matrix<columns, rows, Type>
+  transpose(std::integral_constant<uint8_t, 2>) const;
+  constexpr Matrix<columns, rows, Type>
+  transpose(std::integral_constant<uint8_t, 3>) const;
+  constexpr Matrix<columns, rows, Type>
+  transpose(std::integral_constant<uint8_t, 4>) const;
+
+  constexpr void
+  setMatrixToArray(const std::array<Type, rows * columns> &array);
 };
 
+/**
+ * @brief Matrix with the element type first, for when that reads better
+ * @code
+ * MatrixOf<double, 6, 6> covariance{};
+ * @endcode
+ */
+template <typename Type, uint8_t rows, uint8_t columns>
+using MatrixOf = Matrix<rows, columns, Type>;
+
 #include "Matrix.cpp"
 
+// LU and the views depend on Matrix, so they can only come in once Matrix is
+// fully defined
+#include "LU.hpp"
+#include "MatrixView.hpp"
+
 #endif // MATRIX_H_
\ No newline at end of file
@@ -0,0 +1,514 @@
+#ifdef MATRIX_BATCH_H_ // since the .cpp file has to be included by the .hpp
+                      // file this will evaluate to true
+#include "MatrixBatch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+#include "BoundsCheck.hpp"
+#include "ElementKernels.hpp"
+
+/**
+ * @brief The per matrix formulas of MatrixBatch. Each one works on the matrix
+ * in lane lane of lanes count apart, so inlined into a loop across the lanes
+ * every element becomes one vector. They only ever read the batch and only
+ * ever write scratch of their own, which is what lets GCC vectorize the loop
+ * without checking for overlap at run time.
+ */
+namespace MatrixBatchKernels
+{
+// the elements idx... of the matrix in lane lane, expanded at compile time
+// since a loop inside the lane loop would stop it from being vectorized
+template <size_t count, typename Type, size_t... idx>
+inline std::array<Type, sizeof...(idx)> Gather(const Type *m, size_t lane,
+                                               std::index_sequence<idx...>)
+{
+  return {m[idx * count + lane]...};
+}
+
+// sum over idx of a[idx] * b[idx * b_stride] in lane lane, a row of one
+// matrix times a column of another
+template <size_t count, size_t b_stride, typename Type, size_t... idx>
+inline Type Dot(const Type *a, const Type *b, size_t lane,
+                std::index_sequence<idx...>)
+{
+  return (Type{0} + ... +
+          (a[idx * count + lane] * b[idx * b_stride * count + lane]));
+}
+
+template <size_t count, typename Type>
+inline Type Det(const Type *m, size_t lane, std::integral_constant<uint8_t, 2>)
+{
+  const std::array<Type, 4> a{
+      Gather<count>(m, lane, std::make_index_sequence<4>{})};
+  return a[0] * a[3] - a[1] * a[2];
+}
+
+template <size_t count, typename Type>
+inline Type Det(const Type *m, size_t lane, std::integral_constant<uint8_t, 3>)
+{
+  const std::array<Type, 9> a{
+      Gather<count>(m, lane, std::make_index_sequence<9>{})};
+  return a[0] * (a[4] * a[8] - a[5] * a[7]) -
+         a[1] * (a[3] * a[8] - a[5] * a[6]) +
+         a[2] * (a[3] * a[7] - a[4] * a[6]);
+}
+
+template <size_t count, typename Type>
+inline Type Det(const Type *m, size_t lane, std::integral_constant<uint8_t, 4>)
+{
+  const std::array<Type, 16> a{
+      Gather<count>(m, lane, std::make_index_sequence<16>{})};
+  // Laplace expansion along the top two rows, like Matrix<4, 4>::Det
+  return (a[0] * a[5] - a[1] * a[4]) * (a[10] * a[15] - a[11] * a[14]) -
+         (a[0] * a[6] - a[2] * a[4]) * (a[9] * a[15] - a[11] * a[13]) +
+         (a[0] * a[7] - a[3] * a[4]) * (a[9] * a[14] - a[10] * a[13]) +
+         (a[1] * a[6] - a[2] * a[5]) * (a[8] * a[15] - a[11] * a[12]) -
+         (a[1] * a[7] - a[3] * a[5]) * (a[8] * a[14] - a[10] * a[12]) +
+         (a[2] * a[7] - a[3] * a[6]) * (a[8] * a[13] - a[9] * a[12]);
+}
+
+// 1 / determinant, or 0 for a singular matrix so its inverse comes out as
+// zeros. Written without a branch around the division, which GCC won't
+// vectorize since the division could trap.
+template <typename Type>
+inline Type InverseScale(Type determinant)
+{
+  const Type non_zero{static_cast<Type>(determinant != 0)};
+  return non_zero / (determinant + (1 - non_zero));
+}
+
+template <size_t count, typename Type, typename Scratch>
+inline void Invert(const Type *m, size_t lane, Scratch &result,
+                   std::integral_constant<uint8_t, 2>)
+{
+  const std::array<Type, 4> a{
+      Gather<count>(m, lane, std::make_index_sequence<4>{})};
+  const Type scale{InverseScale(a[0] * a[3] - a[1] * a[2])};
+  result[0][lane] = a[3] * scale;
+  result[1][lane] = -a[1] * scale;
+  result[2][lane] = -a[2] * scale;
+  result[3][lane] = a[0] * scale;
+}
+
+template <size_t count, typename Type, typename Scratch>
+inline void Invert(const Type *m, size_t lane, Scratch &result,
+                   std::integral_constant<uint8_t, 3>)
+{
+  const std::array<Type, 9> a{
+      Gather<count>(m, lane, std::make_index_sequence<9>{})};
+  const Type c0{a[4] * a[8] - a[5] * a[7]};
+  const Type c3{a[5] * a[6] - a[3] * a[8]};
+  const Type c6{a[3] * a[7] - a[4] * a[6]};
+  const Type scale{InverseScale(a[0] * c0 + a[1] * c3 + a[2] * c6)};
+  result[0][lane] = c0 * scale;
+  result[1][lane] = (a[2] * a[7] - a[1] * a[8]) * scale;
+  result[2][lane] = (a[1] * a[5] - a[2] * a[4]) * scale;
+  result[3][lane] = c3 * scale;
+  result[4][lane] = (a[0] * a[8] - a[2] * a[6]) * scale;
+  result[5][lane] = (a[2] * a[3] - a[0] * a[5]) * scale;
+  result[6][lane] = c6 * scale;
+  result[7][lane] = (a[1] * a[6] - a[0] * a[7]) * scale;
+  result[8][lane] = (a[0] * a[4] - a[1] * a[3]) * scale;
+}
+
+template <size_t count, typename Type, typename Scratch>
+inline void Invert(const Type *m, size_t lane, Scratch &result,
+                   std::integral_constant<uint8_t, 4>)
+{
+  const std::array<Type, 16> a{
+      Gather<count>(m, lane, std::make_index_sequence<16>{})};
+  // the same shared 2x2 determinants as Matrix<4, 4>::Invert
+  const Type s0{a[0] * a[5] - a[1] * a[4]};
+  const Type s1{a[0] * a[6] - a[2] * a[4]};
+  const Type s2{a[0] * a[7] - a[3] * a[4]};
+  const Type s3{a[1] * a[6] - a[2] * a[5]};
+  const Type s4{a[1] * a[7] - a[3] * a[5]};
+  const Type s5{a[2] * a[7] - a[3] * a[6]};
+  const Type c0{a[8] * a[13] - a[9] * a[12]};
+  const Type c1{a[8] * a[14] - a[10] * a[12]};
+  const Type c2{a[8] * a[15] - a[11] * a[12]};
+  const Type c3{a[9] * a[14] - a[10] * a[13]};
+  const Type c4{a[9] * a[15] - a[11] * a[13]};
+  const Type c5{a[10] * a[15] - a[11] * a[14]};
+  const Type scale{InverseScale(s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 -
+                                s4 * c1 + s5 * c0)};
+
+  result[0][lane] = (a[5] * c5 - a[6] * c4 + a[7] * c3) * scale;
+  result[1][lane] = (-a[1] * c5 + a[2] * c4 - a[3] * c3) * scale;
+  result[2][lane] = (a[13] * s5 - a[14] * s4 + a[15] * s3) * scale;
+  result[3][lane] = (-a[9] * s5 + a[10] * s4 - a[11] * s3) * scale;
+  result[4][lane] = (-a[4] * c5 + a[6] * c2 - a[7] * c1) * scale;
+  result[5][lane] = (a[0] * c5 - a[2] * c2 + a[3] * c1) * scale;
+  result[6][lane] = (-a[12] * s5 + a[14] * s2 - a[15] * s1) * scale;
+  result[7][lane] = (a[8] * s5 - a[10] * s2 + a[11] * s1) * scale;
+  result[8][lane] = (a[4] * c4 - a[5] * c2 + a[7] * c0) * scale;
+  result[9][lane] = (-a[0] * c4 + a[1] * c2 - a[3] * c0) * scale;
+  result[10][lane] = (a[12] * s4 - a[13] * s2 + a[15] * s0) * scale;
+  result[11][lane] = (-a[8] * s4 + a[9] * s2 - a[11] * s0) * scale;
+  result[12][lane] = (-a[4] * c3 + a[5] * c1 - a[6] * c0) * scale;
+  result[13][lane] = (a[0] * c3 - a[1] * c1 + a[2] * c0) * scale;
+  result[14][lane] = (-a[12] * s3 + a[13] * s1 - a[14] * s0) * scale;
+  result[15][lane] = (a[8] * s3 - a[9] * s1 + a[10] * s0) * scale;
+}
+
+// copy the elements of a chunk of scratch into the lanes of result
+template <size_t count, typename Type, typename Scratch>
+inline void Store(const Scratch &scratch, Type *result, size_t start)
+{
+  for (size_t element_idx{0}; element_idx < scratch.size(); element_idx++)
+  {
+    std::copy(scratch[element_idx].begin(), scratch[element_idx].end(),
+              result + element_idx * count + start);
+  }
+}
+} // namespace MatrixBatchKernels
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+MatrixBatch<count, rows, columns, Type>::MatrixBatch(Type value)
+{
+  this->data.fill(value);
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+MatrixBatch<count, rows, columns, Type>::MatrixBatch(
+    const Matrix<rows, columns, Type> *matrices)
+{
+  this->Load(matrices);
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+Matrix<rows, columns, Type>
+MatrixBatch<count, rows, columns, Type>::Get(size_t idx) const
+{
+  BoundsCheck::Assert(idx < count);
+  Matrix<rows, columns, Type> matrix{};
+  for (size_t element_idx{0}; element_idx < elements; element_idx++)
+  {
+    matrix.matrix[element_idx] = this->data[element_idx * count + idx];
+  }
+  return matrix;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+void MatrixBatch<count, rows, columns, Type>::Set(
+    size_t idx, const Matrix<rows, columns, Type> &matrix)
+{
+  BoundsCheck::Assert(idx < count);
+  for (size_t element_idx{0}; element_idx < elements; element_idx++)
+  {
+    this->data[element_idx * count + idx] = matrix.matrix[element_idx];
+  }
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+void MatrixBatch<count, rows, columns, Type>::Load(
+    const Matrix<rows, columns, Type> *matrices)
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    for (size_t element_idx{0}; element_idx < elements; element_idx++)
+    {
+      this->data[element_idx * count + idx] =
+          matrices[idx].matrix[element_idx];
+    }
+  }
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+void MatrixBatch<count, rows, columns, Type>::Store(
+    Matrix<rows, columns, Type> *matrices) const
+{
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    for (size_t element_idx{0}; element_idx < elements; element_idx++)
+    {
+      matrices[idx].matrix[element_idx] =
+          this->data[element_idx * count + idx];
+    }
+  }
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+Type *MatrixBatch<count, rows, columns, Type>::Lanes(uint8_t row_index,
+                                                     uint8_t column_index)
+{
+  BoundsCheck::Assert(row_index < rows && column_index < columns);
+  return this->data.data() + (row_index * columns + column_index) * count;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+const Type *
+MatrixBatch<count, rows, columns, Type>::Lanes(uint8_t row_index,
+                                               uint8_t column_index) const
+{
+  BoundsCheck::Assert(row_index < rows && column_index < columns);
+  return this->data.data() + (row_index * columns + column_index) * count;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+MatrixBatch<count, rows, columns, Type> &
+MatrixBatch<count, rows, columns, Type>::Add(
+    const MatrixBatch<count, rows, columns, Type> &other,
+    MatrixBatch<count, rows, columns, Type> &result) const
+{
+  // element-wise, so the interleaving doesn't matter
+  ElementKernels::Add(this->data.data(), other.data.data(),
+                      result.data.data(), elements * count);
+  return result;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+MatrixBatch<count, rows, columns, Type> &
+MatrixBatch<count, rows, columns, Type>::Sub(
+    const MatrixBatch<count, rows, columns, Type> &other,
+    MatrixBatch<count, rows, columns, Type> &result) const
+{
+  ElementKernels::Sub(this->data.data(), other.data.data(),
+                      result.data.data(), elements * count);
+  return result;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns>
+MatrixBatch<count, rows, other_columns, Type> &
+MatrixBatch<count, rows, columns, Type>::Mult(
+    const MatrixBatch<count, columns, other_columns, Type> &other,
+    MatrixBatch<count, rows, other_columns, Type> &result) const
+{
+  forEachChunk(
+      [&](size_t start, auto chunk)
+      {
+        constexpr size_t lanes{decltype(chunk)::value};
+        const Type *a{this->data.data() + start};
+        const Type *b{other.data.data() + start};
+        std::array<std::array<Type, lanes>, rows * other_columns> product;
+
+        for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+        {
+          const Type *a_row{a + row_idx * columns * count};
+          for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+          {
+            const Type *b_column{b + column_idx * count};
+            std::array<Type, lanes> &sum{
+                product[row_idx * other_columns + column_idx]};
+            for (size_t lane{0}; lane < lanes; lane++)
+            {
+              sum[lane] = MatrixBatchKernels::Dot<count, other_columns>(
+                  a_row, b_column, lane, std::make_index_sequence<columns>{});
+            }
+          }
+        }
+
+        MatrixBatchKernels::Store<count>(product, result.data.data(), start);
+      });
+  return result;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+MatrixBatch<count, columns, rows, Type> &
+MatrixBatch<count, rows, columns, Type>::Transpose(
+    MatrixBatch<count, columns, rows, Type> &result) const
+{
+  // moving whole elements, each one is count contiguous values
+  Type *destination{result.data.data()};
+  if (static_cast<const void *>(&result) == static_cast<const void *>(this))
+  {
+    // only square batches can be their own transpose
+    for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+    {
+      for (uint8_t column_idx{static_cast<uint8_t>(row_idx + 1)};
+           column_idx < columns; column_idx++)
+      {
+        Type *upper{destination + (row_idx * columns + column_idx) * count};
+        std::swap_ranges(upper, upper + count,
+                         destination + (column_idx * rows + row_idx) * count);
+      }
+    }
+    return result;
+  }
+
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    {
+      const Type *source{this->data.data() +
+                         (row_idx * columns + column_idx) * count};
+      std::copy(source, source + count,
+                destination + (column_idx * rows + row_idx) * count);
+    }
+  }
+  return result;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+void MatrixBatch<count, rows, columns, Type>::Det(
+    std::array<Type, count> &result) const
+{
+  static_assert(rows == columns && rows >= 2 && rows <= 4,
+                "Batched determinants only have closed forms up to 4x4");
+
+  forEachChunk(
+      [&](size_t start, auto chunk)
+      {
+        constexpr size_t lanes{decltype(chunk)::value};
+        const Type *m{this->data.data() + start};
+        std::array<Type, lanes> determinants;
+        for (size_t lane{0}; lane < lanes; lane++)
+        {
+          determinants[lane] = MatrixBatchKernels::Det<count>(
+              m, lane, std::integral_constant<uint8_t, rows>{});
+        }
+        std::copy(determinants.begin(), determinants.end(),
+                  result.begin() + start);
+      });
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+MatrixBatch<count, rows, columns, Type> &
+MatrixBatch<count, rows, columns, Type>::Invert(
+    MatrixBatch<count, rows, columns, Type> &result) const
+{
+  static_assert(rows == columns && rows >= 2 && rows <= 4,
+                "Batched inverses only have closed forms up to 4x4");
+  static_assert(std::is_floating_point<Type>::value,
+                "Batched inverses need a floating point element type");
+
+  forEachChunk(
+      [&](size_t start, auto chunk)
+      {
+        constexpr size_t lanes{decltype(chunk)::value};
+        const Type *m{this->data.data() + start};
+        std::array<std::array<Type, lanes>, elements> inverse;
+        for (size_t lane{0}; lane < lanes; lane++)
+        {
+          MatrixBatchKernels::Invert<count>(
+              m, lane, inverse, std::integral_constant<uint8_t, rows>{});
+        }
+        MatrixBatchKernels::Store<count>(inverse, result.data.data(), start);
+      });
+  return result;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+bool MatrixBatch<count, rows, columns, Type>::Cholesky(
+    MatrixBatch<count, rows, columns, Type> &result) const
+{
+  static_assert(rows == columns, "Only square matrices can be factorized");
+  static_assert(std::is_floating_point<Type>::value,
+                "Batched Cholesky needs a floating point element type");
+
+  bool positive_definite{true};
+  forEachChunk(
+      [&](size_t start, auto chunk)
+      {
+        constexpr size_t lanes{decltype(chunk)::value};
+        const Type *m{this->data.data() + start};
+        std::array<std::array<Type, lanes>, elements> factor;
+        // 1 for the matrices still positive definite, 0 for the others.
+        // Those carry on with a made up pivot of 1 so no lane ever divides
+        // by zero, and get zeroed at the end.
+        std::array<Type, lanes> valid;
+        valid.fill(1);
+
+        // the diagonal of L kept apart from factor, so no loop both reads
+        // and writes factor
+        std::array<std::array<Type, lanes>, rows> diagonal;
+        std::array<Type, lanes> sum;
+
+        // the same row by row order as LLT::FactorInPlace
+        for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+        {
+          for (uint8_t column_idx{0}; column_idx <= row_idx; column_idx++)
+          {
+            const Type *m_lanes{m + (row_idx * columns + column_idx) * count};
+            std::copy(m_lanes, m_lanes + lanes, sum.begin());
+            for (uint8_t inner_idx{0}; inner_idx < column_idx; inner_idx++)
+            {
+              const std::array<Type, lanes> &left{
+                  factor[row_idx * columns + inner_idx]};
+              const std::array<Type, lanes> &right{
+                  factor[column_idx * columns + inner_idx]};
+              for (size_t lane{0}; lane < lanes; lane++)
+              {
+                sum[lane] -= left[lane] * right[lane];
+              }
+            }
+
+            std::array<Type, lanes> &element{
+                factor[row_idx * columns + column_idx]};
+            if (column_idx == row_idx)
+            {
+              for (size_t lane{0}; lane < lanes; lane++)
+              {
+                // this also catches NaN. std::isgreater is the quiet
+                // comparison, which GCC turns into a select where it won't
+                // for a > that could trap.
+                const Type pivot{sum[lane]};
+                const bool pivot_ok{std::isgreater(pivot, Type{0})};
+                valid[lane] = pivot_ok ? valid[lane] : Type{0};
+                sum[lane] = pivot_ok ? pivot : Type{1};
+              }
+              // std::sqrt may set errno so this loop stays scalar, keeping
+              // it on its own lets the others vectorize
+              for (size_t lane{0}; lane < lanes; lane++)
+              {
+                diagonal[row_idx][lane] = std::sqrt(sum[lane]);
+              }
+              element = diagonal[row_idx];
+            }
+            else
+            {
+              const std::array<Type, lanes> &pivot{diagonal[column_idx]};
+              for (size_t lane{0}; lane < lanes; lane++)
+              {
+                element[lane] = sum[lane] / pivot[lane];
+              }
+            }
+          }
+
+          for (uint8_t column_idx{static_cast<uint8_t>(row_idx + 1)};
+               column_idx < columns; column_idx++)
+          {
+            factor[row_idx * columns + column_idx].fill(0);
+          }
+        }
+
+        for (std::array<Type, lanes> &element : factor)
+        {
+          for (size_t lane{0}; lane < lanes; lane++)
+          {
+            const Type value{element[lane]};
+            element[lane] = valid[lane] != 0 ? value : Type{0};
+          }
+        }
+        for (size_t lane{0}; lane < lanes; lane++)
+        {
+          positive_definite = positive_definite && valid[lane] != 0;
+        }
+
+        MatrixBatchKernels::Store<count>(factor, result.data.data(), start);
+      });
+  return positive_definite;
+}
+
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+template <typename Operation>
+void MatrixBatch<count, rows, columns, Type>::forEachChunk(
+    Operation operation)
+{
+  for (size_t start{0}; start + chunk_size <= count; start += chunk_size)
+  {
+    operation(start, Chunk<chunk_size>{});
+  }
+
+  // whatever is left over is a smaller chunk, still with a fixed size
+  if (count % chunk_size != 0)
+  {
+    operation(count - count % chunk_size, Chunk<count % chunk_size>{});
+  }
+}
+
+#endif // MATRIX_BATCH_H_
@@ -0,0 +1,171 @@
+#ifndef MATRIX_BATCH_H_
+#define MATRIX_BATCH_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "Matrix.hpp"
+
+/**
+ * @brief count matrices of the same shape stored interleaved: element (0, 0)
+ * of every matrix, then element (0, 1) of every matrix and so on. Every
+ * operation runs the same scalar formula across the batch, so each SIMD lane
+ * works on a different matrix instead of most lanes of a register idling on a
+ * single 3x3. Use it for the many small independent problems of a frame, like
+ * per landmark covariances or per particle transforms.
+ * @code
+ * MatrixBatch<1024, 3, 3> rotations{particle_rotations};
+ * std::array<float, 1024> determinants{};
+ * rotations.Det(determinants);
+ * @endcode
+ *
+ * The operations work through the batch a chunk of matrices at a time, with
+ * the chunk size fixed at compile time so every loop across the lanes has a
+ * fixed trip count the compiler can vectorize. Each chunk is built in scratch
+ * and copied out, so result can always be this or other.
+ *
+ * @note Det and Invert only have closed forms for 2x2, 3x3 and 4x4. Factorize
+ * bigger symmetric positive definite matrices with Cholesky.
+ * @warning the batch is stored inline, so a big one belongs in static storage
+ * or a long lived object rather than on a small stack
+ */
+template <size_t count, uint8_t rows, uint8_t columns, typename Type>
+class MatrixBatch
+{
+public:
+  /**
+   * @brief Alignment in bytes of the storage
+   */
+  static constexpr size_t alignment{64};
+
+  /**
+   * @brief create a batch but leave all of its values unitialized
+   */
+  MatrixBatch() = default;
+
+  /**
+   * @brief Create a batch with every element of every matrix set to value
+   */
+  explicit MatrixBatch(Type value);
+
+  /**
+   * @brief Create a batch holding a copy of count matrices
+   */
+  explicit MatrixBatch(const Matrix<rows, columns, Type> *matrices);
+
+  /**
+   * @return the number of matrices in the batch
+   */
+  static constexpr size_t Size() { return count; }
+
+  /**
+   * @brief Get one matrix out of the batch
+   * @note idx is only checked when the bounds check policy traps, see
+   * BoundsCheck
+   */
+  Matrix<rows, columns, Type> Get(size_t idx) const;
+
+  /**
+   * @brief Overwrite one matrix in the batch
+   * @note idx is only checked when the bounds check policy traps, see
+   * BoundsCheck
+   */
+  void Set(size_t idx, const Matrix<rows, columns, Type> &matrix);
+
+  /**
+   * @brief Copy count matrices into the batch
+   */
+  void Load(const Matrix<rows, columns, Type> *matrices);
+
+  /**
+   * @brief Copy the batch out into an array of at least count matrices
+   */
+  void Store(Matrix<rows, columns, Type> *matrices) const;
+
+  /**
+   * @return the count values of one element, one per matrix, for writing
+   * kernels of your own
+   * @note the indices are only checked when the bounds check policy traps,
+   * see BoundsCheck
+   */
+  Type *Lanes(uint8_t row_index, uint8_t column_index);
+  const Type *Lanes(uint8_t row_index, uint8_t column_index) const;
+
+  /**
+   * @brief result[i] = this[i] + other[i]
+   */
+  MatrixBatch<count, rows, columns, Type> &
+  Add(const MatrixBatch<count, rows, columns, Type> &other,
+      MatrixBatch<count, rows, columns, Type> &result) const;
+
+  /**
+   * @brief result[i] = this[i] - other[i]
+   */
+  MatrixBatch<count, rows, columns, Type> &
+  Sub(const MatrixBatch<count, rows, columns, Type> &other,
+      MatrixBatch<count, rows, columns, Type> &result) const;
+
+  /**
+   * @brief result[i] = this[i] * other[i], a matrix product per matrix
+   */
+  template <uint8_t other_columns>
+  MatrixBatch<count, rows, other_columns, Type> &
+  Mult(const MatrixBatch<count, columns, other_columns, Type> &other,
+       MatrixBatch<count, rows, other_columns, Type> &result) const;
+
+  /**
+   * @brief result[i] = this[i]^T
+   */
+  MatrixBatch<count, columns, rows, Type> &
+  Transpose(MatrixBatch<count, columns, rows, Type> &result) const;
+
+  /**
+   * @brief result[i] = the determinant of this[i]
+   */
+  void Det(std::array<Type, count> &result) const;
+
+  /**
+   * @brief result[i] = the inverse of this[i], all zeros where this[i] is
+   * singular like Matrix::Invert
+   */
+  MatrixBatch<count, rows, columns, Type> &
+  Invert(MatrixBatch<count, rows, columns, Type> &result) const;
+
+  /**
+   * @brief result[i] = the lower Cholesky factor L of this[i], see LLT. Only
+   * the lower triangle of each matrix is read.
+   * @return false if one of the matrices isn't positive definite. Its factor
+   * is all zeros, which a positive definite matrix's never is.
+   */
+  bool Cholesky(MatrixBatch<count, rows, columns, Type> &result) const;
+
+private:
+  // matrices per chunk: enough for the widest vectors, few enough that the
+  // scratch of a chunk stays small on the stack
+  static constexpr size_t chunk_size{count < 32 ? count : 32};
+
+  // the lanes of a chunk are tagged with their number so each operation gets
+  // a fixed trip count
+  template <size_t lanes>
+  using Chunk = std::integral_constant<size_t, lanes>;
+
+  // run operation(start, Chunk<lanes>) over every chunk of the batch
+  template <typename Operation>
+  static void forEachChunk(Operation operation);
+
+  static constexpr size_t elements{static_cast<size_t>(rows) * columns};
+
+  static_assert(count > 0, "A batch needs at least one matrix");
+
+  alignas(alignment) std::array<Type, elements * count> data;
+
+  template <size_t other_count, uint8_t other_rows, uint8_t other_columns,
+            typename OtherType>
+  friend class MatrixBatch;
+};
+
+#include "MatrixBatch.cpp"
+
+#endif // MATRIX_BATCH_H_
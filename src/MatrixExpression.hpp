@@ -0,0 +1,343 @@
+#ifndef MATRIX_EXPRESSION_H_
+#define MATRIX_EXPRESSION_H_
+
+#include <cstdint>
+
+#include "BoundsCheck.hpp"
+#include "ScalarTraits.hpp"
+
+// the element type defaults to float here, on the first declaration of Matrix
+template <uint8_t rows, uint8_t columns, typename Type = float>
+class Matrix;
+template <uint8_t rows, uint8_t columns, typename Type = float>
+class MatrixTransposed;
+
+/**
+ * @brief Base class of everything that can be used as an operand of the matrix
+ * operators: Matrix itself and the lazy expression nodes below.
+ *
+ * By default Matrix's +, - and * operators evaluate straight away and return a
+ * new Matrix. Define MATRIX_EXPRESSION_TEMPLATES for the whole build and they
+ * return expression nodes instead. Element-wise nodes are evaluated in one
+ * fused loop when they're assigned to a Matrix, so
+ * @code
+ * P = F * P * Ft + Q * dt;
+ * @endcode
+ * only creates the temporaries for the two products and makes a single pass
+ * over memory for the sum and the scale.
+ *
+ * Products are always materialized when the MatrixProduct node is built,
+ * because every element of a product needs a whole row and column of its
+ * operands. That also means a product can safely read the matrix it's being
+ * assigned to.
+ *
+ * Both operands of a node have to have the same element type.
+ *
+ * @warning Nodes hold references to their operands, which are often
+ * temporaries. Assign an expression to a Matrix in the statement that builds
+ * it. Never keep one in an auto variable.
+ */
+template <typename Expression, uint8_t rows, uint8_t columns,
+          typename Type = float>
+class MatrixExpression
+{
+public:
+  /**
+   * @brief The element type
+   */
+  using Scalar = Type;
+
+  /**
+   * @brief True when Element(index) only reads element index of the matrices
+   * the expression was built from. Those can be assigned to one of their own
+   * operands in a single pass, the others are evaluated into a temporary
+   * first.
+   */
+  static constexpr bool element_wise{true};
+
+  /**
+   * @brief Get an element by its row-major index, without bounds checks
+   */
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->Derived().Element(index);
+  }
+
+  /**
+   * @brief Get an element from the expression
+   * @param row_index the row index of the element
+   * @param column_index the column index of the element
+   * @return The value of the element you want to get
+   */
+  constexpr Type Get(uint8_t row_index, uint8_t column_index) const
+  {
+    if (!BoundsCheck::Accept(row_index < rows && column_index < columns))
+    {
+      return ScalarTraits<Type>::Saturate(1e+10);
+    }
+    return this->Element(row_index * columns + column_index);
+  }
+
+  /**
+   * @brief Get the concrete expression (or Matrix) this is the base of
+   */
+  constexpr const Expression &Derived() const
+  {
+    return static_cast<const Expression &>(*this);
+  }
+};
+
+/**
+ * @brief Lazy element-wise sum of two expressions
+ */
+template <typename Left, typename Right, uint8_t rows, uint8_t columns,
+          typename Type>
+class MatrixSum
+    : public MatrixExpression<MatrixSum<Left, Right, rows, columns, Type>, rows,
+                              columns, Type>
+{
+public:
+  static constexpr bool element_wise{Left::element_wise && Right::element_wise};
+
+  constexpr MatrixSum(const Left &left, const Right &right)
+      : left(left), right(right)
+  {
+  }
+
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->left.Element(index) + this->right.Element(index);
+  }
+
+private:
+  const Left &left;
+  const Right &right;
+};
+
+/**
+ * @brief Lazy element-wise difference of two expressions
+ */
+template <typename Left, typename Right, uint8_t rows, uint8_t columns,
+          typename Type>
+class MatrixDifference
+    : public MatrixExpression<
+          MatrixDifference<Left, Right, rows, columns, Type>, rows, columns,
+          Type>
+{
+public:
+  static constexpr bool element_wise{Left::element_wise && Right::element_wise};
+
+  constexpr MatrixDifference(const Left &left, const Right &right)
+      : left(left), right(right)
+  {
+  }
+
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->left.Element(index) - this->right.Element(index);
+  }
+
+private:
+  const Left &left;
+  const Right &right;
+};
+
+/**
+ * @brief Lazy product of an expression and a scalar
+ */
+template <typename Operand, uint8_t rows, uint8_t columns, typename Type>
+class MatrixScaled
+    : public MatrixExpression<MatrixScaled<Operand, rows, columns, Type>, rows,
+                              columns, Type>
+{
+public:
+  static constexpr bool element_wise{Operand::element_wise};
+
+  constexpr MatrixScaled(const Operand &operand, Type scalar)
+      : operand(operand), scalar(scalar)
+  {
+  }
+
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->operand.Element(index) * this->scalar;
+  }
+
+private:
+  const Operand &operand;
+  Type scalar;
+};
+
+/**
+ * @brief Gives a Matrix for any expression. Matrices and products are used as
+ * they are, everything else is evaluated into a temporary.
+ */
+template <typename Expression, uint8_t rows, uint8_t columns, typename Type>
+class EvaluatedMatrix
+{
+public:
+  constexpr EvaluatedMatrix(const Expression &expression)
+      : value(expression)
+  {
+  }
+  constexpr const Matrix<rows, columns, Type> &Value() const
+  {
+    return this->value;
+  }
+
+private:
+  Matrix<rows, columns, Type> value;
+};
+
+template <uint8_t rows, uint8_t columns, typename Type>
+class EvaluatedMatrix<Matrix<rows, columns, Type>, rows, columns, Type>
+{
+public:
+  constexpr EvaluatedMatrix(const Matrix<rows, columns, Type> &matrix)
+      : value(matrix)
+  {
+  }
+  constexpr const Matrix<rows, columns, Type> &Value() const
+  {
+    return this->value;
+  }
+
+private:
+  const Matrix<rows, columns, Type> &value;
+};
+
+/**
+ * @brief Matrix product of two expressions. This is where products are
+ * materialized: the result is computed as soon as the node is built.
+ */
+template <uint8_t rows, uint8_t columns, typename Type>
+class MatrixProduct
+    : public MatrixExpression<MatrixProduct<rows, columns, Type>, rows, columns,
+                              Type>
+{
+public:
+  template <typename Left, typename Right, uint8_t inner>
+  constexpr MatrixProduct(
+      const MatrixExpression<Left, rows, inner, Type> &left,
+      const MatrixExpression<Right, inner, columns, Type> &right)
+      : result{}
+  {
+    this->template multiply<inner>(left.Derived(), right.Derived());
+  }
+
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->result.Element(index);
+  }
+
+  constexpr const Matrix<rows, columns, Type> &Value() const
+  {
+    return this->result;
+  }
+
+private:
+  Matrix<rows, columns, Type> result;
+
+  template <uint8_t inner, typename Left, typename Right>
+  constexpr void multiply(const Left &left, const Right &right)
+  {
+    EvaluatedMatrix<Left, rows, inner, Type> left_value{left};
+    EvaluatedMatrix<Right, inner, columns, Type> right_value{right};
+    left_value.Value().Mult(right_value.Value(), this->result);
+  }
+
+  // transposed operands go straight to the kernels that read them in place
+  template <uint8_t inner, typename Left>
+  constexpr void multiply(const Left &left,
+                          const MatrixTransposed<inner, columns, Type> &right)
+  {
+    EvaluatedMatrix<Left, rows, inner, Type> left_value{left};
+    left_value.Value().View().MultTranspose(right.Source(),
+                                            this->result.View());
+  }
+
+  template <uint8_t inner, typename Right>
+  constexpr void multiply(const MatrixTransposed<rows, inner, Type> &left,
+                          const Right &right)
+  {
+    EvaluatedMatrix<Right, inner, columns, Type> right_value{right};
+    left.Source().TransposeMult(right_value.Value().View(),
+                                this->result.View());
+  }
+
+  template <uint8_t inner>
+  constexpr void multiply(const MatrixTransposed<rows, inner, Type> &left,
+                          const MatrixTransposed<inner, columns, Type> &right)
+  {
+    const Matrix<rows, inner, Type> left_value{left};
+    left_value.View().MultTranspose(right.Source(), this->result.View());
+  }
+};
+
+template <uint8_t rows, uint8_t columns, typename Type>
+class EvaluatedMatrix<MatrixProduct<rows, columns, Type>, rows, columns, Type>
+{
+public:
+  constexpr EvaluatedMatrix(const MatrixProduct<rows, columns, Type> &product)
+      : value(product.Value())
+  {
+  }
+  constexpr const Matrix<rows, columns, Type> &Value() const
+  {
+    return this->value;
+  }
+
+private:
+  const Matrix<rows, columns, Type> &value;
+};
+
+#ifdef MATRIX_EXPRESSION_TEMPLATES
+template <typename Left, typename Right, uint8_t rows, uint8_t columns,
+          typename Type>
+constexpr MatrixSum<Left, Right, rows, columns, Type>
+operator+(const MatrixExpression<Left, rows, columns, Type> &left,
+          const MatrixExpression<Right, rows, columns, Type> &right)
+{
+  return MatrixSum<Left, Right, rows, columns, Type>{left.Derived(),
+                                                     right.Derived()};
+}
+
+template <typename Left, typename Right, uint8_t rows, uint8_t columns,
+          typename Type>
+constexpr MatrixDifference<Left, Right, rows, columns, Type>
+operator-(const MatrixExpression<Left, rows, columns, Type> &left,
+          const MatrixExpression<Right, rows, columns, Type> &right)
+{
+  return MatrixDifference<Left, Right, rows, columns, Type>{
+      left.Derived(), right.Derived()};
+}
+
+template <typename Operand, uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixScaled<Operand, rows, columns, Type>
+operator*(const MatrixExpression<Operand, rows, columns, Type> &operand,
+          typename MatrixExpression<Operand, rows, columns, Type>::Scalar
+              scalar)
+{
+  return MatrixScaled<Operand, rows, columns, Type>{operand.Derived(), scalar};
+}
+
+template <typename Operand, uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixScaled<Operand, rows, columns, Type>
+operator*(typename MatrixExpression<Operand, rows, columns, Type>::Scalar
+              scalar,
+          const MatrixExpression<Operand, rows, columns, Type> &operand)
+{
+  return MatrixScaled<Operand, rows, columns, Type>{operand.Derived(), scalar};
+}
+
+template <typename Left, typename Right, uint8_t rows, uint8_t inner,
+          uint8_t columns, typename Type>
+constexpr MatrixProduct<rows, columns, Type>
+operator*(const MatrixExpression<Left, rows, inner, Type> &left,
+          const MatrixExpression<Right, inner, columns, Type> &right)
+{
+  return MatrixProduct<rows, columns, Type>{left, right};
+}
+#endif // MATRIX_EXPRESSION_TEMPLATES
+
+#endif // MATRIX_EXPRESSION_H_
@@ -0,0 +1,383 @@
+#ifdef MATRIX_VIEW_H_ // since the .cpp file has to be included by the .hpp file
+                     // this will evaluate to true
+#include "MatrixView.hpp"
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns, Type> &
+MatrixView<rows, columns, Type>::operator=(
+    const MatrixView<rows, columns, Type> &other)
+{
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    {
+      this->data[row_idx * this->stride + column_idx] =
+          other.data[row_idx * other.stride + column_idx];
+    }
+  }
+  return *this;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Expression>
+constexpr MatrixView<rows, columns, Type> &
+MatrixView<rows, columns, Type>::operator=(
+    const MatrixExpression<Expression, rows, columns, Value> &expression)
+{
+  if (!Expression::element_wise)
+  {
+    // a transpose or minor of the viewed matrix could read elements the loop
+    // already overwrote
+    const Matrix<rows, columns, Value> evaluated{expression};
+    return *this = evaluated;
+  }
+
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    {
+      this->data[row_idx * this->stride + column_idx] =
+          expression.Element(row_idx * columns + column_idx);
+    }
+  }
+  return *this;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr void MatrixView<rows, columns, Type>::Fill(Value value) const
+{
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    Type *row{this->data + row_idx * this->stride};
+    if (columns < ElementKernels::dispatch_threshold ||
+        ConstexprMath::IsConstantEvaluated())
+    {
+      for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+      {
+        row[column_idx] = value;
+      }
+    }
+    else
+    {
+      ElementKernels::Fill(row, value, columns);
+    }
+  }
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <typename Operation, typename Kernel>
+constexpr void MatrixView<rows, columns, Type>::elementWise(
+    MatrixView<rows, columns, const Value> other,
+    MatrixView<rows, columns, Value> result, Operation operation,
+    Kernel kernel) const
+{
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    const Value *row{this->data + row_idx * this->stride};
+    const Value *other_row{other.Data() + row_idx * other.Stride()};
+    Value *result_row{result.Data() + row_idx * result.Stride()};
+    if (columns < ElementKernels::dispatch_threshold ||
+        ConstexprMath::IsConstantEvaluated())
+    {
+      for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+      {
+        result_row[column_idx] =
+            operation(row[column_idx], other_row[column_idx]);
+      }
+    }
+    else
+    {
+      kernel(row, other_row, result_row, columns);
+    }
+  }
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::Add(MatrixView<rows, columns, const Value> other,
+                                     MatrixView<rows, columns, Value> result) const
+{
+  this->elementWise(
+      other, result, [](Value left, Value right) { return left + right; },
+      [](const Value *a, const Value *b, Value *c, size_t count)
+      { ElementKernels::Add(a, b, c, count); });
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::Sub(MatrixView<rows, columns, const Value> other,
+                                     MatrixView<rows, columns, Value> result) const
+{
+  this->elementWise(
+      other, result, [](Value left, Value right) { return left - right; },
+      [](const Value *a, const Value *b, Value *c, size_t count)
+      { ElementKernels::Sub(a, b, c, count); });
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::ElementMultiply(
+    MatrixView<rows, columns, const Value> other,
+    MatrixView<rows, columns, Value> result) const
+{
+  this->elementWise(
+      other, result, [](Value left, Value right) { return left * right; },
+      [](const Value *a, const Value *b, Value *c, size_t count)
+      { ElementKernels::Multiply(a, b, c, count); });
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::ElementDivide(
+    MatrixView<rows, columns, const Value> other,
+    MatrixView<rows, columns, Value> result) const
+{
+  this->elementWise(
+      other, result, [](Value left, Value right) { return left / right; },
+      [](const Value *a, const Value *b, Value *c, size_t count)
+      { ElementKernels::Divide(a, b, c, count); });
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::Mult(
+    Value scalar, MatrixView<rows, columns, Value> result) const
+{
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    const Value *row{this->data + row_idx * this->stride};
+    Value *result_row{result.Data() + row_idx * result.Stride()};
+    if (columns < ElementKernels::dispatch_threshold ||
+        ConstexprMath::IsConstantEvaluated())
+    {
+      for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+      {
+        result_row[column_idx] = row[column_idx] * scalar;
+      }
+    }
+    else
+    {
+      ElementKernels::Scale(row, scalar, result_row, columns);
+    }
+  }
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns, typename OtherType>
+constexpr MatrixView<rows, other_columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::Mult(
+    MatrixView<columns, other_columns, OtherType> other,
+    MatrixView<rows, other_columns, Value> result) const
+{
+  static_assert(std::is_same<typename std::remove_const<OtherType>::type,
+                             Value>::value,
+                "Both operands of a product need the same element type");
+
+  if (static_cast<uint32_t>(rows) * columns * other_columns <
+          Gemm::block_threshold ||
+      ConstexprMath::IsConstantEvaluated())
+  {
+    using Accumulator = typename ScalarTraits<Value>::Accumulator;
+    for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+    {
+      for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+      {
+        Accumulator sum{0};
+        for (uint8_t inner_idx{0}; inner_idx < columns; inner_idx++)
+        {
+          sum += ScalarTraits<Value>::Product(
+              this->data[row_idx * this->stride + inner_idx],
+              other.Data()[inner_idx * other.Stride() + column_idx]);
+        }
+        result.Data()[row_idx * result.Stride() + column_idx] =
+            static_cast<Value>(sum);
+      }
+    }
+    return result;
+  }
+
+  // the blocked kernel takes the row strides as its leading dimensions
+  Gemm::Multiply(rows, other_columns, columns,
+                 static_cast<const Value *>(this->data), this->stride,
+                 static_cast<const Value *>(other.Data()), other.Stride(),
+                 result.Data(), result.Stride());
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_columns, typename OtherType>
+constexpr MatrixView<columns, other_columns,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::TransposeMult(
+    MatrixView<rows, other_columns, OtherType> other,
+    MatrixView<columns, other_columns, Value> result) const
+{
+  static_assert(std::is_same<typename std::remove_const<OtherType>::type,
+                             Value>::value,
+                "Both operands of a product need the same element type");
+
+  if (static_cast<uint32_t>(rows) * columns * other_columns <
+          Gemm::block_threshold ||
+      ConstexprMath::IsConstantEvaluated())
+  {
+    // every row of the result is a sum of the rows of other, weighted by a
+    // column of this
+    using Accumulator = typename ScalarTraits<Value>::Accumulator;
+    for (uint8_t row_idx{0}; row_idx < columns; row_idx++)
+    {
+      std::array<Accumulator, other_columns> sums{};
+      for (uint8_t inner_idx{0}; inner_idx < rows; inner_idx++)
+      {
+        const Value scale{this->data[inner_idx * this->stride + row_idx]};
+        const Value *other_row{other.Data() + inner_idx * other.Stride()};
+        for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+        {
+          sums[column_idx] +=
+              ScalarTraits<Value>::Product(scale, other_row[column_idx]);
+        }
+      }
+
+      Value *result_row{result.Data() + row_idx * result.Stride()};
+      for (uint8_t column_idx{0}; column_idx < other_columns; column_idx++)
+      {
+        result_row[column_idx] = static_cast<Value>(sums[column_idx]);
+      }
+    }
+    return result;
+  }
+
+  Gemm::MultiplyTransposedA(columns, other_columns, rows,
+                            static_cast<const Value *>(this->data),
+                            this->stride,
+                            static_cast<const Value *>(other.Data()),
+                            other.Stride(), result.Data(), result.Stride());
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t other_rows, typename OtherType>
+constexpr MatrixView<rows, other_rows,
+                     typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::MultTranspose(
+    MatrixView<other_rows, columns, OtherType> other,
+    MatrixView<rows, other_rows, Value> result) const
+{
+  static_assert(std::is_same<typename std::remove_const<OtherType>::type,
+                             Value>::value,
+                "Both operands of a product need the same element type");
+
+  if (static_cast<uint32_t>(rows) * columns * other_rows <
+          Gemm::block_threshold ||
+      ConstexprMath::IsConstantEvaluated())
+  {
+    using Accumulator = typename ScalarTraits<Value>::Accumulator;
+    for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+    {
+      const Value *row{this->data + row_idx * this->stride};
+      for (uint8_t column_idx{0}; column_idx < other_rows; column_idx++)
+      {
+        const Value *other_row{other.Data() + column_idx * other.Stride()};
+        Accumulator sum{0};
+        for (uint8_t inner_idx{0}; inner_idx < columns; inner_idx++)
+        {
+          sum += ScalarTraits<Value>::Product(row[inner_idx],
+                                              other_row[inner_idx]);
+        }
+        result.Data()[row_idx * result.Stride() + column_idx] =
+            static_cast<Value>(sum);
+      }
+    }
+    return result;
+  }
+
+  Gemm::MultiplyTransposedB(rows, other_rows, columns,
+                            static_cast<const Value *>(this->data),
+                            this->stride,
+                            static_cast<const Value *>(other.Data()),
+                            other.Stride(), result.Data(), result.Stride());
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixTransposed<columns, rows,
+                           typename MatrixView<rows, columns, Type>::Value>
+MatrixView<rows, columns, Type>::Transposed() const
+{
+  return MatrixTransposed<columns, rows, Value>{
+      MatrixView<rows, columns, const Value>{*this}};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr typename MatrixView<rows, columns, Type>::Value
+MatrixView<rows, columns, Type>::Det() const
+{
+  static_assert(rows == columns, "Only square matrices have a determinant");
+  return Matrix<rows, columns, Value>{*this}.Det();
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr typename MatrixView<rows, columns, Type>::Value
+MatrixView<rows, columns, Type>::DotProduct(
+    MatrixView<rows, columns, const Value> vec1,
+    MatrixView<rows, columns, const Value> vec2)
+{
+  static_assert(rows == 1 || columns == 1,
+                "The dot product is only defined for rows and columns");
+
+  typename ScalarTraits<Value>::Accumulator sum{0};
+  for (uint8_t row_idx{0}; row_idx < rows; row_idx++)
+  {
+    for (uint8_t column_idx{0}; column_idx < columns; column_idx++)
+    {
+      sum += ScalarTraits<Value>::Product(
+          vec1.Data()[row_idx * vec1.Stride() + column_idx],
+          vec2.Data()[row_idx * vec2.Stride() + column_idx]);
+    }
+  }
+  return static_cast<Value>(sum);
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<1, columns, Type>
+MatrixView<rows, columns, Type>::Row(uint8_t row_index) const
+{
+  BoundsCheck::Assert(row_index < rows);
+  return MatrixView<1, columns, Type>{this->data + row_index * this->stride,
+                                      this->stride};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+constexpr MatrixView<rows, 1, Type>
+MatrixView<rows, columns, Type>::Column(uint8_t column_index) const
+{
+  BoundsCheck::Assert(column_index < columns);
+  return MatrixView<rows, 1, Type>{this->data + column_index, this->stride};
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset,
+          uint8_t column_offset>
+constexpr MatrixView<sub_rows, sub_columns, Type>
+MatrixView<rows, columns, Type>::Block() const
+{
+  static_assert(sub_rows + row_offset <= rows,
+                "The block you're trying to view is out of bounds (rows)");
+  static_assert(sub_columns + column_offset <= columns,
+                "The block you're trying to view is out of bounds (columns)");
+
+  return MatrixView<sub_rows, sub_columns, Type>{
+      this->data + row_offset * this->stride + column_offset, this->stride};
+}
+
+#endif // MATRIX_VIEW_H_
@@ -0,0 +1,389 @@
+#ifndef MATRIX_VIEW_H_
+#define MATRIX_VIEW_H_
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "Matrix.hpp"
+
+/**
+ * @brief A rows x columns window into elements that live somewhere else,
+ * usually a Matrix or a bigger view. Nothing is copied: reads and writes go
+ * straight to the underlying storage.
+ *
+ * Rows of the window are contiguous, and consecutive rows are stride elements
+ * apart. That covers whole matrices, single rows and columns and any
+ * rectangular block of a row-major matrix.
+ *
+ * Type is the element type for a view that can write, and const of it for
+ * one that can only read. Matrix::View, Row, Column and Block return the
+ * writable kind on non-const matrices and the read-only kind on const ones.
+ * @code
+ * Matrix<6, 1> state{};
+ * Matrix<6, 6> covariance{};
+ * // update the velocity half of the state in place
+ * state.Block<3, 1, 3, 0>() = velocity;
+ * // and a block of the covariance from a product of two others
+ * F.Block<3, 3, 0, 0>().Mult(covariance.Block<3, 3, 0, 3>(),
+ *                            covariance.Block<3, 3, 0, 0>());
+ * @endcode
+ *
+ * Views are expressions too, so they can be assigned to a Matrix, used as the
+ * operands of the matrix operators or used to construct a Matrix.
+ *
+ * @note assigning a view writes through it, it never rebinds it to other
+ * storage. Copying one (or passing it by value) does make another view of the
+ * same elements.
+ * @warning A view doesn't keep what it points into alive. Like an expression,
+ * don't let it outlive its matrix.
+ * @warning The destination of an operation must not overlap with the
+ * operands, except for element-wise operations on exactly the same elements.
+ */
+template <uint8_t rows, uint8_t columns, typename Type>
+class MatrixView
+    : public MatrixExpression<MatrixView<rows, columns, Type>, rows, columns,
+                              typename std::remove_const<Type>::type>
+{
+public:
+  /**
+   * @brief The element type without the const
+   */
+  using Value = typename std::remove_const<Type>::type;
+
+  /**
+   * @brief View rows x columns elements starting at data
+   * @param data the first element of the view
+   * @param stride the distance between the starts of two rows, in elements
+   */
+  constexpr MatrixView(Type *data, uint16_t stride)
+      : data(data), stride(stride)
+  {
+  }
+
+  /**
+   * @brief View a whole matrix
+   */
+  constexpr MatrixView(
+      typename std::conditional<std::is_const<Type>::value,
+                                const Matrix<rows, columns, Value>,
+                                Matrix<rows, columns, Value>>::type &matrix)
+      : data(matrix.matrix.data()), stride(columns)
+  {
+  }
+
+  /**
+   * @brief Make a read-only view of a view that can write
+   */
+  template <typename OtherType,
+            typename std::enable_if<
+                std::is_same<const OtherType, Type>::value &&
+                    !std::is_same<OtherType, Type>::value,
+                int>::type = 0>
+  constexpr MatrixView(const MatrixView<rows, columns, OtherType> &other)
+      : data(other.Data()), stride(other.Stride())
+  {
+  }
+
+  constexpr MatrixView(const MatrixView<rows, columns, Type> &other) =
+      default;
+
+  /**
+   * @brief Copy the elements of other into the viewed elements
+   */
+  constexpr MatrixView<rows, columns, Type> &
+  operator=(const MatrixView<rows, columns, Type> &other);
+
+  /**
+   * @brief Evaluate an expression (or a Matrix, or another view) into the
+   * viewed elements
+   */
+  template <typename Expression>
+  constexpr MatrixView<rows, columns, Type> &
+  operator=(const MatrixExpression<Expression, rows, columns, Value> &expression);
+
+  /**
+   * @brief Set all viewed elements to value
+   */
+  constexpr void Fill(Value value) const;
+
+  /**
+   * @brief Type-wise addition
+   * @param other the other view to add to this one
+   * @param result the view to store the result into
+   * @note there is no problem if result is this
+   */
+  constexpr MatrixView<rows, columns, Value>
+  Add(MatrixView<rows, columns, const Value> other,
+      MatrixView<rows, columns, Value> result) const;
+
+  /**
+   * @brief Type-wise subtraction
+   * @note there is no problem if result is this
+   */
+  constexpr MatrixView<rows, columns, Value>
+  Sub(MatrixView<rows, columns, const Value> other,
+      MatrixView<rows, columns, Value> result) const;
+
+  /**
+   * @brief Type-wise multiplication
+   * @note there is no problem if result is this
+   */
+  constexpr MatrixView<rows, columns, Value>
+  ElementMultiply(MatrixView<rows, columns, const Value> other,
+                  MatrixView<rows, columns, Value> result) const;
+
+  /**
+   * @brief Type-wise division
+   * @note there is no problem if result is this
+   */
+  constexpr MatrixView<rows, columns, Value>
+  ElementDivide(MatrixView<rows, columns, const Value> other,
+                MatrixView<rows, columns, Value> result) const;
+
+  /**
+   * @brief Multiply every element by a scalar
+   * @note there is no problem if result is this
+   */
+  constexpr MatrixView<rows, columns, Value>
+  Mult(Value scalar, MatrixView<rows, columns, Value> result) const;
+
+  /**
+   * @brief Matrix multiply this view by another one. Products big enough for
+   * the blocked kernel run on it straight from the viewed storage.
+   * @param other the view to multiply by, use Matrix::View() for a whole
+   * matrix
+   * @param result the view to store the product into
+   * @warning result must not overlap with this or other
+   */
+  template <uint8_t other_columns, typename OtherType>
+  constexpr MatrixView<rows, other_columns, Value>
+  Mult(MatrixView<columns, other_columns, OtherType> other,
+       MatrixView<rows, other_columns, Value> result) const;
+
+  /**
+   * @brief Multiply the transpose of this view by another view, without
+   * transposing anything. Both operands are read along their rows.
+   * @param other the view to multiply by, it has as many rows as this one
+   * @param result the view to store this^T * other into
+   * @warning result must not overlap with this or other
+   */
+  template <uint8_t other_columns, typename OtherType>
+  constexpr MatrixView<columns, other_columns, Value>
+  TransposeMult(MatrixView<rows, other_columns, OtherType> other,
+                MatrixView<columns, other_columns, Value> result) const;
+
+  /**
+   * @brief Multiply this view by the transpose of another view, without
+   * transposing anything. Every element of the result is the dot product of a
+   * row of this and a row of other.
+   * @param other the view to multiply by, it has as many columns as this one
+   * @param result the view to store this * other^T into
+   * @warning result must not overlap with this or other
+   */
+  template <uint8_t other_rows, typename OtherType>
+  constexpr MatrixView<rows, other_rows, Value>
+  MultTranspose(MatrixView<other_rows, columns, OtherType> other,
+                MatrixView<rows, other_rows, Value> result) const;
+
+  /**
+   * @return A read-only view of the transpose of this view, see
+   * MatrixTransposed
+   */
+  constexpr MatrixTransposed<columns, rows, Value> Transposed() const;
+
+  /**
+   * @return The determinant of the viewed elements
+   * @note the elements are gathered into a Matrix first, the factorization
+   * needs its own copy of them anyways
+   */
+  constexpr Value Det() const;
+
+  /**
+   * @brief take the dot product of two row or column views
+   */
+  static constexpr Value
+  DotProduct(MatrixView<rows, columns, const Value> vec1,
+             MatrixView<rows, columns, const Value> vec2);
+
+  /**
+   * @brief A view of one row
+   * @note row_index is only checked when the bounds check policy traps
+   */
+  constexpr MatrixView<1, columns, Type> Row(uint8_t row_index) const;
+
+  /**
+   * @brief A view of one column
+   * @note column_index is only checked when the bounds check policy traps
+   */
+  constexpr MatrixView<rows, 1, Type> Column(uint8_t column_index) const;
+
+  /**
+   * @brief A view of a block of this view
+   */
+  template <uint8_t sub_rows, uint8_t sub_columns, uint8_t row_offset,
+            uint8_t column_offset>
+  constexpr MatrixView<sub_rows, sub_columns, Type> Block() const;
+
+  /**
+   * @brief get the specified row, writes through it land in the viewed
+   * storage
+   */
+  constexpr MatrixRow<columns, Type> operator[](uint8_t row_index) const
+  {
+    BoundsCheck::Assert(row_index < rows);
+    return MatrixRow<columns, Type>{this->data + row_index * this->stride};
+  }
+
+  /**
+   * @brief Get an element by its row-major index within the view, without
+   * bounds checks
+   */
+  constexpr Value Element(uint16_t index) const
+  {
+    return this->data[(index / columns) * this->stride + index % columns];
+  }
+
+  /**
+   * @return The first viewed element
+   */
+  constexpr Type *Data() const { return this->data; }
+
+  /**
+   * @return The distance between the starts of two rows, in elements
+   */
+  constexpr uint16_t Stride() const { return this->stride; }
+
+  constexpr uint8_t GetRowSize() const { return rows; }
+  constexpr uint8_t GetColumnSize() const { return columns; }
+
+private:
+  Type *data;
+  uint16_t stride;
+
+  // run operation over every element of this, other and result a row at a
+  // time. Rows long enough to be worth it go through kernel instead.
+  template <typename Operation, typename Kernel>
+  constexpr void elementWise(MatrixView<rows, columns, const Value> other,
+                             MatrixView<rows, columns, Value> result,
+                             Operation operation, Kernel kernel) const;
+};
+
+/**
+ * @brief Read-only view of a matrix without one of its rows and one of its
+ * columns. It can't be strided like MatrixView, so it's an expression that
+ * maps every element back to its place in the full matrix.
+ * @code
+ * Matrix<2, 2> minor{mat.Minor(0, 1)};
+ * @endcode
+ */
+template <uint8_t rows, uint8_t columns, typename Type>
+class MatrixMinor
+    : public MatrixExpression<MatrixMinor<rows, columns, Type>, rows, columns,
+                              Type>
+{
+public:
+  // elements are read from other places of the parent
+  static constexpr bool element_wise{false};
+
+  /**
+   * @param parent the full matrix
+   * @param row_idx the row of parent to leave out
+   * @param column_idx the column of parent to leave out
+   */
+  constexpr MatrixMinor(MatrixView<rows + 1, columns + 1, const Type> parent,
+                        uint8_t row_idx, uint8_t column_idx)
+      : parent(parent), row_idx(row_idx), column_idx(column_idx)
+  {
+  }
+
+  constexpr Type Element(uint16_t index) const
+  {
+    const uint8_t row = index / columns;
+    const uint8_t column = index % columns;
+    return this->parent.Data()[(row < this->row_idx ? row : row + 1) *
+                                   this->parent.Stride() +
+                               (column < this->column_idx ? column
+                                                          : column + 1)];
+  }
+
+private:
+  MatrixView<rows + 1, columns + 1, const Type> parent;
+  uint8_t row_idx;
+  uint8_t column_idx;
+};
+
+/**
+ * @brief The transpose of a matrix or view, without the copy. It reads the
+ * elements in place, so it's an expression that can be assigned to a Matrix or
+ * used as an operand, and the products below hand it to the kernels that read
+ * transposed operands in their natural order.
+ * @code
+ * // S = H * P * H^T, with no transposed copy of H
+ * H.Mult(P, HP);
+ * HP.Mult(H.Transposed(), S);
+ * // J^T * J
+ * J.Transposed().Mult(J, JtJ);
+ * @endcode
+ * @warning Like a view, it doesn't keep the matrix it transposes alive
+ */
+template <uint8_t rows, uint8_t columns, typename Type>
+class MatrixTransposed
+    : public MatrixExpression<MatrixTransposed<rows, columns, Type>, rows,
+                              columns, Type>
+{
+public:
+  static constexpr bool element_wise{false};
+
+  /**
+   * @param source the matrix to transpose, it's columns x rows
+   */
+  constexpr explicit MatrixTransposed(
+      MatrixView<columns, rows, const Type> source)
+      : source(source)
+  {
+  }
+
+  constexpr Type Element(uint16_t index) const
+  {
+    return this->source.Data()[(index % columns) * this->source.Stride() +
+                               index / columns];
+  }
+
+  /**
+   * @return The matrix this is the transpose of
+   */
+  constexpr MatrixView<columns, rows, const Type> Source() const
+  {
+    return this->source;
+  }
+
+  /**
+   * @brief Multiply this transpose by other, see MatrixView::TransposeMult
+   */
+  template <uint8_t other_columns, typename OtherType>
+  constexpr MatrixView<rows, other_columns, Type>
+  Mult(MatrixView<columns, other_columns, OtherType> other,
+       MatrixView<rows, other_columns, Type> result) const
+  {
+    return this->source.TransposeMult(other, result);
+  }
+
+#ifndef MATRIX_EXPRESSION_TEMPLATES
+  template <uint8_t other_columns>
+  constexpr Matrix<rows, other_columns, Type>
+  operator*(const Matrix<columns, other_columns, Type> &other) const
+  {
+    Matrix<rows, other_columns, Type> result{};
+    this->source.TransposeMult(other.View(), result.View());
+    return result;
+  }
+#endif
+
+private:
+  MatrixView<columns, rows, const Type> source;
+};
+
+#include "MatrixView.cpp"
+
+#endif // MATRIX_VIEW_H_
@@ -0,0 +1,57 @@
+#include "Parallel.hpp"
+
+#ifdef MATRIX_THREADS
+#include <memory>
+
+#include "ThreadPool.hpp"
+
+namespace
+{
+ThreadPool *active_pool{nullptr};
+std::unique_ptr<ThreadPool> owned_pool{};
+} // namespace
+
+namespace Parallel
+{
+void SetPool(ThreadPool *pool)
+{
+  active_pool = pool;
+  if (pool != owned_pool.get())
+  {
+    owned_pool.reset();
+  }
+}
+
+void UseThreads(size_t threads)
+{
+  active_pool = nullptr;
+  owned_pool.reset();
+  if (threads == 1)
+  {
+    return;
+  }
+  owned_pool.reset(new ThreadPool{threads});
+  active_pool = owned_pool.get();
+}
+
+ThreadPool *Pool() { return active_pool; }
+
+void ForChunks(size_t count, size_t chunk_size,
+               void (*task)(size_t begin, size_t end, void *context),
+               void *context)
+{
+  const size_t chunks{(count + chunk_size - 1) / chunk_size};
+  if (active_pool == nullptr || chunks < 2)
+  {
+    task(0, count, context);
+    return;
+  }
+
+  active_pool->Run(chunks, [=](size_t chunk_idx) {
+    const size_t begin{chunk_idx * chunk_size};
+    const size_t end{begin + chunk_size < count ? begin + chunk_size : count};
+    task(begin, end, context);
+  });
+}
+} // namespace Parallel
+#endif // MATRIX_THREADS
@@ -0,0 +1,73 @@
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Opt-in multi-threading for the big operations. Gemm::Multiply splits
+ * large products into macro tiles of the result and the element kernels split
+ * large arrays into chunks, and the pieces run on a ThreadPool.
+ *
+ * Nothing here exists unless the library is built with MATRIX_THREADS (the
+ * CMake option of the same name), so targets without threads never see it.
+ * Even then everything stays on the calling thread until a pool is set with
+ * SetPool or UseThreads.
+ *
+ * The tiles and chunks are a fixed size, and every element of a result is
+ * still computed by exactly one task in the same order as the single threaded
+ * code, so results are bit for bit the same whatever the thread count.
+ */
+#ifdef MATRIX_THREADS
+class ThreadPool;
+
+namespace Parallel
+{
+/**
+ * @brief Products with fewer multiply-adds than this stay single threaded
+ */
+constexpr uint64_t multiply_threshold{128 * 128 * 128};
+
+/**
+ * @brief Element-wise operations on fewer elements than this stay single
+ * threaded
+ */
+constexpr size_t element_threshold{1 << 16};
+
+/**
+ * @brief The number of elements each task of an element-wise operation
+ * handles. A multiple of every SIMD width so the chunks don't change how the
+ * kernels split their loops.
+ */
+constexpr size_t element_chunk{1 << 14};
+
+/**
+ * @brief Run the big operations on pool
+ * @param pool the pool to use, or nullptr to go back to single threaded. The
+ * library doesn't take ownership, pool has to outlive its use.
+ */
+void SetPool(ThreadPool *pool);
+
+/**
+ * @brief Run the big operations on a pool the library owns
+ * @param threads the number of threads to use including the caller, 0 for
+ * one per hardware thread and 1 to go back to single threaded
+ */
+void UseThreads(size_t threads);
+
+/**
+ * @return the pool in use, or nullptr when single threaded
+ */
+ThreadPool *Pool();
+
+/**
+ * @brief Call task(begin, end, context) over [0, count) in chunks of
+ * chunk_size, on the pool if there is one
+ */
+void ForChunks(size_t count, size_t chunk_size,
+               void (*task)(size_t begin, size_t end, void *context),
+               void *context);
+} // namespace Parallel
+#endif // MATRIX_THREADS
+
+#endif // PARALLEL_H_
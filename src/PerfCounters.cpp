@@ -0,0 +1,300 @@
+#include "PerfCounters.hpp"
+
+#ifdef MATRIX_PERF_COUNTERS
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace
+{
+using PerfCounters::Op;
+using PerfCounters::Source;
+
+// the order of the values in a reading
+constexpr size_t cycles_idx{0};
+constexpr size_t instructions_idx{1};
+constexpr size_t cache_misses_idx{2};
+constexpr size_t branch_misses_idx{3};
+constexpr size_t counter_count{4};
+
+struct AtomicTotals
+{
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> values[counter_count]{};
+};
+
+AtomicTotals totals[PerfCounters::op_count]{};
+
+const char *const names[PerfCounters::op_count]{
+    "Matrix::Add",
+    "Matrix::Sub",
+    "Matrix::Mult",
+    "Matrix::TransposeMult",
+    "Matrix::MultTranspose",
+    "Matrix::Mult(scalar)",
+    "Matrix::ElementMultiply",
+    "Matrix::ElementDivide",
+    "Matrix::MinorMatrix",
+    "Matrix::Det",
+    "Matrix::MatrixOfMinors",
+    "Matrix::Invert",
+    "Matrix::Transpose",
+    "Matrix::Normalize",
+    "Matrix::GetRow",
+    "Matrix::GetColumn",
+    "Quaternion::FromAngleAndAxis",
+    "Quaternion::operator*",
+    "Quaternion::operator*(scalar)",
+    "Quaternion::operator+",
+    "Quaternion::Rotate",
+    "Quaternion::RotateMany",
+    "Quaternion::IntegrateMany",
+    "Quaternion::Normalize",
+    "Quaternion::ToRotationMatrix",
+    "Quaternion::ToEulerAngle",
+    "V3D::operator+",
+    "V3D::operator-",
+    "V3D::operator* and /",
+    "V3D::magnitude"};
+
+uint64_t timestamp()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t ticks{0};
+  asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+  return ticks;
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+/**
+ * @brief The perf event group of one thread. Counters are per thread, so each
+ * thread opens its own the first time it measures something.
+ */
+class CounterGroup
+{
+public:
+  CounterGroup()
+  {
+#ifdef __linux__
+    const uint64_t configs[counter_count]{
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (size_t idx{0}; idx < counter_count; idx++)
+    {
+      // the cycles counter leads the group, without it there's no group
+      const int fd{this->open(configs[idx], idx == cycles_idx ? -1
+                                                               : this->fds[0])};
+      if (fd < 0 && idx == cycles_idx)
+      {
+        return;
+      }
+      this->fds[idx] = fd;
+      if (fd >= 0)
+      {
+        // where this counter lands in a group read
+        this->slots[idx] = this->slot_count++;
+      }
+    }
+    ioctl(this->fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(this->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  ~CounterGroup()
+  {
+#ifdef __linux__
+    for (int fd : this->fds)
+    {
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  CounterGroup(const CounterGroup &) = delete;
+  CounterGroup &operator=(const CounterGroup &) = delete;
+
+  Source GetSource() const
+  {
+    return this->fds[0] >= 0 ? Source::PerfEvents : Source::TimestampCounter;
+  }
+
+  void Read(uint64_t (&values)[counter_count]) const
+  {
+#ifdef __linux__
+    if (this->fds[0] >= 0)
+    {
+      // PERF_FORMAT_GROUP reads as the count followed by one value each
+      uint64_t buffer[1 + counter_count]{};
+      if (read(this->fds[0], buffer, sizeof(buffer)) > 0)
+      {
+        for (size_t idx{0}; idx < counter_count; idx++)
+        {
+          values[idx] =
+              this->fds[idx] >= 0 ? buffer[1 + this->slots[idx]] : 0;
+        }
+        return;
+      }
+    }
+#endif
+    values[cycles_idx] = timestamp();
+    values[instructions_idx] = 0;
+    values[cache_misses_idx] = 0;
+    values[branch_misses_idx] = 0;
+  }
+
+private:
+#ifdef __linux__
+  static int open(uint64_t config, int group_fd)
+  {
+    perf_event_attr attributes{};
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = config;
+    attributes.disabled = group_fd == -1 ? 1 : 0;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP;
+    // this thread, any CPU
+    return static_cast<int>(
+        syscall(SYS_perf_event_open, &attributes, 0, -1, group_fd, 0));
+  }
+#endif
+
+  int fds[counter_count]{-1, -1, -1, -1};
+  size_t slots[counter_count]{};
+  size_t slot_count{0};
+};
+
+CounterGroup &threadCounters()
+{
+  thread_local CounterGroup counters{};
+  return counters;
+}
+
+thread_local bool recording{false};
+
+double perCall(uint64_t value, uint64_t calls)
+{
+  return calls == 0 ? 0 : static_cast<double>(value) / calls;
+}
+} // namespace
+
+namespace PerfCounters
+{
+Source ActiveSource() { return threadCounters().GetSource(); }
+
+const char *Name(Op op)
+{
+  return op < Op::Count ? names[static_cast<size_t>(op)] : "unknown";
+}
+
+Totals Get(Op op)
+{
+  if (op >= Op::Count)
+  {
+    return Totals{};
+  }
+  const AtomicTotals &op_totals{totals[static_cast<size_t>(op)]};
+  return Totals{op_totals.calls.load(std::memory_order_relaxed),
+                op_totals.values[cycles_idx].load(std::memory_order_relaxed),
+                op_totals.values[instructions_idx].load(
+                    std::memory_order_relaxed),
+                op_totals.values[cache_misses_idx].load(
+                    std::memory_order_relaxed),
+                op_totals.values[branch_misses_idx].load(
+                    std::memory_order_relaxed)};
+}
+
+void Reset()
+{
+  for (AtomicTotals &op_totals : totals)
+  {
+    op_totals.calls.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint64_t> &value : op_totals.values)
+    {
+      value.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+void Report(std::string &report)
+{
+  const bool perf_events{ActiveSource() == Source::PerfEvents};
+  char line[160]{};
+  std::snprintf(line, sizeof(line), "%-30s %10s %14s %14s %6s %10s %10s\n",
+                "operation", "calls", "cycles/call", "instr/call", "IPC",
+                "cache/call", "branch/call");
+  report += line;
+  if (!perf_events)
+  {
+    report += "(perf events unavailable, cycles are timestamp counter ticks)\n";
+  }
+
+  for (size_t idx{0}; idx < op_count; idx++)
+  {
+    const Totals op_totals{Get(static_cast<Op>(idx))};
+    if (op_totals.calls == 0)
+    {
+      continue;
+    }
+    std::snprintf(
+        line, sizeof(line), "%-30s %10llu %14.1f %14.1f %6.2f %10.3f %10.3f\n",
+        names[idx], static_cast<unsigned long long>(op_totals.calls),
+        perCall(op_totals.cycles, op_totals.calls),
+        perCall(op_totals.instructions, op_totals.calls),
+        perCall(op_totals.instructions, op_totals.cycles),
+        perCall(op_totals.cache_misses, op_totals.calls),
+        perCall(op_totals.branch_misses, op_totals.calls));
+    report += line;
+  }
+}
+
+bool IsRecording() { return recording; }
+
+Scope::Scope(Op op) : op(op), nested(recording)
+{
+  recording = true;
+  threadCounters().Read(this->start);
+}
+
+Scope::~Scope()
+{
+  uint64_t end[counter_count]{};
+  threadCounters().Read(end);
+  recording = this->nested;
+
+  if (this->op >= Op::Count)
+  {
+    return;
+  }
+  AtomicTotals &op_totals{totals[static_cast<size_t>(this->op)]};
+  op_totals.calls.fetch_add(1, std::memory_order_relaxed);
+  for (size_t idx{0}; idx < counter_count; idx++)
+  {
+    op_totals.values[idx].fetch_add(end[idx] - this->start[idx],
+                                    std::memory_order_relaxed);
+  }
+}
+} // namespace PerfCounters
+#endif // MATRIX_PERF_COUNTERS
@@ -0,0 +1,189 @@
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+
+/**
+ * @brief Optional hardware counter instrumentation for the library's hot
+ * paths. Every instrumented Matrix, Quaternion and V3D operation records its
+ * call count, cycles, instructions, cache misses and branch misses, read
+ * through Linux perf_event_open. Where perf events aren't available (another
+ * OS, or perf_event_paranoid forbids it) only the cycles are recorded, from
+ * the CPU's timestamp counter.
+ *
+ * Nothing here exists unless the library is built with MATRIX_PERF_COUNTERS
+ * (the CMake option of the same name). Without it MATRIX_PERF_SCOPE expands to
+ * nothing and the library is exactly as fast as it was.
+ *
+ * Only the outermost instrumented call on a thread is measured. Operations
+ * called from inside it (the determinants inside Invert, for example) count
+ * towards the outer operation, so the overhead of measuring them doesn't end
+ * up in its numbers.
+ *
+ * @note every measurement costs a couple of system calls, so expect the
+ * smallest operations (V3D addition, 2x2 matrices) to run a lot slower while
+ * this is turned on
+ * @note needs a compiler with __builtin_is_constant_evaluated (GCC 9, Clang 9
+ * or newer) so the instrumentation can stay out of compile time evaluation
+ */
+#ifdef MATRIX_PERF_COUNTERS
+#include "ConstexprMath.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PerfCounters
+{
+/**
+ * @brief The instrumented operations
+ */
+enum class Op : uint8_t
+{
+  MatrixAdd,
+  MatrixSub,
+  MatrixMult,
+  MatrixTransposeMult,
+  MatrixMultTranspose,
+  MatrixScalarMult,
+  MatrixElementMultiply,
+  MatrixElementDivide,
+  MatrixMinorMatrix,
+  MatrixDet,
+  MatrixOfMinors,
+  MatrixInvert,
+  MatrixTranspose,
+  MatrixNormalize,
+  MatrixGetRow,
+  MatrixGetColumn,
+  QuaternionFromAngleAndAxis,
+  QuaternionMult,
+  QuaternionScalarMult,
+  QuaternionAdd,
+  QuaternionRotate,
+  QuaternionRotateMany,
+  QuaternionIntegrateMany,
+  QuaternionNormalize,
+  QuaternionToRotationMatrix,
+  QuaternionToEulerAngle,
+  V3DAdd,
+  V3DSub,
+  V3DScale,
+  V3DMagnitude,
+  Count
+};
+
+constexpr size_t op_count{static_cast<size_t>(Op::Count)};
+
+/**
+ * @brief Where the numbers come from
+ */
+enum class Source : uint8_t
+{
+  // cycles, instructions, cache and branch misses from perf_event_open
+  PerfEvents,
+  // only cycles, from the timestamp counter. Instructions and misses stay 0.
+  TimestampCounter
+};
+
+/**
+ * @brief The totals of every measured call of one operation
+ */
+struct Totals
+{
+  uint64_t calls;
+  uint64_t cycles;
+  uint64_t instructions;
+  uint64_t cache_misses;
+  uint64_t branch_misses;
+};
+
+/**
+ * @return where the calling thread's measurements come from. Opens the
+ * counters for the thread if they aren't already.
+ */
+Source ActiveSource();
+
+/**
+ * @return a readable name for op, like "Matrix::Mult"
+ */
+const char *Name(Op op);
+
+/**
+ * @return the totals for op summed over every thread
+ */
+Totals Get(Op op);
+
+/**
+ * @brief Zero every total
+ */
+void Reset();
+
+/**
+ * @brief Write a table of every operation that has been called with its call
+ * count, cycles and instructions per call, IPC and miss rates
+ * @param report the string to write the table to
+ */
+void Report(std::string &report);
+
+/**
+ * @return true while the calling thread is measuring an operation
+ */
+bool IsRecording();
+
+/**
+ * @brief Measures everything between its construction and destruction and
+ * adds it to op's totals
+ */
+class Scope
+{
+public:
+  explicit Scope(Op op);
+  ~Scope();
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  Op op;
+  // set when this scope is inside another one
+  bool nested;
+  // cycles, instructions, cache misses, branch misses
+  uint64_t start[4];
+};
+
+/**
+ * @brief Call call() and add its cost to op's totals
+ * @return whatever call returns
+ */
+template <typename Call>
+decltype(auto) Record(Op op, Call &&call)
+{
+  const Scope scope{op};
+  return call();
+}
+} // namespace PerfCounters
+
+/**
+ * @brief Measure the enclosing function as op. Put it first in the function
+ * body and pass it the call that got here, it gets called again from inside
+ * the measurement.
+ *
+ * @code
+ * float Det() const
+ * {
+ *   MATRIX_PERF_SCOPE(MatrixDet, this->Det());
+ *   ...
+ * @endcode
+ */
+#define MATRIX_PERF_SCOPE(op, ...)                                             \
+  if (!ConstexprMath::IsConstantEvaluated() && !PerfCounters::IsRecording())   \
+  {                                                                            \
+    return PerfCounters::Record(PerfCounters::Op::op,                          \
+                                [&]() -> decltype(auto) {                      \
+                                  return __VA_ARGS__;                          \
+                                });                                            \
+  }
+#else
+#define MATRIX_PERF_SCOPE(op, ...)
+#endif // MATRIX_PERF_COUNTERS
+
+#endif // PERF_COUNTERS_H_
@@ -1,120 +1,67 @@
 #include "Quaternion.h"
 #include <cmath>
 
-/**
- * @brief Create a quaternion from an angle and axis
- * @param angle The angle to rotate by
- * @param axis The axis to rotate around
- */
-Quaternion Quaternion::FromAngleAndAxis(float angle, const Matrix<1, 3> &axis)
+void Quaternion::RotateMany(const float *xyz, float *out, size_t n) const
 {
-    const float halfAngle = angle / 2;
-    const float sinHalfAngle = sin(halfAngle);
-    Matrix<1, 3> normalizedAxis{};
-    axis.Normalize(normalizedAxis);
-    return Quaternion{
-        static_cast<float>(cos(halfAngle)),
-        normalizedAxis.Get(0, 0) * sinHalfAngle,
-        normalizedAxis.Get(0, 1) * sinHalfAngle,
-        normalizedAxis.Get(0, 2) * sinHalfAngle};
-}
-
-float Quaternion::operator[](uint8_t index) const
-{
-    if (index < 4)
+    MATRIX_PERF_SCOPE(QuaternionRotateMany, this->RotateMany(xyz, out, n));
+    if (n < Quaternion::rotation_matrix_threshold)
     {
-        return this->matrix[index];
+        for (size_t idx = 0; idx < n; idx++)
+        {
+            const V3D<float> rotated{this->Rotate(V3D<float>{xyz[3 * idx], xyz[3 * idx + 1], xyz[3 * idx + 2]})};
+            out[3 * idx] = rotated.x;
+            out[3 * idx + 1] = rotated.y;
+            out[3 * idx + 2] = rotated.z;
+        }
+        return;
     }
 
-    // index out of bounds
-    return 1e+6;
-}
-
-void Quaternion::operator=(const Quaternion &other)
-{
-    memcpy(&(this->matrix), &(other.matrix), 4 * sizeof(float));
-}
-
-Quaternion Quaternion::operator*(const Quaternion &other) const
-{
-    Quaternion result{};
-    this->Q_Mult(other, result);
-    return result;
-}
-
-Quaternion Quaternion::operator*(float scalar) const
-{
-    return Quaternion{this->w * scalar, this->v1 * scalar, this->v2 * scalar, this->v3 * scalar};
-}
-
-Quaternion Quaternion::operator+(const Quaternion &other) const
-{
-    return Quaternion{this->w + other.w, this->v1 + other.v1, this->v2 + other.v2, this->v3 + other.v3};
-}
-
-Quaternion &
-Quaternion::Q_Mult(const Quaternion &other, Quaternion &buffer) const
-{
-
-    // eq. 6
-    buffer.w = (other.w * this->w - other.v1 * this->v1 - other.v2 * this->v2 - other.v3 * this->v3);
-    buffer.v1 = (other.w * this->v1 + other.v1 * this->w - other.v2 * this->v3 + other.v3 * this->v2);
-    buffer.v2 = (other.w * this->v2 + other.v1 * this->v3 + other.v2 * this->w - other.v3 * this->v1);
-    buffer.v3 = (other.w * this->v3 - other.v1 * this->v2 + other.v2 * this->v1 + other.v3 * this->w);
-    return buffer;
-}
-
-Quaternion &Quaternion::Rotate(Quaternion &other, Quaternion &buffer) const
-{
-    Quaternion prime{this->w, -this->v1, -this->v2, -this->v3};
-    buffer.v1 = other.v1;
-    buffer.v2 = other.v2;
-    buffer.v3 = other.v3;
-    buffer.w = 0;
-
-    Quaternion temp{};
-    this->Q_Mult(buffer, temp);
-    temp.Q_Mult(prime, buffer);
-    return buffer;
+    const Matrix<3, 3> rotationMatrix{this->ToRotationMatrix()};
+    const float r00 = rotationMatrix.Element(0);
+    const float r01 = rotationMatrix.Element(1);
+    const float r02 = rotationMatrix.Element(2);
+    const float r10 = rotationMatrix.Element(3);
+    const float r11 = rotationMatrix.Element(4);
+    const float r12 = rotationMatrix.Element(5);
+    const float r20 = rotationMatrix.Element(6);
+    const float r21 = rotationMatrix.Element(7);
+    const float r22 = rotationMatrix.Element(8);
+    for (size_t idx = 0; idx < n; idx++)
+    {
+        // read the whole point before writing so out can be xyz
+        const float x = xyz[3 * idx];
+        const float y = xyz[3 * idx + 1];
+        const float z = xyz[3 * idx + 2];
+        out[3 * idx] = r00 * x + r01 * y + r02 * z;
+        out[3 * idx + 1] = r10 * x + r11 * y + r12 * z;
+        out[3 * idx + 2] = r20 * x + r21 * y + r22 * z;
+    }
 }
 
-void Quaternion::Normalize()
+void Quaternion::IntegrateMany(const float *angular_velocities, size_t n, float dt)
 {
-    float magnitude = sqrt(this->v1 * this->v1 + this->v2 * this->v2 + this->v3 * this->v3 + this->w * this->w);
-    if (magnitude == 0)
+    MATRIX_PERF_SCOPE(QuaternionIntegrateMany, this->IntegrateMany(angular_velocities, n, dt));
+    Quaternion orientation{*this};
+    for (size_t idx = 0; idx < n; idx++)
     {
-        return;
+        const V3D<float> angular_velocity{angular_velocities[3 * idx], angular_velocities[3 * idx + 1], angular_velocities[3 * idx + 2]};
+        orientation.Integrate(angular_velocity, dt);
+        orientation.Renormalize();
     }
-    this->v1 /= magnitude;
-    this->v2 /= magnitude;
-    this->v3 /= magnitude;
-    this->w /= magnitude;
+    *this = orientation;
 }
 
-Matrix<3, 3> Quaternion::ToRotationMatrix() const
-{
-    float xx = this->v1 * this->v1;
-    float yy = this->v2 * this->v2;
-    float zz = this->v3 * this->v3;
-    Matrix<3, 3> rotationMatrix{
-        1 - 2 * (yy - zz), 2 * (this->v1 * this->v2 - this->v3 * this->w), 2 * (this->v1 * this->v3 + this->v2 * this->w),
-        2 * (this->v1 * this->v2 + this->v3 * this->w), 1 - 2 * (xx - zz), 2 * (this->v2 * this->v3 - this->v1 * this->w),
-        2 * (this->v1 * this->v3 - this->v2 * this->w), 2 * (this->v2 * this->v3 + this->v1 * this->w), 1 - 2 * (xx - yy)};
-    return rotationMatrix;
-};
-
 Matrix<3, 1> Quaternion::ToEulerAngle() const
 {
-    float sqv1 = this->v1 * this->v1;
-    float sqv2 = this->v2 * this->v2;
-    float sqv3 = this->v3 * this->v3;
-    float sqw = this->w * this->w;
+    MATRIX_PERF_SCOPE(QuaternionToEulerAngle, this->ToEulerAngle());
+    float sqv1 = this->v1() * this->v1();
+    float sqv2 = this->v2() * this->v2();
+    float sqv3 = this->v3() * this->v3();
+    float sqw = this->w() * this->w();
 
-    Matrix<3, 1> eulerAngle;
-    {
-        atan2(2.0 * (this->v1 * this->v2 + this->v3 * this->w), (sqv1 - sqv2 - sqv3 + sqw));
-        asin(-2.0 * (this->v1 * this->v3 - this->v2 * this->w) / (sqv1 + sqv2 + sqv3 + sqw));
-        atan2(2.0 * (this->v2 * this->v3 + this->v1 * this->w), (-sqv1 - sqv2 + sqv3 + sqw));
-    };
+    Matrix<3, 1> eulerAngle{
+        atan2(2.0 * (this->v1() * this->v2() + this->v3() * this->w()), (sqv1 - sqv2 - sqv3 + sqw)),
+        asin(-2.0 * (this->v1() * this->v3() - this->v2() * this->w()) / (sqv1 + sqv2 + sqv3 + sqw)),
+        atan2(2.0 * (this->v2() * this->v3() + this->v1() * this->w()), (-sqv1 - sqv2 + sqv3 + sqw))};
     return eulerAngle;
 }
\ No newline at end of file
@@ -1,52 +1,97 @@
 #ifndef QUATERNION_H_
 #define QUATERNION_H_
 
+#include <cstddef>
+#include <type_traits>
+
 #include "Matrix.hpp"
-class Quaternion : public Matrix<1, 4>
+#include "Vector3D.hpp"
+/**
+ * @brief A quaternion w + v1 i + v2 j + v3 k, stored as its four floats and
+ * nothing else. It is 16 bytes, 16 byte aligned, trivially copyable and
+ * standard layout, so arrays of them pack tightly, load straight into a SIMD
+ * register and can be memcpy'd or written to disk as they are.
+ * @note everything except RotateMany and ToEulerAngle can be used in constant
+ * expressions:
+ * @code
+ * constexpr Quaternion mount{Quaternion::FromAngleAndAxis(angle, axis)};
+ * constexpr Matrix<3, 3> mount_matrix{mount.ToRotationMatrix()};
+ * @endcode
+ */
+class alignas(16) Quaternion : public Matrix<1, 4>
 {
 public:
-    Quaternion() : Matrix<1, 4>() {}
-    Quaternion(float fillValue) : Matrix<1, 4>(fillValue) {}
-    Quaternion(float w, float v1, float v2, float v3) : Matrix<1, 4>(w, v1, v2, v3) {}
-    Quaternion(const Quaternion &q) : Matrix<1, 4>(q.w, q.v1, q.v2, q.v3) {}
-    Quaternion(const Matrix<1, 4> &matrix) : Matrix<1, 4>(matrix) {}
-    Quaternion(const std::array<float, 4> &array) : Matrix<1, 4>(array) {}
+    constexpr Quaternion() : Matrix<1, 4>() {}
+    constexpr Quaternion(float fillValue) : Matrix<1, 4>(fillValue) {}
+    constexpr Quaternion(float w, float v1, float v2, float v3) : Matrix<1, 4>(w, v1, v2, v3) {}
+    constexpr Quaternion(const Quaternion &q) = default;
+    constexpr Quaternion(const Matrix<1, 4> &matrix) : Matrix<1, 4>(matrix) {}
+    constexpr Quaternion(const std::array<float, 4> &array) : Matrix<1, 4>(array) {}
 
     /**
      * @brief Create a quaternion from an angle and axis
      * @param angle The angle to rotate by
      * @param axis The axis to rotate around
      */
-    static Quaternion FromAngleAndAxis(float angle, const Matrix<1, 3> &axis);
+    static constexpr Quaternion FromAngleAndAxis(float angle, const Matrix<1, 3> &axis);
 
     /**
      * @brief Access the elements of the quaternion
      * @param index The index of the element to access
      * @return The value of the element at the index
      */
-    float operator[](uint8_t index) const;
+    constexpr float operator[](uint8_t index) const;
 
     /**
      * @brief Assign one quaternion to another
      */
-    void operator=(const Quaternion &other);
+    constexpr Quaternion &operator=(const Quaternion &other) = default;
+
+    /**
+     * @brief Access the elements of the quaternion by name
+     */
+    constexpr float &w() { return this->matrix[0]; }
+    constexpr float w() const { return this->matrix[0]; }
+    constexpr float &v1() { return this->matrix[1]; }
+    constexpr float v1() const { return this->matrix[1]; }
+    constexpr float &v2() { return this->matrix[2]; }
+    constexpr float v2() const { return this->matrix[2]; }
+    constexpr float &v3() { return this->matrix[3]; }
+    constexpr float v3() const { return this->matrix[3]; }
 
     /**
      * @brief Do quaternion multiplication
      */
-    Quaternion operator*(const Quaternion &other) const;
+    constexpr Quaternion operator*(const Quaternion &other) const;
 
     /**
      * @brief Multiply the quaternion by a scalar
      */
-    Quaternion operator*(float scalar) const;
+    constexpr Quaternion operator*(float scalar) const;
 
     /**
      * @brief Add two quaternions together
      * @param other The quaternion to add to this one
      * @return The net quaternion
      */
-    Quaternion operator+(const Quaternion &other) const;
+    constexpr Quaternion operator+(const Quaternion &other) const;
+
+    /**
+     * @brief Multiply this quaternion by another in place, so
+     * this = this * other
+     * @note other can be this quaternion
+     */
+    constexpr Quaternion &operator*=(const Quaternion &other);
+
+    /**
+     * @brief Scale the quaternion in place
+     */
+    constexpr Quaternion &operator*=(float scalar);
+
+    /**
+     * @brief Add another quaternion to this one in place
+     */
+    constexpr Quaternion &operator+=(const Quaternion &other);
 
     /**
      * @brief Q_Mult a quaternion by another quaternion
@@ -54,26 +99,86 @@ public:
      * @param buffer The buffer to store the result in
      * @return A reference to the buffer
      */
-    Quaternion &Q_Mult(const Quaternion &other, Quaternion &buffer) const;
+    constexpr Quaternion &Q_Mult(const Quaternion &other, Quaternion &buffer) const;
 
     /**
      * @brief Rotate a quaternion by this quaternion
-     * @param other The quaternion to rotate
+     * @param other The quaternion to rotate. Only its vector part is used.
      * @param buffer The buffer to store the result in
-     *
+     * @note this quaternion has to be normalized
+     * @note there is no problem if buffer == other
+     */
+    constexpr Quaternion &Rotate(const Quaternion &other, Quaternion &buffer) const;
+
+    /**
+     * @brief Rotate a vector by this quaternion
+     * @note this quaternion has to be normalized
+     */
+    constexpr V3D<float> Rotate(const V3D<float> &vector) const;
+
+    /**
+     * @brief Rotate a column vector by this quaternion
+     * @note this quaternion has to be normalized
      */
-    Quaternion &Rotate(Quaternion &other, Quaternion &buffer) const;
+    constexpr Matrix<3, 1> Rotate(const Matrix<3, 1> &vector) const;
+
+    /**
+     * @brief Rotate many vectors by this quaternion
+     * @param xyz n vectors stored as x, y, z, x, y, z, ...
+     * @param out A buffer of 3 * n floats to store the results in
+     * @param n The number of vectors
+     * @note this quaternion has to be normalized
+     * @note there is no problem if out == xyz
+     */
+    void RotateMany(const float *xyz, float *out, size_t n) const;
 
     /**
      * @brief Normalize the quaternion to a magnitude of 1
      */
-    void Normalize();
+    constexpr void Normalize();
+
+    /**
+     * @return the conjugate w - v1 i - v2 j - v3 k, which for a normalized
+     * quaternion is the inverse rotation
+     */
+    constexpr Quaternion Conjugate() const;
+
+    /**
+     * @brief Pull the quaternion back towards a magnitude of 1 without a
+     * square root. One Newton step of 1 / sqrt(magnitude^2) taken from 1, so
+     * a quaternion that has drifted by e ends up within about e^2 of unit
+     * length. Meant for quaternions updated every sample, where the drift
+     * per step is tiny; use Normalize for anything further off.
+     */
+    constexpr void Renormalize();
+
+    /**
+     * @brief Turn the quaternion by a body frame angular velocity held for dt
+     * seconds, this = this * exp(angular_velocity * dt / 2). The exponential
+     * map is exact for a constant rate, unlike adding the derivative
+     * 0.5 * q * omega * dt, and keeps the quaternion at unit length up to
+     * rounding.
+     * @param angular_velocity in radians per second
+     * @note follow it with Renormalize now and then to stop rounding from
+     * building up
+     */
+    constexpr Quaternion &Integrate(const V3D<float> &angular_velocity, float dt);
+
+    /**
+     * @brief Integrate a buffer of gyro samples in one call, renormalizing
+     * after every sample. The same as calling Integrate and Renormalize for
+     * each sample, with the quaternion held in registers the whole time.
+     * @param angular_velocities n samples stored as x, y, z, x, y, z, ...
+     * @param n The number of samples
+     * @param dt The time between samples
+     */
+    void IntegrateMany(const float *angular_velocities, size_t n, float dt);
 
     /**
      * @brief Convert the quaternion to a rotation matrix
      * @return The rotation matrix
      */
-    Matrix<3, 3> ToRotationMatrix() const;
+    constexpr Matrix<3, 3> ToRotationMatrix() const;
 
     /**
      * @brief Convert the quaternion to an Euler angle representation
@@ -81,11 +186,220 @@ public:
      */
     Matrix<3, 1> ToEulerAngle() const;
 
-    // Give people an easy way to access the elements
-    float &w{matrix[0]};
-    float &v1{matrix[1]};
-    float &v2{matrix[2]};
-    float &v3{matrix[3]};
+    /**
+     * @brief RotateMany converts to a rotation matrix first when it has at
+     * least this many vectors to rotate. Building the matrix costs about as
+     * much as rotating one vector directly, and after that each vector is
+     * only 9 multiplies instead of 15.
+     */
+    static constexpr size_t rotation_matrix_threshold{2};
+
+    /**
+     * @brief Below this squared half angle Integrate evaluates the
+     * exponential map with a Taylor series instead of sin and cos. The first
+     * term left out is below float precision up to here, and at kHz sample
+     * rates every step is far below it.
+     */
+    static constexpr float small_angle_squared{0.01f};
 };
 
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "A quaternion is its four floats");
+static_assert(std::is_trivially_copyable<Quaternion>::value, "Quaternions have to be memcpy-able");
+static_assert(std::is_standard_layout<Quaternion>::value, "Quaternions have to be standard layout");
+
+constexpr Quaternion Quaternion::FromAngleAndAxis(float angle, const Matrix<1, 3> &axis)
+{
+    MATRIX_PERF_SCOPE(QuaternionFromAngleAndAxis, Quaternion::FromAngleAndAxis(angle, axis));
+    const float halfAngle = angle / 2;
+    const float sinHalfAngle = ConstexprMath::Sin(halfAngle);
+    Matrix<1, 3> normalizedAxis{};
+    axis.Normalize(normalizedAxis);
+    return Quaternion{
+        ConstexprMath::Cos(halfAngle),
+        normalizedAxis.Element(0) * sinHalfAngle,
+        normalizedAxis.Element(1) * sinHalfAngle,
+        normalizedAxis.Element(2) * sinHalfAngle};
+}
+
+constexpr float Quaternion::operator[](uint8_t index) const
+{
+    if (BoundsCheck::Accept(index < 4))
+    {
+        return this->matrix[index];
+    }
+
+    // index out of bounds
+    return 1e+6;
+}
+
+constexpr Quaternion Quaternion::operator*(const Quaternion &other) const
+{
+    MATRIX_PERF_SCOPE(QuaternionMult, *this * other);
+    Quaternion result{*this};
+    result *= other;
+    return result;
+}
+
+constexpr Quaternion Quaternion::operator*(float scalar) const
+{
+    MATRIX_PERF_SCOPE(QuaternionScalarMult, *this * scalar);
+    return Quaternion{this->w() * scalar, this->v1() * scalar, this->v2() * scalar, this->v3() * scalar};
+}
+
+constexpr Quaternion Quaternion::operator+(const Quaternion &other) const
+{
+    MATRIX_PERF_SCOPE(QuaternionAdd, *this + other);
+    return Quaternion{this->w() + other.w(), this->v1() + other.v1(), this->v2() + other.v2(), this->v3() + other.v3()};
+}
+
+constexpr Quaternion &Quaternion::operator*=(const Quaternion &other)
+{
+    MATRIX_PERF_SCOPE(QuaternionMult, *this *= other);
+    // read both quaternions before writing, they can be the same one
+    const float w = this->matrix[0];
+    const float x = this->matrix[1];
+    const float y = this->matrix[2];
+    const float z = this->matrix[3];
+    const float ow = other.matrix[0];
+    const float ox = other.matrix[1];
+    const float oy = other.matrix[2];
+    const float oz = other.matrix[3];
+    this->matrix[0] = ow * w - ox * x - oy * y - oz * z;
+    this->matrix[1] = ow * x + ox * w - oy * z + oz * y;
+    this->matrix[2] = ow * y + ox * z + oy * w - oz * x;
+    this->matrix[3] = ow * z - ox * y + oy * x + oz * w;
+    return *this;
+}
+
+constexpr Quaternion &Quaternion::operator*=(float scalar)
+{
+    MATRIX_PERF_SCOPE(QuaternionScalarMult, *this *= scalar);
+    for (uint8_t idx{0}; idx < 4; idx++)
+    {
+        this->matrix[idx] *= scalar;
+    }
+    return *this;
+}
+
+constexpr Quaternion &Quaternion::operator+=(const Quaternion &other)
+{
+    MATRIX_PERF_SCOPE(QuaternionAdd, *this += other);
+    for (uint8_t idx{0}; idx < 4; idx++)
+    {
+        this->matrix[idx] += other.matrix[idx];
+    }
+    return *this;
+}
+
+constexpr Quaternion &
+Quaternion::Q_Mult(const Quaternion &other, Quaternion &buffer) const
+{
+    MATRIX_PERF_SCOPE(QuaternionMult, this->Q_Mult(other, buffer));
+
+    // eq. 6
+    buffer.w() = (other.w() * this->w() - other.v1() * this->v1() - other.v2() * this->v2() - other.v3() * this->v3());
+    buffer.v1() = (other.w() * this->v1() + other.v1() * this->w() - other.v2() * this->v3() + other.v3() * this->v2());
+    buffer.v2() = (other.w() * this->v2() + other.v1() * this->v3() + other.v2() * this->w() - other.v3() * this->v1());
+    buffer.v3() = (other.w() * this->v3() - other.v1() * this->v2() + other.v2() * this->v1() + other.v3() * this->w());
+    return buffer;
+}
+
+constexpr Quaternion &Quaternion::Rotate(const Quaternion &other, Quaternion &buffer) const
+{
+    MATRIX_PERF_SCOPE(QuaternionRotate, this->Rotate(other, buffer));
+    const V3D<float> rotated{this->Rotate(V3D<float>{other.v1(), other.v2(), other.v3()})};
+    buffer.w() = 0;
+    buffer.v1() = rotated.x;
+    buffer.v2() = rotated.y;
+    buffer.v3() = rotated.z;
+    return buffer;
+}
+
+constexpr V3D<float> Quaternion::Rotate(const V3D<float> &vector) const
+{
+    MATRIX_PERF_SCOPE(QuaternionRotate, this->Rotate(vector));
+    // q * v * q' expanded for a unit quaternion and a pure v:
+    // v' = v + w * t + u x t where u is the vector part and t = 2 * (u x v)
+    const float qw = this->matrix[0];
+    const float qx = this->matrix[1];
+    const float qy = this->matrix[2];
+    const float qz = this->matrix[3];
+    const float tx = 2 * (qy * vector.z - qz * vector.y);
+    const float ty = 2 * (qz * vector.x - qx * vector.z);
+    const float tz = 2 * (qx * vector.y - qy * vector.x);
+    return V3D<float>{
+        vector.x + qw * tx + (qy * tz - qz * ty),
+        vector.y + qw * ty + (qz * tx - qx * tz),
+        vector.z + qw * tz + (qx * ty - qy * tx)};
+}
+
+constexpr Matrix<3, 1> Quaternion::Rotate(const Matrix<3, 1> &vector) const
+{
+    MATRIX_PERF_SCOPE(QuaternionRotate, this->Rotate(vector));
+    const V3D<float> rotated{this->Rotate(V3D<float>{vector})};
+    return Matrix<3, 1>{rotated.x, rotated.y, rotated.z};
+}
+
+constexpr void Quaternion::Normalize()
+{
+    MATRIX_PERF_SCOPE(QuaternionNormalize, this->Normalize());
+    float magnitude = ConstexprMath::Sqrt(this->v1() * this->v1() + this->v2() * this->v2() + this->v3() * this->v3() + this->w() * this->w());
+    if (magnitude == 0)
+    {
+        return;
+    }
+    this->v1() /= magnitude;
+    this->v2() /= magnitude;
+    this->v3() /= magnitude;
+    this->w() /= magnitude;
+}
+
+constexpr Quaternion Quaternion::Conjugate() const
+{
+    return Quaternion{this->w(), -this->v1(), -this->v2(), -this->v3()};
+}
+
+constexpr void Quaternion::Renormalize()
+{
+    const float magnitude_squared = this->w() * this->w() + this->v1() * this->v1() + this->v2() * this->v2() + this->v3() * this->v3();
+    *this *= (3 - magnitude_squared) / 2;
+}
+
+constexpr Quaternion &Quaternion::Integrate(const V3D<float> &angular_velocity, float dt)
+{
+    // exp of the half angle rotation vector h is cos|h| + sin|h| * h / |h|
+    const float half_dt = dt / 2;
+    const float hx = angular_velocity.x * half_dt;
+    const float hy = angular_velocity.y * half_dt;
+    const float hz = angular_velocity.z * half_dt;
+    const float angle_squared = hx * hx + hy * hy + hz * hz;
+    float cos_angle = 0;
+    float sinc_angle = 0;
+    if (angle_squared < Quaternion::small_angle_squared)
+    {
+        cos_angle = 1 - angle_squared / 2 + angle_squared * angle_squared / 24;
+        sinc_angle = 1 - angle_squared / 6 + angle_squared * angle_squared / 120;
+    }
+    else
+    {
+        const float angle = ConstexprMath::Sqrt(angle_squared);
+        cos_angle = ConstexprMath::Cos(angle);
+        sinc_angle = ConstexprMath::Sin(angle) / angle;
+    }
+    return *this *= Quaternion{cos_angle, hx * sinc_angle, hy * sinc_angle, hz * sinc_angle};
+}
+
+constexpr Matrix<3, 3> Quaternion::ToRotationMatrix() const
+{
+    MATRIX_PERF_SCOPE(QuaternionToRotationMatrix, this->ToRotationMatrix());
+    float xx = this->v1() * this->v1();
+    float yy = this->v2() * this->v2();
+    float zz = this->v3() * this->v3();
+    Matrix<3, 3> rotationMatrix{
+        1 - 2 * (yy + zz), 2 * (this->v1() * this->v2() - this->v3() * this->w()), 2 * (this->v1() * this->v3() + this->v2() * this->w()),
+        2 * (this->v1() * this->v2() + this->v3() * this->w()), 1 - 2 * (xx + zz), 2 * (this->v2() * this->v3() - this->v1() * this->w()),
+        2 * (this->v1() * this->v3() - this->v2() * this->w()), 2 * (this->v2() * this->v3() + this->v1() * this->w()), 1 - 2 * (xx + yy)};
+    return rotationMatrix;
+}
+
 #endif // QUATERNION_H_
\ No newline at end of file
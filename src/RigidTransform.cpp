@@ -0,0 +1,69 @@
+#include "RigidTransform.hpp"
+#include <cmath>
+
+void RigidTransform::Apply(const float *xyz, float *out, size_t n) const
+{
+    // one rotation matrix for the whole array, see Quaternion::RotateMany
+    const Matrix<3, 3> rotationMatrix{this->rotation.ToRotationMatrix()};
+    const float r00 = rotationMatrix.Element(0);
+    const float r01 = rotationMatrix.Element(1);
+    const float r02 = rotationMatrix.Element(2);
+    const float r10 = rotationMatrix.Element(3);
+    const float r11 = rotationMatrix.Element(4);
+    const float r12 = rotationMatrix.Element(5);
+    const float r20 = rotationMatrix.Element(6);
+    const float r21 = rotationMatrix.Element(7);
+    const float r22 = rotationMatrix.Element(8);
+    const float tx = this->translation.x;
+    const float ty = this->translation.y;
+    const float tz = this->translation.z;
+    for (size_t idx = 0; idx < n; idx++)
+    {
+        // read the whole point before writing so out can be xyz
+        const float x = xyz[3 * idx];
+        const float y = xyz[3 * idx + 1];
+        const float z = xyz[3 * idx + 2];
+        out[3 * idx] = r00 * x + r01 * y + r02 * z + tx;
+        out[3 * idx + 1] = r10 * x + r11 * y + r12 * z + ty;
+        out[3 * idx + 2] = r20 * x + r21 * y + r22 * z + tz;
+    }
+}
+
+bool RigidTransform::Apply(const V3DBatch<float> &points, V3DBatch<float> &result) const
+{
+    return points.Transform(this->rotation.ToRotationMatrix(), this->translation, result);
+}
+
+RigidTransform RigidTransform::Interpolate(const RigidTransform &other, float t) const
+{
+    const V3D<float> translation{this->translation + (other.translation - this->translation) * t};
+
+    // q and -q are the same rotation, flip other onto this side so the blend
+    // takes the short way round
+    Quaternion target{other.rotation};
+    float cosAngle = 0;
+    for (uint8_t idx = 0; idx < 4; idx++)
+    {
+        cosAngle += this->rotation[idx] * target[idx];
+    }
+    if (cosAngle < 0)
+    {
+        target *= -1.0f;
+        cosAngle = -cosAngle;
+    }
+
+    float fromWeight = 1 - t;
+    float toWeight = t;
+    if (cosAngle < RigidTransform::slerp_threshold)
+    {
+        const float angle = std::acos(cosAngle);
+        const float inverseSin = 1 / std::sin(angle);
+        fromWeight = std::sin((1 - t) * angle) * inverseSin;
+        toWeight = std::sin(t * angle) * inverseSin;
+    }
+
+    Quaternion rotation{this->rotation * fromWeight + target * toWeight};
+    // only needed for the straight line blend, but it also mops up rounding
+    rotation.Normalize();
+    return RigidTransform{rotation, translation};
+}
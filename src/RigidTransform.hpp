@@ -0,0 +1,225 @@
+#ifndef RIGID_TRANSFORM_H_
+#define RIGID_TRANSFORM_H_
+
+#include <cstddef>
+
+#include "ConstexprMath.hpp"
+#include "Matrix.hpp"
+#include "Quaternion.h"
+#include "V3DBatch.hpp"
+#include "Vector3D.hpp"
+
+/**
+ * @brief A rotation followed by a translation, p' = R * p + t, stored as a
+ * unit quaternion and a vector. Composing two of them is a quaternion product
+ * and a rotated vector, and the inverse is a conjugate and a rotated vector,
+ * against a 4x4 product or a cofactor inverse for the same pose as a
+ * Matrix<4, 4>.
+ * @code
+ * const RigidTransform world_from_camera{world_from_body * body_from_camera};
+ * const RigidTransform camera_from_world{world_from_camera.Inverse()};
+ * @endcode
+ * @note everything except Interpolate and the bulk Apply can be used in
+ * constant expressions
+ * @note the rotation has to stay normalized. Composing thousands of
+ * transforms lets rounding creep in, so Normalize the result of long chains.
+ */
+class RigidTransform
+{
+public:
+    /**
+     * @brief Create the identity transform
+     */
+    constexpr RigidTransform() : rotation{1, 0, 0, 0}, translation{} {}
+
+    /**
+     * @brief Create a transform that rotates by rotation, then moves by
+     * translation
+     * @param rotation a normalized quaternion
+     */
+    constexpr RigidTransform(const Quaternion &rotation, const V3D<float> &translation)
+        : rotation{rotation}, translation{translation} {}
+
+    /**
+     * @brief Create a transform from a homogeneous 4x4 matrix
+     * @note the upper left 3x3 has to be a rotation matrix, the bottom row is
+     * ignored
+     */
+    static constexpr RigidTransform FromMatrix(const Matrix<4, 4> &matrix);
+
+    constexpr const Quaternion &Rotation() const { return this->rotation; }
+    constexpr Quaternion &Rotation() { return this->rotation; }
+    constexpr const V3D<float> &Translation() const { return this->translation; }
+    constexpr V3D<float> &Translation() { return this->translation; }
+
+    /**
+     * @brief Compose two transforms, this * other applies other first and
+     * then this, like the product of their matrices
+     */
+    constexpr RigidTransform operator*(const RigidTransform &other) const;
+
+    /**
+     * @brief Compose in place, so this = this * other
+     * @note other can be this transform
+     */
+    constexpr RigidTransform &operator*=(const RigidTransform &other);
+
+    /**
+     * @return the transform that undoes this one, p = R^T * (p' - t)
+     */
+    constexpr RigidTransform Inverse() const;
+
+    /**
+     * @brief this->Inverse() * other without building the inverse, the
+     * relative transform from other's frame into this one's
+     */
+    constexpr RigidTransform InverseCompose(const RigidTransform &other) const;
+
+    /**
+     * @brief Transform a point
+     */
+    constexpr V3D<float> Apply(const V3D<float> &point) const;
+
+    /**
+     * @brief Transform many points
+     * @param xyz n points stored as x, y, z, x, y, z, ...
+     * @param out A buffer of 3 * n floats to store the results in
+     * @param n The number of points
+     * @note there is no problem if out == xyz
+     */
+    void Apply(const float *xyz, float *out, size_t n) const;
+
+    /**
+     * @brief Transform a batch of points, see V3DBatch::Transform
+     * @return false if the batch sizes don't match
+     * @note there is no problem if result == points
+     */
+    bool Apply(const V3DBatch<float> &points, V3DBatch<float> &result) const;
+
+    /**
+     * @brief Blend between this transform at t = 0 and other at t = 1, the
+     * rotation along the shortest great circle (slerp) and the translation in
+     * a straight line
+     */
+    RigidTransform Interpolate(const RigidTransform &other, float t) const;
+
+    /**
+     * @brief Scale the rotation back to unit length
+     */
+    constexpr void Normalize();
+
+    /**
+     * @return the homogeneous 4x4 matrix of the transform
+     */
+    constexpr Matrix<4, 4> ToMatrix() const;
+
+    /**
+     * @brief Interpolate switches from slerp to a normalized straight line
+     * blend once the two rotations are this close, where sin of the angle
+     * between them gets too small to divide by
+     */
+    static constexpr float slerp_threshold{0.9995f};
+
+private:
+    Quaternion rotation;
+    V3D<float> translation;
+};
+
+constexpr RigidTransform RigidTransform::FromMatrix(const Matrix<4, 4> &matrix)
+{
+    const float m00 = matrix.Get(0, 0);
+    const float m01 = matrix.Get(0, 1);
+    const float m02 = matrix.Get(0, 2);
+    const float m10 = matrix.Get(1, 0);
+    const float m11 = matrix.Get(1, 1);
+    const float m12 = matrix.Get(1, 2);
+    const float m20 = matrix.Get(2, 0);
+    const float m21 = matrix.Get(2, 1);
+    const float m22 = matrix.Get(2, 2);
+    const V3D<float> translation{matrix.Get(0, 3), matrix.Get(1, 3), matrix.Get(2, 3)};
+
+    // Shepperd's method, taking the square root of whichever of w, x, y and z
+    // is largest so the division never gets close to zero
+    const float trace = m00 + m11 + m22;
+    Quaternion rotation{};
+    if (trace > 0)
+    {
+        const float s = 2 * ConstexprMath::Sqrt(trace + 1);
+        rotation = Quaternion{s / 4, (m21 - m12) / s, (m02 - m20) / s, (m10 - m01) / s};
+    }
+    else if (m00 > m11 && m00 > m22)
+    {
+        const float s = 2 * ConstexprMath::Sqrt(1 + m00 - m11 - m22);
+        rotation = Quaternion{(m21 - m12) / s, s / 4, (m01 + m10) / s, (m02 + m20) / s};
+    }
+    else if (m11 > m22)
+    {
+        const float s = 2 * ConstexprMath::Sqrt(1 + m11 - m00 - m22);
+        rotation = Quaternion{(m02 - m20) / s, (m01 + m10) / s, s / 4, (m12 + m21) / s};
+    }
+    else
+    {
+        const float s = 2 * ConstexprMath::Sqrt(1 + m22 - m00 - m11);
+        rotation = Quaternion{(m10 - m01) / s, (m02 + m20) / s, (m12 + m21) / s, s / 4};
+    }
+    return RigidTransform{rotation, translation};
+}
+
+constexpr RigidTransform RigidTransform::operator*(const RigidTransform &other) const
+{
+    // R = R1 * R2, t = R1 * t2 + t1
+    return RigidTransform{this->rotation * other.rotation,
+                          this->rotation.Rotate(other.translation) + this->translation};
+}
+
+constexpr RigidTransform &RigidTransform::operator*=(const RigidTransform &other)
+{
+    // the translation first, it needs the rotation before it changes
+    this->translation += this->rotation.Rotate(other.translation);
+    this->rotation *= other.rotation;
+    return *this;
+}
+
+constexpr RigidTransform RigidTransform::Inverse() const
+{
+    const Quaternion inverse_rotation{this->rotation.Conjugate()};
+    return RigidTransform{inverse_rotation, inverse_rotation.Rotate(this->translation) * -1.0f};
+}
+
+constexpr RigidTransform RigidTransform::InverseCompose(const RigidTransform &other) const
+{
+    // R = R1^T * R2, t = R1^T * (t2 - t1)
+    const Quaternion inverse_rotation{this->rotation.Conjugate()};
+    return RigidTransform{inverse_rotation * other.rotation,
+                          inverse_rotation.Rotate(other.translation - this->translation)};
+}
+
+constexpr V3D<float> RigidTransform::Apply(const V3D<float> &point) const
+{
+    return this->rotation.Rotate(point) + this->translation;
+}
+
+constexpr void RigidTransform::Normalize()
+{
+    this->rotation.Normalize();
+}
+
+constexpr Matrix<4, 4> RigidTransform::ToMatrix() const
+{
+    const Matrix<3, 3> rotation_matrix{this->rotation.ToRotationMatrix()};
+    Matrix<4, 4> matrix{};
+    for (uint8_t row_idx = 0; row_idx < 3; row_idx++)
+    {
+        for (uint8_t column_idx = 0; column_idx < 3; column_idx++)
+        {
+            matrix[row_idx][column_idx] = rotation_matrix.Get(row_idx, column_idx);
+        }
+    }
+    matrix[0][3] = this->translation.x;
+    matrix[1][3] = this->translation.y;
+    matrix[2][3] = this->translation.z;
+    matrix[3][3] = 1;
+    return matrix;
+}
+
+#endif // RIGID_TRANSFORM_H_
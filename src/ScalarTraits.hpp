@@ -0,0 +1,97 @@
+#ifndef SCALAR_TRAITS_H_
+#define SCALAR_TRAITS_H_
+
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief What the matrix code needs to know about an element type beyond its
+ * arithmetic: what to accumulate sums in, how precise it is and how to turn
+ * the library's sentinel values (1e+10 for out of bounds reads and so on) into
+ * something the type can hold.
+ *
+ * float, double, long double and every integer type work out of the box.
+ * _Float16 is supported on compilers that have it (GCC 12 and Clang 15 on
+ * x86-64, most ARM compilers); its sums are accumulated in float because half
+ * precision runs out of digits after a few dozen additions.
+ */
+template <typename Type>
+struct ScalarTraits
+{
+  /**
+   * @brief The type dot products, norms and matrix products are summed in
+   */
+  using Accumulator = Type;
+
+  /**
+   * @brief The type ToString converts elements to before printing them
+   */
+  using Printable = Type;
+
+  /**
+   * @brief Whether Type is a number the vector and matrix code can do
+   * arithmetic on. Types that aren't built in, like fixed point, set it in
+   * their own specialization.
+   */
+  static constexpr bool is_number{std::is_arithmetic<Type>::value};
+
+  /**
+   * @brief The difference between 1 and the next representable value, 0 for
+   * integers
+   */
+  static constexpr Type epsilon{std::numeric_limits<Type>::epsilon()};
+
+  static constexpr Type lowest{std::numeric_limits<Type>::lowest()};
+  static constexpr Type max{std::numeric_limits<Type>::max()};
+
+  /**
+   * @brief Convert value, clamping it to the range of the type
+   */
+  static constexpr Type Saturate(double value)
+  {
+    return value > static_cast<double>(max)      ? max
+           : value < static_cast<double>(lowest) ? lowest
+                                                 : static_cast<Type>(value);
+  }
+
+  /**
+   * @brief Multiply two elements into the accumulator. Sums of products go
+   * through this so a type can keep the full width of the product, rather than
+   * rounding it back to Type before it's added.
+   */
+  static constexpr Accumulator Product(Type left, Type right)
+  {
+    return static_cast<Accumulator>(left) * static_cast<Accumulator>(right);
+  }
+};
+
+#if defined(__FLT16_MAX__)
+template <>
+struct ScalarTraits<_Float16>
+{
+  using Accumulator = float;
+  using Printable = float;
+
+  static constexpr bool is_number{true};
+
+  // spelled out because the F16 literal suffix of __FLT16_MAX__ and friends
+  // isn't valid C++ before C++23
+  static constexpr _Float16 epsilon{0.0009765625f};
+  static constexpr _Float16 lowest{-65504.0f};
+  static constexpr _Float16 max{65504.0f};
+
+  static constexpr _Float16 Saturate(double value)
+  {
+    return value > static_cast<double>(max)      ? max
+           : value < static_cast<double>(lowest) ? lowest
+                                                 : static_cast<_Float16>(value);
+  }
+
+  static constexpr float Product(_Float16 left, _Float16 right)
+  {
+    return static_cast<float>(left) * static_cast<float>(right);
+  }
+};
+#endif
+
+#endif // SCALAR_TRAITS_H_
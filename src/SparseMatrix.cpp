@@ -0,0 +1,423 @@
+#include "SparseMatrix.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "BoundsCheck.hpp"
+#include "ElementKernels.hpp"
+
+bool SparseMatrix::allocate(Arena &arena, size_t rows, size_t columns,
+                            size_t non_zeros, Layout layout)
+{
+  const size_t outer_size{layout == Layout::CSR ? rows : columns};
+  uint32_t *outer_starts{arena.Allocate<uint32_t>(outer_size + 1)};
+  uint32_t *inner_indices{arena.Allocate<uint32_t>(non_zeros)};
+  float *values{arena.Allocate<float>(non_zeros)};
+  if (outer_starts == nullptr || inner_indices == nullptr || values == nullptr)
+  {
+    return false;
+  }
+
+  this->outer_starts = outer_starts;
+  this->inner_indices = inner_indices;
+  this->values = values;
+  this->non_zeros = non_zeros;
+  this->rows = rows;
+  this->columns = columns;
+  this->layout = layout;
+  return true;
+}
+
+SparseMatrix SparseMatrix::FromTriplets(Arena &arena, size_t rows,
+                                        size_t columns,
+                                        const Triplet *triplets, size_t count,
+                                        Layout layout)
+{
+  SparseMatrix result{};
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    if (triplets[idx].row >= rows || triplets[idx].column >= columns)
+    {
+      return result;
+    }
+  }
+
+  const size_t mark{arena.Mark()};
+  // duplicates are merged below, so count is only an upper bound on the
+  // number of entries. The few unused slots at the end are the price of not
+  // needing a second pass.
+  uint32_t *triplet_positions{arena.Allocate<uint32_t>(count)};
+  if (triplet_positions == nullptr ||
+      !result.allocate(arena, rows, columns, count, layout))
+  {
+    arena.Rewind(mark);
+    return SparseMatrix{};
+  }
+  result.triplet_positions = triplet_positions;
+  result.triplet_count = count;
+
+  // scratch space for the sort, given back once the matrix is built
+  const size_t scratch_mark{arena.Mark()};
+  const size_t outer_size{result.outerSize()};
+  const size_t inner_size{layout == Layout::CSR ? columns : rows};
+  uint32_t *counts{
+      arena.Allocate<uint32_t>(std::max(outer_size, inner_size) + 1)};
+  uint32_t *by_inner{arena.Allocate<uint32_t>(count)};
+  uint32_t *sorted{arena.Allocate<uint32_t>(count)};
+  if (counts == nullptr || by_inner == nullptr || sorted == nullptr)
+  {
+    arena.Rewind(mark);
+    return SparseMatrix{};
+  }
+
+  auto outerOf = [layout](const Triplet &triplet) -> uint32_t {
+    return layout == Layout::CSR ? triplet.row : triplet.column;
+  };
+  auto innerOf = [layout](const Triplet &triplet) -> uint32_t {
+    return layout == Layout::CSR ? triplet.column : triplet.row;
+  };
+
+  // two stable counting sorts, by inner index and then by outer index, leave
+  // the triplets in storage order in O(count + rows + columns)
+  memset(counts, 0, (inner_size + 1) * sizeof(uint32_t));
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    counts[innerOf(triplets[idx]) + 1]++;
+  }
+  for (size_t idx{0}; idx < inner_size; idx++)
+  {
+    counts[idx + 1] += counts[idx];
+  }
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    by_inner[counts[innerOf(triplets[idx])]++] = idx;
+  }
+
+  memset(counts, 0, (outer_size + 1) * sizeof(uint32_t));
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    counts[outerOf(triplets[idx]) + 1]++;
+  }
+  for (size_t idx{0}; idx < outer_size; idx++)
+  {
+    counts[idx + 1] += counts[idx];
+  }
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    const uint32_t triplet_idx{by_inner[idx]};
+    sorted[counts[outerOf(triplets[triplet_idx])]++] = triplet_idx;
+  }
+
+  // lay out the entries, merging triplets for the same element
+  size_t entry{0};
+  size_t sorted_idx{0};
+  for (size_t outer_idx{0}; outer_idx < outer_size; outer_idx++)
+  {
+    result.outer_starts[outer_idx] = entry;
+    for (; sorted_idx < count &&
+           outerOf(triplets[sorted[sorted_idx]]) == outer_idx;
+         sorted_idx++)
+    {
+      const uint32_t inner_idx{innerOf(triplets[sorted[sorted_idx]])};
+      if (entry == result.outer_starts[outer_idx] ||
+          result.inner_indices[entry - 1] != inner_idx)
+      {
+        result.inner_indices[entry] = inner_idx;
+        entry++;
+      }
+      result.triplet_positions[sorted[sorted_idx]] = entry - 1;
+    }
+  }
+  result.outer_starts[outer_size] = entry;
+  result.non_zeros = entry;
+  arena.Rewind(scratch_mark);
+
+  memset(result.values, 0, entry * sizeof(float));
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    result.values[result.triplet_positions[idx]] += triplets[idx].value;
+  }
+  return result;
+}
+
+SparseMatrix SparseMatrix::FromDense(Arena &arena, const DynMatrix &dense,
+                                     Layout layout)
+{
+  return SparseMatrix::fromDense(arena, dense.Data(), dense.GetRowSize(),
+                                 dense.GetColumnSize(), layout);
+}
+
+SparseMatrix SparseMatrix::fromDense(Arena &arena, const float *dense,
+                                     size_t rows, size_t columns,
+                                     Layout layout)
+{
+  size_t non_zeros{0};
+  for (size_t idx{0}; idx < rows * columns; idx++)
+  {
+    if (dense[idx] != 0)
+    {
+      non_zeros++;
+    }
+  }
+
+  SparseMatrix result{};
+  const size_t mark{arena.Mark()};
+  if (!result.allocate(arena, rows, columns, non_zeros, layout))
+  {
+    arena.Rewind(mark);
+    return SparseMatrix{};
+  }
+
+  const size_t outer_size{result.outerSize()};
+  const size_t inner_size{layout == Layout::CSR ? columns : rows};
+  size_t entry{0};
+  for (size_t outer_idx{0}; outer_idx < outer_size; outer_idx++)
+  {
+    result.outer_starts[outer_idx] = entry;
+    for (size_t inner_idx{0}; inner_idx < inner_size; inner_idx++)
+    {
+      const float value{layout == Layout::CSR
+                            ? dense[outer_idx * columns + inner_idx]
+                            : dense[inner_idx * columns + outer_idx]};
+      if (value != 0)
+      {
+        result.inner_indices[entry] = inner_idx;
+        result.values[entry] = value;
+        entry++;
+      }
+    }
+  }
+  result.outer_starts[outer_size] = entry;
+  return result;
+}
+
+SparseMatrix::SparseMatrix(SparseMatrix &&other)
+{
+  *this = static_cast<SparseMatrix &&>(other);
+}
+
+SparseMatrix &SparseMatrix::operator=(SparseMatrix &&other)
+{
+  if (this != &other)
+  {
+    this->outer_starts = other.outer_starts;
+    this->inner_indices = other.inner_indices;
+    this->values = other.values;
+    this->triplet_positions = other.triplet_positions;
+    this->triplet_count = other.triplet_count;
+    this->non_zeros = other.non_zeros;
+    this->rows = other.rows;
+    this->columns = other.columns;
+    this->layout = other.layout;
+
+    other.outer_starts = nullptr;
+    other.inner_indices = nullptr;
+    other.values = nullptr;
+    other.triplet_positions = nullptr;
+    other.triplet_count = 0;
+    other.non_zeros = 0;
+    other.rows = 0;
+    other.columns = 0;
+  }
+  return *this;
+}
+
+float SparseMatrix::Get(size_t row_index, size_t column_index) const
+{
+  if (!BoundsCheck::Accept(row_index < this->rows &&
+                           column_index < this->columns))
+  {
+    return 1e+10;
+  }
+
+  const size_t outer_idx{this->layout == Layout::CSR ? row_index
+                                                     : column_index};
+  const uint32_t inner_idx{static_cast<uint32_t>(
+      this->layout == Layout::CSR ? column_index : row_index)};
+  const uint32_t *begin{this->inner_indices + this->outer_starts[outer_idx]};
+  const uint32_t *end{this->inner_indices + this->outer_starts[outer_idx + 1]};
+  const uint32_t *found{std::lower_bound(begin, end, inner_idx)};
+  if (found == end || *found != inner_idx)
+  {
+    return 0;
+  }
+  return this->values[found - this->inner_indices];
+}
+
+bool SparseMatrix::SetValues(const float *triplet_values, size_t count)
+{
+  if (this->triplet_positions == nullptr || count != this->triplet_count)
+  {
+    return false;
+  }
+
+  memset(this->values, 0, this->non_zeros * sizeof(float));
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    this->values[this->triplet_positions[idx]] += triplet_values[idx];
+  }
+  return true;
+}
+
+bool SparseMatrix::Mult(const float *vector, float *result) const
+{
+  if (!this->IsValid())
+  {
+    return false;
+  }
+
+  if (this->layout == Layout::CSR)
+  {
+    // one dot product per row
+    for (size_t row_idx{0}; row_idx < this->rows; row_idx++)
+    {
+      float sum{0};
+      for (uint32_t entry{this->outer_starts[row_idx]};
+           entry < this->outer_starts[row_idx + 1]; entry++)
+      {
+        sum += this->values[entry] * vector[this->inner_indices[entry]];
+      }
+      result[row_idx] = sum;
+    }
+    return true;
+  }
+
+  // scatter each column, scaled by its element of vector
+  memset(result, 0, this->rows * sizeof(float));
+  for (size_t column_idx{0}; column_idx < this->columns; column_idx++)
+  {
+    const float scale{vector[column_idx]};
+    for (uint32_t entry{this->outer_starts[column_idx]};
+         entry < this->outer_starts[column_idx + 1]; entry++)
+    {
+      result[this->inner_indices[entry]] += this->values[entry] * scale;
+    }
+  }
+  return true;
+}
+
+bool SparseMatrix::TransposeMult(const float *vector, float *result) const
+{
+  if (!this->IsValid())
+  {
+    return false;
+  }
+
+  // the transpose of CSR is CSC of the same arrays and the other way around,
+  // so this is Mult with the roles of the layouts swapped
+  if (this->layout == Layout::CSC)
+  {
+    for (size_t column_idx{0}; column_idx < this->columns; column_idx++)
+    {
+      float sum{0};
+      for (uint32_t entry{this->outer_starts[column_idx]};
+           entry < this->outer_starts[column_idx + 1]; entry++)
+      {
+        sum += this->values[entry] * vector[this->inner_indices[entry]];
+      }
+      result[column_idx] = sum;
+    }
+    return true;
+  }
+
+  memset(result, 0, this->columns * sizeof(float));
+  for (size_t row_idx{0}; row_idx < this->rows; row_idx++)
+  {
+    const float scale{vector[row_idx]};
+    for (uint32_t entry{this->outer_starts[row_idx]};
+         entry < this->outer_starts[row_idx + 1]; entry++)
+    {
+      result[this->inner_indices[entry]] += this->values[entry] * scale;
+    }
+  }
+  return true;
+}
+
+void SparseMatrix::multiplyDense(const float *dense, size_t dense_columns,
+                                 float *result, size_t result_rows,
+                                 bool transpose) const
+{
+  // every stored entry (row, column, value) adds value * dense row column to
+  // result row row (or value * dense row row to result row column for the
+  // transpose). Both layouts and both products are that same row update,
+  // it's only a question of which index is which.
+  memset(result, 0, result_rows * dense_columns * sizeof(float));
+  const bool outer_is_result{(this->layout == Layout::CSR) != transpose};
+  for (size_t outer_idx{0}; outer_idx < this->outerSize(); outer_idx++)
+  {
+    for (uint32_t entry{this->outer_starts[outer_idx]};
+         entry < this->outer_starts[outer_idx + 1]; entry++)
+    {
+      const size_t inner_idx{this->inner_indices[entry]};
+      const size_t result_idx{outer_is_result ? outer_idx : inner_idx};
+      const size_t dense_idx{outer_is_result ? inner_idx : outer_idx};
+      float *result_row{result + result_idx * dense_columns};
+      const float *dense_row{dense + dense_idx * dense_columns};
+      const float value{this->values[entry]};
+      if (dense_columns < ElementKernels::dispatch_threshold)
+      {
+        for (size_t column_idx{0}; column_idx < dense_columns; column_idx++)
+        {
+          result_row[column_idx] += value * dense_row[column_idx];
+        }
+      }
+      else
+      {
+        ElementKernels::ScaleAdd(dense_row, value, result_row, result_row,
+                                 dense_columns);
+      }
+    }
+  }
+}
+
+bool SparseMatrix::Mult(const DynMatrix &dense, DynMatrix &result) const
+{
+  if (!this->IsValid() || dense.GetRowSize() != this->columns ||
+      result.GetRowSize() != this->rows ||
+      result.GetColumnSize() != dense.GetColumnSize() || &result == &dense)
+  {
+    return false;
+  }
+
+  this->multiplyDense(dense.Data(), dense.GetColumnSize(), result.Data(),
+                      this->rows, false);
+  return true;
+}
+
+bool SparseMatrix::TransposeMult(const DynMatrix &dense,
+                                 DynMatrix &result) const
+{
+  if (!this->IsValid() || dense.GetRowSize() != this->rows ||
+      result.GetRowSize() != this->columns ||
+      result.GetColumnSize() != dense.GetColumnSize() || &result == &dense)
+  {
+    return false;
+  }
+
+  this->multiplyDense(dense.Data(), dense.GetColumnSize(), result.Data(),
+                      this->columns, true);
+  return true;
+}
+
+bool SparseMatrix::ToDense(DynMatrix &dense) const
+{
+  if (!this->IsValid() || dense.GetRowSize() != this->rows ||
+      dense.GetColumnSize() != this->columns)
+  {
+    return false;
+  }
+
+  dense.Fill(0);
+  for (size_t outer_idx{0}; outer_idx < this->outerSize(); outer_idx++)
+  {
+    for (uint32_t entry{this->outer_starts[outer_idx]};
+         entry < this->outer_starts[outer_idx + 1]; entry++)
+    {
+      const size_t inner_idx{this->inner_indices[entry]};
+      const size_t row{this->layout == Layout::CSR ? outer_idx : inner_idx};
+      const size_t column{this->layout == Layout::CSR ? inner_idx : outer_idx};
+      dense[row][column] = this->values[entry];
+    }
+  }
+  return true;
+}
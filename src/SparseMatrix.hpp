@@ -0,0 +1,263 @@
+#ifndef SPARSE_MATRIX_H_
+#define SPARSE_MATRIX_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Arena.hpp"
+#include "DynMatrix.hpp"
+#include "Matrix.hpp"
+
+/**
+ * @brief One entry of a sparse matrix, used to build a SparseMatrix
+ */
+struct Triplet
+{
+  uint32_t row;
+  uint32_t column;
+  float value;
+};
+
+/**
+ * @brief A matrix that only stores its non-zero entries, in compressed sparse
+ * row (CSR) or compressed sparse column (CSC) form. Products with dense
+ * matrices and vectors cost O(non-zeros) instead of O(rows * columns).
+ *
+ * In CSR the outer index is the row: the entries of row r are
+ * InnerIndices()[OuterStarts()[r] .. OuterStarts()[r + 1]) (their columns)
+ * and the matching Values(). CSC is the same with rows and columns swapped.
+ * Inside each row (or column) the entries are sorted.
+ *
+ * The sparsity pattern is fixed when the matrix is built. Matrices built from
+ * triplets remember where every triplet went, so SetValues can refresh all of
+ * the values each cycle in O(non-zeros) without rebuilding the structure.
+ *
+ * Like DynMatrix, all storage comes from an Arena. If the arena runs out (or
+ * a triplet is out of bounds) the matrix is left empty and IsValid returns
+ * false. Every operation returns false and leaves its result untouched if the
+ * sizes don't match.
+ */
+class SparseMatrix
+{
+public:
+  enum class Layout : uint8_t
+  {
+    CSR,
+    CSC
+  };
+
+  /**
+   * @brief Create an empty 0x0 matrix
+   */
+  SparseMatrix() = default;
+
+  /**
+   * @brief Build a matrix from a list of entries. Entries for the same
+   * element are summed.
+   * @param arena where the matrix is stored. Temporary space is used while
+   * building and rewound again.
+   */
+  static SparseMatrix FromTriplets(Arena &arena, size_t rows, size_t columns,
+                                   const Triplet *triplets, size_t count,
+                                   Layout layout = Layout::CSR);
+
+  /**
+   * @brief Build a matrix from the non-zero elements of a dense one
+   * @note matrices built this way can't use SetValues
+   */
+  static SparseMatrix FromDense(Arena &arena, const DynMatrix &dense,
+                                Layout layout = Layout::CSR);
+
+  template <uint8_t fixed_rows, uint8_t fixed_columns>
+  static SparseMatrix FromDense(Arena &arena,
+                                const Matrix<fixed_rows, fixed_columns> &dense,
+                                Layout layout = Layout::CSR);
+
+  // copies would share storage
+  SparseMatrix(const SparseMatrix &) = delete;
+  SparseMatrix &operator=(const SparseMatrix &) = delete;
+
+  /**
+   * @brief Take over other's storage, other is left empty
+   */
+  SparseMatrix(SparseMatrix &&other);
+  SparseMatrix &operator=(SparseMatrix &&other);
+
+  bool IsValid() const { return this->outer_starts != nullptr; }
+
+  size_t GetRowSize() const { return this->rows; }
+  size_t GetColumnSize() const { return this->columns; }
+  Layout GetLayout() const { return this->layout; }
+
+  /**
+   * @return the number of stored entries
+   */
+  size_t NonZeros() const { return this->non_zeros; }
+
+  const uint32_t *OuterStarts() const { return this->outer_starts; }
+  const uint32_t *InnerIndices() const { return this->inner_indices; }
+  float *Values() { return this->values; }
+  const float *Values() const { return this->values; }
+
+  /**
+   * @brief Get an element from the matrix
+   * @return The element (0 if it isn't stored). Out of range indices are
+   * handled by the bounds check policy, by default they return 1e+10, see
+   * BoundsCheck
+   */
+  float Get(size_t row_index, size_t column_index) const;
+
+  /**
+   * @brief Refresh every value without touching the sparsity pattern
+   * @param triplet_values count values in the same order as the triplets the
+   * matrix was built from. Values for the same element are summed.
+   * @return false if count doesn't match or the matrix wasn't built from
+   * triplets
+   */
+  bool SetValues(const float *triplet_values, size_t count);
+
+  /**
+   * @brief Sparse matrix-vector product, result = this * vector
+   * @param vector GetColumnSize() values
+   * @param result GetRowSize() values
+   * @warning result must not overlap vector
+   */
+  bool Mult(const float *vector, float *result) const;
+
+  /**
+   * @brief result = transpose(this) * vector
+   * @param vector GetRowSize() values
+   * @param result GetColumnSize() values
+   * @warning result must not overlap vector
+   */
+  bool TransposeMult(const float *vector, float *result) const;
+
+  /**
+   * @brief Sparse times dense, result = this * dense
+   * @warning result must not be dense, false is returned if it is
+   */
+  bool Mult(const DynMatrix &dense, DynMatrix &result) const;
+
+  /**
+   * @brief result = transpose(this) * dense, without forming the transpose
+   * @warning result must not be dense, false is returned if it is
+   */
+  bool TransposeMult(const DynMatrix &dense, DynMatrix &result) const;
+
+  template <uint8_t dense_rows, uint8_t dense_columns, uint8_t result_rows>
+  bool Mult(const Matrix<dense_rows, dense_columns> &dense,
+            Matrix<result_rows, dense_columns> &result) const;
+
+  template <uint8_t dense_rows, uint8_t dense_columns, uint8_t result_rows>
+  bool TransposeMult(const Matrix<dense_rows, dense_columns> &dense,
+                     Matrix<result_rows, dense_columns> &result) const;
+
+  /**
+   * @brief Write the matrix out densely, zeros included
+   */
+  bool ToDense(DynMatrix &dense) const;
+
+  template <uint8_t fixed_rows, uint8_t fixed_columns>
+  bool ToDense(Matrix<fixed_rows, fixed_columns> &dense) const;
+
+private:
+  static SparseMatrix fromDense(Arena &arena, const float *dense, size_t rows,
+                                size_t columns, Layout layout);
+
+  bool allocate(Arena &arena, size_t rows, size_t columns, size_t non_zeros,
+                Layout layout);
+
+  size_t outerSize() const
+  {
+    return this->layout == Layout::CSR ? this->rows : this->columns;
+  }
+
+  // result (result_rows x dense_columns) = op(this) * dense, where op is the
+  // transpose if transpose is set. Raw row-major arrays so the fixed and
+  // dynamic matrices can share it.
+  void multiplyDense(const float *dense, size_t dense_columns, float *result,
+                     size_t result_rows, bool transpose) const;
+
+  uint32_t *outer_starts{nullptr};
+  uint32_t *inner_indices{nullptr};
+  float *values{nullptr};
+  // where each triplet's value goes, for SetValues
+  uint32_t *triplet_positions{nullptr};
+  size_t triplet_count{0};
+  size_t non_zeros{0};
+  size_t rows{0};
+  size_t columns{0};
+  Layout layout{Layout::CSR};
+};
+
+template <uint8_t fixed_rows, uint8_t fixed_columns>
+SparseMatrix
+SparseMatrix::FromDense(Arena &arena,
+                        const Matrix<fixed_rows, fixed_columns> &dense,
+                        Layout layout)
+{
+  return SparseMatrix::fromDense(arena, dense.matrix.data(), fixed_rows,
+                                 fixed_columns, layout);
+}
+
+template <uint8_t dense_rows, uint8_t dense_columns, uint8_t result_rows>
+bool SparseMatrix::Mult(const Matrix<dense_rows, dense_columns> &dense,
+                        Matrix<result_rows, dense_columns> &result) const
+{
+  if (!this->IsValid() || dense_rows != this->columns ||
+      result_rows != this->rows)
+  {
+    return false;
+  }
+
+  // result may be dense itself, so build the product in a temporary
+  Matrix<result_rows, dense_columns> product{};
+  this->multiplyDense(dense.matrix.data(), dense_columns,
+                      product.matrix.data(), result_rows, false);
+  result = product;
+  return true;
+}
+
+template <uint8_t dense_rows, uint8_t dense_columns, uint8_t result_rows>
+bool SparseMatrix::TransposeMult(
+    const Matrix<dense_rows, dense_columns> &dense,
+    Matrix<result_rows, dense_columns> &result) const
+{
+  if (!this->IsValid() || dense_rows != this->rows ||
+      result_rows != this->columns)
+  {
+    return false;
+  }
+
+  Matrix<result_rows, dense_columns> product{};
+  this->multiplyDense(dense.matrix.data(), dense_columns,
+                      product.matrix.data(), result_rows, true);
+  result = product;
+  return true;
+}
+
+template <uint8_t fixed_rows, uint8_t fixed_columns>
+bool SparseMatrix::ToDense(Matrix<fixed_rows, fixed_columns> &dense) const
+{
+  if (!this->IsValid() || this->rows != fixed_rows ||
+      this->columns != fixed_columns)
+  {
+    return false;
+  }
+
+  dense.Fill(0);
+  for (size_t outer_idx{0}; outer_idx < this->outerSize(); outer_idx++)
+  {
+    for (uint32_t entry{this->outer_starts[outer_idx]};
+         entry < this->outer_starts[outer_idx + 1]; entry++)
+    {
+      const size_t inner_idx{this->inner_indices[entry]};
+      const size_t row{this->layout == Layout::CSR ? outer_idx : inner_idx};
+      const size_t column{this->layout == Layout::CSR ? inner_idx : outer_idx};
+      dense.matrix[row * fixed_columns + column] = this->values[entry];
+    }
+  }
+  return true;
+}
+
+#endif // SPARSE_MATRIX_H_
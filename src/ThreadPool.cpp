@@ -0,0 +1,150 @@
+#include "ThreadPool.hpp"
+
+namespace
+{
+// set on pool threads so a Run from inside a task doesn't wait on itself
+thread_local bool inside_pool{false};
+} // namespace
+
+ThreadPool::ThreadPool(size_t threads)
+{
+  if (threads == 0)
+  {
+    threads = std::thread::hardware_concurrency();
+  }
+  if (threads == 0)
+  {
+    threads = 1;
+  }
+
+  // queue 0 belongs to whoever calls Run
+  for (size_t idx{0}; idx < threads; idx++)
+  {
+    this->queues.push_back(std::unique_ptr<Queue>{new Queue{}});
+  }
+  for (size_t idx{1}; idx < threads; idx++)
+  {
+    this->workers.emplace_back(&ThreadPool::work, this, idx);
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock{this->state_mutex};
+    this->stopping = true;
+  }
+  this->work_ready.notify_all();
+  for (std::thread &worker : this->workers)
+  {
+    worker.join();
+  }
+}
+
+void ThreadPool::Run(size_t task_count,
+                     const std::function<void(size_t)> &task)
+{
+  if (task_count == 0)
+  {
+    return;
+  }
+
+  if (inside_pool || this->workers.empty() || task_count == 1)
+  {
+    for (size_t idx{0}; idx < task_count; idx++)
+    {
+      task(idx);
+    }
+    return;
+  }
+
+  std::lock_guard<std::mutex> run_lock{this->run_mutex};
+  this->job = &task;
+  this->remaining = task_count;
+  for (size_t idx{0}; idx < task_count; idx++)
+  {
+    Queue &queue{*this->queues[idx % this->queues.size()]};
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    queue.tasks.push_back(idx);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock{this->state_mutex};
+    this->generation++;
+  }
+  this->work_ready.notify_all();
+
+  inside_pool = true;
+  this->runTasks(0);
+  inside_pool = false;
+
+  // the last tasks may still be running on other threads
+  std::unique_lock<std::mutex> lock{this->state_mutex};
+  this->work_done.wait(lock, [this]() { return this->remaining == 0; });
+  this->job = nullptr;
+}
+
+void ThreadPool::work(size_t queue_idx)
+{
+  inside_pool = true;
+  uint64_t seen_generation{0};
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock{this->state_mutex};
+      this->work_ready.wait(lock, [this, seen_generation]() {
+        return this->stopping || this->generation != seen_generation;
+      });
+      if (this->stopping)
+      {
+        return;
+      }
+      seen_generation = this->generation;
+    }
+
+    this->runTasks(queue_idx);
+  }
+}
+
+void ThreadPool::runTasks(size_t queue_idx)
+{
+  size_t task_idx{0};
+  while (this->takeTask(queue_idx, task_idx))
+  {
+    (*this->job)(task_idx);
+    if (--this->remaining == 0)
+    {
+      // take the lock so the notification can't slip in between Run checking
+      // remaining and going to sleep
+      std::lock_guard<std::mutex> lock{this->state_mutex};
+      this->work_done.notify_all();
+    }
+  }
+}
+
+bool ThreadPool::takeTask(size_t queue_idx, size_t &task_idx)
+{
+  {
+    Queue &own{*this->queues[queue_idx]};
+    std::lock_guard<std::mutex> lock{own.mutex};
+    if (!own.tasks.empty())
+    {
+      task_idx = own.tasks.front();
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+
+  for (size_t offset{1}; offset < this->queues.size(); offset++)
+  {
+    Queue &victim{*this->queues[(queue_idx + offset) % this->queues.size()]};
+    std::lock_guard<std::mutex> lock{victim.mutex};
+    if (!victim.tasks.empty())
+    {
+      task_idx = victim.tasks.back();
+      victim.tasks.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
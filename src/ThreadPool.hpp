@@ -0,0 +1,85 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A small work-stealing thread pool for splitting one big operation
+ * into independent tasks.
+ *
+ * Run hands out the tasks round robin to one queue per thread. Each thread
+ * works through its own queue from the front and steals from the back of the
+ * others once it runs dry, so uneven tasks still balance out. The thread that
+ * calls Run works on the tasks too.
+ *
+ * @note only built when MATRIX_THREADS is defined, see Parallel.hpp
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @param threads the number of threads working on each Run, including the
+   * one that calls Run. 0 picks one per hardware thread.
+   */
+  explicit ThreadPool(size_t threads = 0);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @return the number of threads working on each Run, including the caller
+   */
+  size_t Size() const { return this->queues.size(); }
+
+  /**
+   * @brief Call task(idx) for every idx in [0, task_count) and wait for all
+   * of them to finish
+   * @note tasks have to be independent of each other, they run in no
+   * particular order
+   * @note Run is safe to call from several threads (the calls take turns), and
+   * from inside a task, where it runs the tasks on the calling thread
+   */
+  void Run(size_t task_count, const std::function<void(size_t)> &task);
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  void work(size_t queue_idx);
+
+  // take a task from our own queue, or steal one from another
+  bool takeTask(size_t queue_idx, size_t &task_idx);
+
+  void runTasks(size_t queue_idx);
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  // only one Run at a time
+  std::mutex run_mutex;
+
+  std::mutex state_mutex;
+  std::condition_variable work_ready;
+  std::condition_variable work_done;
+  uint64_t generation{0};
+  bool stopping{false};
+
+  const std::function<void(size_t)> *job{nullptr};
+  std::atomic<size_t> remaining{0};
+};
+
+#endif // THREAD_POOL_H_
@@ -0,0 +1,421 @@
+#ifdef V3D_BATCH_H_ // since the .cpp file has to be included by the .hpp file
+                    // this will evaluate to true
+#include "V3DBatch.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+
+#include "ElementKernels.hpp"
+
+template <typename Type>
+V3DBatch<Type>::V3DBatch(Arena &arena, size_t size)
+{
+    static_assert(std::is_arithmetic<Type>::value, "Type must be a number");
+    static_assert(V3DBatch<Type>::alignment % sizeof(Type) == 0,
+                  "Type must fit evenly into the alignment");
+
+    // pad every component up to a whole number of aligned blocks so each one
+    // starts on an aligned address
+    constexpr size_t lanes{V3DBatch<Type>::alignment / sizeof(Type)};
+    const size_t padded_size{(size + lanes - 1) / lanes * lanes};
+
+    Type *storage{static_cast<Type *>(arena.Allocate(
+        3 * padded_size * sizeof(Type), V3DBatch<Type>::alignment))};
+    if (storage == nullptr)
+    {
+        return;
+    }
+
+    std::fill(storage, storage + 3 * padded_size, Type{0});
+    this->x = storage;
+    this->y = storage + padded_size;
+    this->z = storage + 2 * padded_size;
+    this->size = size;
+}
+
+template <typename Type>
+V3DBatch<Type>::V3DBatch(Arena &arena, const V3D<Type> *points, size_t size)
+    : V3DBatch(arena, size)
+{
+    this->Load(points);
+}
+
+template <typename Type>
+V3DBatch<Type>::V3DBatch(Type *x, Type *y, Type *z, size_t size)
+    : x(x), y(y), z(z), size(size)
+{
+}
+
+template <typename Type>
+V3DBatch<Type> V3DBatch<Type>::View(Type *x, Type *y, Type *z, size_t size)
+{
+    if (x == nullptr || y == nullptr || z == nullptr)
+    {
+        return V3DBatch<Type>{};
+    }
+    return V3DBatch<Type>{x, y, z, size};
+}
+
+template <typename Type>
+V3DBatch<Type>::V3DBatch(V3DBatch<Type> &&other)
+    : x(other.x), y(other.y), z(other.z), size(other.size)
+{
+    other.x = nullptr;
+    other.y = nullptr;
+    other.z = nullptr;
+    other.size = 0;
+}
+
+template <typename Type>
+V3DBatch<Type> &V3DBatch<Type>::operator=(V3DBatch<Type> &&other)
+{
+    if (this != &other)
+    {
+        this->x = other.x;
+        this->y = other.y;
+        this->z = other.z;
+        this->size = other.size;
+        other.x = nullptr;
+        other.y = nullptr;
+        other.z = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::CopyFrom(const V3DBatch<Type> &other)
+{
+    if (other.size != this->size)
+    {
+        return false;
+    }
+
+    if (this->x != other.x)
+    {
+        std::copy(other.x, other.x + other.size, this->x);
+        std::copy(other.y, other.y + other.size, this->y);
+        std::copy(other.z, other.z + other.size, this->z);
+    }
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::overlaps(const V3DBatch<Type> &a, const V3DBatch<Type> &b)
+{
+    // std::less gives a total order even across unrelated arrays, where the
+    // built in < doesn't have to
+    const std::less<const Type *> before{};
+    const Type *a_arrays[3]{a.x, a.y, a.z};
+    const Type *b_arrays[3]{b.x, b.y, b.z};
+    for (const Type *a_start : a_arrays)
+    {
+        for (const Type *b_start : b_arrays)
+        {
+            if (before(a_start, b_start + b.size) &&
+                before(b_start, a_start + a.size))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Type>
+V3D<Type> V3DBatch<Type>::Get(size_t idx) const
+{
+    BoundsCheck::Assert(idx < this->size);
+    return V3D<Type>{this->x[idx], this->y[idx], this->z[idx]};
+}
+
+template <typename Type>
+void V3DBatch<Type>::Set(size_t idx, const V3D<Type> &vector)
+{
+    BoundsCheck::Assert(idx < this->size);
+    this->x[idx] = vector.x;
+    this->y[idx] = vector.y;
+    this->z[idx] = vector.z;
+}
+
+template <typename Type>
+void V3DBatch<Type>::Load(const V3D<Type> *points)
+{
+    for (size_t idx{0}; idx < this->size; idx++)
+    {
+        this->x[idx] = points[idx].x;
+        this->y[idx] = points[idx].y;
+        this->z[idx] = points[idx].z;
+    }
+}
+
+template <typename Type>
+void V3DBatch<Type>::Store(V3D<Type> *points) const
+{
+    for (size_t idx{0}; idx < this->size; idx++)
+    {
+        points[idx].x = this->x[idx];
+        points[idx].y = this->y[idx];
+        points[idx].z = this->z[idx];
+    }
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Add(const V3DBatch<Type> &other,
+                         V3DBatch<Type> &result) const
+{
+    if (other.size != this->size || result.size != this->size)
+    {
+        return false;
+    }
+
+    ElementKernels::Add(this->x, other.x, result.x, this->size);
+    ElementKernels::Add(this->y, other.y, result.y, this->size);
+    ElementKernels::Add(this->z, other.z, result.z, this->size);
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Add(const V3D<Type> &offset,
+                         V3DBatch<Type> &result) const
+{
+    if (result.size != this->size)
+    {
+        return false;
+    }
+
+    // the kernels only add whole arrays, so add a chunk sized array of the
+    // offset over and over
+    Type offset_x[V3DBatch<Type>::chunk_size];
+    Type offset_y[V3DBatch<Type>::chunk_size];
+    Type offset_z[V3DBatch<Type>::chunk_size];
+    const size_t first_chunk{std::min(this->size, V3DBatch<Type>::chunk_size)};
+    ElementKernels::Fill(offset_x, offset.x, first_chunk);
+    ElementKernels::Fill(offset_y, offset.y, first_chunk);
+    ElementKernels::Fill(offset_z, offset.z, first_chunk);
+
+    for (size_t start{0}; start < this->size;
+         start += V3DBatch<Type>::chunk_size)
+    {
+        const size_t count{
+            std::min(V3DBatch<Type>::chunk_size, this->size - start)};
+        ElementKernels::Add(this->x + start, offset_x, result.x + start, count);
+        ElementKernels::Add(this->y + start, offset_y, result.y + start, count);
+        ElementKernels::Add(this->z + start, offset_z, result.z + start, count);
+    }
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Sub(const V3DBatch<Type> &other,
+                         V3DBatch<Type> &result) const
+{
+    if (other.size != this->size || result.size != this->size)
+    {
+        return false;
+    }
+
+    ElementKernels::Sub(this->x, other.x, result.x, this->size);
+    ElementKernels::Sub(this->y, other.y, result.y, this->size);
+    ElementKernels::Sub(this->z, other.z, result.z, this->size);
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Scale(Type scalar, V3DBatch<Type> &result) const
+{
+    if (result.size != this->size)
+    {
+        return false;
+    }
+
+    ElementKernels::Scale(this->x, scalar, result.x, this->size);
+    ElementKernels::Scale(this->y, scalar, result.y, this->size);
+    ElementKernels::Scale(this->z, scalar, result.z, this->size);
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Dot(const V3DBatch<Type> &other, Type *result) const
+{
+    if (other.size != this->size)
+    {
+        return false;
+    }
+
+    for (size_t start{0}; start < this->size;
+         start += V3DBatch<Type>::chunk_size)
+    {
+        const size_t count{
+            std::min(V3DBatch<Type>::chunk_size, this->size - start)};
+        Type *dot{result + start};
+        ElementKernels::Multiply(this->x + start, other.x + start, dot, count);
+        ElementKernels::MultiplyAdd(this->y + start, other.y + start, dot, dot,
+                                    count);
+        ElementKernels::MultiplyAdd(this->z + start, other.z + start, dot, dot,
+                                    count);
+    }
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Cross(const V3DBatch<Type> &other,
+                           V3DBatch<Type> &result) const
+{
+    if (other.size != this->size || result.size != this->size)
+    {
+        return false;
+    }
+
+    // every output component reads two input components, so if result is an
+    // input each chunk is built in scratch first and copied over at the end
+    const bool aliased{V3DBatch<Type>::overlaps(result, *this) ||
+                       V3DBatch<Type>::overlaps(result, other)};
+    Type scratch_x[V3DBatch<Type>::chunk_size];
+    Type scratch_y[V3DBatch<Type>::chunk_size];
+    Type scratch_z[V3DBatch<Type>::chunk_size];
+
+    for (size_t start{0}; start < this->size;
+         start += V3DBatch<Type>::chunk_size)
+    {
+        const size_t count{
+            std::min(V3DBatch<Type>::chunk_size, this->size - start)};
+        const Type *ax{this->x + start};
+        const Type *ay{this->y + start};
+        const Type *az{this->z + start};
+        const Type *bx{other.x + start};
+        const Type *by{other.y + start};
+        const Type *bz{other.z + start};
+        Type *cross_x{aliased ? scratch_x : result.x + start};
+        Type *cross_y{aliased ? scratch_y : result.y + start};
+        Type *cross_z{aliased ? scratch_z : result.z + start};
+
+        ElementKernels::Multiply(az, by, cross_x, count);
+        ElementKernels::MultiplySub(ay, bz, cross_x, cross_x, count);
+        ElementKernels::Multiply(ax, bz, cross_y, count);
+        ElementKernels::MultiplySub(az, bx, cross_y, cross_y, count);
+        ElementKernels::Multiply(ay, bx, cross_z, count);
+        ElementKernels::MultiplySub(ax, by, cross_z, cross_z, count);
+
+        if (aliased)
+        {
+            std::copy(scratch_x, scratch_x + count, result.x + start);
+            std::copy(scratch_y, scratch_y + count, result.y + start);
+            std::copy(scratch_z, scratch_z + count, result.z + start);
+        }
+    }
+    return true;
+}
+
+template <typename Type>
+void V3DBatch<Type>::SquaredNorm(Type *result) const
+{
+    for (size_t start{0}; start < this->size;
+         start += V3DBatch<Type>::chunk_size)
+    {
+        const size_t count{
+            std::min(V3DBatch<Type>::chunk_size, this->size - start)};
+        Type *squared{result + start};
+        ElementKernels::Multiply(this->x + start, this->x + start, squared,
+                                 count);
+        ElementKernels::MultiplyAdd(this->y + start, this->y + start, squared,
+                                    squared, count);
+        ElementKernels::MultiplyAdd(this->z + start, this->z + start, squared,
+                                    squared, count);
+    }
+}
+
+template <typename Type>
+void V3DBatch<Type>::Norm(Type *result) const
+{
+    this->SquaredNorm(result);
+    ElementKernels::Sqrt(result, result, this->size);
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Normalize(V3DBatch<Type> &result) const
+{
+    if (result.size != this->size)
+    {
+        return false;
+    }
+
+    Type norms[V3DBatch<Type>::chunk_size];
+    for (size_t start{0}; start < this->size;
+         start += V3DBatch<Type>::chunk_size)
+    {
+        const size_t count{
+            std::min(V3DBatch<Type>::chunk_size, this->size - start)};
+        V3DBatch<Type> chunk{V3DBatch<Type>::View(
+            this->x + start, this->y + start, this->z + start, count)};
+        chunk.Norm(norms);
+
+        // dividing a zero vector by 1 keeps it at zero instead of NaN
+        for (size_t idx{0}; idx < count; idx++)
+        {
+            if (norms[idx] == 0)
+            {
+                norms[idx] = 1;
+            }
+        }
+
+        ElementKernels::Divide(this->x + start, norms, result.x + start, count);
+        ElementKernels::Divide(this->y + start, norms, result.y + start, count);
+        ElementKernels::Divide(this->z + start, norms, result.z + start, count);
+    }
+    return true;
+}
+
+template <typename Type>
+bool V3DBatch<Type>::Transform(const Matrix<3, 3, Type> &rotation,
+                               const V3D<Type> &translation,
+                               V3DBatch<Type> &result) const
+{
+    if (result.size != this->size)
+    {
+        return false;
+    }
+
+    const bool aliased{V3DBatch<Type>::overlaps(result, *this)};
+    Type scratch[3][V3DBatch<Type>::chunk_size];
+    const Type offsets[3]{translation.x, translation.y, translation.z};
+    Type *outputs[3]{result.x, result.y, result.z};
+
+    for (size_t start{0}; start < this->size;
+         start += V3DBatch<Type>::chunk_size)
+    {
+        const size_t count{
+            std::min(V3DBatch<Type>::chunk_size, this->size - start)};
+
+        // each output component is one row of the rotation dotted with the
+        // input, accumulated on top of the translation
+        for (uint8_t row_idx{0}; row_idx < 3; row_idx++)
+        {
+            Type *output{aliased ? scratch[row_idx]
+                                 : outputs[row_idx] + start};
+            ElementKernels::Fill(output, offsets[row_idx], count);
+            ElementKernels::ScaleAdd(this->x + start,
+                                     rotation.Element(row_idx * 3), output,
+                                     output, count);
+            ElementKernels::ScaleAdd(this->y + start,
+                                     rotation.Element(row_idx * 3 + 1), output,
+                                     output, count);
+            ElementKernels::ScaleAdd(this->z + start,
+                                     rotation.Element(row_idx * 3 + 2), output,
+                                     output, count);
+        }
+
+        if (aliased)
+        {
+            for (uint8_t row_idx{0}; row_idx < 3; row_idx++)
+            {
+                std::copy(scratch[row_idx], scratch[row_idx] + count,
+                          outputs[row_idx] + start);
+            }
+        }
+    }
+    return true;
+}
+
+#endif // V3D_BATCH_H_
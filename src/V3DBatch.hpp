@@ -0,0 +1,193 @@
+#ifndef V3D_BATCH_H_
+#define V3D_BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Arena.hpp"
+#include "Matrix.hpp"
+#include "Vector3D.hpp"
+
+/**
+ * @brief Many 3D vectors stored as a structure of arrays: all the x values,
+ * then all the y values, then all the z values. Every operation works on whole
+ * arrays at a time through the vectorized element kernels, which is far faster
+ * than looping over V3D for things like point clouds.
+ *
+ * A batch never allocates on its own. Its storage comes from an Arena, where
+ * each component array is aligned to V3DBatch::alignment and padded up to a
+ * multiple of it, or from component arrays the caller wraps with View. If the
+ * arena runs out the batch is left empty and IsValid returns false.
+ *
+ * Every operation writing into a result batch returns false and leaves it
+ * untouched if the batch sizes don't match.
+ */
+template <typename Type>
+class V3DBatch
+{
+public:
+    /**
+     * @brief Alignment in bytes of every component array allocated from an
+     * arena
+     */
+    static constexpr size_t alignment{64};
+
+    /**
+     * @brief Create an empty batch
+     */
+    V3DBatch() = default;
+
+    /**
+     * @brief Allocate a batch of size zero vectors from arena
+     */
+    V3DBatch(Arena &arena, size_t size);
+
+    /**
+     * @brief Allocate a batch holding a copy of an array of vectors from arena
+     */
+    V3DBatch(Arena &arena, const V3D<Type> *points, size_t size);
+
+    /**
+     * @brief Wrap existing component arrays without copying them
+     * @note the arrays have to outlive the view
+     */
+    static V3DBatch<Type> View(Type *x, Type *y, Type *z, size_t size);
+
+    // copies would share storage, use CopyFrom to copy the vectors
+    V3DBatch(const V3DBatch<Type> &) = delete;
+    V3DBatch<Type> &operator=(const V3DBatch<Type> &) = delete;
+
+    /**
+     * @brief Take over other's storage, other is left empty
+     */
+    V3DBatch(V3DBatch<Type> &&other);
+    V3DBatch<Type> &operator=(V3DBatch<Type> &&other);
+
+    /**
+     * @return false if the arena ran out while creating this batch
+     */
+    bool IsValid() const { return this->x != nullptr; }
+
+    /**
+     * @brief Copy the vectors of other into this batch
+     */
+    bool CopyFrom(const V3DBatch<Type> &other);
+
+    /**
+     * @return the number of vectors in the batch
+     */
+    size_t Size() const { return this->size; }
+
+    Type *X() { return this->x; }
+    Type *Y() { return this->y; }
+    Type *Z() { return this->z; }
+    const Type *X() const { return this->x; }
+    const Type *Y() const { return this->y; }
+    const Type *Z() const { return this->z; }
+
+    /**
+     * @brief Get one vector out of the batch
+     * @note idx is only checked when the bounds check policy traps, see
+     * BoundsCheck
+     */
+    V3D<Type> Get(size_t idx) const;
+
+    /**
+     * @brief Overwrite one vector in the batch
+     * @note idx is only checked when the bounds check policy traps, see
+     * BoundsCheck
+     */
+    void Set(size_t idx, const V3D<Type> &vector);
+
+    /**
+     * @brief Copy Size() vectors from an array of V3D into the batch
+     */
+    void Load(const V3D<Type> *points);
+
+    /**
+     * @brief Copy the batch out into an array of at least Size() V3D
+     */
+    void Store(V3D<Type> *points) const;
+
+    /**
+     * @brief result[i] = this[i] + other[i]
+     * @note there is no problem if result == this or result == other
+     */
+    bool Add(const V3DBatch<Type> &other, V3DBatch<Type> &result) const;
+
+    /**
+     * @brief result[i] = this[i] + offset
+     * @note there is no problem if result == this
+     */
+    bool Add(const V3D<Type> &offset, V3DBatch<Type> &result) const;
+
+    /**
+     * @brief result[i] = this[i] - other[i]
+     * @note there is no problem if result == this or result == other
+     */
+    bool Sub(const V3DBatch<Type> &other, V3DBatch<Type> &result) const;
+
+    /**
+     * @brief result[i] = this[i] * scalar
+     * @note there is no problem if result == this
+     */
+    bool Scale(Type scalar, V3DBatch<Type> &result) const;
+
+    /**
+     * @brief result[i] = dot product of this[i] and other[i]
+     * @param result an array of at least Size() elements
+     */
+    bool Dot(const V3DBatch<Type> &other, Type *result) const;
+
+    /**
+     * @brief result[i] = cross product of this[i] and other[i]
+     * @note there is no problem if result shares its arrays with this or
+     * other
+     */
+    bool Cross(const V3DBatch<Type> &other, V3DBatch<Type> &result) const;
+
+    /**
+     * @brief result[i] = squared length of this[i]
+     * @param result an array of at least Size() elements
+     */
+    void SquaredNorm(Type *result) const;
+
+    /**
+     * @brief result[i] = length of this[i]
+     * @param result an array of at least Size() elements
+     */
+    void Norm(Type *result) const;
+
+    /**
+     * @brief Scale every vector to unit length. Zero vectors stay zero.
+     * @note there is no problem if result == this
+     */
+    bool Normalize(V3DBatch<Type> &result) const;
+
+    /**
+     * @brief result[i] = rotation * this[i] + translation
+     * @note there is no problem if result shares its arrays with this
+     */
+    bool Transform(const Matrix<3, 3, Type> &rotation,
+                   const V3D<Type> &translation,
+                   V3DBatch<Type> &result) const;
+
+private:
+    // the operations that need scratch space work through the batch this many
+    // vectors at a time so the scratch stays in L1
+    static constexpr size_t chunk_size{256};
+
+    V3DBatch(Type *x, Type *y, Type *z, size_t size);
+
+    // true if any component array of a overlaps any component array of b
+    static bool overlaps(const V3DBatch<Type> &a, const V3DBatch<Type> &b);
+
+    Type *x{nullptr};
+    Type *y{nullptr};
+    Type *z{nullptr};
+    size_t size{0};
+};
+
+#include "V3DBatch.cpp"
+
+#endif // V3D_BATCH_H_
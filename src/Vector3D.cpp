@@ -1,133 +1,133 @@
 #ifdef VECTOR3D_H_ // since the .cpp file has to be included by the .hpp file this
                    // will evaluate to true
-#include <cmath>
 #include <type_traits>
 #include <string>
 
 template <typename Type>
-V3D<Type>::V3D(const Matrix<1, 3> &other)
+constexpr V3D<Type>::V3D(const Matrix<1, 3> &other) : x(other.Element(0)),
+                                                      y(other.Element(1)),
+                                                      z(other.Element(2))
 {
-    this->x = other.Get(0, 0);
-    this->y = other.Get(0, 1);
-    this->z = other.Get(0, 2);
 }
 
 template <typename Type>
-V3D<Type>::V3D(const Matrix<3, 1> &other)
+constexpr V3D<Type>::V3D(const Matrix<3, 1> &other) : x(other.Element(0)),
+                                                      y(other.Element(1)),
+                                                      z(other.Element(2))
 {
-    this->x = other.Get(0, 0);
-    this->y = other.Get(1, 0);
-    this->z = other.Get(2, 0);
 }
 
 template <typename Type>
-V3D<Type>::V3D(const V3D &other) : x(other.x),
-                                   y(other.y),
-                                   z(other.z)
+constexpr V3D<Type>::V3D(Type x, Type y, Type z) : x(x),
+                                                   y(y),
+                                                   z(z)
 {
-    static_assert(std::is_arithmetic<Type>::value, "Type must be a number");
-}
-
-template <typename Type>
-V3D<Type>::V3D(Type x, Type y, Type z) : x(x),
-                                         y(y),
-                                         z(z)
-{
-    static_assert(std::is_arithmetic<Type>::value, "Type must be a number");
+    static_assert(ScalarTraits<Type>::is_number, "Type must be a number");
 }
 
 template <typename Type>
 template <typename OtherType>
-V3D<Type>::V3D(const V3D<OtherType> &other)
+constexpr V3D<Type>::V3D(const V3D<OtherType> &other)
+    : x(static_cast<Type>(other.x)),
+      y(static_cast<Type>(other.y)),
+      z(static_cast<Type>(other.z))
 {
-    static_assert(std::is_arithmetic<Type>::value, "Type must be a number");
-    static_assert(std::is_arithmetic<OtherType>::value, "OtherType must be a number");
-    this->x = static_cast<Type>(other.x);
-    this->y = static_cast<Type>(other.y);
-    this->z = static_cast<Type>(other.z);
+    static_assert(ScalarTraits<Type>::is_number, "Type must be a number");
+    static_assert(ScalarTraits<OtherType>::is_number, "OtherType must be a number");
 }
 
 template <typename Type>
-std::array<Type, 3> V3D<Type>::ToArray() const
+constexpr std::array<Type, 3> V3D<Type>::ToArray() const
 {
     return {this->x, this->y, this->z};
 }
 
 template <typename Type>
-void V3D<Type>::operator=(const V3D<Type> &other)
-{
-    this->x = other.x;
-    this->y = other.y;
-    this->z = other.z;
-}
-
-template <typename Type>
-V3D<Type> V3D<Type>::operator+(Type other) const
+constexpr V3D<Type> V3D<Type>::operator+(Type other) const
 {
+    MATRIX_PERF_SCOPE(V3DAdd, *this + other);
     return V3D<Type>{this->x + other, this->y + other, this->z + other};
 }
 
 template <typename Type>
-V3D<Type> V3D<Type>::operator+(const V3D<Type> &other) const
+constexpr V3D<Type> V3D<Type>::operator+(const V3D<Type> &other) const
 {
+    MATRIX_PERF_SCOPE(V3DAdd, *this + other);
     return V3D<Type>{this->x + other.x, this->y + other.y, this->z + other.z};
 }
 
 template <typename Type>
-V3D<Type> V3D<Type>::operator-(Type other) const
+constexpr V3D<Type> V3D<Type>::operator-(Type other) const
 {
+    MATRIX_PERF_SCOPE(V3DSub, *this - other);
     return V3D<Type>{this->x - other, this->y - other, this->z - other};
 }
 
 template <typename Type>
-V3D<Type> V3D<Type>::operator-(const V3D<Type> &other) const
+constexpr V3D<Type> V3D<Type>::operator-(const V3D<Type> &other) const
 {
+    MATRIX_PERF_SCOPE(V3DSub, *this - other);
     return V3D<Type>{this->x - other.x, this->y - other.y, this->z - other.z};
 }
 
 template <typename Type>
-V3D<Type> V3D<Type>::operator*(Type scalar) const
+constexpr V3D<Type> V3D<Type>::operator*(Type scalar) const
 {
+    MATRIX_PERF_SCOPE(V3DScale, *this * scalar);
     return V3D<Type>{this->x * scalar, this->y * scalar, this->z * scalar};
 }
 
 template <typename Type>
-V3D<Type> V3D<Type>::operator/(Type scalar) const
+constexpr V3D<Type> V3D<Type>::operator/(Type scalar) const
 {
+    MATRIX_PERF_SCOPE(V3DScale, *this / scalar);
     return V3D<Type>{this->x / scalar, this->y / scalar, this->z / scalar};
 }
 
 template <typename Type>
-V3D<Type> &V3D<Type>::operator+=(Type other)
+constexpr V3D<Type> &V3D<Type>::operator+=(Type other)
 {
-    *this = *this + other;
+    MATRIX_PERF_SCOPE(V3DAdd, *this += other);
+    this->x += other;
+    this->y += other;
+    this->z += other;
     return *this;
 }
 
 template <typename Type>
-V3D<Type> &V3D<Type>::operator+=(const V3D<Type> &other)
+constexpr V3D<Type> &V3D<Type>::operator+=(const V3D<Type> &other)
 {
-    *this = *this + other;
+    MATRIX_PERF_SCOPE(V3DAdd, *this += other);
+    this->x += other.x;
+    this->y += other.y;
+    this->z += other.z;
     return *this;
 }
 
 template <typename Type>
-V3D<Type> &V3D<Type>::operator-=(Type other)
+constexpr V3D<Type> &V3D<Type>::operator-=(Type other)
 {
-    *this = *this - other;
+    MATRIX_PERF_SCOPE(V3DSub, *this -= other);
+    this->x -= other;
+    this->y -= other;
+    this->z -= other;
     return *this;
 }
 
 template <typename Type>
-V3D<Type> &V3D<Type>::operator-=(const V3D<Type> &other)
+constexpr V3D<Type> &V3D<Type>::operator-=(const V3D<Type> &other)
 {
-    *this = *this - other;
+    MATRIX_PERF_SCOPE(V3DSub, *this -= other);
+    this->x -= other.x;
+    this->y -= other.y;
+    this->z -= other.z;
     return *this;
 }
 
 template <typename Type>
-V3D<Type> &V3D<Type>::operator/=(Type scalar)
+constexpr V3D<Type> &V3D<Type>::operator/=(Type scalar)
 {
+    MATRIX_PERF_SCOPE(V3DScale, *this /= scalar);
     if (scalar == 0)
     {
         return *this;
@@ -139,8 +139,9 @@ V3D<Type> &V3D<Type>::operator/=(Type scalar)
 }
 
 template <typename Type>
-V3D<Type> &V3D<Type>::operator*=(Type scalar)
+constexpr V3D<Type> &V3D<Type>::operator*=(Type scalar)
 {
+    MATRIX_PERF_SCOPE(V3DScale, *this *= scalar);
     this->x *= scalar;
     this->y *= scalar;
     this->z *= scalar;
@@ -148,15 +149,16 @@ V3D<Type> &V3D<Type>::operator*=(Type scalar)
 }
 
 template <typename Type>
-bool V3D<Type>::operator==(const V3D<Type> &other)
+constexpr bool V3D<Type>::operator==(const V3D<Type> &other) const
 {
     return this->x == other.x && this->y == other.y && this->z == other.z;
 }
 
 template <typename Type>
-float V3D<Type>::magnitude()
+constexpr float V3D<Type>::magnitude() const
 {
-    return std::sqrt(static_cast<float>(this->x * this->x + this->y * this->y + this->z * this->z));
+    MATRIX_PERF_SCOPE(V3DMagnitude, this->magnitude());
+    return ConstexprMath::Sqrt(static_cast<float>(this->x * this->x + this->y * this->y + this->z * this->z));
 }
 
 #endif // VECTOR3D_H_
\ No newline at end of file
@@ -4,50 +4,54 @@
 #include <cstdint>
 #include "Matrix.hpp"
 
+/**
+ * @note everything except the conversion operator can be used in constant
+ * expressions
+ */
 template <typename Type>
 class V3D
 {
 public:
-    V3D(const Matrix<1, 3> &other);
-    V3D(const Matrix<3, 1> &other);
+    constexpr V3D(const Matrix<1, 3> &other);
+    constexpr V3D(const Matrix<3, 1> &other);
 
-    V3D(const V3D &other);
+    constexpr V3D(const V3D &other) = default;
 
-    V3D(Type x = 0, Type y = 0, Type z = 0);
+    constexpr V3D(Type x = 0, Type y = 0, Type z = 0);
 
     template <typename OtherType>
-    V3D(const V3D<OtherType> &other);
+    constexpr V3D(const V3D<OtherType> &other);
 
     template <typename OtherType>
     operator OtherType() const;
 
-    std::array<Type, 3> ToArray() const;
+    constexpr std::array<Type, 3> ToArray() const;
 
-    V3D<Type> operator+(Type other) const;
-    V3D<Type> operator+(const V3D<Type> &other) const;
+    constexpr V3D<Type> operator+(Type other) const;
+    constexpr V3D<Type> operator+(const V3D<Type> &other) const;
 
-    V3D<Type> operator-(Type other) const;
-    V3D<Type> operator-(const V3D<Type> &other) const;
+    constexpr V3D<Type> operator-(Type other) const;
+    constexpr V3D<Type> operator-(const V3D<Type> &other) const;
 
-    V3D<Type> operator*(Type scalar) const;
+    constexpr V3D<Type> operator*(Type scalar) const;
 
-    V3D<Type> operator/(Type scalar) const;
+    constexpr V3D<Type> operator/(Type scalar) const;
 
-    void operator=(const V3D<Type> &other);
+    constexpr V3D<Type> &operator=(const V3D<Type> &other) = default;
 
-    V3D<Type> &operator+=(Type other);
-    V3D<Type> &operator+=(const V3D<Type> &other);
+    constexpr V3D<Type> &operator+=(Type other);
+    constexpr V3D<Type> &operator+=(const V3D<Type> &other);
 
-    V3D<Type> &operator-=(Type other);
-    V3D<Type> &operator-=(const V3D<Type> &other);
+    constexpr V3D<Type> &operator-=(Type other);
+    constexpr V3D<Type> &operator-=(const V3D<Type> &other);
 
-    V3D<Type> &operator/=(Type scalar);
+    constexpr V3D<Type> &operator/=(Type scalar);
 
-    V3D<Type> &operator*=(Type scalar);
+    constexpr V3D<Type> &operator*=(Type scalar);
 
-    bool operator==(const V3D<Type> &other);
+    constexpr bool operator==(const V3D<Type> &other) const;
 
-    float magnitude();
+    constexpr float magnitude() const;
 
     Type x;
     Type y;
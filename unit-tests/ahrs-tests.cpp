@@ -0,0 +1,317 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Ahrs.hpp"
+
+// any other libraries
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+void requireNear(const V3D<float> &actual, const V3D<float> &expected, float margin = 1e-5f)
+{
+    REQUIRE_THAT(actual.x, Catch::Matchers::WithinAbs(expected.x, margin));
+    REQUIRE_THAT(actual.y, Catch::Matchers::WithinAbs(expected.y, margin));
+    REQUIRE_THAT(actual.z, Catch::Matchers::WithinAbs(expected.z, margin));
+}
+
+// q and -q are the same rotation
+void requireSameRotation(const Quaternion &actual, const Quaternion &expected, float margin = 1e-5f)
+{
+    float dot = 0;
+    for (uint8_t idx = 0; idx < 4; idx++)
+    {
+        dot += actual[idx] * expected[idx];
+    }
+    REQUIRE_THAT(std::abs(dot), Catch::Matchers::WithinAbs(1, margin));
+}
+
+void requireEqual(const Quaternion &actual, const Quaternion &expected)
+{
+    for (uint8_t idx = 0; idx < 4; idx++)
+    {
+        REQUIRE(actual[idx] == expected[idx]);
+    }
+}
+
+float squaredNorm(const Quaternion &q)
+{
+    return q.w() * q.w() + q.v1() * q.v1() + q.v2() * q.v2() + q.v3() * q.v3();
+}
+
+// what the sensors read while held still at orientation
+const V3D<float> up{0, 0, 1};
+const V3D<float> earth_field{0.4f, 0, -0.9f};
+
+V3D<float> accelAt(const Quaternion &orientation)
+{
+    return orientation.Conjugate().Rotate(up);
+}
+
+V3D<float> magAt(const Quaternion &orientation)
+{
+    return orientation.Conjugate().Rotate(earth_field);
+}
+
+// compile time integration
+constexpr Quaternion turned{Quaternion{1, 0, 0, 0}.Integrate(V3D<float>{0, 0, 2}, 0.5f)};
+static_assert(ConstexprMath::Abs(turned.w() - 0.877582562f) < 1e-5f, "");
+static_assert(ConstexprMath::Abs(turned.v3() - 0.479425539f) < 1e-5f, "");
+
+TEST_CASE("Quaternion Integrate", "Quaternion")
+{
+    const Matrix<1, 3> axis{1, -2, 0.5f};
+    const float length = std::sqrt(1 + 4 + 0.25f);
+    const float rate = 1.5f;
+    const V3D<float> angular_velocity{rate / length, -2 * rate / length, 0.5f * rate / length};
+
+    SECTION("Small Steps")
+    {
+        // a constant rate integrates to the rotation about that axis
+        Quaternion q{1, 0, 0, 0};
+        for (int idx = 0; idx < 1000; idx++)
+        {
+            q.Integrate(angular_velocity, 0.001f);
+        }
+        // a thousand steps of rounding shrink it a little
+        REQUIRE_THAT(squaredNorm(q), Catch::Matchers::WithinAbs(1, 1e-4));
+        q.Renormalize();
+        requireSameRotation(q, Quaternion::FromAngleAndAxis(rate, axis));
+    }
+
+    SECTION("Large Steps")
+    {
+        // above small_angle_squared, through sin and cos
+        Quaternion q{1, 0, 0, 0};
+        q.Integrate(angular_velocity, 1);
+        q.Integrate(angular_velocity, 1);
+        requireSameRotation(q, Quaternion::FromAngleAndAxis(2 * rate, axis));
+    }
+
+    SECTION("Body Frame")
+    {
+        // the rate is about the body axes, so it's applied on the right
+        const Quaternion start{Quaternion::FromAngleAndAxis(0.8f, Matrix<1, 3>{0, 1, 0})};
+        Quaternion q{start};
+        q.Integrate(V3D<float>{0, 0, 0.3f}, 1);
+        requireSameRotation(q, start * Quaternion::FromAngleAndAxis(0.3f, Matrix<1, 3>{0, 0, 1}));
+    }
+
+    SECTION("Renormalize")
+    {
+        // each call squares the error in the norm
+        Quaternion q{Quaternion::FromAngleAndAxis(0.8f, axis) * 1.01f};
+        q.Renormalize();
+        REQUIRE(std::abs(squaredNorm(q) - 1) < 1e-3f);
+        q.Renormalize();
+        REQUIRE(std::abs(squaredNorm(q) - 1) < 1e-6f);
+        requireSameRotation(q, Quaternion::FromAngleAndAxis(0.8f, axis));
+    }
+
+    SECTION("Integrate Many")
+    {
+        constexpr size_t count = 37;
+        std::vector<float> samples(3 * count);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            samples[3 * idx] = std::sin(0.1f * idx);
+            samples[3 * idx + 1] = 0.5f;
+            samples[3 * idx + 2] = -std::cos(0.2f * idx);
+        }
+
+        Quaternion expected{Quaternion::FromAngleAndAxis(0.3f, axis)};
+        Quaternion actual{expected};
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            expected.Integrate(V3D<float>{samples[3 * idx], samples[3 * idx + 1], samples[3 * idx + 2]}, 0.01f);
+            expected.Renormalize();
+        }
+        actual.IntegrateMany(samples.data(), count, 0.01f);
+        requireEqual(actual, expected);
+
+        // nothing to integrate
+        actual.IntegrateMany(samples.data(), 0, 0.01f);
+        requireEqual(actual, expected);
+    }
+}
+
+TEST_CASE("Mahony Filter", "Ahrs")
+{
+    const Quaternion tilted{Quaternion::FromAngleAndAxis(0.6f, Matrix<1, 3>{1, 0.5f, 0.3f})};
+    const V3D<float> still{0, 0, 0};
+    const float dt = 0.01f;
+
+    SECTION("Level From Accelerometer")
+    {
+        // heading can't be seen without a magnetometer, so only compare tilt
+        MahonyFilter filter{2};
+        for (int idx = 0; idx < 1000; idx++)
+        {
+            filter.Update(still, accelAt(tilted), dt);
+        }
+        requireNear(accelAt(filter.Orientation()), accelAt(tilted), 1e-4f);
+    }
+
+    SECTION("Heading From Magnetometer")
+    {
+        MahonyFilter filter{2};
+        for (int idx = 0; idx < 1000; idx++)
+        {
+            filter.Update(still, accelAt(tilted), magAt(tilted), dt);
+        }
+        requireSameRotation(filter.Orientation(), tilted, 1e-4f);
+    }
+
+    SECTION("Gyro Bias")
+    {
+        const V3D<float> bias{0.02f, -0.05f, 0.03f};
+        MahonyFilter filter{1, 0.3f};
+        filter.Reset(tilted);
+        for (int idx = 0; idx < 6000; idx++)
+        {
+            filter.Update(bias, accelAt(tilted), magAt(tilted), dt);
+        }
+        requireNear(filter.GyroCorrection(), bias * -1.0f, 1e-3f);
+        requireSameRotation(filter.Orientation(), tilted, 1e-4f);
+
+        // and forgets it on reset
+        filter.Reset();
+        requireNear(filter.GyroCorrection(), still, 0);
+        requireEqual(filter.Orientation(), Quaternion{1, 0, 0, 0});
+    }
+
+    SECTION("Gyro Only")
+    {
+        // an accelerometer and magnetometer reading nothing are skipped
+        const V3D<float> rate{0.1f, 0.2f, -0.3f};
+        MahonyFilter filter{2, 0.5f};
+        filter.Reset(tilted);
+        filter.Update(rate, still, still, 1);
+        requireSameRotation(filter.Orientation(), Quaternion{tilted}.Integrate(rate, 1));
+        requireNear(filter.GyroCorrection(), still, 0);
+    }
+
+    SECTION("Update Many")
+    {
+        constexpr size_t count = 37;
+        std::vector<float> gyro(3 * count);
+        std::vector<float> accel(3 * count);
+        std::vector<float> mag(3 * count);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> a{accelAt(tilted)};
+            const V3D<float> m{magAt(tilted)};
+            gyro[3 * idx] = 0.1f * std::sin(0.3f * idx);
+            gyro[3 * idx + 1] = 0.05f;
+            gyro[3 * idx + 2] = -0.02f;
+            accel[3 * idx] = a.x;
+            accel[3 * idx + 1] = a.y;
+            accel[3 * idx + 2] = a.z;
+            mag[3 * idx] = m.x;
+            mag[3 * idx + 1] = m.y;
+            mag[3 * idx + 2] = m.z;
+        }
+
+        MahonyFilter expected{1, 0.1f};
+        MahonyFilter actual{1, 0.1f};
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            expected.Update(V3D<float>{gyro[3 * idx], gyro[3 * idx + 1], gyro[3 * idx + 2]},
+                            V3D<float>{accel[3 * idx], accel[3 * idx + 1], accel[3 * idx + 2]}, dt);
+        }
+        actual.UpdateMany(gyro.data(), accel.data(), count, dt);
+        requireEqual(actual.Orientation(), expected.Orientation());
+        requireNear(actual.GyroCorrection(), expected.GyroCorrection(), 0);
+
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            expected.Update(V3D<float>{gyro[3 * idx], gyro[3 * idx + 1], gyro[3 * idx + 2]},
+                            V3D<float>{accel[3 * idx], accel[3 * idx + 1], accel[3 * idx + 2]},
+                            V3D<float>{mag[3 * idx], mag[3 * idx + 1], mag[3 * idx + 2]}, dt);
+        }
+        actual.UpdateMany(gyro.data(), accel.data(), mag.data(), count, dt);
+        requireEqual(actual.Orientation(), expected.Orientation());
+        requireNear(actual.GyroCorrection(), expected.GyroCorrection(), 0);
+    }
+}
+
+TEST_CASE("Madgwick Filter", "Ahrs")
+{
+    const Quaternion tilted{Quaternion::FromAngleAndAxis(0.6f, Matrix<1, 3>{1, 0.5f, 0.3f})};
+    const V3D<float> still{0, 0, 0};
+    const float dt = 0.01f;
+
+    SECTION("Level From Accelerometer")
+    {
+        MadgwickFilter filter{0.5f};
+        for (int idx = 0; idx < 2000; idx++)
+        {
+            filter.Update(still, accelAt(tilted), dt);
+        }
+        // every step is beta * dt long, so it ends up hopping around the
+        // answer rather than settling on it
+        requireNear(accelAt(filter.Orientation()), accelAt(tilted), 5e-3f);
+    }
+
+    SECTION("Heading From Magnetometer")
+    {
+        MadgwickFilter filter{0.5f};
+        for (int idx = 0; idx < 2000; idx++)
+        {
+            filter.Update(still, accelAt(tilted), magAt(tilted), dt);
+        }
+        requireSameRotation(filter.Orientation(), tilted, 1e-4f);
+    }
+
+    SECTION("Gyro Only")
+    {
+        const V3D<float> rate{0.1f, 0.2f, -0.3f};
+        MadgwickFilter filter{0.5f};
+        filter.Reset(tilted);
+        filter.Update(rate, still, still, 1);
+        requireSameRotation(filter.Orientation(), Quaternion{tilted}.Integrate(rate, 1));
+    }
+
+    SECTION("Update Many")
+    {
+        constexpr size_t count = 37;
+        std::vector<float> gyro(3 * count);
+        std::vector<float> accel(3 * count);
+        std::vector<float> mag(3 * count);
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> a{accelAt(tilted)};
+            const V3D<float> m{magAt(tilted)};
+            gyro[3 * idx] = 0.1f * std::sin(0.3f * idx);
+            gyro[3 * idx + 1] = 0.05f;
+            gyro[3 * idx + 2] = -0.02f;
+            accel[3 * idx] = a.x;
+            accel[3 * idx + 1] = a.y;
+            accel[3 * idx + 2] = a.z;
+            mag[3 * idx] = m.x;
+            mag[3 * idx + 1] = m.y;
+            mag[3 * idx + 2] = m.z;
+        }
+
+        MadgwickFilter expected{};
+        MadgwickFilter actual{};
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            expected.Update(V3D<float>{gyro[3 * idx], gyro[3 * idx + 1], gyro[3 * idx + 2]},
+                            V3D<float>{accel[3 * idx], accel[3 * idx + 1], accel[3 * idx + 2]}, dt);
+        }
+        actual.UpdateMany(gyro.data(), accel.data(), count, dt);
+        requireEqual(actual.Orientation(), expected.Orientation());
+
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            expected.Update(V3D<float>{gyro[3 * idx], gyro[3 * idx + 1], gyro[3 * idx + 2]},
+                            V3D<float>{accel[3 * idx], accel[3 * idx + 1], accel[3 * idx + 2]},
+                            V3D<float>{mag[3 * idx], mag[3 * idx + 1], mag[3 * idx + 2]}, dt);
+        }
+        actual.UpdateMany(gyro.data(), accel.data(), mag.data(), count, dt);
+        requireEqual(actual.Orientation(), expected.Orientation());
+    }
+}
@@ -0,0 +1,213 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Cholesky.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <iostream>
+
+// build a symmetric positive definite matrix as A * A^T + size * I
+template <uint8_t size>
+Matrix<size, size> spdMatrix()
+{
+  Matrix<size, size> a{};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      a[row][column] = static_cast<float>((row * 5 + column * 3) % 7) - 3;
+    }
+  }
+  Matrix<size, size> spd = a * a.Transpose();
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    spd[idx][idx] += size;
+  }
+  return spd;
+}
+
+TEST_CASE("LLT", "Cholesky")
+{
+  Matrix<3, 3> mat1{4, 12, -16,
+                    12, 37, -43,
+                    -16, -43, 98};
+
+  SECTION("Factorization")
+  {
+    LLT<3> llt{mat1};
+    REQUIRE(llt.IsPositiveDefinite());
+
+    // the textbook answer
+    const Matrix<3, 3> &l{llt.GetL()};
+    REQUIRE_THAT(l.Get(0, 0), Catch::Matchers::WithinRel(2.0f, 1e-6f));
+    REQUIRE_THAT(l.Get(1, 0), Catch::Matchers::WithinRel(6.0f, 1e-6f));
+    REQUIRE_THAT(l.Get(1, 1), Catch::Matchers::WithinRel(1.0f, 1e-6f));
+    REQUIRE_THAT(l.Get(2, 0), Catch::Matchers::WithinRel(-8.0f, 1e-6f));
+    REQUIRE_THAT(l.Get(2, 1), Catch::Matchers::WithinRel(5.0f, 1e-6f));
+    REQUIRE_THAT(l.Get(2, 2), Catch::Matchers::WithinRel(3.0f, 1e-6f));
+    REQUIRE(l.Get(0, 1) == 0);
+    REQUIRE(l.Get(0, 2) == 0);
+    REQUIRE(l.Get(1, 2) == 0);
+
+    // in place gives the same factor
+    Matrix<3, 3> mat2{mat1};
+    REQUIRE(LLT<3>::FactorInPlace(mat2));
+    for (uint8_t row{0}; row < 3; row++)
+    {
+      for (uint8_t column{0}; column < 3; column++)
+      {
+        REQUIRE(mat2.Get(row, column) == l.Get(row, column));
+      }
+    }
+  }
+
+  SECTION("Determinant")
+  {
+    LLT<3> llt{mat1};
+    REQUIRE_THAT(llt.Det(), Catch::Matchers::WithinRel(36.0f, 1e-5f));
+    REQUIRE_THAT(llt.LogDet(),
+                 Catch::Matchers::WithinRel(std::log(36.0f), 1e-5f));
+  }
+
+  SECTION("Solve")
+  {
+    Matrix<9, 9> mat2{spdMatrix<9>()};
+    LLT<9> llt{mat2};
+    REQUIRE(llt.IsPositiveDefinite());
+
+    // Kalman gain style: solve S * X = B instead of inverting S
+    Matrix<9, 4> expected{};
+    for (uint8_t row{0}; row < 9; row++)
+    {
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        expected[row][column] = static_cast<float>(row) - column * 0.5f;
+      }
+    }
+    Matrix<9, 4> rhs = mat2 * expected;
+    Matrix<9, 4> x{};
+    llt.Solve(rhs, x);
+    for (uint8_t row{0}; row < 9; row++)
+    {
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        REQUIRE_THAT(x.Get(row, column),
+                     Catch::Matchers::WithinAbs(expected.Get(row, column),
+                                                1e-4f));
+      }
+    }
+
+    Matrix<9, 9> inverse{};
+    llt.Invert(inverse);
+    Matrix<9, 9> identity = mat2 * inverse;
+    for (uint8_t row{0}; row < 9; row++)
+    {
+      for (uint8_t column{0}; column < 9; column++)
+      {
+        REQUIRE_THAT(identity.Get(row, column),
+                     Catch::Matchers::WithinAbs(row == column ? 1 : 0, 1e-5f));
+      }
+    }
+  }
+
+  SECTION("Not positive definite")
+  {
+    Matrix<2, 2> mat2{1, 2,
+                      2, 1};
+    LLT<2> llt{};
+    REQUIRE_FALSE(llt.Compute(mat2));
+    REQUIRE_FALSE(llt.IsPositiveDefinite());
+
+    Matrix<2, 1> x{};
+    llt.Solve(Matrix<2, 1>{1, 1}, x);
+    REQUIRE(x.Get(0, 0) == 0);
+    REQUIRE(x.Get(1, 0) == 0);
+  }
+}
+
+TEST_CASE("LDLT", "Cholesky")
+{
+  SECTION("Positive definite")
+  {
+    Matrix<15, 15> mat1{spdMatrix<15>()};
+    LDLT<15> ldlt{mat1};
+    LLT<15> llt{mat1};
+    REQUIRE(ldlt.IsValid());
+    REQUIRE(ldlt.IsPositiveDefinite());
+    REQUIRE_THAT(ldlt.LogDet(),
+                 Catch::Matchers::WithinRel(llt.LogDet(), 1e-4f));
+
+    Matrix<15, 1> expected{};
+    for (uint8_t row{0}; row < 15; row++)
+    {
+      expected[row][0] = row * 0.25f - 1;
+    }
+    Matrix<15, 1> rhs = mat1 * expected;
+    ldlt.Solve(rhs, rhs);
+    for (uint8_t row{0}; row < 15; row++)
+    {
+      REQUIRE_THAT(rhs.Get(row, 0),
+                   Catch::Matchers::WithinAbs(expected.Get(row, 0), 1e-4f));
+    }
+  }
+
+  SECTION("Indefinite")
+  {
+    Matrix<2, 2> mat1{1, 2,
+                      2, 1};
+    LDLT<2> ldlt{mat1};
+    REQUIRE(ldlt.IsValid());
+    REQUIRE_FALSE(ldlt.IsPositiveDefinite());
+    REQUIRE_THAT(ldlt.Det(), Catch::Matchers::WithinRel(-3.0f, 1e-6f));
+
+    Matrix<2, 1> x{};
+    ldlt.Solve(Matrix<2, 1>{3, 3}, x);
+    REQUIRE_THAT(x.Get(0, 0), Catch::Matchers::WithinRel(1.0f, 1e-6f));
+    REQUIRE_THAT(x.Get(1, 0), Catch::Matchers::WithinRel(1.0f, 1e-6f));
+  }
+
+  SECTION("Badly scaled")
+  {
+    // states in very different units, which LLT accepts, so LDLT has to too
+    Matrix<6, 6> mat1{};
+    for (uint8_t idx{0}; idx < 3; idx++)
+    {
+      mat1[idx][idx] = 100;
+      mat1[idx + 3][idx + 3] = 1e-5f;
+    }
+    mat1[0][1] = mat1[1][0] = 20;
+    mat1[3][4] = mat1[4][3] = 2e-6f;
+
+    LLT<6> llt{mat1};
+    LDLT<6> ldlt{mat1};
+    REQUIRE(llt.IsPositiveDefinite());
+    REQUIRE(ldlt.IsValid());
+    REQUIRE(ldlt.IsPositiveDefinite());
+    REQUIRE_THAT(ldlt.LogDet(),
+                 Catch::Matchers::WithinRel(llt.LogDet(), 1e-4f));
+
+    const Matrix<6, 1> expected{1, -2, 3, 0.5f, -0.25f, 2};
+    Matrix<6, 1> x{};
+    const Matrix<6, 1> rhs{mat1 * expected};
+    ldlt.Solve(rhs, x);
+    for (uint8_t row{0}; row < 6; row++)
+    {
+      REQUIRE_THAT(x.Get(row, 0),
+                   Catch::Matchers::WithinRel(expected.Get(row, 0), 1e-4f));
+    }
+  }
+
+  SECTION("Singular")
+  {
+    Matrix<2, 2> mat1{1, 1,
+                      1, 1};
+    LDLT<2> ldlt{};
+    REQUIRE_FALSE(ldlt.Compute(mat1));
+    REQUIRE(ldlt.Det() == 0);
+  }
+}
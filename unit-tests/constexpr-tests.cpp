@@ -0,0 +1,160 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Matrix.hpp"
+#include "Quaternion.h"
+#include "Vector3D.hpp"
+
+// any other libraries
+#include <cmath>
+
+// everything here is evaluated by the compiler, the static_asserts are the
+// real tests. The test cases check the compile time results agree with the
+// same math done at run time.
+
+constexpr Matrix<3, 3> mount{0, -1, 0,
+                             1, 0, 0,
+                             0, 0, 1};
+constexpr Matrix<3, 3> calibration{1.5f, 0, 0,
+                                   0, 2, 0,
+                                   0.5f, 0, 1};
+constexpr Matrix<3, 3> sensor_to_body{mount * calibration};
+static_assert(sensor_to_body.Get(0, 0) == 0, "");
+static_assert(sensor_to_body.Get(0, 1) == -2, "");
+static_assert(sensor_to_body.Get(1, 0) == 1.5f, "");
+static_assert(sensor_to_body.Get(2, 0) == 0.5f, "");
+static_assert(sensor_to_body.Get(2, 2) == 1, "");
+
+// big enough to take the GEMM, LU and SIMD paths at run time
+constexpr Matrix<6, 6> bigMatrix()
+{
+  Matrix<6, 6> matrix{};
+  for (uint8_t row{0}; row < 6; row++)
+  {
+    for (uint8_t column{0}; column < 6; column++)
+    {
+      matrix[row][column] = static_cast<float>((row * 3 + column * 7) % 5) - 2;
+    }
+    matrix[row][row] += 6;
+  }
+  return matrix;
+}
+
+constexpr Matrix<6, 6> big{bigMatrix()};
+constexpr Matrix<6, 6> big_inverse{big.Invert()};
+constexpr Matrix<6, 6> big_identity{big * big_inverse};
+constexpr bool isIdentity(const Matrix<6, 6> &matrix, float tolerance)
+{
+  for (uint8_t row{0}; row < 6; row++)
+  {
+    for (uint8_t column{0}; column < 6; column++)
+    {
+      const float expected{row == column ? 1.0f : 0.0f};
+      if (ConstexprMath::Abs(matrix.Get(row, column) - expected) > tolerance)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+static_assert(isIdentity(big_identity, 1e-5f), "");
+static_assert(big.Transpose().Get(1, 4) == big.Get(4, 1), "");
+
+constexpr Matrix<3, 3> small_inverse{calibration.Invert()};
+static_assert(calibration.Det() == 3, "");
+static_assert(small_inverse.Get(0, 0) * 1.5f == 1, "");
+
+// the 4x4 closed forms
+constexpr Matrix<4, 4> transform{2, 0, 0, 1,
+                                 0, 1, 0, 2,
+                                 0, 0, 4, 3,
+                                 0, 0, 0, 1};
+static_assert(transform.Det() == 8, "");
+static_assert((transform * transform.Invert()).Get(2, 3) == 0, "");
+static_assert(transform.Invert().Get(0, 3) == -0.5f, "");
+static_assert(transform.Transpose().Get(3, 1) == 2, "");
+
+constexpr V3D<float> v1{1, 2, 3};
+constexpr V3D<float> v2{v1 * 2 + V3D<float>{1, 1, 1}};
+static_assert(v2 == V3D<float>{3, 5, 7}, "");
+static_assert(V3D<float>{3, 4, 0}.magnitude() == 5, "");
+
+constexpr Quaternion quarter_turn{
+    Quaternion::FromAngleAndAxis(M_PI / 2, Matrix<1, 3>{0, 0, 1})};
+static_assert(ConstexprMath::Abs(quarter_turn.v3() - quarter_turn.w()) < 1e-6f,
+              "");
+constexpr V3D<float> rotated{quarter_turn.Rotate(V3D<float>{1, 0, 0})};
+static_assert(ConstexprMath::Abs(rotated.x) < 1e-6f, "");
+static_assert(ConstexprMath::Abs(rotated.y - 1) < 1e-6f, "");
+constexpr Quaternion half_turn{quarter_turn * quarter_turn};
+static_assert(ConstexprMath::Abs(half_turn.v3() - 1) < 1e-6f, "");
+constexpr Matrix<3, 3> quarter_turn_matrix{quarter_turn.ToRotationMatrix()};
+static_assert(ConstexprMath::Abs(quarter_turn_matrix.Get(1, 0) - 1) < 1e-6f,
+              "");
+
+TEST_CASE("Compile time math", "Constexpr")
+{
+  SECTION("Math functions")
+  {
+    for (float value{-7}; value < 7; value += 0.37f)
+    {
+      // runtime inputs call <cmath>, a constant would use the series
+      REQUIRE_THAT(ConstexprMath::Sin(value),
+                   Catch::Matchers::WithinAbs(std::sin(value), 1e-6));
+      REQUIRE_THAT(ConstexprMath::Cos(value),
+                   Catch::Matchers::WithinAbs(std::cos(value), 1e-6));
+    }
+
+    constexpr float sin_values[]{ConstexprMath::Sin(-6.5f),
+                                 ConstexprMath::Sin(0.3f),
+                                 ConstexprMath::Sin(2.9f)};
+    constexpr float cos_values[]{ConstexprMath::Cos(-6.5f),
+                                 ConstexprMath::Cos(0.3f),
+                                 ConstexprMath::Cos(2.9f)};
+    constexpr float sqrt_values[]{ConstexprMath::Sqrt(1e-8f),
+                                  ConstexprMath::Sqrt(2),
+                                  ConstexprMath::Sqrt(12345.6f)};
+    const float inputs[]{-6.5f, 0.3f, 2.9f};
+    const float sqrt_inputs[]{1e-8f, 2, 12345.6f};
+    for (uint8_t idx{0}; idx < 3; idx++)
+    {
+      REQUIRE_THAT(sin_values[idx],
+                   Catch::Matchers::WithinAbs(std::sin(inputs[idx]), 1e-6));
+      REQUIRE_THAT(cos_values[idx],
+                   Catch::Matchers::WithinAbs(std::cos(inputs[idx]), 1e-6));
+      REQUIRE_THAT(sqrt_values[idx],
+                   Catch::Matchers::WithinRel(std::sqrt(sqrt_inputs[idx]),
+                                              1e-6f));
+    }
+  }
+
+  SECTION("Matrices")
+  {
+    const Matrix<6, 6> runtime_big{bigMatrix()};
+    const Matrix<6, 6> runtime_inverse{runtime_big.Invert()};
+    for (uint8_t row{0}; row < 6; row++)
+    {
+      for (uint8_t column{0}; column < 6; column++)
+      {
+        REQUIRE_THAT(big_inverse.Get(row, column),
+                     Catch::Matchers::WithinAbs(
+                         runtime_inverse.Get(row, column), 1e-6));
+      }
+    }
+  }
+
+  SECTION("Quaternions")
+  {
+    const Quaternion runtime_quarter_turn{
+        Quaternion::FromAngleAndAxis(M_PI / 2, Matrix<1, 3>{0, 0, 1})};
+    for (uint8_t idx{0}; idx < 4; idx++)
+    {
+      REQUIRE_THAT(quarter_turn.Get(0, idx),
+                   Catch::Matchers::WithinAbs(runtime_quarter_turn[idx],
+                                              1e-6));
+    }
+  }
+}
@@ -0,0 +1,325 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Arena.hpp"
+#include "DynMatrix.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// a non-symmetric test matrix. Square ones are diagonally dominant, so they're
+// well conditioned at every size.
+void fillTestMatrix(DynMatrix &matrix)
+{
+  for (size_t row{0}; row < matrix.GetRowSize(); row++)
+  {
+    for (size_t column{0}; column < matrix.GetColumnSize(); column++)
+    {
+      matrix[row][column] =
+          static_cast<float>((row * 3 + column * 7) % 5) - 2;
+    }
+    if (row < matrix.GetColumnSize())
+    {
+      matrix[row][row] += 2 * matrix.GetRowSize() + 2;
+    }
+  }
+}
+
+TEST_CASE("Arena", "Arena")
+{
+  StaticArena<1024> arena{};
+
+  SECTION("Alignment")
+  {
+    void *first{arena.Allocate(3, 1)};
+    void *second{arena.Allocate(8)};
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(second) % Arena::default_alignment ==
+            0);
+    REQUIRE(arena.Used() <= 3 + Arena::default_alignment + 8);
+  }
+
+  SECTION("Running out")
+  {
+    REQUIRE(arena.Allocate(1024, 1) != nullptr);
+    REQUIRE(arena.Allocate(1, 1) == nullptr);
+    // a failed allocation doesn't use anything up
+    REQUIRE(arena.Used() == 1024);
+    arena.Reset();
+    REQUIRE(arena.Used() == 0);
+    REQUIRE(arena.Allocate(2000, 1) == nullptr);
+  }
+
+  SECTION("Mark and rewind")
+  {
+    arena.Allocate(100);
+    const size_t mark{arena.Mark()};
+    void *temporary{arena.Allocate(100)};
+    arena.Rewind(mark);
+    REQUIRE(arena.Used() == mark);
+    REQUIRE(arena.Allocate(100) == temporary);
+  }
+}
+
+TEST_CASE("Dynamic matrix basics", "DynMatrix")
+{
+  StaticArena<4096> arena{};
+
+  SECTION("Initialization")
+  {
+    DynMatrix mat1{arena, 3, 4};
+    REQUIRE(mat1.IsValid());
+    REQUIRE(mat1.GetRowSize() == 3);
+    REQUIRE(mat1.GetColumnSize() == 4);
+    for (size_t idx{0}; idx < mat1.Size(); idx++)
+    {
+      REQUIRE(mat1.Data()[idx] == 0);
+    }
+    REQUIRE(reinterpret_cast<uintptr_t>(mat1.Data()) %
+                Arena::default_alignment ==
+            0);
+
+    Matrix<2, 3> fixed{1, 2, 3, 4, 5, 6};
+    DynMatrix mat2{arena, fixed};
+    REQUIRE(mat2.Get(0, 0) == 1);
+    REQUIRE(mat2.Get(1, 2) == 6);
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(mat2.Get(2, 0) == 1e+10);
+    }
+
+    Matrix<2, 3> copy{};
+    REQUIRE(mat2.CopyTo(copy));
+    REQUIRE(copy.Get(1, 1) == 5);
+    Matrix<3, 2> wrong{};
+    REQUIRE_FALSE(mat2.CopyTo(wrong));
+
+    std::array<float, 4> values{1, 2, 3, 4};
+    DynMatrix view{DynMatrix::View(values.data(), 2, 2)};
+    view[1][0] = 7;
+    REQUIRE(values[2] == 7);
+  }
+
+  SECTION("Out of memory")
+  {
+    DynMatrix mat1{arena, 100, 100};
+    REQUIRE_FALSE(mat1.IsValid());
+    REQUIRE(mat1.GetRowSize() == 0);
+    REQUIRE(mat1.GetColumnSize() == 0);
+    REQUIRE(arena.Used() == 0);
+  }
+
+  SECTION("Moving")
+  {
+    DynMatrix mat1{arena, 2, 2};
+    mat1.Identity();
+    DynMatrix mat2{std::move(mat1)};
+    REQUIRE_FALSE(mat1.IsValid());
+    REQUIRE(mat2.Get(1, 1) == 1);
+  }
+
+  SECTION("Element-wise operations")
+  {
+    DynMatrix mat1{arena, 5, 7};
+    DynMatrix mat2{arena, 5, 7};
+    DynMatrix mat3{arena, 5, 7};
+    DynMatrix wrong{arena, 7, 5};
+    fillTestMatrix(mat1);
+    mat2.Fill(2);
+
+    REQUIRE(mat1.Add(mat2, mat3));
+    REQUIRE(mat3.Get(4, 6) == mat1.Get(4, 6) + 2);
+    REQUIRE(mat1.Sub(mat2, mat3));
+    REQUIRE(mat3.Get(3, 2) == mat1.Get(3, 2) - 2);
+    REQUIRE(mat1.ElementMultiply(mat2, mat3));
+    REQUIRE(mat3.Get(0, 5) == mat1.Get(0, 5) * 2);
+    REQUIRE(mat1.ElementDivide(mat2, mat3));
+    REQUIRE(mat3.Get(2, 2) == mat1.Get(2, 2) / 2);
+    REQUIRE(mat1.Mult(3, mat3));
+    REQUIRE(mat3.Get(1, 4) == mat1.Get(1, 4) * 3);
+
+    // in place
+    REQUIRE(mat3.Add(mat2, mat3));
+    REQUIRE(mat3.Get(1, 4) == mat1.Get(1, 4) * 3 + 2);
+
+    mat3.Fill(-1);
+    REQUIRE_FALSE(mat1.Add(wrong, mat3));
+    REQUIRE_FALSE(mat1.Add(mat2, wrong));
+    REQUIRE(mat3.Get(0, 0) == -1);
+  }
+
+  SECTION("Transpose")
+  {
+    DynMatrix mat1{arena, 5, 19};
+    DynMatrix mat2{arena, 19, 5};
+    fillTestMatrix(mat1);
+    REQUIRE(mat1.Transpose(mat2));
+    for (size_t row{0}; row < 5; row++)
+    {
+      for (size_t column{0}; column < 19; column++)
+      {
+        REQUIRE(mat2.Get(column, row) == mat1.Get(row, column));
+      }
+    }
+    REQUIRE_FALSE(mat1.Transpose(mat1));
+  }
+}
+
+TEST_CASE("Dynamic matrix products", "DynMatrix")
+{
+  std::vector<float> buffer(1 << 20);
+  Arena arena{buffer.data(), buffer.size() * sizeof(float)};
+
+  // sizes on both sides of the GEMM threshold
+  const std::array<std::array<size_t, 3>, 4> sizes{{{3, 4, 5},
+                                                    {17, 16, 15},
+                                                    {64, 64, 64},
+                                                    {101, 67, 33}}};
+  for (const std::array<size_t, 3> &size : sizes)
+  {
+    const size_t mark{arena.Mark()};
+    DynMatrix mat1{arena, size[0], size[1]};
+    DynMatrix mat2{arena, size[1], size[2]};
+    DynMatrix result{arena, size[0], size[2]};
+    fillTestMatrix(mat1);
+    fillTestMatrix(mat2);
+
+    REQUIRE(mat1.Mult(mat2, result));
+    for (size_t row{0}; row < size[0]; row++)
+    {
+      for (size_t column{0}; column < size[2]; column++)
+      {
+        float expected{0};
+        for (size_t inner{0}; inner < size[1]; inner++)
+        {
+          expected += mat1.Get(row, inner) * mat2.Get(inner, column);
+        }
+        REQUIRE_THAT(result.Get(row, column),
+                     Catch::Matchers::WithinAbs(expected, 1e-3));
+      }
+    }
+    REQUIRE_FALSE(mat1.Mult(mat2, mat1));
+    REQUIRE_FALSE(mat1.Mult(mat2, mat2));
+    arena.Rewind(mark);
+  }
+
+  SECTION("Matches Matrix")
+  {
+    Matrix<6, 6> fixed1{};
+    Matrix<6, 6> fixed2{};
+    for (uint8_t idx{0}; idx < 36; idx++)
+    {
+      fixed1[idx / 6][idx % 6] = static_cast<float>(idx % 7) - 3;
+      fixed2[idx / 6][idx % 6] = static_cast<float>(idx % 5) + 1;
+    }
+    DynMatrix mat1{arena, fixed1};
+    DynMatrix mat2{arena, fixed2};
+    DynMatrix result{arena, 6, 6};
+    REQUIRE(mat1.Mult(mat2, result));
+    const Matrix<6, 6> expected{fixed1 * fixed2};
+    for (uint8_t row{0}; row < 6; row++)
+    {
+      for (uint8_t column{0}; column < 6; column++)
+      {
+        REQUIRE(result.Get(row, column) == expected.Get(row, column));
+      }
+    }
+  }
+}
+
+TEST_CASE("Dynamic matrix solve", "DynMatrix")
+{
+  std::vector<float> buffer(1 << 20);
+  Arena arena{buffer.data(), buffer.size() * sizeof(float)};
+
+  for (size_t size : {1, 2, 5, 40, 300})
+  {
+    const size_t mark{arena.Mark()};
+    DynMatrix a{arena, size, size};
+    DynMatrix x{arena, size, 3};
+    DynMatrix b{arena, size, 3};
+    DynMatrix solution{arena, size, 3};
+    fillTestMatrix(a);
+    for (size_t row{0}; row < size; row++)
+    {
+      x[row][0] = static_cast<float>(row % 11) - 5;
+      x[row][1] = 1;
+      x[row][2] = static_cast<float>(row % 3);
+    }
+    REQUIRE(a.Mult(x, b));
+
+    const size_t used{arena.Used()};
+    REQUIRE(a.Solve(b, solution, arena));
+    // the factorization doesn't stay in the arena
+    REQUIRE(arena.Used() == used);
+    for (size_t idx{0}; idx < x.Size(); idx++)
+    {
+      REQUIRE_THAT(solution.Data()[idx],
+                   Catch::Matchers::WithinAbs(x.Data()[idx], 1e-3));
+    }
+
+    // in place
+    REQUIRE(a.Solve(b, b, arena));
+    for (size_t idx{0}; idx < x.Size(); idx++)
+    {
+      REQUIRE(b.Data()[idx] == solution.Data()[idx]);
+    }
+    arena.Rewind(mark);
+  }
+
+  SECTION("Mixed scale")
+  {
+    // the same covariance as LU's mixed scale test, with a big and a tiny
+    // block that are both well conditioned relative to their own rows
+    Matrix<6, 6> covariance{};
+    for (uint8_t idx{0}; idx < 3; idx++)
+    {
+      covariance[idx][idx] = 100;
+      covariance[idx + 3][idx + 3] = 1e-5f;
+    }
+    covariance[0][1] = covariance[1][0] = 20;
+    covariance[3][4] = covariance[4][3] = 2e-6f;
+
+    DynMatrix a{arena, covariance};
+    DynMatrix x{arena, 6, 1};
+    DynMatrix b{arena, 6, 1};
+    DynMatrix solution{arena, 6, 1};
+    for (size_t row{0}; row < 6; row++)
+    {
+      x[row][0] = static_cast<float>(row + 1);
+    }
+    REQUIRE(a.Mult(x, b));
+    REQUIRE(a.Solve(b, solution, arena));
+    for (size_t row{0}; row < 6; row++)
+    {
+      REQUIRE_THAT(solution[row][0],
+                   Catch::Matchers::WithinRel(x[row][0], 1e-4f));
+    }
+  }
+
+  SECTION("Failures")
+  {
+    DynMatrix singular{arena, 3, 3};
+    DynMatrix rhs{arena, 3, 1};
+    DynMatrix result{arena, 3, 1};
+    singular.Fill(1);
+    rhs.Fill(1);
+    REQUIRE_FALSE(singular.Solve(rhs, result, arena));
+
+    DynMatrix rectangular{arena, 3, 4};
+    REQUIRE_FALSE(rectangular.Solve(rhs, result, arena));
+
+    // not enough scratch space for the factorization
+    singular.Identity();
+    StaticArena<16> tiny{};
+    REQUIRE_FALSE(singular.Solve(rhs, result, tiny));
+    REQUIRE(tiny.Used() == 0);
+  }
+}
@@ -0,0 +1,150 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "ElementKernels.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <iostream>
+
+TEST_CASE("Element Kernels", "ElementKernels")
+{
+  using ElementKernels::InstructionSet;
+  const InstructionSet original{ElementKernels::ActiveInstructionSet()};
+
+  // odd length so every kernel has to deal with a tail
+  constexpr size_t length{67};
+  std::array<float, length> a{};
+  std::array<float, length> b{};
+  std::array<float, length> result{};
+  for (size_t idx{0}; idx < length; idx++)
+  {
+    a[idx] = static_cast<float>(idx) - 20.5f;
+    b[idx] = static_cast<float>(idx % 7) + 0.25f;
+  }
+
+  const std::array<InstructionSet, 5> instruction_sets{
+      InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2,
+      InstructionSet::AVX512, InstructionSet::NEON};
+
+  SECTION("Scalar is always supported")
+  {
+    REQUIRE(ElementKernels::IsSupported(InstructionSet::Scalar));
+    REQUIRE(ElementKernels::IsSupported(original));
+  }
+
+  SECTION("Every supported instruction set matches the scalar math")
+  {
+    for (InstructionSet instruction_set : instruction_sets)
+    {
+      if (!ElementKernels::UseInstructionSet(instruction_set))
+      {
+        REQUIRE_FALSE(ElementKernels::IsSupported(instruction_set));
+        continue;
+      }
+      REQUIRE(ElementKernels::ActiveInstructionSet() == instruction_set);
+
+      ElementKernels::Add(a.data(), b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] + b[idx]);
+      }
+
+      ElementKernels::Sub(a.data(), b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] - b[idx]);
+      }
+
+      ElementKernels::Multiply(a.data(), b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] * b[idx]);
+      }
+
+      ElementKernels::Divide(a.data(), b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] / b[idx]);
+      }
+
+      ElementKernels::Scale(a.data(), 3.5f, result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] * 3.5f);
+      }
+
+      ElementKernels::DivideScalar(a.data(), 3.5f, result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] / 3.5f);
+      }
+
+      // the fused kernels may or may not round the product before the add
+      ElementKernels::MultiplyAdd(a.data(), b.data(), a.data(), result.data(),
+                                  length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE_THAT(result[idx],
+                     Catch::Matchers::WithinAbs(a[idx] * b[idx] + a[idx], 1e-4));
+      }
+
+      ElementKernels::MultiplySub(a.data(), b.data(), a.data(), result.data(),
+                                  length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE_THAT(result[idx],
+                     Catch::Matchers::WithinAbs(a[idx] * b[idx] - a[idx], 1e-4));
+      }
+
+      ElementKernels::ScaleAdd(a.data(), 3.5f, b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE_THAT(result[idx],
+                     Catch::Matchers::WithinAbs(a[idx] * 3.5f + b[idx], 1e-4));
+      }
+
+      ElementKernels::Sqrt(b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == std::sqrt(b[idx]));
+      }
+
+      ElementKernels::Fill(result.data(), -2.0f, length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == -2.0f);
+      }
+
+      float expected{0};
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        expected += a[idx] * a[idx];
+      }
+      REQUIRE_THAT(ElementKernels::SumOfSquares(a.data(), length),
+                   Catch::Matchers::WithinRel(expected, 1e-6f));
+
+      // the result is allowed to be one of the inputs
+      result = a;
+      ElementKernels::Add(result.data(), b.data(), result.data(), length);
+      for (size_t idx{0}; idx < length; idx++)
+      {
+        REQUIRE(result[idx] == a[idx] + b[idx]);
+      }
+
+      // a matrix big enough to go through the kernels
+      Matrix<8, 9> mat1{};
+      Matrix<8, 9> mat2{};
+      mat1.Fill(3);
+      mat1.Mult(2, mat2);
+      mat2.Add(mat1, mat2);
+      REQUIRE(mat2.Get(7, 8) == 9);
+    }
+
+    REQUIRE(ElementKernels::UseInstructionSet(original));
+  }
+}
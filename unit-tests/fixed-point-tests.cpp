@@ -0,0 +1,243 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "FixedPoint.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+using FixedPoint::Q15;
+using FixedPoint::Q16_16;
+using FixedPoint::Q31;
+
+static_assert(sizeof(Q15) == 2 && sizeof(Q31) == 4 && sizeof(Q16_16) == 4,
+              "Fixed point values should be just their storage");
+static_assert(std::is_same<ScalarTraits<Q31>::Accumulator,
+                           FixedPoint::Fixed<int64_t, 31>>::value,
+              "Q31 sums should be accumulated in 64 bits");
+
+// everything folds at compile time
+constexpr Q16_16 half{0.5};
+static_assert(half.Raw() == 0x8000, "");
+static_assert((half * 3).Raw() == 0x18000, "");
+static_assert(FixedPoint::Sqrt(Q16_16{16}) == Q16_16{4}, "");
+static_assert(FixedPoint::Reciprocal(Q16_16{4}) == Q16_16{0.25}, "");
+static_assert(Q15{1} == Q15::Max(), "");
+
+TEST_CASE("Fixed point arithmetic", "FixedPoint")
+{
+  SECTION("Basic operations")
+  {
+    Q16_16 a{1.5};
+    Q16_16 b{-2.25};
+    REQUIRE(static_cast<double>(a + b) == -0.75);
+    REQUIRE(static_cast<double>(a - b) == 3.75);
+    REQUIRE(static_cast<double>(a * b) == -3.375);
+    REQUIRE(static_cast<double>(b / a) == -1.5);
+    REQUIRE(static_cast<double>(-a) == -1.5);
+    REQUIRE(a > b);
+    REQUIRE(a != b);
+
+    a += 1;
+    REQUIRE(a == Q16_16{2.5});
+    a *= 2;
+    REQUIRE(a == 5);
+  }
+
+  SECTION("Rounding")
+  {
+    // 2^-16 * 0.5 rounds up to 2^-16 rather than down to 0
+    REQUIRE((Q16_16::Epsilon() * Q16_16{0.5}) == Q16_16::Epsilon());
+    REQUIRE((-Q16_16::Epsilon() * Q16_16{0.5}) == -Q16_16::Epsilon());
+    REQUIRE((Q16_16{1} / 3).Raw() == 21845);
+    REQUIRE((Q16_16{2} / 3).Raw() == 43691);
+    REQUIRE(Q15{0.1}.Raw() == 3277);
+  }
+
+  SECTION("Saturation")
+  {
+    REQUIRE(Q15{0.75} + Q15{0.75} == Q15::Max());
+    REQUIRE(Q15{-0.75} - Q15{0.75} == Q15::Lowest());
+    REQUIRE(-Q15::Lowest() == Q15::Max());
+    REQUIRE(Q15{-1} == Q15::Lowest());
+    REQUIRE(Q15{1000} == Q15::Max());
+    REQUIRE(Q16_16{40000.0} == Q16_16::Max());
+    REQUIRE(Q16_16{-32768} == Q16_16::Lowest());
+    REQUIRE(Q16_16{-40000} == Q16_16::Lowest());
+    REQUIRE(Q16_16{300} * Q16_16{300} == Q16_16::Max());
+    REQUIRE(Q16_16{300} * Q16_16{-300} == Q16_16::Lowest());
+    REQUIRE(Q15{0.5} / Q15{0.25} == Q15::Max());
+    REQUIRE(Q31::Lowest() * Q31::Lowest() == Q31::Max());
+  }
+
+  SECTION("Division by zero")
+  {
+    REQUIRE(Q16_16{3} / Q16_16{} == Q16_16::Max());
+    REQUIRE(Q16_16{-3} / Q16_16{} == Q16_16::Lowest());
+    REQUIRE(Q16_16{} / Q16_16{} == Q16_16{});
+    REQUIRE(FixedPoint::Reciprocal(Q16_16{}) == Q16_16::Max());
+  }
+
+  SECTION("Conversions")
+  {
+    Q16_16 value{-2.75};
+    REQUIRE(static_cast<float>(value) == -2.75f);
+    REQUIRE(static_cast<int>(value) == -2);
+    REQUIRE(static_cast<int>(Q16_16{2.75}) == 2);
+
+    // narrower to wider is exact and implicit
+    FixedPoint::Fixed<int64_t, 16> wide{value};
+    REQUIRE(wide.Raw() == value.Raw());
+
+    // changing the fraction rounds and saturates
+    REQUIRE(Q15{Q16_16{0.25}} == Q15{0.25});
+    REQUIRE(Q15{Q16_16{7}} == Q15::Max());
+    REQUIRE(Q16_16{Q31{0.5}} == half);
+    REQUIRE(Q16_16{Q31::Epsilon()} == Q16_16{});
+  }
+
+  SECTION("64 bit storage")
+  {
+    using Q32_32 = FixedPoint::Fixed<int64_t, 32>;
+    Q32_32 a{100000.5};
+    Q32_32 b{-3.25};
+    REQUIRE(static_cast<double>(a * b) == -325001.625);
+    REQUIRE_THAT(static_cast<double>(a / b),
+                 Catch::Matchers::WithinRel(100000.5 / -3.25, 1e-12));
+    REQUIRE(Q32_32{3e+9} * Q32_32{3e+9} == Q32_32::Max());
+    REQUIRE_THAT(static_cast<double>(FixedPoint::Sqrt(Q32_32{2})),
+                 Catch::Matchers::WithinAbs(1.41421356237, 1e-9));
+    REQUIRE_THAT(static_cast<double>(FixedPoint::Reciprocal(b)),
+                 Catch::Matchers::WithinAbs(-1 / 3.25, 1e-9));
+  }
+}
+
+TEST_CASE("Fixed point square roots and reciprocals", "FixedPoint")
+{
+  SECTION("Square roots")
+  {
+    REQUIRE(FixedPoint::Sqrt(Q16_16{2}).Raw() == 92681);
+    REQUIRE(FixedPoint::Sqrt(Q15{0.25}) == Q15{0.5});
+    REQUIRE(FixedPoint::Sqrt(Q31{0.81}).Raw() ==
+            static_cast<int32_t>(0.9 * 2147483648.0));
+    REQUIRE(FixedPoint::Sqrt(Q16_16{-4}) == Q16_16{});
+    REQUIRE(FixedPoint::Sqrt(Q15::Epsilon()).Raw() == 181);
+  }
+
+  SECTION("Reciprocals")
+  {
+    REQUIRE(FixedPoint::Reciprocal(Q16_16{-0.5}) == -2);
+    REQUIRE_THAT(static_cast<double>(FixedPoint::Reciprocal(Q16_16{3})),
+                 Catch::Matchers::WithinAbs(1 / 3.0, 1.0 / 65536));
+    // 1 doesn't fit in Q15, but its reciprocal of 2 still works out
+    REQUIRE(FixedPoint::Reciprocal(Q15{0.5}) == Q15::Max());
+    REQUIRE(FixedPoint::Reciprocal(Q31{-0.5}) == Q31::Lowest());
+  }
+}
+
+TEST_CASE("Fixed point matrices", "FixedPoint")
+{
+  SECTION("Products match float")
+  {
+    // big enough to take the blocked path
+    Matrix<17, 17, Q16_16> mat1{};
+    Matrix<17, 17, Q16_16> mat2{};
+    Matrix<17, 17> float1{};
+    Matrix<17, 17> float2{};
+    for (uint8_t row{0}; row < 17; row++)
+    {
+      for (uint8_t column{0}; column < 17; column++)
+      {
+        float1[row][column] = static_cast<float>((row * 5 + column) % 7) / 4 - 0.75f;
+        float2[row][column] = static_cast<float>((row + column * 3) % 9) / 8 - 0.5f;
+        mat1[row][column] = float1[row][column];
+        mat2[row][column] = float2[row][column];
+      }
+    }
+
+    Matrix<17, 17, Q16_16> result{};
+    mat1.Mult(mat2, result);
+    Matrix<17, 17> expected{};
+    float1.Mult(float2, expected);
+    for (uint8_t row{0}; row < 17; row++)
+    {
+      for (uint8_t column{0}; column < 17; column++)
+      {
+        // the inputs are exact in Q16.16 and products are summed unrounded
+        REQUIRE(static_cast<float>(result.Get(row, column)) ==
+                expected.Get(row, column));
+      }
+    }
+
+    Matrix<3, 3, Q16_16> small{1, 2, 0, 0.5, 1, 0, 0, 0, 2};
+    Matrix<3, 1, Q16_16> vector{1, -1, 0.25};
+    Matrix<3, 1, Q16_16> rotated{};
+    small.Mult(vector, rotated);
+    REQUIRE(rotated.Get(0, 0) == -1);
+    REQUIRE(rotated.Get(1, 0) == -0.5);
+    REQUIRE(rotated.Get(2, 0) == 0.5);
+  }
+
+  SECTION("Sums are accumulated wider")
+  {
+    // 0.6 + 0.6 - 0.6 saturates in Q31 but not in its 64 bit accumulator
+    Matrix<1, 3, Q31> vec1{0.6, 0.6, -0.6};
+    Matrix<1, 3, Q31> vec2{0.99, 0.99, 0.99};
+    const double dot{static_cast<double>(
+        Matrix<1, 3, Q31>::DotProduct(vec1, vec2))};
+    REQUIRE_THAT(dot, Catch::Matchers::WithinAbs(0.594, 1e-8));
+
+    Matrix<1, 2, Q31> vec3{0.3, 0.4};
+    Matrix<1, 2, Q31> normalized{};
+    vec3.Normalize(normalized);
+    REQUIRE_THAT(static_cast<double>(normalized.Get(0, 0)),
+                 Catch::Matchers::WithinAbs(0.6, 1e-8));
+    REQUIRE_THAT(static_cast<double>(normalized.Get(0, 1)),
+                 Catch::Matchers::WithinAbs(0.8, 1e-8));
+  }
+
+  SECTION("Determinant and inverse")
+  {
+    Matrix<3, 3, Q15> mat1{0.5, 0.25, 0,
+                           0, 0.5, 0.25,
+                           0.25, 0, 0.5};
+    REQUIRE(mat1.Det() == Q15{0.140625});
+
+    Matrix<2, 2, Q16_16> mat2{2, 1, 1, 3};
+    Matrix<2, 2, Q16_16> inverse{mat2.Invert()};
+    Matrix<2, 2, Q16_16> identity{};
+    mat2.Mult(inverse, identity);
+    for (uint8_t row{0}; row < 2; row++)
+    {
+      for (uint8_t column{0}; column < 2; column++)
+      {
+        // 1/5 isn't exact in binary, allow a couple of steps of rounding
+        REQUIRE_THAT(static_cast<double>(identity.Get(row, column)),
+                     Catch::Matchers::WithinAbs(row == column ? 1 : 0,
+                                                4.0 / 65536));
+      }
+    }
+  }
+
+  SECTION("Out of bounds reads saturate")
+  {
+    Matrix<2, 2, Q16_16> mat1{};
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(mat1.Get(2, 2) == Q16_16::Max());
+    }
+  }
+
+  SECTION("ToString")
+  {
+    Matrix<1, 2, Q16_16> mat1{1.5, -0.25};
+    std::string string_buffer{};
+    mat1.ToString(string_buffer);
+    REQUIRE(string_buffer == "|1.500000\t-0.250000|\n");
+  }
+}
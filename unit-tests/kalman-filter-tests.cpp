@@ -0,0 +1,298 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "KalmanFilter.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <cmath>
+#include <iostream>
+
+// a symmetric positive definite matrix as A * A^T + size * I
+template <uint8_t size, typename Type = float>
+Matrix<size, size, Type> spdMatrix(uint8_t seed)
+{
+  Matrix<size, size, Type> a{};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      a[row][column] =
+          static_cast<Type>((row * 5 + column * 3 + seed) % 7) / 7 - Type{0.4};
+    }
+  }
+  Matrix<size, size, Type> spd = a * a.Transpose();
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    spd[idx][idx] += 1;
+  }
+  return spd;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type = float>
+Matrix<rows, columns, Type> filledMatrix(uint8_t seed)
+{
+  Matrix<rows, columns, Type> result{};
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      result[row][column] =
+          static_cast<Type>((row * 3 + column * 7 + seed) % 11) / 11 -
+          Type{0.5};
+    }
+  }
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+void requireClose(const Matrix<rows, columns, Type> &result,
+                  const Matrix<rows, columns, Type> &expected, Type margin)
+{
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      REQUIRE_THAT(result.Get(row, column),
+                   Catch::Matchers::WithinAbs(expected.Get(row, column), margin));
+    }
+  }
+}
+
+template <uint8_t size, typename Type>
+bool isSymmetric(const Matrix<size, size, Type> &matrix)
+{
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < row; column++)
+    {
+      if (matrix.Get(row, column) != matrix.Get(column, row))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST_CASE("Kalman Filter", "KalmanFilter")
+{
+  const Matrix<4, 1> state{0.5f, -1.0f, 2.0f, 0.25f};
+  const Matrix<4, 4> covariance{spdMatrix<4>(1)};
+  const Matrix<4, 4> transition{filledMatrix<4, 4>(2)};
+  const Matrix<4, 4> process_noise{spdMatrix<4>(3) * 0.1f};
+  const Matrix<2, 4> observation{filledMatrix<2, 4>(4)};
+  const Matrix<2, 2> measurement_noise{spdMatrix<2>(5) * 0.5f};
+  const Matrix<2, 1> measurement{1.5f, -0.5f};
+
+  SECTION("Construction")
+  {
+    KalmanFilter<4, 2> filter{};
+    for (uint8_t row{0}; row < 4; row++)
+    {
+      REQUIRE(filter.State().Get(row, 0) == 0);
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        REQUIRE(filter.Covariance().Get(row, column) == (row == column ? 1 : 0));
+      }
+    }
+
+    KalmanFilter<4, 2> filter2{state, covariance};
+    requireClose(filter2.State(), state, 0.0f);
+    requireClose(filter2.Covariance(), covariance, 0.0f);
+  }
+
+  SECTION("Predict")
+  {
+    KalmanFilter<4, 2> filter{state, covariance};
+    filter.Predict(transition, process_noise);
+
+    const Matrix<4, 1> expected_state = transition * state;
+    const Matrix<4, 4> expected_covariance =
+        transition * covariance * transition.Transpose() + process_noise;
+    requireClose(filter.State(), expected_state, 1e-5f);
+    requireClose(filter.Covariance(), expected_covariance, 1e-5f);
+    REQUIRE(isSymmetric(filter.Covariance()));
+
+    // the covariance only version leaves the state alone
+    KalmanFilter<4, 2> filter2{state, covariance};
+    filter2.PredictCovariance(transition, process_noise);
+    requireClose(filter2.State(), state, 0.0f);
+    requireClose(filter2.Covariance(), expected_covariance, 1e-5f);
+  }
+
+  SECTION("Update")
+  {
+    KalmanFilter<4, 2> filter{state, covariance};
+    REQUIRE(filter.Update(measurement, observation, measurement_noise));
+
+    // the textbook version with an explicit inverse
+    const Matrix<2, 2> innovation_covariance =
+        observation * covariance * observation.Transpose() + measurement_noise;
+    const Matrix<4, 2> gain = covariance * observation.Transpose() *
+                              innovation_covariance.Invert();
+    const Matrix<2, 1> innovation = measurement - observation * state;
+    const Matrix<4, 1> expected_state = state + gain * innovation;
+    Matrix<4, 4> identity{};
+    identity.Identity();
+    const Matrix<4, 4> joseph = identity - gain * observation;
+    const Matrix<4, 4> expected_covariance =
+        joseph * covariance * joseph.Transpose() +
+        gain * measurement_noise * gain.Transpose();
+
+    requireClose(filter.State(), expected_state, 1e-5f);
+    requireClose(filter.Covariance(), expected_covariance, 1e-5f);
+    REQUIRE(isSymmetric(filter.Covariance()));
+
+    // the same with the innovation passed in
+    KalmanFilter<4, 2> filter2{state, covariance};
+    REQUIRE(filter2.UpdateInnovation(innovation, observation, measurement_noise));
+    requireClose(filter2.State(), expected_state, 1e-5f);
+    requireClose(filter2.Covariance(), expected_covariance, 1e-5f);
+  }
+
+  SECTION("Update Failure")
+  {
+    // a negative definite noise makes the innovation covariance indefinite
+    KalmanFilter<4, 2> filter{state, covariance};
+    const Matrix<2, 2> bad_noise{-100.0f, 0.0f,
+                                 0.0f, -100.0f};
+    REQUIRE_FALSE(filter.Update(measurement, observation, bad_noise));
+    requireClose(filter.State(), state, 0.0f);
+    requireClose(filter.Covariance(), covariance, 0.0f);
+
+    const Matrix<1, 4> row{1.0f, 0.0f, 0.0f, 0.0f};
+    REQUIRE_FALSE(filter.UpdateScalar(1.0f, row, -100.0f));
+    REQUIRE_FALSE(filter.UpdateScalar(1.0f, row, NAN));
+    requireClose(filter.State(), state, 0.0f);
+    requireClose(filter.Covariance(), covariance, 0.0f);
+  }
+
+  SECTION("Sequential Update")
+  {
+    const Matrix<2, 1> noise{0.3f, 0.7f};
+    const Matrix<2, 2> diagonal_noise{0.3f, 0.0f,
+                                      0.0f, 0.7f};
+
+    KalmanFilter<4, 2> batch{state, covariance};
+    REQUIRE(batch.Update(measurement, observation, diagonal_noise));
+
+    KalmanFilter<4, 2> sequential{state, covariance};
+    REQUIRE(sequential.UpdateSequential(measurement, observation, noise));
+
+    requireClose(sequential.State(), batch.State(), 1e-5f);
+    requireClose(sequential.Covariance(), batch.Covariance(), 1e-5f);
+    REQUIRE(isSymmetric(sequential.Covariance()));
+
+    // a single scalar update is the batch update with one measurement
+    KalmanFilter<4, 1> scalar{state, covariance};
+    KalmanFilter<4, 1> single{state, covariance};
+    Matrix<1, 4> row{};
+    observation.GetRow(0, row);
+    const Matrix<1, 1> row_measurement{measurement.Get(0, 0)};
+    const Matrix<1, 1> row_noise{0.3f};
+    REQUIRE(single.Update(row_measurement, row, row_noise));
+    const Matrix<1, 1> predicted = row * state;
+    REQUIRE(scalar.UpdateScalar(measurement.Get(0, 0) - predicted.Get(0, 0),
+                                row, 0.3f));
+    requireClose(scalar.State(), single.State(), 1e-5f);
+    requireClose(scalar.Covariance(), single.Covariance(), 1e-5f);
+  }
+
+  SECTION("Tracking")
+  {
+    // constant velocity in one dimension, measuring the position
+    const float dt{0.1f};
+    const Matrix<2, 2> cv_transition{1.0f, dt,
+                                     0.0f, 1.0f};
+    const Matrix<2, 2> cv_noise{1e-6f, 0.0f,
+                                0.0f, 1e-6f};
+    const Matrix<1, 2> position{1.0f, 0.0f};
+    const Matrix<1, 1> position_noise{0.01f};
+
+    KalmanFilter<2, 1> filter{};
+    Matrix<2, 1> truth{0.0f, 2.0f};
+    for (uint16_t step{0}; step < 200; step++)
+    {
+      truth = cv_transition * truth;
+      filter.Predict(cv_transition, cv_noise);
+      // a deterministic wobble standing in for measurement noise
+      const Matrix<1, 1> z{truth.Get(0, 0) + 0.05f * std::sin(step * 1.7f)};
+      REQUIRE(filter.Update(z, position, position_noise));
+    }
+
+    REQUIRE_THAT(filter.State().Get(0, 0),
+                 Catch::Matchers::WithinAbs(truth.Get(0, 0), 0.05f));
+    REQUIRE_THAT(filter.State().Get(1, 0),
+                 Catch::Matchers::WithinAbs(truth.Get(1, 0), 0.05f));
+    REQUIRE(filter.Covariance().Get(0, 0) > 0);
+    REQUIRE(filter.Covariance().Get(0, 0) < 0.01f);
+    REQUIRE(isSymmetric(filter.Covariance()));
+  }
+
+  SECTION("Large")
+  {
+    const Matrix<24, 1> big_state{filledMatrix<24, 1>(1)};
+    const Matrix<24, 24> big_covariance{spdMatrix<24>(2)};
+    const Matrix<24, 24> big_transition{filledMatrix<24, 24>(3) * 0.2f};
+    const Matrix<24, 24> big_process_noise{spdMatrix<24>(4) * 0.01f};
+    const Matrix<6, 24> big_observation{filledMatrix<6, 24>(5)};
+    const Matrix<6, 6> big_noise{spdMatrix<6>(6)};
+    const Matrix<6, 1> big_measurement{filledMatrix<6, 1>(7)};
+
+    KalmanFilter<24, 6> filter{big_state, big_covariance};
+    filter.Predict(big_transition, big_process_noise);
+    REQUIRE(filter.Update(big_measurement, big_observation, big_noise));
+
+    const Matrix<24, 1> predicted_state = big_transition * big_state;
+    const Matrix<24, 24> predicted =
+        big_transition * big_covariance * big_transition.Transpose() +
+        big_process_noise;
+    const Matrix<6, 6> innovation_covariance =
+        big_observation * predicted * big_observation.Transpose() + big_noise;
+    const Matrix<24, 6> gain = predicted * big_observation.Transpose() *
+                               innovation_covariance.Invert();
+    const Matrix<24, 1> expected_state =
+        predicted_state +
+        gain * (big_measurement - big_observation * predicted_state);
+    Matrix<24, 24> identity{};
+    identity.Identity();
+    const Matrix<24, 24> joseph = identity - gain * big_observation;
+    const Matrix<24, 24> expected_covariance =
+        joseph * predicted * joseph.Transpose() +
+        gain * big_noise * gain.Transpose();
+
+    requireClose(filter.State(), expected_state, 1e-4f);
+    requireClose(filter.Covariance(), expected_covariance, 1e-4f);
+    REQUIRE(isSymmetric(filter.Covariance()));
+  }
+
+  SECTION("Double")
+  {
+    const Matrix<3, 1, double> double_state{1.0, 2.0, 3.0};
+    const Matrix<3, 3, double> double_covariance{spdMatrix<3, double>(1)};
+    const Matrix<3, 3, double> double_transition{filledMatrix<3, 3, double>(2)};
+    const Matrix<3, 3, double> double_process_noise{spdMatrix<3, double>(3)};
+    const Matrix<3, 1, double> double_noise{0.1, 0.2, 0.3};
+    const Matrix<3, 3, double> double_diagonal_noise{0.1, 0.0, 0.0,
+                                                     0.0, 0.2, 0.0,
+                                                     0.0, 0.0, 0.3};
+    const Matrix<3, 3, double> double_observation{filledMatrix<3, 3, double>(4)};
+    const Matrix<3, 1, double> double_measurement{0.5, -0.5, 1.0};
+
+    KalmanFilter<3, 3, double> batch{double_state, double_covariance};
+    batch.Predict(double_transition, double_process_noise);
+    REQUIRE(batch.Update(double_measurement, double_observation,
+                         double_diagonal_noise));
+
+    KalmanFilter<3, 3, double> sequential{double_state, double_covariance};
+    sequential.Predict(double_transition, double_process_noise);
+    REQUIRE(sequential.UpdateSequential(double_measurement, double_observation,
+                                        double_noise));
+
+    requireClose(sequential.State(), batch.State(), 1e-12);
+    requireClose(sequential.Covariance(), batch.Covariance(), 1e-12);
+  }
+}
@@ -0,0 +1,196 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "LU.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <iostream>
+
+// a well conditioned, non-symmetric test matrix
+template <uint8_t size>
+Matrix<size, size> testMatrix()
+{
+  Matrix<size, size> matrix{};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      matrix[row][column] =
+          static_cast<float>((row * 3 + column * 7) % 5) - 2;
+    }
+    matrix[row][row] += size;
+  }
+  return matrix;
+}
+
+TEST_CASE("LU Decomposition", "LU")
+{
+  Matrix<3, 3> mat1{2, 1, 1,
+                    4, -6, 0,
+                    -2, 7, 2};
+
+  SECTION("Factorization")
+  {
+    LU<3> lu{mat1};
+    REQUIRE_FALSE(lu.IsSingular());
+
+    // rebuild PA from the packed factors and compare it against A
+    Matrix<3, 3> lower{};
+    Matrix<3, 3> upper{};
+    lower.Identity();
+    upper.Fill(0);
+    for (uint8_t row{0}; row < 3; row++)
+    {
+      for (uint8_t column{0}; column < 3; column++)
+      {
+        if (column < row)
+        {
+          lower[row][column] = lu.GetFactors().Get(row, column);
+        }
+        else
+        {
+          upper[row][column] = lu.GetFactors().Get(row, column);
+        }
+      }
+    }
+    Matrix<3, 3> product = lower * upper;
+    for (uint8_t row{0}; row < 3; row++)
+    {
+      for (uint8_t column{0}; column < 3; column++)
+      {
+        REQUIRE_THAT(product.Get(row, column),
+                     Catch::Matchers::WithinAbs(
+                         mat1.Get(lu.GetPermutation()[row], column), 1e-6f));
+      }
+    }
+  }
+
+  SECTION("Determinant")
+  {
+    LU<3> lu{mat1};
+    REQUIRE_THAT(lu.Det(), Catch::Matchers::WithinRel(-16.0f, 1e-6f));
+    REQUIRE_THAT(lu.Det(), Catch::Matchers::WithinRel(mat1.Det(), 1e-6f));
+
+    // big enough for Matrix::Det to use LU on its own
+    Matrix<5, 5> mat2{};
+    mat2.Fill(0);
+    for (uint8_t idx{0}; idx < 5; idx++)
+    {
+      mat2[idx][idx] = idx + 1;
+    }
+    mat2[0][4] = 3;
+    REQUIRE_THAT(mat2.Det(), Catch::Matchers::WithinRel(120.0f, 1e-6f));
+  }
+
+  SECTION("Solve")
+  {
+    LU<3> lu{mat1};
+    Matrix<3, 1> rhs{5, -2, 9};
+    Matrix<3, 1> x{};
+    lu.Solve(rhs, x);
+    REQUIRE_THAT(x.Get(0, 0), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    REQUIRE_THAT(x.Get(1, 0), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    REQUIRE_THAT(x.Get(2, 0), Catch::Matchers::WithinRel(2.0f, 1e-5f));
+
+    // several right hand sides at once, solved in place
+    Matrix<3, 2> rhs2{5, 4,
+                      -2, -2,
+                      9, 7};
+    lu.Solve(rhs2, rhs2);
+    REQUIRE_THAT(rhs2.Get(0, 0), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    REQUIRE_THAT(rhs2.Get(1, 0), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    REQUIRE_THAT(rhs2.Get(2, 0), Catch::Matchers::WithinRel(2.0f, 1e-5f));
+    REQUIRE_THAT(rhs2.Get(0, 1), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    REQUIRE_THAT(rhs2.Get(1, 1), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+    REQUIRE_THAT(rhs2.Get(2, 1), Catch::Matchers::WithinRel(1.0f, 1e-5f));
+  }
+
+  SECTION("Invert")
+  {
+    Matrix<9, 9> mat2{testMatrix<9>()};
+    Matrix<9, 9> inverse{mat2.Invert()};
+    Matrix<9, 9> identity = mat2 * inverse;
+    for (uint8_t row{0}; row < 9; row++)
+    {
+      for (uint8_t column{0}; column < 9; column++)
+      {
+        REQUIRE_THAT(identity.Get(row, column),
+                     Catch::Matchers::WithinAbs(row == column ? 1 : 0, 1e-5f));
+      }
+    }
+
+    Matrix<15, 15> mat3{testMatrix<15>()};
+    Matrix<15, 15> inverse3{};
+    LU<15>{mat3}.Invert(inverse3);
+    Matrix<15, 15> identity3 = inverse3 * mat3;
+    for (uint8_t row{0}; row < 15; row++)
+    {
+      for (uint8_t column{0}; column < 15; column++)
+      {
+        REQUIRE_THAT(identity3.Get(row, column),
+                     Catch::Matchers::WithinAbs(row == column ? 1 : 0, 1e-5f));
+      }
+    }
+  }
+
+  SECTION("Mixed Scale")
+  {
+    // a covariance of states in very different units, position in metres
+    // and attitude in radians. Nothing is near singular relative to its own
+    // row even though the small block is far below the big one.
+    Matrix<6, 6> covariance{};
+    for (uint8_t idx{0}; idx < 3; idx++)
+    {
+      covariance[idx][idx] = 100;
+      covariance[idx + 3][idx + 3] = 1e-5f;
+    }
+    covariance[0][1] = covariance[1][0] = 20;
+    covariance[3][4] = covariance[4][3] = 2e-6f;
+
+    LU<6> lu{};
+    REQUIRE(lu.Compute(covariance));
+    REQUIRE_FALSE(lu.IsSingular());
+    const float expected_det{(100.0f * 100 - 20 * 20) * 100 *
+                             (1e-5f * 1e-5f - 2e-6f * 2e-6f) * 1e-5f};
+    REQUIRE_THAT(lu.Det(), Catch::Matchers::WithinRel(expected_det, 1e-4f));
+    REQUIRE_THAT(covariance.Det(),
+                 Catch::Matchers::WithinRel(expected_det, 1e-4f));
+
+    const Matrix<6, 6> product{covariance * covariance.Invert()};
+    for (uint8_t row{0}; row < 6; row++)
+    {
+      for (uint8_t column{0}; column < 6; column++)
+      {
+        REQUIRE_THAT(product.Get(row, column),
+                     Catch::Matchers::WithinAbs(row == column ? 1 : 0, 1e-5f));
+      }
+    }
+  }
+
+  SECTION("Singular")
+  {
+    Matrix<4, 4> mat2{1, 2, 3, 4,
+                      2, 4, 6, 8,
+                      0, 1, 0, 1,
+                      5, 1, 2, 3};
+    LU<4> lu{};
+    REQUIRE_FALSE(lu.Compute(mat2));
+    REQUIRE(lu.IsSingular());
+    REQUIRE(lu.Det() == 0);
+    REQUIRE(mat2.Det() == 0);
+
+    Matrix<4, 4> inverse{mat2.Invert()};
+    for (uint8_t row{0}; row < 4; row++)
+    {
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        REQUIRE(inverse.Get(row, column) == 0);
+      }
+    }
+  }
+}
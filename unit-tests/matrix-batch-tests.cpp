@@ -0,0 +1,290 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Cholesky.hpp"
+#include "Matrix.hpp"
+#include "MatrixBatch.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <iostream>
+
+// a different, well conditioned matrix for every seed
+template <uint8_t rows, uint8_t columns, typename Type = float>
+Matrix<rows, columns, Type> seededMatrix(size_t seed)
+{
+  Matrix<rows, columns, Type> result{};
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      result[row][column] =
+          static_cast<Type>((row * 5 + column * 3 + seed * 7) % 11) / 4 - 1;
+    }
+    if (rows == columns)
+    {
+      result[row][row] += 4;
+    }
+  }
+  return result;
+}
+
+template <uint8_t rows, uint8_t columns, typename Type>
+void requireClose(const Matrix<rows, columns, Type> &result,
+                  const Matrix<rows, columns, Type> &expected, Type margin)
+{
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      REQUIRE_THAT(result.Get(row, column),
+                   Catch::Matchers::WithinAbs(expected.Get(row, column),
+                                              margin));
+    }
+  }
+}
+
+// every batched operation of a square size against Matrix, one matrix at a
+// time. count isn't a multiple of the chunk size so the short last chunk gets
+// checked too.
+template <uint8_t size, typename Type>
+void checkSquareBatch(Type margin)
+{
+  constexpr size_t count{45};
+  static std::array<Matrix<size, size, Type>, count> a{};
+  static std::array<Matrix<size, size, Type>, count> b{};
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    a[idx] = seededMatrix<size, size, Type>(idx);
+    b[idx] = seededMatrix<size, size, Type>(idx + 3);
+  }
+
+  static MatrixBatch<count, size, size, Type> batch_a{a.data()};
+  static MatrixBatch<count, size, size, Type> batch_b{b.data()};
+  static MatrixBatch<count, size, size, Type> result{};
+  std::array<Type, count> determinants{};
+
+  batch_a.Mult(batch_b, result);
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    requireClose(result.Get(idx), Matrix<size, size, Type>{a[idx] * b[idx]},
+                 margin);
+  }
+
+  batch_a.Transpose(result);
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    requireClose(result.Get(idx), a[idx].Transpose(), Type{0});
+  }
+
+  batch_a.Det(determinants);
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    REQUIRE_THAT(determinants[idx],
+                 Catch::Matchers::WithinRel(a[idx].Det(), margin));
+  }
+
+  batch_a.Invert(result);
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    requireClose(result.Get(idx), a[idx].Invert(), margin);
+  }
+
+  // symmetric positive definite matrices as A * A^T + I
+  static MatrixBatch<count, size, size, Type> spd{};
+  batch_a.Transpose(result);
+  batch_a.Mult(result, spd);
+  for (uint8_t idx{0}; idx < size; idx++)
+  {
+    Type *diagonal{spd.Lanes(idx, idx)};
+    for (size_t lane{0}; lane < count; lane++)
+    {
+      diagonal[lane] += 1;
+    }
+  }
+  REQUIRE(spd.Cholesky(result));
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    Matrix<size, size, Type> expected{spd.Get(idx)};
+    REQUIRE(LLT<size, Type>::FactorInPlace(expected));
+    requireClose(result.Get(idx), expected, margin);
+  }
+}
+
+TEST_CASE("Matrix Batch", "MatrixBatch")
+{
+  SECTION("Load and Store")
+  {
+    std::array<Matrix<2, 3>, 5> matrices{};
+    for (size_t idx{0}; idx < matrices.size(); idx++)
+    {
+      matrices[idx] = seededMatrix<2, 3>(idx);
+    }
+
+    MatrixBatch<5, 2, 3> batch{matrices.data()};
+    REQUIRE(batch.Size() == 5);
+
+    // element major, matrix minor
+    for (size_t idx{0}; idx < matrices.size(); idx++)
+    {
+      REQUIRE(batch.Lanes(0, 0)[idx] == matrices[idx].Get(0, 0));
+      REQUIRE(batch.Lanes(1, 2)[idx] == matrices[idx].Get(1, 2));
+    }
+    REQUIRE(batch.Lanes(1, 0) - batch.Lanes(0, 0) == 15);
+
+    std::array<Matrix<2, 3>, 5> stored{};
+    batch.Store(stored.data());
+    for (size_t idx{0}; idx < matrices.size(); idx++)
+    {
+      requireClose(stored[idx], matrices[idx], 0.0f);
+      requireClose(batch.Get(idx), matrices[idx], 0.0f);
+    }
+
+    batch.Set(3, Matrix<2, 3>{1, 2, 3, 4, 5, 6});
+    REQUIRE(batch.Get(3).Get(1, 1) == 5);
+    REQUIRE(batch.Get(2).Get(1, 1) == matrices[2].Get(1, 1));
+
+    MatrixBatch<5, 2, 3> filled{2.5f};
+    REQUIRE(filled.Get(4).Get(1, 2) == 2.5f);
+  }
+
+  SECTION("Add and Sub")
+  {
+    std::array<Matrix<3, 3>, 7> a{};
+    std::array<Matrix<3, 3>, 7> b{};
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      a[idx] = seededMatrix<3, 3>(idx);
+      b[idx] = seededMatrix<3, 3>(idx * 2 + 1);
+    }
+    MatrixBatch<7, 3, 3> batch_a{a.data()};
+    MatrixBatch<7, 3, 3> batch_b{b.data()};
+    MatrixBatch<7, 3, 3> result{};
+
+    batch_a.Add(batch_b, result);
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      requireClose(result.Get(idx), Matrix<3, 3>{a[idx] + b[idx]}, 0.0f);
+    }
+
+    // in place
+    batch_a.Sub(batch_b, batch_a);
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      requireClose(batch_a.Get(idx), Matrix<3, 3>{a[idx] - b[idx]}, 0.0f);
+    }
+  }
+
+  SECTION("Non-Square")
+  {
+    std::array<Matrix<2, 3>, 40> a{};
+    std::array<Matrix<3, 4>, 40> b{};
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      a[idx] = seededMatrix<2, 3>(idx);
+      b[idx] = seededMatrix<3, 4>(idx + 1);
+    }
+    MatrixBatch<40, 2, 3> batch_a{a.data()};
+    MatrixBatch<40, 3, 4> batch_b{b.data()};
+    MatrixBatch<40, 2, 4> product{};
+    MatrixBatch<40, 3, 2> transposed{};
+
+    batch_a.Mult(batch_b, product);
+    batch_a.Transpose(transposed);
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      requireClose(product.Get(idx), Matrix<2, 4>{a[idx] * b[idx]}, 1e-5f);
+      requireClose(transposed.Get(idx), a[idx].Transpose(), 0.0f);
+    }
+  }
+
+  SECTION("Aliasing")
+  {
+    std::array<Matrix<3, 3>, 9> a{};
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      a[idx] = seededMatrix<3, 3>(idx);
+    }
+    MatrixBatch<9, 3, 3> batch{a.data()};
+
+    batch.Mult(batch, batch);
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      requireClose(batch.Get(idx), Matrix<3, 3>{a[idx] * a[idx]}, 1e-4f);
+    }
+
+    batch.Load(a.data());
+    batch.Transpose(batch);
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      requireClose(batch.Get(idx), a[idx].Transpose(), 0.0f);
+    }
+
+    batch.Load(a.data());
+    batch.Invert(batch);
+    for (size_t idx{0}; idx < a.size(); idx++)
+    {
+      requireClose(batch.Get(idx), a[idx].Invert(), 1e-5f);
+    }
+  }
+
+  SECTION("Square Sizes")
+  {
+    checkSquareBatch<2, float>(1e-5f);
+    checkSquareBatch<3, float>(1e-5f);
+    checkSquareBatch<4, float>(1e-5f);
+    checkSquareBatch<2, double>(1e-12);
+    checkSquareBatch<3, double>(1e-12);
+    checkSquareBatch<4, double>(1e-12);
+  }
+
+  SECTION("Cholesky")
+  {
+    // 6x6 covariances, one of them not positive definite
+    std::array<Matrix<6, 6>, 33> covariances{};
+    for (size_t idx{0}; idx < covariances.size(); idx++)
+    {
+      const Matrix<6, 6> a{seededMatrix<6, 6>(idx)};
+      covariances[idx] = a * a.Transpose();
+    }
+    covariances[20][2][2] = -1;
+
+    MatrixBatch<33, 6, 6> batch{covariances.data()};
+    MatrixBatch<33, 6, 6> factor{};
+    REQUIRE_FALSE(batch.Cholesky(factor));
+
+    for (size_t idx{0}; idx < covariances.size(); idx++)
+    {
+      Matrix<6, 6> expected{covariances[idx]};
+      if (idx == 20)
+      {
+        REQUIRE_FALSE(LLT<6>::FactorInPlace(expected));
+        requireClose(factor.Get(idx), Matrix<6, 6>{0.0f}, 0.0f);
+      }
+      else
+      {
+        REQUIRE(LLT<6>::FactorInPlace(expected));
+        requireClose(factor.Get(idx), expected, 1e-4f);
+      }
+    }
+  }
+
+  SECTION("Singular")
+  {
+    std::array<Matrix<4, 4>, 3> a{seededMatrix<4, 4>(0), Matrix<4, 4>{0.0f},
+                                  seededMatrix<4, 4>(2)};
+    MatrixBatch<3, 4, 4> batch{a.data()};
+    MatrixBatch<3, 4, 4> inverse{};
+    std::array<float, 3> determinants{};
+
+    batch.Det(determinants);
+    batch.Invert(inverse);
+    REQUIRE(determinants[1] == 0);
+    requireClose(inverse.Get(1), Matrix<4, 4>{0.0f}, 0.0f);
+    requireClose(inverse.Get(0), a[0].Invert(), 1e-5f);
+    requireClose(inverse.Get(2), a[2].Invert(), 1e-5f);
+  }
+}
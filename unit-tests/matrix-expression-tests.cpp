@@ -0,0 +1,191 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Matrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <iostream>
+
+// this file is built with MATRIX_EXPRESSION_TEMPLATES defined
+
+template <uint8_t rows, uint8_t columns>
+Matrix<rows, columns> testMatrix(float offset)
+{
+  Matrix<rows, columns> matrix{};
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      matrix[row][column] =
+          static_cast<float>((row * 3 + column * 7) % 5) - 2 + offset;
+    }
+  }
+  return matrix;
+}
+
+template <uint8_t rows, uint8_t columns>
+void requireEqual(const Matrix<rows, columns> &actual,
+                  const Matrix<rows, columns> &expected)
+{
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      REQUIRE_THAT(actual.Get(row, column),
+                   Catch::Matchers::WithinAbs(expected.Get(row, column), 1e-4));
+    }
+  }
+}
+
+TEST_CASE("Matrix Expressions", "Matrix Expressions")
+{
+  Matrix<3, 3> mat1{1, 2, 3,
+                    4, 5, 6,
+                    7, 8, 9};
+  Matrix<3, 3> mat2{9, 8, 7,
+                    6, 5, 4,
+                    3, 2, 1};
+  Matrix<3, 3> mat3{0.5, 1, 1.5,
+                    2, 2.5, 3,
+                    3.5, 4, 4.5};
+
+  SECTION("Element-wise")
+  {
+    Matrix<3, 3> expected{};
+    Matrix<3, 3> scaled{};
+    mat1.Add(mat2, expected);
+    expected.Sub(mat3, expected);
+    mat2.Mult(2.0f, scaled);
+    expected.Add(scaled, expected);
+
+    Matrix<3, 3> result{mat1 + mat2 - mat3 + mat2 * 2};
+    requireEqual(result, expected);
+
+    result = mat1 + mat2 - mat3 + 2 * mat2;
+    requireEqual(result, expected);
+
+    REQUIRE((mat1 - mat2).Get(0, 0) == -8);
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE((mat1 - mat2).Get(3, 0) == 1e+10);
+    }
+  }
+
+  SECTION("Products")
+  {
+    Matrix<3, 3> expected{};
+    Matrix<3, 3> product{};
+    mat1.Mult(mat2, product);
+    product.Mult(mat3, expected);
+
+    Matrix<3, 3> result{mat1 * mat2 * mat3};
+    requireEqual(result, expected);
+
+    // a product of a sum evaluates the sum once before multiplying
+    Matrix<3, 3> sum{};
+    mat1.Add(mat2, sum);
+    sum.Mult(mat3, expected);
+    result = (mat1 + mat2) * mat3;
+    requireEqual(result, expected);
+  }
+
+  SECTION("Non-square")
+  {
+    Matrix<2, 3> left{testMatrix<2, 3>(0)};
+    Matrix<3, 4> right{testMatrix<3, 4>(1)};
+    Matrix<2, 4> offset{testMatrix<2, 4>(0.5)};
+
+    Matrix<2, 4> expected{};
+    left.Mult(right, expected);
+    expected.Add(offset, expected);
+
+    Matrix<2, 4> result = left * right + offset;
+    requireEqual(result, expected);
+  }
+
+  SECTION("Covariance Update")
+  {
+    // P = F * P * F^T + Q * dt
+    Matrix<6, 6> F{};
+    F.Identity();
+    for (uint8_t idx{0}; idx < 3; idx++)
+    {
+      F[idx][idx + 3] = 0.01f;
+    }
+    Matrix<6, 6> Ft{F.Transpose()};
+    Matrix<6, 6> P{testMatrix<6, 6>(3)};
+    Matrix<6, 6> Q{testMatrix<6, 6>(-1)};
+    const float dt{0.01f};
+
+    Matrix<6, 6> temp{};
+    Matrix<6, 6> expected{};
+    Matrix<6, 6> scaled{};
+    F.Mult(P, temp);
+    temp.Mult(Ft, expected);
+    Q.Mult(dt, scaled);
+    expected.Add(scaled, expected);
+
+    // P appears on both sides
+    P = F * P * Ft + Q * dt;
+    requireEqual(P, expected);
+  }
+
+  SECTION("Aliasing")
+  {
+    Matrix<3, 3> expected{};
+    mat1.Add(mat1, expected);
+    expected.Sub(mat2, expected);
+
+    mat1 = mat1 + mat1 - mat2;
+    requireEqual(mat1, expected);
+
+    mat1.Mult(mat2, expected);
+    mat1 = mat1 * mat2;
+    requireEqual(mat1, expected);
+
+    // transposes read other elements of the matrix they're assigned to
+    Matrix<3, 3> transposed{mat1.Transpose()};
+    transposed.Add(mat1, expected);
+    mat1 = mat1 + mat1.Transposed();
+    requireEqual(mat1, expected);
+  }
+
+  SECTION("Compound Assignment")
+  {
+    Matrix<3, 3> expected{mat1};
+    Matrix<3, 3> product{};
+    mat1.Mult(mat2, product);
+    expected.Add(product, expected);
+    Matrix<3, 3> scaled{};
+    mat2.Mult(2.0f, scaled);
+    expected.Sub(scaled, expected);
+
+    mat1 += mat1 * mat2;
+    mat1 -= mat2 * 2.0f;
+    requireEqual(mat1, expected);
+
+    Matrix<3, 3> transposed{mat1.Transpose()};
+    expected.Sub(transposed, expected);
+    mat1 -= mat1.Transposed();
+    requireEqual(mat1, expected);
+  }
+
+  SECTION("Large")
+  {
+    Matrix<20, 20> mat4{testMatrix<20, 20>(0)};
+    Matrix<20, 20> mat5{testMatrix<20, 20>(2)};
+
+    Matrix<20, 20> expected{};
+    Matrix<20, 20> scaled{};
+    mat4.Mult(mat5, expected);
+    mat4.Mult(0.5f, scaled);
+    expected.Sub(scaled, expected);
+
+    Matrix<20, 20> result{mat4 * mat5 - mat4 * 0.5f};
+    requireEqual(result, expected);
+  }
+}
@@ -10,6 +10,99 @@
 #include <cmath>
 #include <iostream>
 
+// compare the closed forms of one size against the general paths
+template <uint8_t size, typename Type>
+void checkClosedForms(Type margin)
+{
+  Matrix<size, size, Type> a{};
+  Matrix<size, size, Type> b{};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      a[row][column] = static_cast<Type>((row * 5 + column * 3) % 7) - 3;
+      b[row][column] = static_cast<Type>((row * 2 + column * 5) % 9) / 4;
+    }
+    a[row][row] += 5;
+  }
+
+  // the product against a plain triple loop
+  Matrix<size, size, Type> product{};
+  a.Mult(b, product);
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      Type expected{0};
+      for (uint8_t idx{0}; idx < size; idx++)
+      {
+        expected += a.Get(row, idx) * b.Get(idx, column);
+      }
+      REQUIRE_THAT(product.Get(row, column),
+                   Catch::Matchers::WithinAbs(expected, margin));
+    }
+  }
+
+  // the operands are read before anything is written, so aliasing is fine
+  Matrix<size, size, Type> squared{a};
+  squared.Mult(squared, squared);
+  Matrix<size, size, Type> expected_squared{};
+  a.Mult(a, expected_squared);
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      REQUIRE(squared.Get(row, column) == expected_squared.Get(row, column));
+    }
+  }
+
+  const Matrix<size, size, Type> transposed{a.Transpose()};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      REQUIRE(transposed.Get(row, column) == a.Get(column, row));
+    }
+  }
+
+  // the determinant and inverse against LU
+  const LU<size, Type> lu{a};
+  REQUIRE_THAT(a.Det(), Catch::Matchers::WithinRel(lu.Det(), margin));
+
+  const Matrix<size, size, Type> inverse{a.Invert()};
+  Matrix<size, size, Type> expected_inverse{};
+  lu.Invert(expected_inverse);
+  Matrix<size, size, Type> identity{};
+  inverse.Mult(a, identity);
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      REQUIRE_THAT(inverse.Get(row, column),
+                   Catch::Matchers::WithinAbs(
+                       expected_inverse.Get(row, column), margin));
+      REQUIRE_THAT(identity.Get(row, column),
+                   Catch::Matchers::WithinAbs(row == column ? 1 : 0, margin));
+    }
+  }
+
+  // a singular matrix has a zero determinant and inverts to all zeros
+  Matrix<size, size, Type> singular{a};
+  for (uint8_t column{0}; column < size; column++)
+  {
+    singular[size - 1][column] = singular.Get(0, column);
+  }
+  REQUIRE(singular.Det() == 0);
+  const Matrix<size, size, Type> singular_inverse{singular.Invert()};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      REQUIRE(singular_inverse.Get(row, column) == 0);
+    }
+  }
+}
+
 TEST_CASE("Elementary Matrix Operations", "Matrix")
 {
   std::array<float, 4> arr2{5, 6, 7, 8};
@@ -128,7 +221,65 @@ TEST_CASE("Elementary Matrix Operations", "Matrix")
     REQUIRE(mat3.Get(1, 0) == 43);
     REQUIRE(mat3.Get(1, 1) == 50);
 
-    // TODO: You need to add non-square multiplications to this.
+    // non-square multiplication
+    Matrix<2, 3> mat4{1, 2, 3, 4, 5, 6};
+    Matrix<3, 4> mat5{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    Matrix<2, 4> mat6{};
+    mat4.Mult(mat5, mat6);
+    REQUIRE(mat6.Get(0, 0) == 38);
+    REQUIRE(mat6.Get(0, 1) == 44);
+    REQUIRE(mat6.Get(0, 2) == 50);
+    REQUIRE(mat6.Get(0, 3) == 56);
+    REQUIRE(mat6.Get(1, 0) == 83);
+    REQUIRE(mat6.Get(1, 1) == 98);
+    REQUIRE(mat6.Get(1, 2) == 113);
+    REQUIRE(mat6.Get(1, 3) == 128);
+
+    Matrix<3, 1> mat7{1, 2, 3};
+    Matrix<1, 3> mat8{4, 5, 6};
+    Matrix<3, 3> outer = mat7 * mat8;
+    REQUIRE(outer.Get(0, 0) == 4);
+    REQUIRE(outer.Get(1, 1) == 10);
+    REQUIRE(outer.Get(2, 2) == 18);
+    REQUIRE(outer.Get(2, 0) == 12);
+    Matrix<1, 1> inner = mat8 * mat7;
+    REQUIRE(inner.Get(0, 0) == 32);
+  }
+
+  SECTION("Large Multiplication")
+  {
+    // big enough to go through the blocked kernel with ragged edges on every
+    // dimension
+    Matrix<67, 131> mat4{};
+    Matrix<131, 45> mat5{};
+    for (uint8_t row{0}; row < 67; row++)
+    {
+      for (uint8_t column{0}; column < 131; column++)
+      {
+        mat4[row][column] = static_cast<float>((row * 7 + column * 3) % 11) - 5;
+      }
+    }
+    for (uint8_t row{0}; row < 131; row++)
+    {
+      for (uint8_t column{0}; column < 45; column++)
+      {
+        mat5[row][column] = static_cast<float>((row * 5 + column * 13) % 9) - 4;
+      }
+    }
+
+    Matrix<67, 45> mat6 = mat4 * mat5;
+    for (uint8_t row{0}; row < 67; row++)
+    {
+      for (uint8_t column{0}; column < 45; column++)
+      {
+        float expected{0};
+        for (uint8_t inner{0}; inner < 131; inner++)
+        {
+          expected += mat4.Get(row, inner) * mat5.Get(inner, column);
+        }
+        REQUIRE(mat6.Get(row, column) == expected);
+      }
+    }
   }
 
   SECTION("Scalar Multiplication")
@@ -141,6 +292,88 @@ TEST_CASE("Elementary Matrix Operations", "Matrix")
     REQUIRE(mat3.Get(1, 1) == 8);
   }
 
+  SECTION("Compound Assignment")
+  {
+    mat1 += mat2;
+    REQUIRE(mat1.Get(0, 0) == 6);
+    REQUIRE(mat1.Get(1, 1) == 12);
+    mat1 -= mat2;
+    REQUIRE(mat1.Get(0, 1) == 2);
+    REQUIRE(mat1.Get(1, 0) == 3);
+    mat1 *= 2;
+    REQUIRE(mat1.Get(0, 0) == 2);
+    REQUIRE(mat1.Get(1, 1) == 8);
+
+    // in place product, with another matrix and with itself
+    mat1 *= mat2;
+    REQUIRE(mat1.Get(0, 0) == 38);
+    REQUIRE(mat1.Get(0, 1) == 44);
+    REQUIRE(mat1.Get(1, 0) == 86);
+    REQUIRE(mat1.Get(1, 1) == 100);
+    mat2 *= mat2;
+    REQUIRE(mat2.Get(0, 0) == 67);
+    REQUIRE(mat2.Get(0, 1) == 78);
+    REQUIRE(mat2.Get(1, 0) == 91);
+    REQUIRE(mat2.Get(1, 1) == 106);
+
+    Matrix<2, 3> mat4{1, 2, 3, 4, 5, 6};
+    Matrix<3, 3> mat5{1, 0, 1, 0, 1, 0, 1, 0, 1};
+    mat4 *= mat5;
+    REQUIRE(mat4.Get(0, 0) == 4);
+    REQUIRE(mat4.Get(0, 1) == 2);
+    REQUIRE(mat4.Get(0, 2) == 4);
+    REQUIRE(mat4.Get(1, 0) == 10);
+    REQUIRE(mat4.Get(1, 1) == 5);
+    REQUIRE(mat4.Get(1, 2) == 10);
+
+    // big enough for the blocked kernel
+    Matrix<20, 20> mat6{};
+    Matrix<20, 20> mat7{};
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 20; column++)
+      {
+        mat6[row][column] = static_cast<float>((row * 7 + column * 3) % 11) - 5;
+        mat7[row][column] = static_cast<float>((row * 5 + column * 13) % 9) - 4;
+      }
+    }
+    Matrix<20, 20> product{};
+    mat6.Mult(mat7, product);
+    Matrix<20, 20> square{};
+    product.Mult(product, square);
+    mat6 *= mat7;
+    mat6 *= mat6;
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 20; column++)
+      {
+        REQUIRE(mat6.Get(row, column) == square.Get(row, column));
+      }
+    }
+  }
+
+  SECTION("Bounds Checks")
+  {
+    // in range accesses behave the same under every policy
+    REQUIRE(BoundsCheck::Accept(true));
+    REQUIRE(mat1.Get(1, 1) == 4);
+    REQUIRE(mat1[1][0] == 3);
+    Matrix<2, 1> column{};
+    mat1.GetColumn(1, column);
+    REQUIRE(column.Get(1, 0) == 4);
+
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE_FALSE(BoundsCheck::Accept(false));
+      REQUIRE(mat1.Get(0, 2) == 1e+10);
+      // rows out of range fall back to the first row
+      REQUIRE(mat1[2][1] == 2);
+      mat1.GetColumn(2, column);
+      REQUIRE(column.Get(0, 0) == 1e+10);
+      REQUIRE(column.Get(1, 0) == 1e+10);
+    }
+  }
+
   SECTION("Element Multiply")
   {
     mat1.ElementMultiply(mat2, mat3);
@@ -269,6 +502,13 @@ TEST_CASE("Elementary Matrix Operations", "Matrix")
     REQUIRE(mat5.Get(1, 1) == 5);
     REQUIRE(mat5.Get(2, 0) == 3);
     REQUIRE(mat5.Get(2, 1) == 6);
+
+    // transpose a matrix into itself
+    mat1 = mat1.Transposed();
+    REQUIRE(mat1.Get(0, 0) == 1);
+    REQUIRE(mat1.Get(0, 1) == 3);
+    REQUIRE(mat1.Get(1, 0) == 2);
+    REQUIRE(mat1.Get(1, 1) == 4);
   }
 
   SECTION("Normalize")
@@ -381,144 +621,30 @@ TEST_CASE("Elementary Matrix Operations", "Matrix")
     REQUIRE(mat4.Get(0, 1) == 11);
     REQUIRE(mat4.Get(0, 2) == 12);
   }
-}
 
-// basically re-run all of the previous tests with huge matrices and time the
-// results.
-TEST_CASE("Timing Tests", "Matrix")
-{
-  std::array<float, 50 * 50> arr1{};
-  for (uint16_t i{0}; i < 50 * 50; i++)
-  {
-    arr1[i] = i;
-  }
-  std::array<float, 50 * 50> arr2{5, 6, 7, 8};
-  for (uint16_t i{50 * 50}; i < 2 * 50 * 50; i++)
-  {
-    arr2[i] = i;
+  SECTION("Closed Forms")
+  {
+    checkClosedForms<2, float>(1e-5f);
+    checkClosedForms<3, float>(1e-5f);
+    checkClosedForms<4, float>(1e-5f);
+    checkClosedForms<2, double>(1e-12);
+    checkClosedForms<3, double>(1e-12);
+    checkClosedForms<4, double>(1e-12);
+
+    // the 4x4 determinant and inverse against hand worked values
+    Matrix<4, 4> mat4{2, 0, 0, 1,
+                      0, 3, 0, 0,
+                      0, 0, 4, 0,
+                      1, 0, 0, 1};
+    REQUIRE_THAT(mat4.Det(), Catch::Matchers::WithinRel(12.0F, 1e-6f));
+    Matrix<4, 4> mat5{mat4.Invert()};
+    REQUIRE_THAT(mat5.Get(0, 0), Catch::Matchers::WithinRel(1.0F, 1e-6f));
+    REQUIRE_THAT(mat5.Get(0, 3), Catch::Matchers::WithinRel(-1.0F, 1e-6f));
+    REQUIRE_THAT(mat5.Get(1, 1), Catch::Matchers::WithinRel(1.0F / 3, 1e-6f));
+    REQUIRE_THAT(mat5.Get(2, 2), Catch::Matchers::WithinRel(0.25F, 1e-6f));
+    REQUIRE_THAT(mat5.Get(3, 0), Catch::Matchers::WithinRel(-1.0F, 1e-6f));
+    REQUIRE_THAT(mat5.Get(3, 3), Catch::Matchers::WithinRel(2.0F, 1e-6f));
+    REQUIRE(mat5.Get(0, 1) == 0);
+    REQUIRE(mat5.Get(1, 0) == 0);
   }
-  Matrix<50, 50> mat1{arr1};
-  Matrix<50, 50> mat2{arr2};
-  Matrix<50, 50> mat3{};
-
-  // A smaller matrix to use for really badly optimized operations
-  Matrix<4, 4> mat4{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
-  Matrix<4, 4> mat5{};
-
-  SECTION("Addition")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat3 = mat1 + mat2;
-    }
-  }
-
-  SECTION("Subtraction")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat3 = mat1 - mat2;
-    }
-  }
-
-  SECTION("Multiplication")
-  {
-    for (uint32_t i{0}; i < 1000; i++)
-    {
-      mat3 = mat1 * mat2;
-    }
-  }
-
-  SECTION("Scalar Multiplication")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat3 = mat1 * 3;
-    }
-  }
-
-  SECTION("Element Multiply")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat1.ElementMultiply(mat2, mat3);
-    }
-  }
-
-  SECTION("Element Divide")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat1.ElementDivide(mat2, mat3);
-    }
-  }
-
-  SECTION("Minor Matrix")
-  {
-    // what about matrices of 0,0 or 1,1?
-    // minor matrix for 2x2 matrix
-    Matrix<49, 49> minorMat1{};
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat1.MinorMatrix(minorMat1, 0, 0);
-    }
-  }
-
-  SECTION("Determinant")
-  {
-    for (uint32_t i{0}; i < 100000; i++)
-    {
-      float det1 = mat4.Det();
-    }
-  }
-
-  SECTION("Matrix of Minors")
-  {
-    for (uint32_t i{0}; i < 100000; i++)
-    {
-      mat4.MatrixOfMinors(mat5);
-    }
-  }
-
-  SECTION("Invert")
-  {
-    for (uint32_t i{0}; i < 100000; i++)
-    {
-      mat5 = mat4.Invert();
-    }
-  };
-
-  SECTION("Transpose")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat3 = mat1.Transpose();
-    }
-  }
-
-  SECTION("Normalize")
-  {
-    for (uint32_t i{0}; i < 10000; i++)
-    {
-      mat1.Normalize(mat3);
-    }
-  }
-
-  SECTION("GET ROW")
-  {
-    Matrix<1, 50> mat1Rows{};
-    for (uint32_t i{0}; i < 1000000; i++)
-    {
-      mat1.GetRow(0, mat1Rows);
-    }
-  }
-
-  SECTION("GET COLUMN")
-  {
-    Matrix<50, 1> mat1Columns{};
-    for (uint32_t i{0}; i < 1000000; i++)
-    {
-      mat1.GetColumn(0, mat1Columns);
-    }
-  }
-}
\ No newline at end of file
+}
@@ -0,0 +1,299 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Cholesky.hpp"
+#include "LU.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+static_assert(std::is_same<MatrixOf<double, 2, 3>, Matrix<2, 3, double>>::value,
+              "MatrixOf should only reorder the parameters");
+static_assert(std::is_same<Matrix<2, 3>, Matrix<2, 3, float>>::value,
+              "The element type should default to float");
+
+// a well conditioned, non-symmetric test matrix
+template <uint8_t size, typename Type>
+Matrix<size, size, Type> testMatrix()
+{
+  Matrix<size, size, Type> matrix{};
+  for (uint8_t row{0}; row < size; row++)
+  {
+    for (uint8_t column{0}; column < size; column++)
+    {
+      matrix[row][column] = static_cast<Type>((row * 3 + column * 7) % 5) - 2;
+    }
+    matrix[row][row] += size;
+  }
+  return matrix;
+}
+
+// plain triple loop to check the products against
+template <uint8_t rows, uint8_t inner, uint8_t columns, typename Type>
+Matrix<rows, columns, Type> naiveProduct(const Matrix<rows, inner, Type> &a,
+                                         const Matrix<inner, columns, Type> &b)
+{
+  Matrix<rows, columns, Type> result{};
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      Type sum{0};
+      for (uint8_t idx{0}; idx < inner; idx++)
+      {
+        sum += a.Get(row, idx) * b.Get(idx, column);
+      }
+      result[row][column] = sum;
+    }
+  }
+  return result;
+}
+
+// the determinant and a unimodular matrix fold at compile time for integers too
+constexpr Matrix<3, 3, int32_t> unimodular{2, 3, 1,
+                                           1, 2, 1,
+                                           1, 1, 1};
+static_assert(unimodular.Det() == 1, "");
+static_assert((unimodular * unimodular).Get(0, 0) == 8, "");
+constexpr Matrix<3, 3, double> precise{4, 1, 0,
+                                       1, 3, 1,
+                                       0, 1, 2};
+static_assert(precise.Det() == 18, "");
+
+TEST_CASE("Double precision matrices", "MatrixType")
+{
+  SECTION("Element-wise operations")
+  {
+    Matrix<5, 5, double> mat1{testMatrix<5, double>()};
+    Matrix<5, 5, double> mat2{0.1};
+    Matrix<5, 5, double> result{};
+
+    mat1.Add(mat2, result);
+    REQUIRE(result.Get(0, 0) == mat1.Get(0, 0) + 0.1);
+    mat1.Sub(mat2, result);
+    REQUIRE(result.Get(4, 4) == mat1.Get(4, 4) - 0.1);
+    mat1.ElementMultiply(mat2, result);
+    REQUIRE(result.Get(2, 3) == mat1.Get(2, 3) * 0.1);
+    mat1.ElementDivide(mat2, result);
+    REQUIRE(result.Get(3, 2) == mat1.Get(3, 2) / 0.1);
+    mat1.Mult(0.5, result);
+    REQUIRE(result.Get(1, 1) == mat1.Get(1, 1) * 0.5);
+  }
+
+  SECTION("Products keep double precision")
+  {
+    // big enough to take the blocked path for float
+    Matrix<20, 20, double> mat1{};
+    Matrix<20, 20, double> mat2{};
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 20; column++)
+      {
+        mat1[row][column] = 1 + 1e-9 * (row + column);
+        mat2[row][column] = 1 - 1e-9 * (row * column % 7);
+      }
+    }
+
+    Matrix<20, 20, double> result{};
+    mat1.Mult(mat2, result);
+    Matrix<20, 20, double> expected{naiveProduct(mat1, mat2)};
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 20; column++)
+      {
+        REQUIRE_THAT(result.Get(row, column),
+                     Catch::Matchers::WithinAbs(expected.Get(row, column), 1e-12));
+      }
+    }
+    // the 1e-9 terms vanish in float but not in double
+    REQUIRE(result.Get(0, 0) != result.Get(19, 19));
+  }
+
+  SECTION("Determinant and inverse")
+  {
+    Matrix<6, 6, double> mat1{testMatrix<6, double>()};
+    Matrix<6, 6, double> inverse{mat1.Invert()};
+    Matrix<6, 6, double> identity{};
+    mat1.Mult(inverse, identity);
+    for (uint8_t row{0}; row < 6; row++)
+    {
+      for (uint8_t column{0}; column < 6; column++)
+      {
+        REQUIRE_THAT(identity.Get(row, column),
+                     Catch::Matchers::WithinAbs(row == column ? 1 : 0, 1e-12));
+      }
+    }
+
+    LU<6, double> lu{mat1};
+    REQUIRE_THAT(mat1.Det(), Catch::Matchers::WithinRel(lu.Det(), 1e-12));
+  }
+
+  SECTION("Cholesky")
+  {
+    LLT<3, double> llt{precise};
+    REQUIRE(llt.IsPositiveDefinite());
+    REQUIRE_THAT(llt.Det(), Catch::Matchers::WithinRel(18.0, 1e-12));
+  }
+
+  SECTION("Normalize")
+  {
+    Matrix<1, 20, double> vec{};
+    vec.Fill(2);
+    Matrix<1, 20, double> normalized{};
+    vec.Normalize(normalized);
+    const double length{
+        Matrix<1, 20, double>::DotProduct(normalized, normalized)};
+    REQUIRE_THAT(length, Catch::Matchers::WithinAbs(1.0, 1e-15));
+  }
+
+  SECTION("Out of bounds")
+  {
+    Matrix<2, 2, double> mat1{1, 2, 3, 4};
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(mat1.Get(2, 0) == 1e+10);
+    }
+  }
+}
+
+TEST_CASE("Integer matrices", "MatrixType")
+{
+  SECTION("Determinants are exact")
+  {
+    // big enough that float matrices would go through LU
+    Matrix<5, 5, int64_t> mat1{testMatrix<5, int64_t>()};
+    Matrix<5, 5, double> as_double{mat1};
+    REQUIRE(mat1.Det() == static_cast<int64_t>(as_double.Det() + 0.5));
+    REQUIRE(Matrix<3, 3, int32_t>{1, 2, 3, 4, 5, 6, 7, 8, 9}.Det() == 0);
+  }
+
+  SECTION("Products")
+  {
+    Matrix<17, 17, int32_t> mat1{testMatrix<17, int32_t>()};
+    Matrix<17, 17, int32_t> result{};
+    mat1.Mult(mat1, result);
+    Matrix<17, 17, int32_t> expected{naiveProduct(mat1, mat1)};
+    for (uint8_t row{0}; row < 17; row++)
+    {
+      for (uint8_t column{0}; column < 17; column++)
+      {
+        REQUIRE(result.Get(row, column) == expected.Get(row, column));
+      }
+    }
+  }
+
+  SECTION("Inverse of a unimodular matrix")
+  {
+    Matrix<3, 3, int32_t> inverse{unimodular.Invert()};
+    Matrix<3, 3, int32_t> identity{};
+    unimodular.Mult(inverse, identity);
+    for (uint8_t row{0}; row < 3; row++)
+    {
+      for (uint8_t column{0}; column < 3; column++)
+      {
+        REQUIRE(identity.Get(row, column) == (row == column ? 1 : 0));
+      }
+    }
+  }
+
+  SECTION("Out of bounds reads saturate")
+  {
+    Matrix<2, 2, int16_t> mat1{1, 2, 3, 4};
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(mat1.Get(0, 2) == std::numeric_limits<int16_t>::max());
+    }
+  }
+
+  SECTION("ToString")
+  {
+    Matrix<1, 2, int32_t> mat1{7, -3};
+    std::string string_buffer{};
+    mat1.ToString(string_buffer);
+    REQUIRE(string_buffer == "|7\t-3|\n");
+  }
+}
+
+TEST_CASE("Converting between element types", "MatrixType")
+{
+  Matrix<2, 2> single{1.5f, -2.25f, 3, 4};
+  Matrix<2, 2, double> widened{single};
+  REQUIRE(widened.Get(0, 1) == -2.25);
+
+  Matrix<2, 2, int32_t> truncated{widened};
+  REQUIRE(truncated.Get(0, 0) == 1);
+  REQUIRE(truncated.Get(0, 1) == -2);
+
+  Matrix<2, 2> back{truncated};
+  REQUIRE(back.Get(1, 1) == 4);
+}
+
+#if defined(__FLT16_MAX__)
+TEST_CASE("Half precision matrices", "MatrixType")
+{
+  SECTION("Element-wise operations")
+  {
+    Matrix<4, 8, _Float16> mat1{};
+    mat1.Fill(1.5f);
+    Matrix<4, 8, _Float16> result{};
+    mat1.Add(mat1, result);
+    REQUIRE(static_cast<float>(result.Get(3, 7)) == 3);
+    mat1.Mult(static_cast<_Float16>(2), result);
+    REQUIRE(static_cast<float>(result.Get(0, 0)) == 3);
+  }
+
+  SECTION("Sums accumulate in float")
+  {
+    // 2048 + 1 + 1 + ... stays at 2048 when it's summed in half precision
+    Matrix<1, 64, _Float16> vec1{};
+    Matrix<1, 64, _Float16> vec2{};
+    vec1.Fill(1);
+    vec2.Fill(1);
+    vec1[0][0] = 2048;
+    vec1[0][1] = 0;
+    REQUIRE(static_cast<float>(
+                Matrix<1, 64, _Float16>::DotProduct(vec1, vec2)) == 2110);
+
+    Matrix<64, 1, _Float16> column{vec2.Transpose()};
+    Matrix<1, 1, _Float16> product{};
+    vec1.Mult(column, product);
+    REQUIRE(static_cast<float>(product.Get(0, 0)) == 2110);
+  }
+
+  SECTION("Cholesky")
+  {
+    Matrix<3, 3, _Float16> mat1{};
+    const float elements[9]{4, 2, 0,
+                            2, 5, 1,
+                            0, 1, 3};
+    for (uint8_t idx{0}; idx < 9; idx++)
+    {
+      mat1[idx / 3][idx % 3] = static_cast<_Float16>(elements[idx]);
+    }
+
+    LLT<3, _Float16> llt{mat1};
+    LDLT<3, _Float16> ldlt{mat1};
+    REQUIRE(llt.IsPositiveDefinite());
+    REQUIRE(ldlt.IsPositiveDefinite());
+    REQUIRE_THAT(static_cast<float>(llt.Det()),
+                 Catch::Matchers::WithinRel(44.0f, 1e-2f));
+    REQUIRE_THAT(static_cast<float>(ldlt.Det()),
+                 Catch::Matchers::WithinRel(44.0f, 1e-2f));
+  }
+
+  SECTION("Out of bounds reads saturate")
+  {
+    Matrix<2, 2, _Float16> mat1{};
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(static_cast<float>(mat1.Get(5, 5)) == 65504);
+    }
+  }
+}
+#endif
@@ -0,0 +1,364 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Matrix.hpp"
+#include "MatrixView.hpp"
+
+// any other libraries
+#include <cstdint>
+
+// a matrix where every element is different
+template <uint8_t rows, uint8_t columns>
+Matrix<rows, columns> counting()
+{
+  Matrix<rows, columns> matrix{};
+  for (uint8_t row{0}; row < rows; row++)
+  {
+    for (uint8_t column{0}; column < columns; column++)
+    {
+      matrix[row][column] = static_cast<float>(row * columns + column);
+    }
+  }
+  return matrix;
+}
+
+// views of constant matrices work at compile time too
+constexpr Matrix<3, 3> constant{1, 2, 3,
+                                4, 5, 6,
+                                7, 8, 10};
+static_assert(constant.Row(1).Get(0, 2) == 6, "");
+static_assert(constant.Column(2).Get(2, 0) == 10, "");
+static_assert(constant.Block<2, 2, 1, 1>().Det() == 2, "");
+static_assert(Matrix<2, 2>{constant.Minor(0, 0)}.Get(1, 1) == 10, "");
+
+TEST_CASE("Views refer to the matrix they came from", "MatrixView")
+{
+  Matrix<4, 5> mat1{counting<4, 5>()};
+
+  SECTION("Reads")
+  {
+    MatrixView<1, 5> row{mat1.Row(2)};
+    MatrixView<4, 1> column{mat1.Column(3)};
+    MatrixView<2, 3> block{mat1.Block<2, 3, 1, 2>()};
+    REQUIRE(row.Get(0, 4) == 14);
+    REQUIRE(column.Get(3, 0) == 18);
+    REQUIRE(block.Get(0, 0) == 7);
+    REQUIRE(block.Get(1, 2) == 14);
+    REQUIRE(block.Stride() == 5);
+
+    // out of bounds reads saturate like a Matrix
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(block.Get(2, 0) == 1e+10f);
+    }
+  }
+
+  SECTION("Writes")
+  {
+    mat1.Row(0).Fill(-1);
+    mat1.Column(4).Fill(-2);
+    mat1.Block<2, 2, 2, 0>()[1][1] = 100;
+    REQUIRE(mat1.Get(0, 0) == -1);
+    REQUIRE(mat1.Get(0, 3) == -1);
+    REQUIRE(mat1.Get(0, 4) == -2);
+    REQUIRE(mat1.Get(3, 4) == -2);
+    REQUIRE(mat1.Get(3, 1) == 100);
+    REQUIRE(mat1.Get(1, 1) == 6);
+  }
+
+  SECTION("Assignment copies elements instead of rebinding")
+  {
+    Matrix<2, 2> values{1, 2, 3, 4};
+    MatrixView<2, 2> block{mat1.Block<2, 2, 0, 0>()};
+    block = values;
+    REQUIRE(mat1.Get(1, 1) == 4);
+
+    // view to view, between two blocks of the same matrix
+    block = mat1.Block<2, 2, 2, 3>();
+    REQUIRE(mat1.Get(0, 0) == 13);
+    REQUIRE(mat1.Get(1, 1) == 19);
+    REQUIRE(block.Data() == &mat1[0][0]);
+
+    // and back out into a matrix
+    Matrix<1, 5> row{mat1.Row(3)};
+    REQUIRE(row.Get(0, 2) == 17);
+    Matrix<4, 1> column{};
+    column = mat1.Column(1);
+    REQUIRE(column.Get(2, 0) == 11);
+  }
+
+  SECTION("Read only views")
+  {
+    const Matrix<4, 5> &constant_ref{mat1};
+    MatrixView<2, 2, const float> block{constant_ref.Block<2, 2, 1, 1>()};
+    REQUIRE(block.Get(1, 1) == 12);
+
+    // writable views turn into read only ones, not the other way around
+    MatrixView<1, 5, const float> row{mat1.Row(0)};
+    REQUIRE(row.Get(0, 1) == 1);
+  }
+}
+
+TEST_CASE("Kernels on views", "MatrixView")
+{
+  SECTION("Element-wise")
+  {
+    // wide enough for the rows to go through the element-wise kernels
+    Matrix<4, 40> mat1{counting<4, 40>()};
+    Matrix<4, 40> mat2{counting<4, 40>()};
+    MatrixView<2, 20> top_left{mat1.Block<2, 20, 0, 0>()};
+    MatrixView<2, 20> bottom_right{mat2.Block<2, 20, 2, 20>()};
+    Matrix<2, 20> result{};
+
+    top_left.Add(bottom_right, result);
+    REQUIRE(result.Get(1, 19) == 59 + 159);
+    top_left.Sub(bottom_right, result);
+    REQUIRE(result.Get(0, 0) == -100);
+    top_left.ElementMultiply(bottom_right, result);
+    REQUIRE(result.Get(0, 1) == 101);
+    top_left.ElementDivide(bottom_right, result);
+    REQUIRE(result.Get(1, 0) == 40.0f / 140);
+    top_left.Mult(2, result);
+    REQUIRE(result.Get(1, 2) == 84);
+
+    // in place, and straight into another part of a matrix
+    top_left.Add(top_left, top_left);
+    REQUIRE(mat1.Get(1, 2) == 84);
+    REQUIRE(mat1.Get(2, 2) == 82);
+    bottom_right.Sub(bottom_right, mat2.Block<2, 20, 0, 0>());
+    REQUIRE(mat2.Get(1, 5) == 0);
+    REQUIRE(mat2.Get(2, 20) == 100);
+  }
+
+  SECTION("Small products")
+  {
+    Matrix<3, 3> rotation{0, -1, 0,
+                          1, 0, 0,
+                          0, 0, 1};
+    Matrix<6, 2> states{counting<6, 2>()};
+    Matrix<6, 2> result{};
+    result.Fill(0);
+
+    // rotate the bottom half of the first column of states
+    rotation.View().Mult(states.Block<3, 1, 3, 0>(),
+                         result.Block<3, 1, 3, 1>());
+    REQUIRE(result.Get(3, 1) == -8);
+    REQUIRE(result.Get(4, 1) == 6);
+    REQUIRE(result.Get(5, 1) == 10);
+    REQUIRE(result.Get(3, 0) == 0);
+  }
+
+  SECTION("Blocked products")
+  {
+    // big enough for the blocked kernel, with all three operands strided
+    Matrix<20, 24> mat1{counting<20, 24>()};
+    Matrix<24, 20> mat2{counting<24, 20>()};
+    Matrix<20, 20> result{};
+    result.Fill(-1);
+
+    MatrixView<18, 18> product{result.Block<18, 18, 1, 2>()};
+    mat1.Block<18, 20, 2, 3>().Mult(mat2.Block<20, 18, 4, 1>(), product);
+
+    Matrix<18, 20> left{mat1.Block<18, 20, 2, 3>()};
+    Matrix<20, 18> right{mat2.Block<20, 18, 4, 1>()};
+    Matrix<18, 18> expected{};
+    left.Mult(right, expected);
+    for (uint8_t row{0}; row < 18; row++)
+    {
+      for (uint8_t column{0}; column < 18; column++)
+      {
+        REQUIRE_THAT(result.Get(row + 1, column + 2),
+                     Catch::Matchers::WithinRel(expected.Get(row, column),
+                                                1e-6f));
+      }
+    }
+    // nothing outside the block was touched
+    REQUIRE(result.Get(0, 0) == -1);
+    REQUIRE(result.Get(19, 19) == -1);
+    REQUIRE(result.Get(5, 1) == -1);
+  }
+
+  SECTION("Dot products and determinants")
+  {
+    Matrix<3, 4> mat1{counting<3, 4>()};
+    REQUIRE(MatrixView<3, 1>::DotProduct(mat1.Column(0), mat1.Column(1)) ==
+            0 * 1 + 4 * 5 + 8 * 9);
+    REQUIRE(MatrixView<1, 4>::DotProduct(mat1.Row(1), mat1.Row(1)) ==
+            16 + 25 + 36 + 49);
+
+    Matrix<3, 3> mat2{2, 0, 1,
+                      1, 3, 0,
+                      0, 1, 4};
+    Matrix<5, 5> outer{};
+    outer.Fill(7);
+    outer.Block<3, 3, 1, 2>() = mat2;
+    REQUIRE(outer.Block<3, 3, 1, 2>().Det() == mat2.Det());
+  }
+
+#ifdef MATRIX_EXPRESSION_TEMPLATES
+  SECTION("Views in expressions")
+  {
+    Matrix<3, 3> mat1{counting<3, 3>()};
+    Matrix<2, 2> sum{mat1.Block<2, 2, 0, 0>() + mat1.Block<2, 2, 1, 1>()};
+    REQUIRE(sum.Get(0, 0) == 4);
+    REQUIRE(sum.Get(1, 1) == 12);
+  }
+#endif
+}
+
+TEST_CASE("Minors", "MatrixView")
+{
+  Matrix<4, 4> mat1{counting<4, 4>()};
+
+  Matrix<3, 3> copied{};
+  mat1.MinorMatrix(copied, 1, 2);
+  Matrix<3, 3> viewed{mat1.Minor(1, 2)};
+  for (uint8_t row{0}; row < 3; row++)
+  {
+    for (uint8_t column{0}; column < 3; column++)
+    {
+      REQUIRE(viewed.Get(row, column) == copied.Get(row, column));
+    }
+  }
+  REQUIRE(copied.Get(0, 0) == 0);
+  REQUIRE(copied.Get(1, 2) == 11);
+  REQUIRE(copied.Get(2, 1) == 13);
+}
+
+// transposes fold at compile time as well
+static_assert(constant.Transposed().Get(0, 1) == 4, "");
+static_assert((constant.Transposed() * constant).Get(2, 2) == 9 + 36 + 100,
+              "");
+
+TEST_CASE("Transposed products", "MatrixView")
+{
+  SECTION("The transpose is a view")
+  {
+    Matrix<2, 3> mat1{counting<2, 3>()};
+    MatrixTransposed<3, 2> transposed{mat1.Transposed()};
+    REQUIRE(transposed.Get(2, 1) == 5);
+    mat1[1][2] = -5;
+    REQUIRE(transposed.Get(2, 1) == -5);
+
+    Matrix<3, 2> copied{transposed};
+    Matrix<3, 2> expected{mat1.Transpose()};
+    for (uint8_t row{0}; row < 3; row++)
+    {
+      for (uint8_t column{0}; column < 2; column++)
+      {
+        REQUIRE(copied.Get(row, column) == expected.Get(row, column));
+      }
+    }
+  }
+
+  SECTION("Small")
+  {
+    // H * P * H^T and J^T * J, the shapes a filter uses
+    Matrix<2, 4> H{counting<2, 4>()};
+    Matrix<4, 4> P{counting<4, 4>()};
+    Matrix<2, 4> HP{};
+    H.Mult(P, HP);
+
+    Matrix<2, 2> S{};
+    HP.Mult(H.Transposed(), S);
+    Matrix<2, 2> expected{};
+    HP.Mult(H.Transpose(), expected);
+    for (uint8_t row{0}; row < 2; row++)
+    {
+      for (uint8_t column{0}; column < 2; column++)
+      {
+        REQUIRE(S.Get(row, column) == expected.Get(row, column));
+      }
+    }
+
+    Matrix<4, 4> JtJ{};
+    H.TransposeMult(H, JtJ);
+    Matrix<4, 4> JtJ_expected{};
+    H.Transpose().Mult(H, JtJ_expected);
+    Matrix<4, 4> JtJ_view{};
+    H.Transposed().Mult(H.View(), JtJ_view.View());
+    for (uint8_t row{0}; row < 4; row++)
+    {
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        REQUIRE(JtJ.Get(row, column) == JtJ_expected.Get(row, column));
+        REQUIRE(JtJ_view.Get(row, column) == JtJ_expected.Get(row, column));
+      }
+    }
+
+    Matrix<2, 2> operator_result{HP * H.Transposed()};
+    REQUIRE(operator_result.Get(1, 0) == expected.Get(1, 0));
+  }
+
+  SECTION("Blocked")
+  {
+    Matrix<30, 20> mat1{counting<30, 20>()};
+    Matrix<30, 25> mat2{counting<30, 25>()};
+    Matrix<20, 25> mat3{counting<20, 25>()};
+
+    Matrix<20, 25> at_b{};
+    mat1.TransposeMult(mat2, at_b);
+    Matrix<20, 25> at_b_expected{};
+    mat1.Transpose().Mult(mat2, at_b_expected);
+
+    Matrix<30, 20> a_bt{};
+    mat2.MultTranspose(mat3, a_bt);
+    Matrix<30, 20> a_bt_expected{};
+    mat2.Mult(mat3.Transpose(), a_bt_expected);
+
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 25; column++)
+      {
+        REQUIRE_THAT(at_b.Get(row, column),
+                     Catch::Matchers::WithinRel(
+                         at_b_expected.Get(row, column), 1e-6f));
+      }
+    }
+    for (uint8_t row{0}; row < 30; row++)
+    {
+      for (uint8_t column{0}; column < 20; column++)
+      {
+        REQUIRE_THAT(a_bt.Get(row, column),
+                     Catch::Matchers::WithinRel(
+                         a_bt_expected.Get(row, column), 1e-6f));
+      }
+    }
+  }
+
+  SECTION("Other element types")
+  {
+    Matrix<20, 18, int32_t> mat1{};
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 18; column++)
+      {
+        mat1[row][column] = (row * 3 + column) % 7 - 3;
+      }
+    }
+    Matrix<18, 18, int32_t> result{};
+    mat1.TransposeMult(mat1, result);
+    Matrix<18, 18, int32_t> expected{};
+    mat1.Transpose().Mult(mat1, expected);
+    Matrix<20, 20, int32_t> outer{};
+    mat1.MultTranspose(mat1, outer);
+    Matrix<20, 20, int32_t> outer_expected{};
+    mat1.Mult(mat1.Transpose(), outer_expected);
+    for (uint8_t row{0}; row < 18; row++)
+    {
+      for (uint8_t column{0}; column < 18; column++)
+      {
+        REQUIRE(result.Get(row, column) == expected.Get(row, column));
+      }
+    }
+    for (uint8_t row{0}; row < 20; row++)
+    {
+      for (uint8_t column{0}; column < 20; column++)
+      {
+        REQUIRE(outer.Get(row, column) == outer_expected.Get(row, column));
+      }
+    }
+  }
+}
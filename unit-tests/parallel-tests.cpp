@@ -0,0 +1,182 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+
+// include the module you're going to test next
+#include "ElementKernels.hpp"
+#include "Gemm.hpp"
+#include "Parallel.hpp"
+#include "ThreadPool.hpp"
+
+// any other libraries
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Thread pool", "ThreadPool")
+{
+  for (size_t threads : {1, 2, 4, 8})
+  {
+    ThreadPool pool{threads};
+    REQUIRE(pool.Size() == threads);
+
+    // every task runs exactly once, whatever the balance between them
+    for (size_t task_count : {0, 1, 3, 64, 1000})
+    {
+      std::vector<std::atomic<uint32_t>> runs(task_count);
+      pool.Run(task_count, [&runs](size_t idx) {
+        // uneven work so some threads have to steal
+        volatile uint32_t spin{0};
+        for (size_t step{0}; step < (idx % 13) * 100; step++)
+        {
+          spin = spin + 1;
+        }
+        runs[idx]++;
+      });
+      for (size_t idx{0}; idx < task_count; idx++)
+      {
+        REQUIRE(runs[idx] == 1);
+      }
+    }
+
+    // a Run from inside a task runs on that thread
+    std::atomic<uint32_t> inner_runs{0};
+    pool.Run(8, [&pool, &inner_runs](size_t) {
+      pool.Run(5, [&inner_runs](size_t) { inner_runs++; });
+    });
+    REQUIRE(inner_runs == 40);
+
+    // and Runs from several threads at once take turns
+    std::atomic<uint32_t> shared_runs{0};
+    std::vector<std::thread> callers{};
+    for (size_t idx{0}; idx < 4; idx++)
+    {
+      callers.emplace_back([&pool, &shared_runs]() {
+        for (size_t repeat{0}; repeat < 20; repeat++)
+        {
+          pool.Run(16, [&shared_runs](size_t) { shared_runs++; });
+        }
+      });
+    }
+    for (std::thread &caller : callers)
+    {
+      caller.join();
+    }
+    REQUIRE(shared_runs == 4 * 20 * 16);
+  }
+
+  ThreadPool hardware_pool{};
+  REQUIRE(hardware_pool.Size() >= 1);
+}
+
+TEST_CASE("Parallel matrix multiply", "Parallel")
+{
+  // big enough to split, with edges that don't line up with the tiles
+  constexpr size_t m{203};
+  constexpr size_t n{331};
+  constexpr size_t k{150};
+  std::vector<float> a(m * k);
+  std::vector<float> b(k * n);
+  for (size_t idx{0}; idx < a.size(); idx++)
+  {
+    a[idx] = static_cast<float>(idx % 17) * 0.37f - 2.9f;
+  }
+  for (size_t idx{0}; idx < b.size(); idx++)
+  {
+    b[idx] = static_cast<float>(idx % 23) * 0.11f - 1.3f;
+  }
+
+  Parallel::SetPool(nullptr);
+  REQUIRE(Parallel::Pool() == nullptr);
+  std::vector<float> serial(m * n);
+  Gemm::Multiply(m, n, k, a.data(), k, b.data(), n, serial.data(), n);
+
+  for (size_t threads : {1, 2, 4, 8})
+  {
+    ThreadPool pool{threads};
+    Parallel::SetPool(&pool);
+    REQUIRE(Parallel::Pool() == &pool);
+
+    std::vector<float> parallel(m * n);
+    Gemm::Multiply(m, n, k, a.data(), k, b.data(), n, parallel.data(), n);
+    // the same bits, not just close
+    REQUIRE(parallel == serial);
+
+    // a block inside a bigger matrix, through the leading dimensions
+    std::vector<float> padded(m * (n + 5), -1.0f);
+    Gemm::Multiply(m, n, k, a.data(), k, b.data(), n, padded.data(), n + 5);
+    for (size_t row{0}; row < m; row++)
+    {
+      for (size_t column{0}; column < n + 5; column++)
+      {
+        const float expected{column < n ? serial[row * n + column] : -1.0f};
+        REQUIRE(padded[row * (n + 5) + column] == expected);
+      }
+    }
+  }
+  Parallel::SetPool(nullptr);
+}
+
+TEST_CASE("Parallel element-wise operations", "Parallel")
+{
+  // a few chunks plus a partial one
+  constexpr size_t count{Parallel::element_threshold * 3 + 123};
+  std::vector<float> a(count);
+  std::vector<float> b(count);
+  std::vector<float> c(count);
+  for (size_t idx{0}; idx < count; idx++)
+  {
+    a[idx] = static_cast<float>(idx % 101) * 0.5f + 1.0f;
+    b[idx] = static_cast<float>(idx % 31) - 15.25f;
+    c[idx] = static_cast<float>(idx % 7) * 1.5f;
+  }
+
+  constexpr size_t operation_count{11};
+  auto run_all = [&](std::array<std::vector<float>, operation_count> &out) {
+    for (std::vector<float> &result : out)
+    {
+      result.assign(count, 0.0f);
+    }
+    ElementKernels::Add(a.data(), b.data(), out[0].data(), count);
+    ElementKernels::Sub(a.data(), b.data(), out[1].data(), count);
+    ElementKernels::Multiply(a.data(), b.data(), out[2].data(), count);
+    ElementKernels::Divide(b.data(), a.data(), out[3].data(), count);
+    ElementKernels::Scale(a.data(), 1.7f, out[4].data(), count);
+    ElementKernels::DivideScalar(a.data(), 3.0f, out[5].data(), count);
+    ElementKernels::MultiplyAdd(a.data(), b.data(), c.data(), out[6].data(),
+                                count);
+    ElementKernels::MultiplySub(a.data(), b.data(), c.data(), out[7].data(),
+                                count);
+    ElementKernels::ScaleAdd(a.data(), -0.3f, c.data(), out[8].data(), count);
+    ElementKernels::Sqrt(a.data(), out[9].data(), count);
+    ElementKernels::Fill(out[10].data(), 4.5f, count);
+  };
+
+  Parallel::SetPool(nullptr);
+  std::array<std::vector<float>, operation_count> serial{};
+  run_all(serial);
+  const float serial_sum{ElementKernels::SumOfSquares(a.data(), count)};
+
+  for (size_t threads : {2, 4, 8})
+  {
+    Parallel::UseThreads(threads);
+    REQUIRE(Parallel::Pool() != nullptr);
+    REQUIRE(Parallel::Pool()->Size() == threads);
+
+    std::array<std::vector<float>, operation_count> parallel{};
+    run_all(parallel);
+    for (size_t operation{0}; operation < operation_count; operation++)
+    {
+      REQUIRE(parallel[operation] == serial[operation]);
+    }
+    REQUIRE(ElementKernels::SumOfSquares(a.data(), count) == serial_sum);
+
+    // in place works too
+    std::vector<float> in_place{a};
+    ElementKernels::Add(in_place.data(), b.data(), in_place.data(), count);
+    REQUIRE(in_place == serial[0]);
+  }
+
+  Parallel::UseThreads(1);
+  REQUIRE(Parallel::Pool() == nullptr);
+}
@@ -0,0 +1,140 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+
+// include the module you're going to test next
+#include "PerfCounters.hpp"
+
+// any other libraries
+#include "Matrix.hpp"
+#include "Quaternion.h"
+#include "Vector3D.hpp"
+
+#include <string>
+#include <thread>
+
+using PerfCounters::Op;
+
+// instrumented functions still have to work at compile time
+constexpr float compile_time_det{Matrix<3, 3>{2, 0, 0, 0, 3, 0, 0, 0, 4}.Det()};
+static_assert(compile_time_det == 24, "constexpr Det with perf counters");
+constexpr V3D<float> compile_time_sum{V3D<float>{1, 2, 3} + V3D<float>{4, 5, 6}};
+static_assert(compile_time_sum.z == 9, "constexpr V3D with perf counters");
+
+TEST_CASE("Perf counters record calls", "PerfCounters")
+{
+  PerfCounters::Reset();
+  Matrix<4, 4> mat1{4, 0, 0, 1, 0, 3, 0, 0, 0, 0, 2, 0, 1, 0, 0, 1};
+  Matrix<4, 4> mat2{2};
+  Matrix<4, 4> result{};
+
+  for (int idx{0}; idx < 10; idx++)
+  {
+    mat1.Add(mat2, result);
+  }
+  mat1.Mult(mat2, result);
+  mat1.Mult(mat2, result);
+  result = mat1.Transpose();
+
+  REQUIRE(PerfCounters::Get(Op::MatrixAdd).calls == 10);
+  REQUIRE(PerfCounters::Get(Op::MatrixMult).calls == 2);
+  REQUIRE(PerfCounters::Get(Op::MatrixTranspose).calls == 1);
+  REQUIRE(PerfCounters::Get(Op::MatrixSub).calls == 0);
+  REQUIRE(PerfCounters::Get(Op::MatrixMult).cycles > 0);
+  if (PerfCounters::ActiveSource() == PerfCounters::Source::PerfEvents)
+  {
+    REQUIRE(PerfCounters::Get(Op::MatrixMult).instructions > 0);
+  }
+  else
+  {
+    REQUIRE(PerfCounters::Get(Op::MatrixMult).instructions == 0);
+  }
+
+  SECTION("Results are unchanged")
+  {
+    Matrix<4, 4> expected{};
+    for (uint8_t row{0}; row < 4; row++)
+    {
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        expected[row][column] = mat1.Get(column, row);
+      }
+    }
+    for (uint8_t idx{0}; idx < 16; idx++)
+    {
+      REQUIRE(result.Element(idx) == expected.Element(idx));
+    }
+    REQUIRE(mat1.Det() == 18);
+  }
+
+  SECTION("Only the outermost call is measured")
+  {
+    PerfCounters::Reset();
+    // Invert goes through Det and MatrixOfMinors (or LU) internally
+    result = mat1.Invert();
+    REQUIRE(PerfCounters::Get(Op::MatrixInvert).calls == 1);
+    REQUIRE(PerfCounters::Get(Op::MatrixDet).calls == 0);
+    REQUIRE(PerfCounters::Get(Op::MatrixOfMinors).calls == 0);
+    REQUIRE(PerfCounters::Get(Op::MatrixMinorMatrix).calls == 0);
+    REQUIRE_FALSE(PerfCounters::IsRecording());
+
+    // operator+ and += go through Add
+    V3D<float> vector{1, 2, 3};
+    vector += V3D<float>{1, 1, 1};
+    REQUIRE(PerfCounters::Get(Op::V3DAdd).calls == 1);
+    REQUIRE(vector == V3D<float>{2, 3, 4});
+  }
+
+  SECTION("Quaternions")
+  {
+    PerfCounters::Reset();
+    Quaternion q{Quaternion::FromAngleAndAxis(1.0f, Matrix<1, 3>{0, 0, 1})};
+    const V3D<float> rotated{q.Rotate(V3D<float>{1, 0, 0})};
+    float points[6]{1, 0, 0, 0, 1, 0};
+    q.RotateMany(points, points, 2);
+    q.Normalize();
+    REQUIRE(PerfCounters::Get(Op::QuaternionFromAngleAndAxis).calls == 1);
+    REQUIRE(PerfCounters::Get(Op::QuaternionRotate).calls == 1);
+    REQUIRE(PerfCounters::Get(Op::QuaternionRotateMany).calls == 1);
+    REQUIRE(PerfCounters::Get(Op::QuaternionNormalize).calls == 1);
+    REQUIRE(PerfCounters::Get(Op::MatrixNormalize).calls == 0);
+    REQUIRE(points[0] == rotated.x);
+    REQUIRE(points[1] == rotated.y);
+  }
+
+  SECTION("Threads add up")
+  {
+    PerfCounters::Reset();
+    std::thread worker{[&mat1, &mat2]() {
+      Matrix<4, 4> worker_result{};
+      for (int idx{0}; idx < 5; idx++)
+      {
+        mat1.Sub(mat2, worker_result);
+      }
+    }};
+    mat1.Sub(mat2, result);
+    worker.join();
+    REQUIRE(PerfCounters::Get(Op::MatrixSub).calls == 6);
+  }
+}
+
+TEST_CASE("Perf counter report", "PerfCounters")
+{
+  PerfCounters::Reset();
+  Matrix<3, 3> mat{1, 2, 3, 4, 5, 6, 7, 8, 10};
+  Matrix<1, 3> row{};
+  mat.GetRow(1, row);
+  mat.GetRow(2, row);
+
+  std::string report{};
+  PerfCounters::Report(report);
+  REQUIRE(report.find("operation") != std::string::npos);
+  REQUIRE(report.find("Matrix::GetRow") != std::string::npos);
+  // operations that weren't called are left out
+  REQUIRE(report.find("Matrix::GetColumn") == std::string::npos);
+
+  REQUIRE(std::string{PerfCounters::Name(Op::MatrixMult)} == "Matrix::Mult");
+  REQUIRE(std::string{PerfCounters::Name(Op::Count)} == "unknown");
+
+  PerfCounters::Reset();
+  REQUIRE(PerfCounters::Get(Op::MatrixGetRow).calls == 0);
+}
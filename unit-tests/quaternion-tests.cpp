@@ -4,10 +4,12 @@
 
 // include the module you're going to test next
 #include "Quaternion.h"
+#include "FixedQuaternion.hpp"
 
 // any other libraries
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
 TEST_CASE("Vector Math", "Vector")
@@ -18,49 +20,49 @@ TEST_CASE("Vector Math", "Vector")
     SECTION("Initialization")
     {
         // explicit initialization
-        REQUIRE(q1.w == 1);
-        REQUIRE(q1.v1 == 2);
-        REQUIRE(q1.v2 == 3);
-        REQUIRE(q1.v3 == 4);
+        REQUIRE(q1.w() == 1);
+        REQUIRE(q1.v1() == 2);
+        REQUIRE(q1.v2() == 3);
+        REQUIRE(q1.v3() == 4);
 
         // fill initialization
         Quaternion q3{0};
-        REQUIRE(q3.w == 0);
-        REQUIRE(q3.v1 == 0);
-        REQUIRE(q3.v2 == 0);
-        REQUIRE(q3.v3 == 0);
+        REQUIRE(q3.w() == 0);
+        REQUIRE(q3.v1() == 0);
+        REQUIRE(q3.v2() == 0);
+        REQUIRE(q3.v3() == 0);
 
         // copy initialization
         Quaternion q4{q1};
-        REQUIRE(q4.w == 1);
-        REQUIRE(q4.v1 == 2);
-        REQUIRE(q4.v2 == 3);
-        REQUIRE(q4.v3 == 4);
+        REQUIRE(q4.w() == 1);
+        REQUIRE(q4.v1() == 2);
+        REQUIRE(q4.v2() == 3);
+        REQUIRE(q4.v3() == 4);
 
         // matrix initialization
         Matrix<1, 4> m1{1, 2, 3, 4};
         Quaternion q5{m1};
-        REQUIRE(q5.w == 1);
-        REQUIRE(q5.v1 == 2);
-        REQUIRE(q5.v2 == 3);
-        REQUIRE(q5.v3 == 4);
+        REQUIRE(q5.w() == 1);
+        REQUIRE(q5.v1() == 2);
+        REQUIRE(q5.v2() == 3);
+        REQUIRE(q5.v3() == 4);
 
         // array initialization
         Quaternion q6{std::array<float, 4>{1, 2, 3, 4}};
-        REQUIRE(q6.w == 1);
-        REQUIRE(q6.v1 == 2);
-        REQUIRE(q6.v2 == 3);
-        REQUIRE(q6.v3 == 4);
+        REQUIRE(q6.w() == 1);
+        REQUIRE(q6.v1() == 2);
+        REQUIRE(q6.v2() == 3);
+        REQUIRE(q6.v3() == 4);
     }
 
     SECTION("Equals")
     {
         Quaternion q3{0, 0, 0, 0};
         q3 = q1;
-        REQUIRE(q3.w == 1);
-        REQUIRE(q3.v1 == 2);
-        REQUIRE(q3.v2 == 3);
-        REQUIRE(q3.v3 == 4);
+        REQUIRE(q3.w() == 1);
+        REQUIRE(q3.v1() == 2);
+        REQUIRE(q3.v2() == 3);
+        REQUIRE(q3.v3() == 4);
     }
 
     SECTION("Array access")
@@ -74,20 +76,57 @@ TEST_CASE("Vector Math", "Vector")
     SECTION("Addition")
     {
         Quaternion q3 = q1 + q2;
-        REQUIRE(q3.w == 6);
-        REQUIRE(q3.v1 == 8);
-        REQUIRE(q3.v2 == 10);
-        REQUIRE(q3.v3 == 12);
+        REQUIRE(q3.w() == 6);
+        REQUIRE(q3.v1() == 8);
+        REQUIRE(q3.v2() == 10);
+        REQUIRE(q3.v3() == 12);
     }
 
     SECTION("Multiplication")
     {
         Quaternion q3;
         q1.Q_Mult(q2, q3);
-        REQUIRE(q3.w == -60);
-        REQUIRE(q3.v1 == 12);
-        REQUIRE(q3.v2 == 30);
-        REQUIRE(q3.v3 == 24);
+        REQUIRE(q3.w() == -60);
+        REQUIRE(q3.v1() == 12);
+        REQUIRE(q3.v2() == 30);
+        REQUIRE(q3.v3() == 24);
+    }
+
+    SECTION("Compound Assignment")
+    {
+        Quaternion q3{q1};
+        q3 *= q2;
+        REQUIRE(q3.w() == -60);
+        REQUIRE(q3.v1() == 12);
+        REQUIRE(q3.v2() == 30);
+        REQUIRE(q3.v3() == 24);
+
+        Quaternion q4 = q1 * q2;
+        REQUIRE(q4.w() == -60);
+        REQUIRE(q4.v3() == 24);
+
+        // multiplying by itself
+        Quaternion squared;
+        q1.Q_Mult(q1, squared);
+        q3 = q1;
+        q3 *= q3;
+        REQUIRE(q3.w() == squared.w());
+        REQUIRE(q3.v1() == squared.v1());
+        REQUIRE(q3.v2() == squared.v2());
+        REQUIRE(q3.v3() == squared.v3());
+
+        q3 = q1;
+        q3 += q2;
+        REQUIRE(q3.w() == 6);
+        REQUIRE(q3.v1() == 8);
+        REQUIRE(q3.v2() == 10);
+        REQUIRE(q3.v3() == 12);
+
+        q3 *= 0.5f;
+        REQUIRE(q3.w() == 3);
+        REQUIRE(q3.v1() == 4);
+        REQUIRE(q3.v2() == 5);
+        REQUIRE(q3.v3() == 6);
     }
 
     SECTION("Rotation")
@@ -96,8 +135,219 @@ TEST_CASE("Vector Math", "Vector")
         Quaternion q4{0, 1, 0, 0};
         Quaternion q5;
         q3.Rotate(q4, q5);
-        REQUIRE_THAT(q5.v1, Catch::Matchers::WithinRel(0.0f, 1e-6f));
-        REQUIRE_THAT(q5.v2, Catch::Matchers::WithinRel(1.0f, 1e-6f));
-        REQUIRE_THAT(q5.v3, Catch::Matchers::WithinRel(0.0f, 1e-6f));
+        // a relative tolerance around 0 only accepts exactly 0
+        REQUIRE_THAT(q5.v1(), Catch::Matchers::WithinAbs(0.0f, 1e-6f));
+        REQUIRE_THAT(q5.v2(), Catch::Matchers::WithinRel(1.0f, 1e-6f));
+        REQUIRE_THAT(q5.v3(), Catch::Matchers::WithinAbs(0.0f, 1e-6f));
+    }
+
+    SECTION("Vector Rotation")
+    {
+        Quaternion q3{Quaternion::FromAngleAndAxis(0.7f, Matrix<1, 3>{1, -2, 3})};
+        Quaternion q4{0, 0.5f, -1.5f, 2};
+        Quaternion expected;
+        Quaternion temp;
+
+        // q * v * q' the long way
+        q3.Q_Mult(q4, temp);
+        temp.Q_Mult(Quaternion{q3.w(), -q3.v1(), -q3.v2(), -q3.v3()}, expected);
+
+        const V3D<float> v1{q3.Rotate(V3D<float>{0.5f, -1.5f, 2})};
+        REQUIRE_THAT(v1.x, Catch::Matchers::WithinAbs(expected.v1(), 1e-5));
+        REQUIRE_THAT(v1.y, Catch::Matchers::WithinAbs(expected.v2(), 1e-5));
+        REQUIRE_THAT(v1.z, Catch::Matchers::WithinAbs(expected.v3(), 1e-5));
+
+        const Matrix<3, 1> m1{q3.Rotate(Matrix<3, 1>{0.5f, -1.5f, 2})};
+        REQUIRE_THAT(m1.Get(0, 0), Catch::Matchers::WithinAbs(expected.v1(), 1e-5));
+        REQUIRE_THAT(m1.Get(1, 0), Catch::Matchers::WithinAbs(expected.v2(), 1e-5));
+        REQUIRE_THAT(m1.Get(2, 0), Catch::Matchers::WithinAbs(expected.v3(), 1e-5));
+
+        // the rotation matrix has to agree with the quaternion
+        const Matrix<3, 3> rotation{q3.ToRotationMatrix()};
+        Matrix<3, 1> m2{};
+        rotation.Mult(Matrix<3, 1>{0.5f, -1.5f, 2}, m2);
+        REQUIRE_THAT(m2.Get(0, 0), Catch::Matchers::WithinAbs(expected.v1(), 1e-5));
+        REQUIRE_THAT(m2.Get(1, 0), Catch::Matchers::WithinAbs(expected.v2(), 1e-5));
+        REQUIRE_THAT(m2.Get(2, 0), Catch::Matchers::WithinAbs(expected.v3(), 1e-5));
+    }
+
+    SECTION("Rotate Many")
+    {
+        Quaternion q3{Quaternion::FromAngleAndAxis(-1.2f, Matrix<1, 3>{0, 1, 1})};
+
+        // every count on both sides of the rotation matrix threshold
+        for (size_t n = 0; n < 9; n++)
+        {
+            std::array<float, 27> points{};
+            std::array<float, 27> rotated{};
+            for (size_t idx = 0; idx < 3 * n; idx++)
+            {
+                points[idx] = static_cast<float>(idx % 5) - 1.5f;
+            }
+
+            q3.RotateMany(points.data(), rotated.data(), n);
+            for (size_t idx = 0; idx < n; idx++)
+            {
+                const V3D<float> expected{q3.Rotate(V3D<float>{points[3 * idx], points[3 * idx + 1], points[3 * idx + 2]})};
+                REQUIRE_THAT(rotated[3 * idx], Catch::Matchers::WithinAbs(expected.x, 1e-5));
+                REQUIRE_THAT(rotated[3 * idx + 1], Catch::Matchers::WithinAbs(expected.y, 1e-5));
+                REQUIRE_THAT(rotated[3 * idx + 2], Catch::Matchers::WithinAbs(expected.z, 1e-5));
+            }
+
+            // in place
+            q3.RotateMany(points.data(), points.data(), n);
+            for (size_t idx = 0; idx < 3 * n; idx++)
+            {
+                REQUIRE(points[idx] == rotated[idx]);
+            }
+        }
+    }
+
+    SECTION("Layout")
+    {
+        REQUIRE(sizeof(Quaternion) == 16);
+        REQUIRE(alignof(Quaternion) == 16);
+        REQUIRE(sizeof(std::array<Quaternion, 3>) == 48);
+
+        // the accessors write straight into the storage
+        Quaternion q3{};
+        q3.w() = 1;
+        q3.v3() = 4;
+        REQUIRE(q3[0] == 1);
+        REQUIRE(q3[3] == 4);
+
+        // a copy owns its own values
+        Quaternion q4{q3};
+        q4.v1() = 7;
+        REQUIRE(q3.v1() == 0);
+        REQUIRE(q4.w() == 1);
+
+        // a packed array of quaternions streams out and back as raw bytes
+        const std::array<Quaternion, 3> poses{q1, q2, q4};
+        std::array<float, 12> raw{};
+        std::memcpy(raw.data(), poses.data(), sizeof(poses));
+        REQUIRE(raw[4] == 5);
+        REQUIRE(raw[9] == 7);
+
+        std::array<Quaternion, 3> loaded{};
+        std::memcpy(static_cast<void *>(loaded.data()), raw.data(), sizeof(loaded));
+        for (uint8_t idx = 0; idx < 4; idx++)
+        {
+            REQUIRE(loaded[1][idx] == q2[idx]);
+            REQUIRE(loaded[2][idx] == q4[idx]);
+        }
+    }
+}
+
+TEST_CASE("Fixed point quaternions", "Vector")
+{
+    using FixedPoint::Q16_16;
+    const Quaternion a{Quaternion::FromAngleAndAxis(0.7f, Matrix<1, 3>{1, -2, 3})};
+    const Quaternion b{Quaternion::FromAngleAndAxis(-1.3f, Matrix<1, 3>{0.5f, 1, 0})};
+    const FixedQuaternion<> fixed_a{a};
+    const FixedQuaternion<> fixed_b{b};
+
+    SECTION("Conversion")
+    {
+        const Quaternion round_trip{fixed_a.ToQuaternion()};
+        for (uint8_t idx = 0; idx < 4; idx++)
+        {
+            REQUIRE_THAT(round_trip[idx], Catch::Matchers::WithinAbs(a[idx], 1e-5));
+        }
+    }
+
+    SECTION("Multiplication")
+    {
+        Quaternion expected;
+        a.Q_Mult(b, expected);
+
+        FixedQuaternion<> buffer;
+        const Quaternion product{fixed_a.Q_Mult(fixed_b, buffer).ToQuaternion()};
+        const Quaternion operator_product{(fixed_a * fixed_b).ToQuaternion()};
+        FixedQuaternion<> in_place{fixed_a};
+        in_place *= fixed_b;
+        for (uint8_t idx = 0; idx < 4; idx++)
+        {
+            REQUIRE_THAT(product[idx], Catch::Matchers::WithinAbs(expected[idx], 1e-4));
+            REQUIRE(operator_product[idx] == product[idx]);
+            REQUIRE(in_place.Element(idx) == buffer.Element(idx));
+        }
+
+        // the conjugate undoes the rotation
+        const FixedQuaternion<> identity{fixed_a * fixed_a.Conjugate()};
+        REQUIRE_THAT(static_cast<float>(identity.w()), Catch::Matchers::WithinAbs(1.0f, 1e-4));
+        REQUIRE_THAT(static_cast<float>(identity.v1()), Catch::Matchers::WithinAbs(0.0f, 1e-4));
+        REQUIRE_THAT(static_cast<float>(identity.v2()), Catch::Matchers::WithinAbs(0.0f, 1e-4));
+        REQUIRE_THAT(static_cast<float>(identity.v3()), Catch::Matchers::WithinAbs(0.0f, 1e-4));
+    }
+
+    SECTION("Normalization")
+    {
+        Quaternion expected{1, -2, 3, 0.5f};
+        expected.Normalize();
+
+        FixedQuaternion<> fixed{1, -2, 3, 0.5};
+        fixed.Normalize();
+        const Quaternion normalized{fixed.ToQuaternion()};
+        for (uint8_t idx = 0; idx < 4; idx++)
+        {
+            REQUIRE_THAT(normalized[idx], Catch::Matchers::WithinAbs(expected[idx], 1e-4));
+        }
+
+        // zero stays zero rather than dividing by it
+        FixedQuaternion<> zero{};
+        zero.Normalize();
+        REQUIRE(zero.w() == Q16_16{});
+
+        // a small drift is pulled back like the float version does it
+        Quaternion drifted{a * 1.01f};
+        drifted.Renormalize();
+        FixedQuaternion<> fixed_drifted{a * 1.01f};
+        fixed_drifted.Renormalize();
+        const Quaternion renormalized{fixed_drifted.ToQuaternion()};
+        for (uint8_t idx = 0; idx < 4; idx++)
+        {
+            REQUIRE_THAT(renormalized[idx], Catch::Matchers::WithinAbs(drifted[idx], 1e-4));
+        }
+    }
+
+    SECTION("Vector Rotation")
+    {
+        const V3D<float> expected{a.Rotate(V3D<float>{0.5f, -1.5f, 2})};
+        const V3D<Q16_16> rotated{fixed_a.Rotate(V3D<Q16_16>{0.5f, -1.5f, 2})};
+        REQUIRE_THAT(static_cast<float>(rotated.x), Catch::Matchers::WithinAbs(expected.x, 1e-4));
+        REQUIRE_THAT(static_cast<float>(rotated.y), Catch::Matchers::WithinAbs(expected.y, 1e-4));
+        REQUIRE_THAT(static_cast<float>(rotated.z), Catch::Matchers::WithinAbs(expected.z, 1e-4));
+
+        // vectors of fixed point numbers do their arithmetic in fixed point
+        const V3D<Q16_16> sum{rotated + V3D<Q16_16>{1, 1, 1}};
+        REQUIRE(sum.x == rotated.x + Q16_16{1});
+        REQUIRE_THAT(sum.magnitude(), Catch::Matchers::WithinRel(V3D<float>{expected + 1.0f}.magnitude(), 1e-4f));
+    }
+
+    SECTION("Attitude updates")
+    {
+        // a thousand small steps, the way a gyro integrates an attitude. The
+        // step itself is rounded to Q16_16, which adds up to about an epsilon
+        // of angle per step, while Renormalize keeps the length at 1.
+        const Quaternion step{Quaternion::FromAngleAndAxis(0.002f, Matrix<1, 3>{0.3f, -1, 0.6f})};
+        const FixedQuaternion<> fixed_step{step};
+        Quaternion attitude{a};
+        FixedQuaternion<> fixed_attitude{fixed_a};
+        for (int idx = 0; idx < 1000; idx++)
+        {
+            attitude *= step;
+            attitude.Renormalize();
+            fixed_attitude *= fixed_step;
+            fixed_attitude.Renormalize();
+        }
+
+        const Quaternion result{fixed_attitude.ToQuaternion()};
+        for (uint8_t idx = 0; idx < 4; idx++)
+        {
+            REQUIRE_THAT(result[idx], Catch::Matchers::WithinAbs(attitude[idx], 1e-2));
+        }
+        REQUIRE_THAT(result.w() * result.w() + result.v1() * result.v1() + result.v2() * result.v2() + result.v3() * result.v3(),
+                     Catch::Matchers::WithinAbs(1.0f, 1e-3));
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,193 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "RigidTransform.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+void requireNear(const V3D<float> &actual, const V3D<float> &expected, float margin = 1e-5f)
+{
+    REQUIRE_THAT(actual.x, Catch::Matchers::WithinAbs(expected.x, margin));
+    REQUIRE_THAT(actual.y, Catch::Matchers::WithinAbs(expected.y, margin));
+    REQUIRE_THAT(actual.z, Catch::Matchers::WithinAbs(expected.z, margin));
+}
+
+template <uint8_t rows, uint8_t columns>
+void requireNear(const Matrix<rows, columns> &actual, const Matrix<rows, columns> &expected, float margin = 1e-5f)
+{
+    for (uint8_t row = 0; row < rows; row++)
+    {
+        for (uint8_t column = 0; column < columns; column++)
+        {
+            REQUIRE_THAT(actual.Get(row, column), Catch::Matchers::WithinAbs(expected.Get(row, column), margin));
+        }
+    }
+}
+
+// the same point through the homogeneous matrix
+V3D<float> applyMatrix(const Matrix<4, 4> &matrix, const V3D<float> &point)
+{
+    const Matrix<4, 1> transformed{matrix * Matrix<4, 1>{point.x, point.y, point.z, 1}};
+    return V3D<float>{transformed.Get(0, 0), transformed.Get(1, 0), transformed.Get(2, 0)};
+}
+
+// compile time composition and inverse
+constexpr RigidTransform quarter_turn{
+    Quaternion::FromAngleAndAxis(M_PI / 2, Matrix<1, 3>{0, 0, 1}), V3D<float>{1, 2, 3}};
+constexpr V3D<float> moved{quarter_turn.Apply(V3D<float>{1, 0, 0})};
+static_assert(ConstexprMath::Abs(moved.x - 1) < 1e-6f, "");
+static_assert(ConstexprMath::Abs(moved.y - 3) < 1e-6f, "");
+constexpr V3D<float> back{quarter_turn.Inverse().Apply(moved)};
+static_assert(ConstexprMath::Abs(back.x - 1) < 1e-5f, "");
+static_assert(ConstexprMath::Abs(back.y) < 1e-5f, "");
+
+TEST_CASE("Rigid Transform", "RigidTransform")
+{
+    const RigidTransform a{Quaternion::FromAngleAndAxis(0.7f, Matrix<1, 3>{1, 2, 3}), V3D<float>{0.5f, -1, 2}};
+    const RigidTransform b{Quaternion::FromAngleAndAxis(-1.2f, Matrix<1, 3>{0, 1, -1}), V3D<float>{-3, 0.25f, 1}};
+    const V3D<float> point{1, -2, 0.5f};
+
+    SECTION("Identity")
+    {
+        const RigidTransform identity{};
+        requireNear(identity.Apply(point), point, 0);
+        requireNear(identity.ToMatrix(), Matrix<4, 4>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}, 0);
+        requireNear((a * identity).Apply(point), a.Apply(point));
+    }
+
+    SECTION("Apply")
+    {
+        requireNear(a.Apply(point), a.Rotation().Rotate(point) + a.Translation());
+        requireNear(a.Apply(point), applyMatrix(a.ToMatrix(), point));
+    }
+
+    SECTION("Compose")
+    {
+        // b first, then a
+        const RigidTransform ab{a * b};
+        requireNear(ab.Apply(point), a.Apply(b.Apply(point)));
+        requireNear(ab.ToMatrix(), Matrix<4, 4>{a.ToMatrix() * b.ToMatrix()});
+
+        RigidTransform in_place{a};
+        in_place *= b;
+        requireNear(in_place.Apply(point), ab.Apply(point), 0);
+
+        // composing with itself
+        in_place = a;
+        in_place *= in_place;
+        requireNear(in_place.Apply(point), a.Apply(a.Apply(point)));
+    }
+
+    SECTION("Inverse")
+    {
+        const RigidTransform inverse{a.Inverse()};
+        requireNear(inverse.Apply(a.Apply(point)), point);
+        requireNear((inverse * a).Apply(point), point);
+        requireNear(inverse.ToMatrix(), a.ToMatrix().Invert());
+
+        // the relative transform between two frames
+        const RigidTransform relative{a.InverseCompose(b)};
+        requireNear(relative.Apply(point), (a.Inverse() * b).Apply(point));
+        requireNear((a * relative).Apply(point), b.Apply(point));
+    }
+
+    SECTION("Matrix Conversion")
+    {
+        // every branch of the conversion, through rotations that make each of
+        // w, x, y and z the largest
+        const std::array<RigidTransform, 5> transforms{
+            a,
+            b,
+            RigidTransform{Quaternion::FromAngleAndAxis(3.0f, Matrix<1, 3>{1, 0.1f, 0}), V3D<float>{1, 0, 0}},
+            RigidTransform{Quaternion::FromAngleAndAxis(3.0f, Matrix<1, 3>{0.1f, 1, 0}), V3D<float>{0, 1, 0}},
+            RigidTransform{Quaternion::FromAngleAndAxis(3.0f, Matrix<1, 3>{0, 0.1f, 1}), V3D<float>{0, 0, 1}}};
+        for (const RigidTransform &transform : transforms)
+        {
+            const RigidTransform converted{RigidTransform::FromMatrix(transform.ToMatrix())};
+            requireNear(converted.ToMatrix(), transform.ToMatrix());
+            requireNear(converted.Apply(point), transform.Apply(point));
+        }
+    }
+
+    SECTION("Interpolate")
+    {
+        requireNear(a.Interpolate(b, 0).ToMatrix(), a.ToMatrix());
+        requireNear(a.Interpolate(b, 1).ToMatrix(), b.ToMatrix());
+
+        // halfway round a single axis is half the angle
+        const Matrix<1, 3> axis{0, 0, 1};
+        const RigidTransform start{Quaternion::FromAngleAndAxis(0.2f, axis), V3D<float>{0, 0, 0}};
+        const RigidTransform end{Quaternion::FromAngleAndAxis(1.4f, axis), V3D<float>{2, -4, 6}};
+        const RigidTransform expected{Quaternion::FromAngleAndAxis(0.5f, axis), V3D<float>{0.5f, -1, 1.5f}};
+        requireNear(start.Interpolate(end, 0.25f).ToMatrix(), expected.ToMatrix());
+
+        // the same rotation with the quaternion negated still takes the short
+        // way round
+        const RigidTransform flipped{end.Rotation() * -1.0f, end.Translation()};
+        requireNear(start.Interpolate(flipped, 0.25f).ToMatrix(), expected.ToMatrix());
+
+        // nearly identical rotations take the straight line blend
+        const RigidTransform close{Quaternion::FromAngleAndAxis(0.2001f, axis), V3D<float>{0, 0, 0}};
+        const RigidTransform blended{start.Interpolate(close, 0.5f)};
+        REQUIRE_THAT(blended.Rotation().w() * blended.Rotation().w() + blended.Rotation().v3() * blended.Rotation().v3(),
+                     Catch::Matchers::WithinAbs(1, 1e-6));
+    }
+
+    SECTION("Normalize")
+    {
+        RigidTransform chain{};
+        for (int idx = 0; idx < 1000; idx++)
+        {
+            chain *= a;
+        }
+        chain.Normalize();
+        const Quaternion &rotation{chain.Rotation()};
+        REQUIRE_THAT(rotation.w() * rotation.w() + rotation.v1() * rotation.v1() + rotation.v2() * rotation.v2() +
+                         rotation.v3() * rotation.v3(),
+                     Catch::Matchers::WithinAbs(1, 1e-6));
+    }
+
+    SECTION("Apply Many")
+    {
+        // both an array of points and a batch, not a multiple of any SIMD width
+        constexpr size_t count = 37;
+        std::vector<float> xyz(3 * count);
+        std::vector<V3D<float>> points{};
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            points.push_back(V3D<float>{static_cast<float>(idx % 5) - 2, static_cast<float>(idx % 7) * 0.5f, 1});
+            xyz[3 * idx] = points.back().x;
+            xyz[3 * idx + 1] = points.back().y;
+            xyz[3 * idx + 2] = points.back().z;
+        }
+
+        std::vector<float> out(3 * count);
+        a.Apply(xyz.data(), out.data(), count);
+        StaticArena<4096> arena{};
+        V3DBatch<float> batch{arena, points.data(), count};
+        V3DBatch<float> result{arena, count};
+        REQUIRE(a.Apply(batch, result));
+        for (size_t idx = 0; idx < count; idx++)
+        {
+            const V3D<float> expected{a.Apply(points[idx])};
+            requireNear(V3D<float>{out[3 * idx], out[3 * idx + 1], out[3 * idx + 2]}, expected);
+            requireNear(result.Get(idx), expected);
+        }
+
+        // in place
+        a.Apply(xyz.data(), xyz.data(), count);
+        for (size_t idx = 0; idx < 3 * count; idx++)
+        {
+            REQUIRE(xyz[idx] == out[idx]);
+        }
+
+        V3DBatch<float> wrong_size{arena, count - 1};
+        REQUIRE_FALSE(a.Apply(batch, wrong_size));
+    }
+}
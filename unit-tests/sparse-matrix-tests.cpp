@@ -0,0 +1,304 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Arena.hpp"
+#include "DynMatrix.hpp"
+#include "SparseMatrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// a sparse-ish pattern with some empty rows and columns and a few duplicate
+// entries
+std::vector<Triplet> testTriplets(uint32_t rows, uint32_t columns)
+{
+  std::vector<Triplet> triplets{};
+  for (uint32_t row{0}; row < rows; row++)
+  {
+    if (row % 7 == 3)
+    {
+      continue;
+    }
+    for (uint32_t column{(row * 5) % 3}; column < columns; column += 4)
+    {
+      triplets.push_back(
+          Triplet{row, column, static_cast<float>((row + 2 * column) % 9) - 4});
+    }
+  }
+  // added twice, the values should be summed
+  triplets.push_back(Triplet{0, 0, 1.5f});
+  triplets.push_back(Triplet{rows - 1, columns - 1, -2.0f});
+  triplets.push_back(Triplet{rows - 1, columns - 1, 0.25f});
+  return triplets;
+}
+
+void tripletsToDense(const std::vector<Triplet> &triplets, DynMatrix &dense)
+{
+  dense.Fill(0);
+  for (const Triplet &triplet : triplets)
+  {
+    dense[triplet.row][triplet.column] += triplet.value;
+  }
+}
+
+TEST_CASE("Sparse matrix construction", "SparseMatrix")
+{
+  std::vector<float> buffer(1 << 18);
+  Arena arena{buffer.data(), buffer.size() * sizeof(float)};
+
+  for (SparseMatrix::Layout layout :
+       {SparseMatrix::Layout::CSR, SparseMatrix::Layout::CSC})
+  {
+    const size_t mark{arena.Mark()};
+    const std::vector<Triplet> triplets{testTriplets(23, 17)};
+    SparseMatrix sparse{SparseMatrix::FromTriplets(
+        arena, 23, 17, triplets.data(), triplets.size(), layout)};
+    REQUIRE(sparse.IsValid());
+    REQUIRE(sparse.GetRowSize() == 23);
+    REQUIRE(sparse.GetColumnSize() == 17);
+    REQUIRE(sparse.GetLayout() == layout);
+    // the two duplicates of the last element share one entry
+    REQUIRE(sparse.NonZeros() < triplets.size());
+
+    DynMatrix expected{arena, 23, 17};
+    tripletsToDense(triplets, expected);
+    for (size_t row{0}; row < 23; row++)
+    {
+      for (size_t column{0}; column < 17; column++)
+      {
+        REQUIRE(sparse.Get(row, column) == expected.Get(row, column));
+      }
+    }
+    if (BoundsCheck::policy == BoundsCheck::Policy::Saturate)
+    {
+      REQUIRE(sparse.Get(23, 0) == 1e+10);
+    }
+
+    // indices are sorted inside each row (or column)
+    const size_t outer_size{layout == SparseMatrix::Layout::CSR ? 23u : 17u};
+    for (size_t outer{0}; outer < outer_size; outer++)
+    {
+      for (uint32_t entry{sparse.OuterStarts()[outer] + 1};
+           entry < sparse.OuterStarts()[outer + 1]; entry++)
+      {
+        REQUIRE(sparse.InnerIndices()[entry - 1] <
+                sparse.InnerIndices()[entry]);
+      }
+    }
+
+    DynMatrix dense{arena, 23, 17};
+    REQUIRE(sparse.ToDense(dense));
+    for (size_t idx{0}; idx < dense.Size(); idx++)
+    {
+      REQUIRE(dense.Data()[idx] == expected.Data()[idx]);
+    }
+
+    SparseMatrix from_dense{SparseMatrix::FromDense(arena, dense, layout)};
+    REQUIRE(from_dense.NonZeros() <= sparse.NonZeros());
+    for (size_t row{0}; row < 23; row++)
+    {
+      for (size_t column{0}; column < 17; column++)
+      {
+        REQUIRE(from_dense.Get(row, column) == expected.Get(row, column));
+      }
+    }
+    REQUIRE_FALSE(from_dense.SetValues(nullptr, 0));
+    arena.Rewind(mark);
+  }
+
+  SECTION("Fixed size matrices")
+  {
+    const Matrix<3, 4> fixed{1, 0, 0, 2,
+                             0, 0, 3, 0,
+                             0, 4, 0, 0};
+    SparseMatrix sparse{SparseMatrix::FromDense(arena, fixed)};
+    REQUIRE(sparse.NonZeros() == 4);
+    Matrix<3, 4> dense{};
+    REQUIRE(sparse.ToDense(dense));
+    for (uint8_t row{0}; row < 3; row++)
+    {
+      for (uint8_t column{0}; column < 4; column++)
+      {
+        REQUIRE(dense.Get(row, column) == fixed.Get(row, column));
+      }
+    }
+    Matrix<4, 3> wrong{};
+    REQUIRE_FALSE(sparse.ToDense(wrong));
+  }
+
+  SECTION("Failures")
+  {
+    const std::array<Triplet, 2> triplets{{{0, 0, 1}, {5, 0, 1}}};
+    SparseMatrix out_of_bounds{
+        SparseMatrix::FromTriplets(arena, 5, 5, triplets.data(), 2)};
+    REQUIRE_FALSE(out_of_bounds.IsValid());
+
+    StaticArena<64> tiny{};
+    const std::vector<Triplet> many{testTriplets(30, 30)};
+    SparseMatrix too_big{
+        SparseMatrix::FromTriplets(tiny, 30, 30, many.data(), many.size())};
+    REQUIRE_FALSE(too_big.IsValid());
+    REQUIRE(tiny.Used() == 0);
+  }
+}
+
+TEST_CASE("Sparse matrix products", "SparseMatrix")
+{
+  std::vector<float> buffer(1 << 20);
+  Arena arena{buffer.data(), buffer.size() * sizeof(float)};
+
+  const std::vector<Triplet> triplets{testTriplets(41, 29)};
+  DynMatrix expected{arena, 41, 29};
+  tripletsToDense(triplets, expected);
+
+  for (SparseMatrix::Layout layout :
+       {SparseMatrix::Layout::CSR, SparseMatrix::Layout::CSC})
+  {
+    const size_t mark{arena.Mark()};
+    SparseMatrix sparse{SparseMatrix::FromTriplets(
+        arena, 41, 29, triplets.data(), triplets.size(), layout)};
+
+    // SpMV in both directions
+    std::vector<float> x(29);
+    std::vector<float> y(41);
+    for (size_t idx{0}; idx < x.size(); idx++)
+    {
+      x[idx] = static_cast<float>(idx % 6) - 2.5f;
+    }
+    REQUIRE(sparse.Mult(x.data(), y.data()));
+    for (size_t row{0}; row < 41; row++)
+    {
+      float sum{0};
+      for (size_t column{0}; column < 29; column++)
+      {
+        sum += expected.Get(row, column) * x[column];
+      }
+      REQUIRE_THAT(y[row], Catch::Matchers::WithinAbs(sum, 1e-4));
+    }
+
+    std::vector<float> z(29);
+    REQUIRE(sparse.TransposeMult(y.data(), z.data()));
+    for (size_t column{0}; column < 29; column++)
+    {
+      float sum{0};
+      for (size_t row{0}; row < 41; row++)
+      {
+        sum += expected.Get(row, column) * y[row];
+      }
+      REQUIRE_THAT(z[column], Catch::Matchers::WithinAbs(sum, 1e-3));
+    }
+
+    // sparse times dense, narrow and wide enough for the kernels
+    for (size_t dense_columns : {3, 40})
+    {
+      DynMatrix dense{arena, 29, dense_columns};
+      DynMatrix dense_t{arena, 41, dense_columns};
+      for (size_t idx{0}; idx < dense.Size(); idx++)
+      {
+        dense.Data()[idx] = static_cast<float>(idx % 13) - 6;
+      }
+      for (size_t idx{0}; idx < dense_t.Size(); idx++)
+      {
+        dense_t.Data()[idx] = static_cast<float>(idx % 7) - 3;
+      }
+
+      DynMatrix result{arena, 41, dense_columns};
+      DynMatrix reference{arena, 41, dense_columns};
+      REQUIRE(sparse.Mult(dense, result));
+      REQUIRE(expected.Mult(dense, reference));
+      for (size_t idx{0}; idx < result.Size(); idx++)
+      {
+        REQUIRE_THAT(result.Data()[idx],
+                     Catch::Matchers::WithinAbs(reference.Data()[idx], 1e-3));
+      }
+
+      DynMatrix result_t{arena, 29, dense_columns};
+      DynMatrix reference_t{arena, 29, dense_columns};
+      DynMatrix expected_t{arena, 29, 41};
+      REQUIRE(sparse.TransposeMult(dense_t, result_t));
+      REQUIRE(expected.Transpose(expected_t));
+      REQUIRE(expected_t.Mult(dense_t, reference_t));
+      for (size_t idx{0}; idx < result_t.Size(); idx++)
+      {
+        REQUIRE_THAT(result_t.Data()[idx],
+                     Catch::Matchers::WithinAbs(reference_t.Data()[idx], 1e-3));
+      }
+
+      REQUIRE_FALSE(sparse.Mult(dense_t, result));
+      REQUIRE_FALSE(sparse.TransposeMult(dense, result_t));
+    }
+    arena.Rewind(mark);
+  }
+
+  SECTION("Fixed size matrices")
+  {
+    const std::array<Triplet, 4> fixed_triplets{
+        {{0, 1, 2}, {1, 0, -1}, {2, 2, 3}, {2, 0, 0.5f}}};
+    SparseMatrix sparse{
+        SparseMatrix::FromTriplets(arena, 3, 3, fixed_triplets.data(), 4)};
+    Matrix<3, 2> dense{1, 2,
+                       3, 4,
+                       5, 6};
+    Matrix<3, 2> result{};
+    REQUIRE(sparse.Mult(dense, result));
+    REQUIRE(result.Get(0, 0) == 6);
+    REQUIRE(result.Get(1, 1) == -2);
+    REQUIRE(result.Get(2, 0) == 15.5f);
+
+    REQUIRE(sparse.TransposeMult(dense, result));
+    REQUIRE(result.Get(0, 0) == -0.5f);
+    REQUIRE(result.Get(1, 0) == 2);
+    REQUIRE(result.Get(2, 1) == 18);
+
+    // result can be the same matrix as dense
+    REQUIRE(sparse.Mult(dense, dense));
+    REQUIRE(dense.Get(2, 0) == 15.5f);
+  }
+}
+
+TEST_CASE("Sparse matrix static pattern", "SparseMatrix")
+{
+  std::vector<float> buffer(1 << 18);
+  Arena arena{buffer.data(), buffer.size() * sizeof(float)};
+
+  std::vector<Triplet> triplets{testTriplets(19, 31)};
+  SparseMatrix sparse{SparseMatrix::FromTriplets(
+      arena, 19, 31, triplets.data(), triplets.size(),
+      SparseMatrix::Layout::CSC)};
+  const size_t non_zeros{sparse.NonZeros()};
+  const uint32_t *inner_indices{sparse.InnerIndices()};
+  const size_t used{arena.Used()};
+
+  // refresh the values a few times without rebuilding anything
+  for (uint8_t cycle{1}; cycle < 4; cycle++)
+  {
+    std::vector<float> values(triplets.size());
+    for (size_t idx{0}; idx < triplets.size(); idx++)
+    {
+      values[idx] = static_cast<float>(cycle) * (idx % 5) - 1;
+      triplets[idx].value = values[idx];
+    }
+    REQUIRE(sparse.SetValues(values.data(), values.size()));
+    REQUIRE(sparse.NonZeros() == non_zeros);
+    REQUIRE(sparse.InnerIndices() == inner_indices);
+    REQUIRE(arena.Used() == used);
+
+    DynMatrix expected{arena, 19, 31};
+    tripletsToDense(triplets, expected);
+    for (size_t row{0}; row < 19; row++)
+    {
+      for (size_t column{0}; column < 31; column++)
+      {
+        REQUIRE(sparse.Get(row, column) == expected.Get(row, column));
+      }
+    }
+    arena.Rewind(used);
+  }
+
+  std::vector<float> short_values(triplets.size() - 1);
+  REQUIRE_FALSE(sparse.SetValues(short_values.data(), short_values.size()));
+}
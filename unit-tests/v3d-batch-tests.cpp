@@ -0,0 +1,262 @@
+// include the unit test framework first
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+// include the module you're going to test next
+#include "Arena.hpp"
+#include "V3DBatch.hpp"
+#include "Vector3D.hpp"
+#include "Matrix.hpp"
+
+// any other libraries
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// more than one chunk and not a multiple of any SIMD width
+constexpr size_t point_count{601};
+
+template <typename Type>
+std::vector<V3D<Type>> testPoints(Type offset)
+{
+    std::vector<V3D<Type>> points{};
+    for (size_t idx{0}; idx < point_count; idx++)
+    {
+        points.push_back(V3D<Type>{static_cast<Type>(idx % 13) - 6 + offset,
+                                   static_cast<Type>(idx % 7) * 0.5f - offset,
+                                   static_cast<Type>(idx % 5) + 1});
+    }
+    return points;
+}
+
+template <typename Type>
+void requireNear(const V3D<Type> &actual, const V3D<Type> &expected)
+{
+    REQUIRE_THAT(actual.x, Catch::Matchers::WithinAbs(expected.x, 1e-4));
+    REQUIRE_THAT(actual.y, Catch::Matchers::WithinAbs(expected.y, 1e-4));
+    REQUIRE_THAT(actual.z, Catch::Matchers::WithinAbs(expected.z, 1e-4));
+}
+
+TEST_CASE("V3D Batch", "V3DBatch")
+{
+    std::vector<V3D<float>> points1{testPoints<float>(0.25f)};
+    std::vector<V3D<float>> points2{testPoints<float>(-1.5f)};
+    StaticArena<64 * 1024> arena{};
+    V3DBatch<float> batch1{arena, points1.data(), point_count};
+    V3DBatch<float> batch2{arena, points2.data(), point_count};
+    V3DBatch<float> result{arena, point_count};
+
+    SECTION("Layout")
+    {
+        REQUIRE(batch1.Size() == point_count);
+        REQUIRE(batch1.IsValid());
+        for (const float *component : {batch1.X(), batch1.Y(), batch1.Z()})
+        {
+            REQUIRE(reinterpret_cast<uintptr_t>(component) %
+                        V3DBatch<float>::alignment ==
+                    0);
+        }
+
+        std::vector<V3D<float>> stored(point_count);
+        batch1.Store(stored.data());
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            REQUIRE(stored[idx] == points1[idx]);
+            REQUIRE(batch1.Get(idx) == points1[idx]);
+        }
+
+        batch1.Set(3, V3D<float>{7, 8, 9});
+        REQUIRE(batch1.Get(3) == V3D<float>{7, 8, 9});
+
+        REQUIRE(result.CopyFrom(batch1));
+        REQUIRE(result.X() != batch1.X());
+        REQUIRE(result.Get(3) == V3D<float>{7, 8, 9});
+        REQUIRE_FALSE(result.CopyFrom(V3DBatch<float>{}));
+
+        V3DBatch<float> moved{std::move(result)};
+        REQUIRE(moved.Get(3) == V3D<float>{7, 8, 9});
+        REQUIRE_FALSE(result.IsValid());
+        REQUIRE(result.Size() == 0);
+    }
+
+    SECTION("Out of memory")
+    {
+        StaticArena<1024> tiny{};
+        V3DBatch<float> batch{tiny, point_count};
+        REQUIRE_FALSE(batch.IsValid());
+        REQUIRE(batch.Size() == 0);
+        REQUIRE(tiny.Used() == 0);
+    }
+
+    SECTION("Views")
+    {
+        std::array<float, 4> x{1, 2, 3, 4};
+        std::array<float, 4> y{0, 0, 0, 0};
+        std::array<float, 4> z{-1, -2, -3, -4};
+        V3DBatch<float> view{
+            V3DBatch<float>::View(x.data(), y.data(), z.data(), 4)};
+        REQUIRE(view.IsValid());
+
+        // writes go straight to the wrapped arrays
+        view.Scale(2, view);
+        REQUIRE(x[3] == 8);
+        REQUIRE(z[0] == -2);
+
+        // mismatched sizes are rejected
+        REQUIRE_FALSE(view.Add(batch1, view));
+        REQUIRE(x[0] == 2);
+
+        REQUIRE_FALSE(
+            V3DBatch<float>::View(x.data(), nullptr, z.data(), 4).IsValid());
+    }
+
+    SECTION("Aliased views")
+    {
+        // two separate views over batch1's arrays, writing into one while
+        // reading the other has to work like writing over batch1 itself
+        V3DBatch<float> input{V3DBatch<float>::View(batch1.X(), batch1.Y(),
+                                                    batch1.Z(), point_count)};
+        V3DBatch<float> output{V3DBatch<float>::View(batch1.X(), batch1.Y(),
+                                                     batch1.Z(), point_count)};
+        REQUIRE(input.Cross(batch2, output));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            const V3D<float> &a{points1[idx]};
+            const V3D<float> &b{points2[idx]};
+            requireNear(batch1.Get(idx), V3D<float>{a.y * b.z - a.z * b.y,
+                                                    a.z * b.x - a.x * b.z,
+                                                    a.x * b.y - a.y * b.x});
+        }
+
+        // the components of a view don't have to line up with the ones of
+        // the batch it overlaps
+        V3DBatch<float> rotated{V3DBatch<float>::View(batch2.Y(), batch2.Z(),
+                                                      batch2.X(), point_count)};
+        const Matrix<3, 3> rotation{0, -1, 0,
+                                    1, 0, 0,
+                                    0, 0, 1};
+        REQUIRE(batch2.Transform(rotation, V3D<float>{}, rotated));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            const V3D<float> &point{points2[idx]};
+            requireNear(batch2.Get(idx),
+                        V3D<float>{point.z, -point.y, point.x});
+        }
+    }
+
+    SECTION("Element-wise")
+    {
+        REQUIRE(batch1.Add(batch2, result));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            requireNear(result.Get(idx), points1[idx] + points2[idx]);
+        }
+
+        REQUIRE(batch1.Sub(batch2, result));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            requireNear(result.Get(idx), points1[idx] - points2[idx]);
+        }
+
+        REQUIRE(batch1.Add(V3D<float>{1, -2, 3}, result));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            requireNear(result.Get(idx), points1[idx] + V3D<float>{1, -2, 3});
+        }
+
+        REQUIRE(batch1.Scale(-0.5f, batch1));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            requireNear(batch1.Get(idx), points1[idx] * -0.5f);
+        }
+    }
+
+    SECTION("Products")
+    {
+        std::vector<float> dots(point_count);
+        REQUIRE(batch1.Dot(batch2, dots.data()));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            const V3D<float> &a{points1[idx]};
+            const V3D<float> &b{points2[idx]};
+            REQUIRE_THAT(dots[idx], Catch::Matchers::WithinAbs(
+                                        a.x * b.x + a.y * b.y + a.z * b.z,
+                                        1e-4));
+        }
+
+        // into a separate batch and over one of the inputs
+        REQUIRE(batch1.Cross(batch2, result));
+        REQUIRE(batch1.Cross(batch2, batch1));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            const V3D<float> &a{points1[idx]};
+            const V3D<float> &b{points2[idx]};
+            const V3D<float> expected{a.y * b.z - a.z * b.y,
+                                      a.z * b.x - a.x * b.z,
+                                      a.x * b.y - a.y * b.x};
+            requireNear(result.Get(idx), expected);
+            requireNear(batch1.Get(idx), expected);
+        }
+    }
+
+    SECTION("Norms")
+    {
+        std::vector<float> norms(point_count);
+        batch1.Norm(norms.data());
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            REQUIRE_THAT(norms[idx], Catch::Matchers::WithinRel(
+                                         points1[idx].magnitude(), 1e-5f));
+        }
+
+        batch1.Set(0, V3D<float>{0, 0, 0});
+        REQUIRE(batch1.Normalize(batch1));
+        REQUIRE(batch1.Get(0) == V3D<float>{0, 0, 0});
+        for (size_t idx{1}; idx < point_count; idx++)
+        {
+            requireNear(batch1.Get(idx),
+                        points1[idx] / points1[idx].magnitude());
+        }
+    }
+
+    SECTION("Transform")
+    {
+        // 90 degrees about z, then a shift
+        Matrix<3, 3> rotation{0, -1, 0,
+                              1, 0, 0,
+                              0, 0, 1};
+        const V3D<float> translation{10, 20, 30};
+
+        REQUIRE(batch1.Transform(rotation, translation, result));
+        REQUIRE(batch1.Transform(rotation, translation, batch1));
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            const V3D<float> &point{points1[idx]};
+            const V3D<float> expected{-point.y + 10, point.x + 20,
+                                      point.z + 30};
+            requireNear(result.Get(idx), expected);
+            requireNear(batch1.Get(idx), expected);
+        }
+    }
+
+    SECTION("Other types")
+    {
+        std::vector<V3D<double>> points{testPoints<double>(0.25)};
+        V3DBatch<double> batch{arena, points.data(), point_count};
+        V3DBatch<double> doubled{arena, point_count};
+        REQUIRE(batch.Add(batch, doubled));
+
+        std::vector<double> norms(point_count);
+        doubled.Norm(norms.data());
+        for (size_t idx{0}; idx < point_count; idx++)
+        {
+            requireNear(doubled.Get(idx), points[idx] * 2.0);
+            REQUIRE_THAT(norms[idx],
+                         Catch::Matchers::WithinRel(
+                             2.0 * static_cast<double>(points[idx].magnitude()),
+                             1e-6));
+        }
+    }
+}
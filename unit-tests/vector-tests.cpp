@@ -42,4 +42,28 @@ TEST_CASE("Vector Math", "Vector")
         REQUIRE(v5.y == v1.y);
         REQUIRE(v5.z == v1.z);
     }
-}
\ No newline at end of file
+
+    SECTION("Compound Assignment")
+    {
+        v1 += v2;
+        REQUIRE(v1 == V3D<float>{5, 7, 9});
+        v1 -= v2;
+        REQUIRE(v1 == V3D<float>{1, 2, 3});
+        v1 += 1;
+        REQUIRE(v1 == V3D<float>{2, 3, 4});
+        v1 -= 2;
+        REQUIRE(v1 == V3D<float>{0, 1, 2});
+        v1 *= 3;
+        REQUIRE(v1 == V3D<float>{0, 3, 6});
+        v1 /= 3;
+        REQUIRE(v1 == V3D<float>{0, 1, 2});
+
+        // chained
+        v3 = v1 = v2;
+        REQUIRE(v3 == V3D<float>{4, 5, 6});
+        REQUIRE(v1 == V3D<float>{4, 5, 6});
+
+        // passed around in registers
+        REQUIRE(std::is_trivially_copyable<V3D<float>>::value);
+    }
+}